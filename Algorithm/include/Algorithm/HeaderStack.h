@@ -21,11 +21,143 @@
 // to check the consistency of the header stack, also the next-header-flag
 // is part of the BaseHeader
 #include "Headers/DataHeader.h" // for o2::Header::get
+#include <array>
+#include <utility>
 
 namespace o2 {
 
 namespace algorithm {
 
+/**
+ * @class HeaderStackIndex
+ * Index of the headers in an O2 header stack
+ *
+ * The stack is scanned once, the header type and offset of every header are
+ * stored in a small fixed array. Subsequent lookups of a header type compare
+ * the 64 bit integer representation of the type against this array instead
+ * of following the chain of headers through the buffer again.
+ *
+ * The scan stops at the first inconsistency, i.e. a missing magic string or
+ * a header exceeding the buffer size if the size is known. Only the first
+ * sMaxEntries headers are indexed, headers beyond are found by walking the
+ * rest of the chain from the first one not in the index.
+ *
+ * Usage:
+ *   HeaderStackIndex index(ptr, size);
+ *   auto dh = index.get<DataHeader>();
+ */
+class HeaderStackIndex {
+public:
+  using BaseHeader = o2::Header::BaseHeader;
+  using byte = ::byte;
+  static const size_t sMaxEntries = 8;
+
+  /// index the header stack at buffer, size 0 disables the bounds check
+  template<typename PtrType>
+  HeaderStackIndex(PtrType buffer, size_t size = 0)
+    : mBuffer(reinterpret_cast<const byte*>(buffer)), mBufferSize(size), mEntries(), mNEntries(0), mNHeaders(0), mTailOffset(0)
+  {
+    if (mBuffer == nullptr) return;
+    size_t offset = 0;
+    const BaseHeader* current = nullptr;
+    while ((current = header(offset)) != nullptr) {
+      if (mNEntries < sMaxEntries) {
+        mEntries[mNEntries].type = current->description.itg[0];
+        mEntries[mNEntries].offset = offset;
+        ++mNEntries;
+      } else if (mTailOffset == 0) {
+        mTailOffset = offset;
+      }
+      ++mNHeaders;
+      if (!current->flagsNextHeader) break;
+      offset += current->headerSize;
+    }
+  }
+
+  /// number of headers in the stack
+  size_t size() const {return mNHeaders;}
+
+  /// header at position in the stack
+  const BaseHeader* at(size_t position) const {
+    if (position < mNEntries) {
+      return reinterpret_cast<const BaseHeader*>(mBuffer + mEntries[position].offset);
+    }
+    if (position >= mNHeaders) return nullptr;
+    size_t offset = mTailOffset;
+    for (size_t i = mNEntries; i < position; ++i) {
+      offset += header(offset)->headerSize;
+    }
+    return header(offset);
+  }
+
+  /// first header of type HeaderType, nullptr if not in the stack
+  template<typename HeaderType>
+  const HeaderType* get() const {
+    const auto type = HeaderType::sHeaderType.itg[0];
+    for (size_t i = 0; i < mNEntries; ++i) {
+      if (mEntries[i].type == type) {
+        return reinterpret_cast<const HeaderType*>(mBuffer + mEntries[i].offset);
+      }
+    }
+    // the stack is longer than the index, walk the rest of the chain
+    size_t offset = mTailOffset;
+    for (size_t i = mNEntries; i < mNHeaders; ++i) {
+      const BaseHeader* current = header(offset);
+      if (current->description.itg[0] == type) {
+        return reinterpret_cast<const HeaderType*>(current);
+      }
+      offset += current->headerSize;
+    }
+    return nullptr;
+  }
+
+  /// invoke callbacks for pairs of header type and callback, see
+  /// dispatchHeaderStackCallback
+  template<typename HeaderType, typename HeaderCallbackType, typename... MoreTypes>
+  void dispatch(HeaderType /*dummy*/, HeaderCallbackType onHeader, MoreTypes&&... types) const {
+    const HeaderType* h = get<HeaderType>();
+    if (h) {
+      onHeader(*h);
+    }
+    dispatch(std::forward<MoreTypes>(types)...);
+  }
+  void dispatch() const {}
+
+  /// copy headers to the references, see parseHeaderStack
+  template<typename HeaderType, typename... MoreTypes>
+  void parse(HeaderType& header, MoreTypes&&... types) const {
+    const HeaderType* h = get<HeaderType>();
+    if (h) {
+      header = *h;
+    }
+    parse(std::forward<MoreTypes>(types)...);
+  }
+  void parse() const {}
+
+private:
+  struct Entry {
+    uint64_t type = 0;
+    size_t offset = 0;
+  };
+
+  /// consistent header at offset, nullptr if there is none
+  const BaseHeader* header(size_t offset) const {
+    if (mBufferSize > 0 && offset + sizeof(BaseHeader) > mBufferSize) return nullptr;
+    const BaseHeader* current = BaseHeader::get(mBuffer + offset);
+    if (current == nullptr) return nullptr;
+    if (current->headerSize < sizeof(BaseHeader)) return nullptr;
+    if (mBufferSize > 0 && offset + current->headerSize > mBufferSize) return nullptr;
+    return current;
+  }
+
+  const byte* mBuffer;
+  size_t mBufferSize;
+  std::array<Entry, sMaxEntries> mEntries;
+  size_t mNEntries; // number of indexed headers
+  size_t mNHeaders; // number of headers in the stack
+  size_t mTailOffset; // offset of the first header not in the index
+};
+
 /**
  * Generic utility for the O2 header stack, redirect to header specific callbacks
  *
@@ -35,6 +167,8 @@ namespace algorithm {
  * of type and callback has to be provided. The header type can be provided as
  * a dummy parameter, the callback with a lambda or any callable object.
  *
+ * The header stack is indexed once, see HeaderStackIndex.
+ *
  * Usage:
  *   dispatchHeaderStackCallback(ptr, size,
  *                               MyHeader(),
@@ -45,56 +179,14 @@ namespace algorithm {
 template<
   typename PtrType,
   typename SizeType,
-  typename HeaderType,
-  typename HeaderCallbackType,
   typename... MoreTypes
   >
 void dispatchHeaderStackCallback(PtrType ptr,
                                  SizeType size,
-                                 HeaderType header,
-                                 HeaderCallbackType onHeader,
-                                 MoreTypes&&... types);
-
-// template specialization: handler for one pair of type and callback
-template<
-  typename PtrType,
-  typename SizeType,
-  typename HeaderType,
-  typename HeaderCallbackType
-  >
-void dispatchHeaderStackCallback(PtrType ptr,
-                                 SizeType size,
-                                 HeaderType /*dummy*/,
-                                 HeaderCallbackType onHeader)
-{
-  const HeaderType* h = o2::Header::get<HeaderType>(ptr, size);
-  if (h) {
-    onHeader(*h);
-  }
-}
-
-// an empty function in case no StackTypes have been provided to call
-template<typename PtrType, typename SizeType>
-void dispatchHeaderStackCallback(PtrType ptr, SizeType size) {}
-
-// actual implementation
-template<
-  typename PtrType,
-  typename SizeType,
-  typename HeaderType,
-  typename HeaderCallbackType,
-  typename... MoreTypes
-  >
-void dispatchHeaderStackCallback(PtrType ptr,
-                                 SizeType size,
-                                 HeaderType header,
-                                 HeaderCallbackType onHeader,
                                  MoreTypes&&... types)
 {
-  // call for current
-  dispatchHeaderStackCallback(ptr, size, header, onHeader);
-  // call for next
-  dispatchHeaderStackCallback(ptr, size, types...);
+  HeaderStackIndex index(ptr, size);
+  index.dispatch(std::forward<MoreTypes>(types)...);
 }
 
 /**
@@ -106,6 +198,8 @@ void dispatchHeaderStackCallback(PtrType ptr,
  * extracted, a variable can be passed be reference. If a header of corresponding
  * type is in the stack, its content will be assigned to the variable.
  *
+ * The header stack is indexed once, see HeaderStackIndex.
+ *
  * Usage:
  *   DataHeader dataheader;
  *   TriggerHeader triggerheader
@@ -116,50 +210,14 @@ void dispatchHeaderStackCallback(PtrType ptr,
 template<
   typename PtrType,
   typename SizeType,
-  typename HeaderType,
-  typename... MoreTypes
-  >
-void parseHeaderStack(PtrType ptr,
-                      SizeType size,
-                      HeaderType & header,
-                      MoreTypes&&... types);
-
-// template specialization: handler for one type
-template<
-  typename PtrType,
-  typename SizeType,
-  typename HeaderType
-  >
-void parseHeaderStack(PtrType ptr,
-                      SizeType size,
-                      HeaderType & header)
-{
-  const HeaderType* h = o2::Header::get<HeaderType>(ptr, size);
-  if (h) {
-    header = *h;
-  }
-}
-
-// an empty function in case no StackTypes have been provided to call
-template<typename PtrType, typename SizeType>
-void parseHeaderStack(PtrType ptr, SizeType size) {}
-
-// generic implementation
-template<
-  typename PtrType,
-  typename SizeType,
-  typename HeaderType,
   typename... MoreTypes
   >
 void parseHeaderStack(PtrType ptr,
                       SizeType size,
-                      HeaderType & header,
                       MoreTypes&&... types)
 {
-  // call for current
-  parseHeaderStack(ptr, size, header);
-  // call for next
-  parseHeaderStack(ptr, size, types...);
+  HeaderStackIndex index(ptr, size);
+  index.parse(std::forward<MoreTypes>(types)...);
 }
 
 }; // namespace algorithm
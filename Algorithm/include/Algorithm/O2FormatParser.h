@@ -69,14 +69,13 @@ int parseO2Format(const InputListT& list,
   for (auto & part : list) {
     if (!dh) {
       // new header - payload pair, read DataHeader
-      dh = o2::Header::get<o2::Header::DataHeader>(getPointer(part), getSize(part));
+      // the header stack is scanned only once for all headers
+      HeaderStackIndex index(getPointer(part), getSize(part));
+      dh = index.get<o2::Header::DataHeader>();
       if (!dh) {
         return -ENOMSG;
       }
-      o2::algorithm::dispatchHeaderStackCallback(getPointer(part),
-                                                 getSize(part),
-                                                 stackArgs...
-                                                 );
+      index.dispatch(stackArgs...);
     } else {
       insert(*dh, getPointer(part), getSize(part));
       dh = nullptr;
@@ -91,18 +91,44 @@ public:
   using GetFrameSizeFct = std::function<size_t(const HeaderType& )>;
   using InsertFct = std::function<bool(FrameInfo&)>;
 
+  /// parse the buffer, frames are inserted after the complete buffer has
+  /// been found to be consistent
   template<typename InputType>
   int parse(const InputType* buffer, size_t bufferSize,
             CheckHeaderFct checkHeader,
             CheckTrailerFct checkTrailer,
             GetFrameSizeFct getFrameSize,
             InsertFct insert) {
+    return parseFrames<false>(buffer, bufferSize, checkHeader, checkTrailer, getFrameSize, insert);
+  }
+
+  /// parse the buffer and insert every frame as soon as it has been found,
+  /// frames before a format error have already been inserted when -1 is
+  /// returned
+  template<typename InputType>
+  int stream(const InputType* buffer, size_t bufferSize,
+             CheckHeaderFct checkHeader,
+             CheckTrailerFct checkTrailer,
+             GetFrameSizeFct getFrameSize,
+             InsertFct insert) {
+    return parseFrames<true>(buffer, bufferSize, checkHeader, checkTrailer, getFrameSize, insert);
+  }
+
+private:
+  template<bool Streaming, typename InputType>
+  int parseFrames(const InputType* buffer, size_t bufferSize,
+                  CheckHeaderFct& checkHeader,
+                  CheckTrailerFct& checkTrailer,
+                  GetFrameSizeFct& getFrameSize,
+                  InsertFct& insert) {
     static_assert(sizeof(InputType) == 1,
                   "ForwardParser currently only supports byte type buffer"
                   );
     if (buffer == nullptr || bufferSize == 0) return 0;
-    auto position = 0;
+    size_t position = 0;
     std::vector<FrameInfo> frames;
+    int nFrames = 0;
+    bool inserting = true;
     do {
       FrameInfo entry;
 
@@ -121,7 +147,7 @@ public:
       entry.length = frameSize - totalOffset;
 
       // optionally extract and check trailer
-      if (tailOffset > 0) {
+      if (tailOffset == 0) {
         entry.trailer = nullptr;
       } else {
         auto trailerStart = buffer + position + frameSize - tailOffset;
@@ -130,7 +156,12 @@ public:
       }
 
       // store the extracted frame info and continue with remaining buffer
-      frames.emplace_back(entry);
+      if (Streaming) {
+        if (inserting) inserting = insert(entry);
+      } else {
+        frames.emplace_back(entry);
+      }
+      ++nFrames;
       position += frameSize;
     } while (position < bufferSize);
 
@@ -140,8 +171,8 @@ public:
       for (auto entry : frames) {
         if (!insert(entry)) break;
       }
-      return frames.size();
-    } else if (frames.size() == 0) {
+      return nFrames;
+    } else if (nFrames == 0) {
       // no frames found at all, the buffer does not contain any
       return 0;
     }
@@ -208,18 +239,44 @@ public:
   using GetFrameSizeFct = std::function<size_t(const TrailerType&)>;
   using InsertFct = std::function<bool(const FrameInfo&)>;
 
+  /// parse the buffer, frames are inserted after the complete buffer has
+  /// been found to be consistent
   template<typename InputType>
   int parse(const InputType* buffer, size_t bufferSize,
             CheckHeaderFct checkHeader,
             CheckTrailerFct checkTrailer,
             GetFrameSizeFct getFrameSize,
             InsertFct insert) {
+    return parseFrames<false>(buffer, bufferSize, checkHeader, checkTrailer, getFrameSize, insert);
+  }
+
+  /// parse the buffer and insert every frame as soon as it has been found,
+  /// frames before a format error have already been inserted when -1 is
+  /// returned
+  template<typename InputType>
+  int stream(const InputType* buffer, size_t bufferSize,
+             CheckHeaderFct checkHeader,
+             CheckTrailerFct checkTrailer,
+             GetFrameSizeFct getFrameSize,
+             InsertFct insert) {
+    return parseFrames<true>(buffer, bufferSize, checkHeader, checkTrailer, getFrameSize, insert);
+  }
+
+private:
+  template<bool Streaming, typename InputType>
+  int parseFrames(const InputType* buffer, size_t bufferSize,
+                  CheckHeaderFct& checkHeader,
+                  CheckTrailerFct& checkTrailer,
+                  GetFrameSizeFct& getFrameSize,
+                  InsertFct& insert) {
     static_assert(sizeof(InputType) == 1,
                   "ReverseParser currently only supports byte type buffer"
                   );
     if (buffer == nullptr || bufferSize == 0) return 0;
     auto position = bufferSize;
     std::vector<FrameInfo> frames;
+    int nFrames = 0;
+    bool inserting = true;
     do {
       FrameInfo entry;
 
@@ -240,7 +297,12 @@ public:
       // payload immediately after header
       entry.payload = reinterpret_cast<typename FrameInfo::PtrT>(entry.header + 1);
       entry.length = frameSize - sizeof(HeaderType) - sizeof(TrailerType);
-      frames.emplace_back(entry);
+      if (Streaming) {
+        if (inserting) inserting = insert(entry);
+      } else {
+        frames.emplace_back(entry);
+      }
+      ++nFrames;
       position -= frameSize;
     } while (position > 0);
 
@@ -249,8 +311,8 @@ public:
       for (auto entry : frames) {
         if (!insert(entry)) break;
       }
-      return frames.size();
-    } else if (frames.size() == 0) {
+      return nFrames;
+    } else if (nFrames == 0) {
       // no frames found at all, the buffer does not contain any
       return 0;
     }
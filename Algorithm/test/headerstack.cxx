@@ -21,6 +21,7 @@
 #include <iomanip>
 #include <cstring> // memcmp
 #include "Headers/DataHeader.h" // hexdump
+#include "Headers/HeartbeatFrame.h" // HeartbeatFrameEnvelope
 #include "../include/Algorithm/HeaderStack.h"
 
 using DataHeader = o2::Header::DataHeader;
@@ -86,3 +87,77 @@ BOOST_AUTO_TEST_CASE(test_headerstack)
   BOOST_CHECK(targetDataHeader == dh);
   BOOST_CHECK(memcmp(&targetNameHeader, &nh, sizeof(targetNameHeader)) == 0);
 }
+
+BOOST_AUTO_TEST_CASE(test_headerstackindex)
+{
+  o2::Header::DataHeader dh;
+  dh.dataDescription = o2::Header::DataDescription("SOMEDATA");
+  dh.dataOrigin = o2::Header::DataOrigin("TST");
+  dh.subSpecification = 42;
+
+  using Name8Header = o2::Header::NameHeader<8>;
+  Name8Header nh("NAMEDHDR");
+
+  o2::Header::Stack stack(dh, nh);
+
+  o2::algorithm::HeaderStackIndex index(stack.buffer.get(), stack.bufferSize);
+  BOOST_REQUIRE(index.size() == 2);
+  BOOST_CHECK(index.at(0) == reinterpret_cast<const o2::Header::BaseHeader*>(stack.buffer.get()));
+  BOOST_CHECK(index.at(2) == nullptr);
+
+  // same result as walking the stack for every header
+  auto indexedDataHeader = index.get<o2::Header::DataHeader>();
+  BOOST_REQUIRE(indexedDataHeader != nullptr);
+  BOOST_CHECK(indexedDataHeader == o2::Header::get<o2::Header::DataHeader>(stack.buffer.get()));
+  BOOST_CHECK(indexedDataHeader->subSpecification == 42);
+  BOOST_CHECK(index.get<Name8Header>() == o2::Header::get<Name8Header>(stack.buffer.get()));
+
+  // the bounds are checked if the size is known
+  o2::algorithm::HeaderStackIndex truncated(stack.buffer.get(), sizeof(o2::Header::DataHeader) + 8);
+  BOOST_CHECK(truncated.size() == 1);
+  BOOST_CHECK(truncated.get<Name8Header>() == nullptr);
+
+  // not a header stack
+  char noheader[sizeof(o2::Header::DataHeader)] = {0};
+  o2::algorithm::HeaderStackIndex empty(noheader, sizeof(noheader));
+  BOOST_CHECK(empty.size() == 0);
+  BOOST_CHECK(empty.get<o2::Header::DataHeader>() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_headerstackindex_long)
+{
+  // a stack with more headers than indexed, the last one is only found by
+  // walking the chain beyond the index
+  o2::Header::DataHeader dh;
+  dh.subSpecification = 42;
+  using Name8Header = o2::Header::NameHeader<8>;
+  Name8Header nh("NAMEDHDR");
+  o2::Header::HeartbeatFrameEnvelope hbf;
+  hbf.header.orbit = 7;
+
+  o2::Header::Stack stack(dh, nh, nh, nh, nh, nh, nh, nh, nh, nh, hbf);
+  const size_t nHeaders = 11;
+  BOOST_REQUIRE(nHeaders > o2::algorithm::HeaderStackIndex::sMaxEntries);
+
+  o2::algorithm::HeaderStackIndex index(stack.buffer.get(), stack.bufferSize);
+  BOOST_CHECK(index.size() == nHeaders);
+  auto current = reinterpret_cast<const o2::Header::BaseHeader*>(stack.buffer.get());
+  for (size_t i = 0; i < nHeaders; ++i, current = current->next()) {
+    BOOST_CHECK(index.at(i) == current);
+  }
+  BOOST_CHECK(index.at(nHeaders) == nullptr);
+
+  auto indexedEnvelope = index.get<o2::Header::HeartbeatFrameEnvelope>();
+  BOOST_REQUIRE(indexedEnvelope != nullptr);
+  BOOST_CHECK(indexedEnvelope == o2::Header::get<o2::Header::HeartbeatFrameEnvelope>(stack.buffer.get()));
+  BOOST_CHECK(index.get<o2::Header::DataHeader>()->subSpecification == 42);
+
+  o2::Header::HeartbeatFrameEnvelope targetEnvelope;
+  o2::algorithm::parseHeaderStack(stack.buffer.get(), stack.bufferSize, targetEnvelope);
+  BOOST_CHECK(targetEnvelope.header.orbit == 7);
+
+  // the bounds are checked beyond the index as well
+  o2::algorithm::HeaderStackIndex truncated(stack.buffer.get(), stack.bufferSize - 8);
+  BOOST_CHECK(truncated.size() == nHeaders - 1);
+  BOOST_CHECK(truncated.get<o2::Header::HeartbeatFrameEnvelope>() == nullptr);
+}
@@ -93,6 +93,63 @@ BOOST_AUTO_TEST_CASE(test_forwardparser_header_and_trailer)
   BOOST_CHECK(memcmp(frames[2].payload, "dummydata",       frames[2].length) == 0);
 }
 
+BOOST_AUTO_TEST_CASE(test_forwardparser_stream)
+{
+  using FrameT = o2::algorithm::Composite<Header, Trailer>;
+  using TestFrame = o2::algorithm::StaticSequenceAllocator;
+  TestFrame tf(FrameT(16, "lotsofsillydata", 0xaa),
+               FrameT(5,  "test",            0xcc),
+               FrameT(10, "dummydata",       0x33)
+               );
+
+  using ParserT = o2::algorithm::ForwardParser<typename FrameT::HeaderType,
+                                               typename FrameT::TrailerType>;
+
+  auto checkHeader = [] (const typename FrameT::HeaderType& header) {
+    return header.identifier == 0xdeadbeef;
+  };
+  auto checkTrailer = [] (const typename FrameT::TrailerType& trailer) {
+    return trailer.identifier == 0xaaffee00;
+  };
+  auto getFrameSize = [] (const typename ParserT::HeaderType& header) {
+    return header.payloadSize + ParserT::totalOffset;
+  };
+
+  std::vector<typename ParserT::FrameInfo> frames;
+  auto insert = [&frames] (typename ParserT::FrameInfo& info) {
+    frames.emplace_back(info);
+    return true;
+  };
+
+  ParserT parser;
+  auto result = parser.stream(tf.buffer.get(), tf.size(),
+                              checkHeader,
+                              checkTrailer,
+                              getFrameSize,
+                              insert
+                              );
+
+  BOOST_REQUIRE(result == 3);
+  BOOST_REQUIRE(frames.size() == 3);
+  BOOST_CHECK(memcmp(frames[0].payload, "lotsofsillydata", frames[0].length) == 0);
+  BOOST_CHECK(memcmp(frames[1].payload, "test",            frames[1].length) == 0);
+  BOOST_CHECK(memcmp(frames[2].payload, "dummydata",       frames[2].length) == 0);
+  BOOST_CHECK(frames[2].trailer->flags == 0x33);
+
+  // a truncated buffer: the frames before the error are inserted in
+  // streaming mode, none in the default mode
+  frames.clear();
+  result = parser.stream(tf.buffer.get(), tf.size() - 1,
+                         checkHeader, checkTrailer, getFrameSize, insert);
+  BOOST_CHECK(result == -1);
+  BOOST_CHECK(frames.size() == 2);
+  frames.clear();
+  result = parser.parse(tf.buffer.get(), tf.size() - 1,
+                        checkHeader, checkTrailer, getFrameSize, insert);
+  BOOST_CHECK(result == -1);
+  BOOST_CHECK(frames.size() == 0);
+}
+
 // TODO: make a test of a composite with header and payload
 
 BOOST_AUTO_TEST_CASE(test_reverseparser)
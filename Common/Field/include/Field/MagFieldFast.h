@@ -15,6 +15,7 @@
 #define ALICEO2_FIELD_MAGFIELDFAST_H_
 
 #include <Rtypes.h>
+#include <cstddef>
 #include <string>
 
 namespace o2
@@ -42,6 +43,12 @@ class MagFieldFast
 
   bool Field(const double xyz[3], double bxyz[3]) const;
   bool Field(const float xyz[3], float bxyz[3]) const;
+
+  // field for n points, xyz and bxyz holding 3 components for each point: the points are grouped by segment
+  // and evaluated with SIMD instructions, in float precision for both versions. Returns the number of points
+  // inside the parametrization, the field of the others is set to 0 and, if provided, ok flags them
+  size_t Field(const float* xyz, float* bxyz, size_t n, bool* ok = nullptr) const;
+  size_t Field(const double* xyz, double* bxyz, size_t n, bool* ok = nullptr) const;
   bool GetBcomp(EDim comp, const double xyz[3], double& b) const;
   bool GetBcomp(EDim comp, const float xyz[3], float& b) const;
 
@@ -64,7 +71,11 @@ class MagFieldFast
     return y > 0 ? (x > 0 ? 0 : 1) : (x > 0 ? 3 : 2);
   }
 
-  float CalcPol(const float* cf, float x, float y, float z) const;
+  template <typename T, typename C>
+  T CalcPol(const C* cf, T x, T y, T z) const;
+
+  template <typename T>
+  size_t fieldBatch(const T* xyz, T* bxyz, size_t n, bool* ok) const;
 
   float mFactorSol; // scaling factor
   SolParam mSolPar[kNSolRRanges][kNSolZRanges][kNQuadrants];
@@ -72,17 +83,18 @@ class MagFieldFast
   ClassDef(MagFieldFast, 1)
 };
 
-inline float MagFieldFast::CalcPol(const float* cf, float x, float y, float z) const
+template <typename T, typename C>
+inline T MagFieldFast::CalcPol(const C* cf, T x, T y, T z) const
 {
-  /** calculate polynomial
+  /** calculate polynomial, T and C being floats or SIMD vectors of floats
    *   cf[0] + cf[1]*x + cf[2]*y + cf[3]*z + cf[4]*xx + cf[5]*xy + cf[6]*xz + cf[7]*yy + cf[8]*yz + cf[9]*zz +
    *   cf[10]*xxx + cf[11]*xxy + cf[12]*xxz + cf[13]*xyy + cf[14]*xyz + cf[15]*xzz + cf[16]*yyy + cf[17]*yyz +
    *cf[18]*yzz + cf[19]*zzz
   **/
 
-  float val = cf[0] + x * (cf[1] + x * (cf[4] + x * cf[10] + y * cf[11] + z * cf[12]) + y * (cf[5] + z * cf[14])) +
-              y * (cf[2] + y * (cf[7] + x * cf[13] + y * cf[16] + z * cf[17]) + z * (cf[8])) +
-              z * (cf[3] + z * (cf[9] + x * cf[15] + y * cf[18] + z * cf[19]) + x * (cf[6]));
+  T val = cf[0] + x * (cf[1] + x * (cf[4] + x * cf[10] + y * cf[11] + z * cf[12]) + y * (cf[5] + z * cf[14])) +
+          y * (cf[2] + y * (cf[7] + x * cf[13] + y * cf[16] + z * cf[17]) + z * (cf[8])) +
+          z * (cf[3] + z * (cf[9] + x * cf[15] + y * cf[18] + z * cf[19]) + x * (cf[6]));
 
   return val;
 }
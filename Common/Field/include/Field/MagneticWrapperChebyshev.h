@@ -21,6 +21,7 @@
 #include "MathUtils/Chebyshev3D.h"      // for Chebyshev3D
 #include "MathUtils/Chebyshev3DCalc.h"  // for _INC_CREATION_Chebyshev3D_
 #include "Rtypes.h"                     // for Double_t, Int_t, Float_t, etc
+#include <cstddef>                      // for size_t
 
 class FairLogger;  // lines 16-16
 
@@ -209,6 +210,10 @@ class MagneticWrapperChebyshev : public TNamed
     /// it gets it at closest valid point
     virtual void Field(const Double_t *xyz, Double_t *b) const;
 
+    /// Computes field in cartesian coordinates for n points, xyz and b holding the 3 components for each point.
+    /// The points are grouped by parameterization segment and evaluated with SIMD instructions.
+    void Field(const Float_t *xyz, Float_t *b, size_t n) const;
+
     /// Computes Bz for the point in cartesian coordinates. If point is outside of the parameterized region
     /// it gets it at closest valid point
     Double_t getBz(const Double_t *xyz) const;
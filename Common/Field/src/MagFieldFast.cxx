@@ -16,9 +16,12 @@
 #include <FairLogger.h>
 #include <TString.h>
 #include <TSystem.h>
+#include <Vc/Vc>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <sstream>
+#include <utility>
 
 using namespace o2::field;
 using namespace std;
@@ -162,6 +165,116 @@ bool MagFieldFast::Field(const float xyz[3], float bxyz[3]) const
   return true;
 }
 
+//_______________________________________________________________________
+size_t MagFieldFast::Field(const float* xyz, float* bxyz, size_t n, bool* ok) const
+{
+  // get field for n points
+  return fieldBatch(xyz, bxyz, n, ok);
+}
+
+//_______________________________________________________________________
+size_t MagFieldFast::Field(const double* xyz, double* bxyz, size_t n, bool* ok) const
+{
+  // get field for n points
+  return fieldBatch(xyz, bxyz, n, ok);
+}
+
+//_______________________________________________________________________
+template <typename T>
+size_t MagFieldFast::fieldBatch(const T* xyz, T* bxyz, size_t n, bool* ok) const
+{
+  // The points are processed by blocks, with the buffers on the stack: the segment of each point of the block
+  // is found, then the points are sorted by segment and the 3 components are evaluated one point per SIMD lane.
+  // When all the lanes share the same segment, which is the common case for the points of tracks, its
+  // coefficients are broadcast, otherwise the coefficients of each lane are gathered
+  using float_v = Vc::float_v;
+  const int kBlock = 64; // must be a multiple of the SIMD width
+  std::pair<int, int> segPoint[kBlock]; // segment ID (-1 if outside), point
+  float pos[kNDim][kBlock], grp[kNDim][kBlock], res[kNDim][kBlock];
+  int seg[kBlock];
+  float cfLanes[kNDim][kNPolCoefs][float_v::Size];
+  auto getParam = [this](int id) -> const SolParam& {
+    return mSolPar[id / (kNSolZRanges * kNQuadrants)][id / kNQuadrants % kNSolZRanges][id % kNQuadrants];
+  };
+  size_t nOK = 0;
+
+  for (size_t start = 0; start < n; start += kBlock) {
+    const int np = std::min<size_t>(kBlock, n - start);
+    for (int ip = 0; ip < np; ip++) {
+      const T* pnt = xyz + kNDim * (start + ip);
+      const float fxyz[kNDim] = { float(pnt[kX]), float(pnt[kY]), float(pnt[kZ]) };
+      int zSeg, rSeg, quadrant, id = -1;
+      if (GetSegment(fxyz, zSeg, rSeg, quadrant)) {
+        id = (rSeg * kNSolZRanges + zSeg) * kNQuadrants + quadrant;
+      }
+      for (int i = kNDim; i--;) {
+        pos[i][ip] = fxyz[i];
+      }
+      segPoint[ip] = std::make_pair(id, ip);
+    }
+    std::sort(segPoint, segPoint + np);
+
+    // the points outside come first
+    int first = 0;
+    for (; first < np && segPoint[first].first < 0; first++) {
+      const size_t ip = start + segPoint[first].second;
+      bxyz[kNDim * ip + kX] = bxyz[kNDim * ip + kY] = bxyz[kNDim * ip + kZ] = 0;
+      if (ok) {
+        ok[ip] = false;
+      }
+    }
+    const int ng = np - first;
+    if (!ng) {
+      continue;
+    }
+    // gather the points inside, the last one is repeated up to the SIMD width
+    const int ngPadded = (ng + float_v::Size - 1) / float_v::Size * float_v::Size;
+    for (int ig = 0; ig < ngPadded; ig++) {
+      const auto& sp = segPoint[first + std::min(ig, ng - 1)];
+      seg[ig] = sp.first;
+      for (int i = kNDim; i--;) {
+        grp[i][ig] = pos[i][sp.second];
+      }
+    }
+    for (int ig = 0; ig < ngPadded; ig += float_v::Size) {
+      const float_v x(grp[kX] + ig, Vc::Unaligned), y(grp[kY] + ig, Vc::Unaligned), z(grp[kZ] + ig, Vc::Unaligned);
+      if (seg[ig] == seg[ig + float_v::Size - 1]) { // sorted, so all the lanes are in the same segment
+        const SolParam& par = getParam(seg[ig]);
+        for (int i = kNDim; i--;) {
+          (CalcPol(par.parBxyz[i], x, y, z) * mFactorSol).store(res[i] + ig, Vc::Unaligned);
+        }
+        continue;
+      }
+      for (size_t l = 0; l < float_v::Size; l++) {
+        const SolParam& par = getParam(seg[ig + l]);
+        for (int i = kNDim; i--;) {
+          for (int k = kNPolCoefs; k--;) {
+            cfLanes[i][k][l] = par.parBxyz[i][k];
+          }
+        }
+      }
+      for (int i = kNDim; i--;) {
+        float_v cf[kNPolCoefs];
+        for (int k = kNPolCoefs; k--;) {
+          cf[k] = float_v(cfLanes[i][k], Vc::Unaligned);
+        }
+        (CalcPol(cf, x, y, z) * mFactorSol).store(res[i] + ig, Vc::Unaligned);
+      }
+    }
+    for (int ig = 0; ig < ng; ig++) {
+      const size_t ip = start + segPoint[first + ig].second;
+      for (int i = kNDim; i--;) {
+        bxyz[kNDim * ip + i] = res[i][ig];
+      }
+      if (ok) {
+        ok[ip] = true;
+      }
+    }
+    nOK += ng;
+  }
+  return nOK;
+}
+
 //_______________________________________________________________________
 bool MagFieldFast::GetSegment(const float xyz[3], int& zSeg, int& rSeg, int& quadrant) const
 {
@@ -16,6 +16,8 @@
 #include <TArrayF.h>     // for TArrayF
 #include <TArrayI.h>     // for TArrayI
 #include <TSystem.h>     // for TSystem, gSystem
+#include <algorithm>     // for min, sort
+#include <utility>       // for pair
 #include <cstdio>       // for printf, fprintf, fclose, fopen, FILE
 #include <cstring>      // for memcpy
 #include "FairLogger.h"  // for FairLogger, MESSAGE_ORIGIN
@@ -446,6 +448,92 @@ void MagneticWrapperChebyshev::Field(const Double_t *xyz, Double_t *b) const
   par->Eval(xyz, b);
 }
 
+void MagneticWrapperChebyshev::Field(const Float_t *xyz, Float_t *b, size_t n) const
+{
+  // the points are processed by blocks, with the buffers on the stack: for each point of the block the segment
+  // is found, then the points are sorted by segment and each group of points is evaluated at once
+  const int kBlock = 64;
+  std::pair<int, int> segPoint[kBlock]; // segment ID (dipole ones after the solenoid ones, -1 if none), point
+  Float_t coord[3][kBlock];             // r,phi,z for the points in the solenoid, x,y,z for the others
+  Float_t par[3][kBlock], res[3][kBlock];
+  const Float_t* parPtr[3] = { par[0], par[1], par[2] };
+  Float_t* resPtr[3] = { res[0], res[1], res[2] };
+
+  for (size_t start = 0; start < n; start += kBlock) {
+    const int np = std::min<size_t>(kBlock, n - start);
+    for (int ip = 0; ip < np; ip++) {
+      const Float_t* pnt = xyz + 3 * (start + ip);
+      const Double_t cart[3] = { pnt[0], pnt[1], pnt[2] };
+      Double_t pos[3] = { cart[0], cart[1], cart[2] };
+      int id = -1;
+      if (pos[2] > mMinZSolenoid) {
+        cartesianToCylindrical(cart, pos);
+        id = findSolenoidSegment(pos);
+#ifndef _BRING_TO_BOUNDARY_
+        if (id >= 0 && !getParameterSolenoid(id)->isInside(pos)) {
+          id = -1;
+        }
+#endif
+      } else {
+        id = findDipoleSegment(pos);
+#ifndef _BRING_TO_BOUNDARY_
+        if (id >= 0 && !getParameterDipole(id)->isInside(pos)) {
+          id = -1;
+        }
+#endif
+        if (id >= 0) {
+          id += mNumberOfParameterizationSolenoid;
+        }
+      }
+      for (int i = 3; i--;) {
+        coord[i][ip] = pos[i];
+      }
+      segPoint[ip] = std::make_pair(id, ip);
+    }
+    std::sort(segPoint, segPoint + np);
+
+    for (int first = 0, last = 0; first < np; first = last) {
+      const int id = segPoint[first].first;
+      while (last < np && segPoint[last].first == id) {
+        last++;
+      }
+      const int ng = last - first;
+      if (id < 0) {
+        for (int ig = 0; ig < ng; ig++) {
+          Float_t* bp = b + 3 * (start + segPoint[first + ig].second);
+          bp[0] = bp[1] = bp[2] = 0;
+        }
+        continue;
+      }
+      for (int i = 3; i--;) {
+        for (int ig = 0; ig < ng; ig++) {
+          par[i][ig] = coord[i][segPoint[first + ig].second];
+        }
+      }
+      const bool solenoid = id < mNumberOfParameterizationSolenoid;
+      const Chebyshev3D* param =
+        solenoid ? getParameterSolenoid(id) : getParameterDipole(id - mNumberOfParameterizationSolenoid);
+      param->Eval(parPtr, resPtr, ng);
+      for (int ig = 0; ig < ng; ig++) {
+        Float_t* bp = b + 3 * (start + segPoint[first + ig].second);
+        if (solenoid) {
+          // convert field to cartesian system
+          const Double_t rphiz[3] = { par[0][ig], par[1][ig], par[2][ig] };
+          Double_t bcyl[3] = { res[0][ig], res[1][ig], res[2][ig] };
+          cylindricalToCartesianCylB(rphiz, bcyl, bcyl);
+          for (int i = 3; i--;) {
+            bp[i] = bcyl[i];
+          }
+        } else {
+          for (int i = 3; i--;) {
+            bp[i] = res[i][ig];
+          }
+        }
+      }
+    }
+  }
+}
+
 Double_t MagneticWrapperChebyshev::getBz(const Double_t *xyz) const
 {
   Double_t rphiz[3];
@@ -19,6 +19,8 @@
 #include "FairLogger.h"                // for FairLogger, MESSAGE_ORIGIN
 #include <TStopwatch.h>
 #include <TRandom.h>
+#include <thread>
+#include <vector>
 
 using namespace o2::field;
 
@@ -100,3 +102,150 @@ BOOST_AUTO_TEST_CASE(MagneticField_test)
   }
   
 }
+
+BOOST_AUTO_TEST_CASE(MagneticWrapperChebyshev_batch)
+{
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>
+    ("Maps","Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  const MagneticWrapperChebyshev* map = fld->getMeasuredMap();
+  BOOST_REQUIRE(map);
+
+  // points in the Z range of the parameterization, some of them outside of its R range
+  const int ntst = 10000;
+  float rnd[3];
+  std::vector<float> xyz(3 * ntst), bBatch(3 * ntst);
+  std::vector<double> bxyz(3 * ntst);
+  for (int it = ntst; it--;) {
+    gRandom->RndmArray(3, rnd);
+    xyz[3 * it] = rnd[0] * 550. * TMath::Cos(rnd[1] * TMath::Pi() * 2);
+    xyz[3 * it + 1] = rnd[0] * 550. * TMath::Sin(rnd[1] * TMath::Pi() * 2);
+    xyz[3 * it + 2] = map->getMinZ() + rnd[2] * (map->getMaxZ() - map->getMinZ());
+  }
+
+  const int repFactor = 50;
+  TStopwatch swPoint;
+  swPoint.Start();
+  for (int ii = repFactor; ii--;) {
+    for (int it = ntst; it--;) {
+      const double pnt[3] = { xyz[3 * it], xyz[3 * it + 1], xyz[3 * it + 2] };
+      map->Field(pnt, &bxyz[3 * it]);
+    }
+  }
+  swPoint.Stop();
+
+  TStopwatch swBatch;
+  swBatch.Start();
+  for (int ii = repFactor; ii--;) {
+    map->Field(xyz.data(), bBatch.data(), ntst);
+  }
+  swBatch.Stop();
+  double sP = swPoint.CpuTime() / (ntst * repFactor);
+  double sB = swBatch.CpuTime() / (ntst * repFactor);
+  LOG(INFO) << "Timing: single point: " << sP << " batch: " << sB << "s/point -> factor " << (sB > 0. ? sP / sB : -1)
+            << FairLogger::endl;
+
+  // the batch is evaluated in float precision
+  for (int i = 3 * ntst; i--;) {
+    BOOST_CHECK_SMALL(bBatch[i] - bxyz[i], 1.e-4 * (1. + TMath::Abs(bxyz[i])));
+  }
+
+  // the same map evaluated concurrently must give the same field
+  const int nThreads = 4;
+  std::vector<std::vector<double>> bThread(nThreads, std::vector<double>(3 * ntst));
+  std::vector<std::thread> threads;
+  for (int ith = 0; ith < nThreads; ith++) {
+    threads.emplace_back([&, ith]() {
+      for (int it = 0; it < ntst; it++) {
+        const double pnt[3] = { xyz[3 * it], xyz[3 * it + 1], xyz[3 * it + 2] };
+        map->Field(pnt, &bThread[ith][3 * it]);
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  for (int ith = 0; ith < nThreads; ith++) {
+    BOOST_CHECK(bThread[ith] == bxyz);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MagFieldFast_batch)
+{
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>
+    ("Maps","Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  fld->AllowFastField(true);
+  const MagFieldFast* fast = fld->getFastField();
+  const MagneticWrapperChebyshev* map = fld->getMeasuredMap();
+  BOOST_REQUIRE(fast && map);
+
+  // points along straight tracks from the origin, as queried during the propagation, part of them beyond the
+  // R range of the fast parametrization
+  const int ntrk = 500, nstep = 20, ntst = ntrk * nstep;
+  float rnd[3];
+  std::vector<float> xyz(3 * ntst);
+  for (int itr = ntrk; itr--;) {
+    gRandom->RndmArray(3, rnd);
+    const double phi = rnd[0] * TMath::Pi() * 2, tgl = (rnd[1] - 0.5) * 1.8;
+    for (int is = nstep; is--;) {
+      const double r = (is + 1) * 550. / nstep;
+      float* pnt = &xyz[3 * (itr * nstep + is)];
+      pnt[0] = r * TMath::Cos(phi);
+      pnt[1] = r * TMath::Sin(phi);
+      pnt[2] = r * tgl;
+    }
+  }
+  std::vector<double> xyzD(xyz.begin(), xyz.end());
+
+  // batch vs single point fast field, in float and double
+  std::vector<float> bPoint(3 * ntst), bBatch(3 * ntst);
+  std::vector<double> bBatchD(3 * ntst);
+  std::unique_ptr<bool[]> okBatch(new bool[ntst]), okBatchD(new bool[ntst]);
+  BOOST_CHECK_EQUAL(fast->Field(xyz.data(), bBatch.data(), ntst, okBatch.get()),
+                    fast->Field(xyzD.data(), bBatchD.data(), ntst, okBatchD.get()));
+  for (int it = ntst; it--;) {
+    bool ok = fast->Field(&xyz[3 * it], &bPoint[3 * it]);
+    BOOST_CHECK_EQUAL(okBatch[it], ok);
+    BOOST_CHECK_EQUAL(okBatchD[it], ok);
+    for (int i = 3; i--;) {
+      const float b = ok ? bPoint[3 * it + i] : 0.f;
+      BOOST_CHECK_SMALL(bBatch[3 * it + i] - b, 1.e-5f * (1.f + TMath::Abs(b)));
+      BOOST_CHECK_SMALL(float(bBatchD[3 * it + i]) - b, 1.e-5f * (1.f + TMath::Abs(b)));
+    }
+  }
+
+  // timing of the fast parametrization and of the Chebyshev one
+  const int repFactor = 50;
+  TStopwatch sw;
+  const char* names[] = { "fast, single point", "fast, batch", "fast, batch in double",
+                          "Chebyshev, single point", "Chebyshev, batch" };
+  std::vector<double> bPointD(3 * ntst);
+  for (int mode = 0; mode < 5; mode++) {
+    sw.Start();
+    for (int ii = repFactor; ii--;) {
+      switch (mode) {
+        case 0:
+          for (int it = ntst; it--;) {
+            fast->Field(&xyz[3 * it], &bPoint[3 * it]);
+          }
+          break;
+        case 1:
+          fast->Field(xyz.data(), bBatch.data(), ntst);
+          break;
+        case 2:
+          fast->Field(xyzD.data(), bBatchD.data(), ntst);
+          break;
+        case 3:
+          for (int it = ntst; it--;) {
+            map->Field(&xyzD[3 * it], &bPointD[3 * it]);
+          }
+          break;
+        case 4:
+          map->Field(xyz.data(), bBatch.data(), ntst);
+          break;
+      }
+    }
+    sw.Stop();
+    LOG(INFO) << "Timing " << names[mode] << ": " << sw.CpuTime() / (ntst * repFactor) << " s/point"
+              << FairLogger::endl;
+  }
+}
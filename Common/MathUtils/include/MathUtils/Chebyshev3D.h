@@ -52,6 +52,8 @@ namespace mathUtils {
 /// To compute the interpolation use Eval(float* par,float *res) method, with par being 3D vector of arguments
 /// (inside the validity region) and res is the array of DimOut elements for the output.
 /// If only one component (say, idim-th) of the output is needed, use faster Float_t Eval(Float_t *par,int idim) method
+/// Many points are evaluated at once, with SIMD instructions, by Eval(float** par,float** res,int n).
+/// The evaluation methods do not modify the object, so that the same parameterization can be used from several threads.
 /// void Print(option="") will print the name, the ranges of validity and the absolute precision of the
 /// parameterization. Option "l" will also print the information about the number of coefficients for each output
 /// dimension.
@@ -128,25 +130,29 @@ class Chebyshev3D : public TNamed
 
     Chebyshev3D &operator=(const Chebyshev3D &rhs);
 
-    void Eval(const Float_t *par, Float_t *res);
+    void Eval(const Float_t *par, Float_t *res) const;
 
-    Float_t Eval(const Float_t *par, int idim);
+    Float_t Eval(const Float_t *par, int idim) const;
 
-    void Eval(const Double_t *par, Double_t *res);
+    void Eval(const Double_t *par, Double_t *res) const;
 
-    Double_t Eval(const Double_t *par, int idim);
+    Double_t Eval(const Double_t *par, int idim) const;
 
-    void evaluateDerivative(int dimd, const Float_t *par, Float_t *res);
+    /// Evaluates the parameterization for n points, par[i] being the array of the i-th coordinates of the points
+    /// and res[i] receiving their values of the i-th output dimension
+    void Eval(const Float_t *const *par, Float_t *const *res, int n) const;
 
-    void evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, Float_t *res);
+    void evaluateDerivative(int dimd, const Float_t *par, Float_t *res) const;
 
-    Float_t evaluateDerivative(int dimd, const Float_t *par, int idim);
+    void evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, Float_t *res) const;
 
-    Float_t evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, int idim);
+    Float_t evaluateDerivative(int dimd, const Float_t *par, int idim) const;
 
-    void evaluateDerivative3D(const Float_t *par, Float_t dbdr[3][3]);
+    Float_t evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, int idim) const;
 
-    void evaluateDerivative3D2(const Float_t *par, Float_t dbdrdr[3][3][3]);
+    void evaluateDerivative3D(const Float_t *par, Float_t dbdr[3][3]) const;
+
+    void evaluateDerivative3D2(const Float_t *par, Float_t dbdrdr[3][3][3]) const;
 
     void Print(const Option_t *opt = "") const override;
 
@@ -281,68 +287,74 @@ inline Bool_t Chebyshev3D::isInside(const Double_t *par) const
 }
 
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
-inline void Chebyshev3D::Eval(const Float_t *par, Float_t *res)
+inline void Chebyshev3D::Eval(const Float_t *par, Float_t *res) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(x);
   }
 }
 
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
-inline void Chebyshev3D::Eval(const Double_t *par, Double_t *res)
+inline void Chebyshev3D::Eval(const Double_t *par, Double_t *res) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(x);
   }
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
-inline Double_t Chebyshev3D::Eval(const Double_t *par, int idim)
+inline Double_t Chebyshev3D::Eval(const Double_t *par, int idim) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(x);
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
-inline Float_t Chebyshev3D::Eval(const Float_t *par, int idim)
+inline Float_t Chebyshev3D::Eval(const Float_t *par, int idim) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(x);
 }
 
 /// Returns the gradient matrix
-inline void Chebyshev3D::evaluateDerivative3D(const Float_t *par, Float_t dbdr[3][3])
+inline void Chebyshev3D::evaluateDerivative3D(const Float_t *par, Float_t dbdr[3][3]) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int ib = 3; ib--;) {
     for (int id = 3; id--;) {
-      dbdr[ib][id] = getChebyshevCalc(ib)->evaluateDerivative(id, mTemporaryCoefficient) * mBoundaryMappingScale[id];
+      dbdr[ib][id] = getChebyshevCalc(ib)->evaluateDerivative(id, x) * mBoundaryMappingScale[id];
     }
   }
 }
 
 /// Returns the gradient matrix
-inline void Chebyshev3D::evaluateDerivative3D2(const Float_t *par, Float_t dbdrdr[3][3][3])
+inline void Chebyshev3D::evaluateDerivative3D2(const Float_t *par, Float_t dbdrdr[3][3][3]) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int ib = 3; ib--;) {
     for (int id = 3; id--;) {
       for (int id1 = 3; id1--;) {
-        dbdrdr[ib][id][id1] = getChebyshevCalc(ib)->evaluateDerivative2(id, id1, mTemporaryCoefficient) *
+        dbdrdr[ib][id][id1] = getChebyshevCalc(ib)->evaluateDerivative2(id, id1, x) *
                               mBoundaryMappingScale[id] * mBoundaryMappingScale[id1];
       }
     }
@@ -350,46 +362,50 @@ inline void Chebyshev3D::evaluateDerivative3D2(const Float_t *par, Float_t dbdrd
 }
 
 // Evaluates Chebyshev parameterization derivative for 3d->DimOut function
-inline void Chebyshev3D::evaluateDerivative(int dimd, const Float_t *par, Float_t *res)
+inline void Chebyshev3D::evaluateDerivative(int dimd, const Float_t *par, Float_t *res) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->evaluateDerivative(dimd, mTemporaryCoefficient) * mBoundaryMappingScale[dimd];
+    res[i] = getChebyshevCalc(i)->evaluateDerivative(dimd, x) * mBoundaryMappingScale[dimd];
   };
 }
 
 // Evaluates Chebyshev parameterization 2nd derivative over dimd1 and dimd2 dimensions for 3d->DimOut function
-inline void Chebyshev3D::evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, Float_t *res)
+inline void Chebyshev3D::evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, Float_t *res) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->evaluateDerivative2(dimd1, dimd2, mTemporaryCoefficient) *
+    res[i] = getChebyshevCalc(i)->evaluateDerivative2(dimd1, dimd2, x) *
              mBoundaryMappingScale[dimd1] * mBoundaryMappingScale[dimd2];
   }
 }
 
 /// Evaluates Chebyshev parameterization derivative over dimd dimention for idim-th output dimension of 3d->DimOut
 /// function
-inline Float_t Chebyshev3D::evaluateDerivative(int dimd, const Float_t *par, int idim)
+inline Float_t Chebyshev3D::evaluateDerivative(int dimd, const Float_t *par, int idim) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->evaluateDerivative(dimd, mTemporaryCoefficient) * mBoundaryMappingScale[dimd];
+  return getChebyshevCalc(idim)->evaluateDerivative(dimd, x) * mBoundaryMappingScale[dimd];
 }
 
 /// Evaluates Chebyshev parameterization 2ns derivative over dimd1 and dimd2 dimensions for idim-th output dimension of
 /// 3d->DimOut function
-inline Float_t Chebyshev3D::evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, int idim)
+inline Float_t Chebyshev3D::evaluateDerivative2(int dimd1, int dimd2, const Float_t *par, int idim) const
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->evaluateDerivative2(dimd1, dimd2, mTemporaryCoefficient) *
+  return getChebyshevCalc(idim)->evaluateDerivative2(dimd1, dimd2, x) *
          mBoundaryMappingScale[dimd1] * mBoundaryMappingScale[dimd2];
 }
 
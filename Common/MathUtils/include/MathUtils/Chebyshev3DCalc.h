@@ -31,6 +31,56 @@ class TString;
 
 namespace o2 {
 namespace mathUtils {
+
+/// Clenshaw summation of a 1D Chebyshev series, or of its 1st or 2nd derivative, with the coefficients
+/// added one by one from the highest order down. The nested sums of the 3D parameterization are evaluated
+/// this way as soon as their coefficients are known, without storing them in scratch arrays.
+/// x is the argument mapped to [-1:1] interval; T can be a float or a SIMD vector of floats.
+template <typename T>
+class ChebyshevSum
+{
+  public:
+    ChebyshevSum(T x, int derivative = 0) : mX(x), mX2(x + x), mB0(0.f), mB1(0.f), mDerivative(derivative)
+    {
+      for (int i = 0; i < 2; i++) {
+        mD[i][0] = mD[i][1] = 0.f;
+      }
+    }
+
+    /// Adds the coefficient of order j, the coefficients being added in decreasing order
+    void add(T a, int j)
+    {
+      // the coefficient of order j-1 of the derivative is d[j-1] = d[j+1] + 2*j*a[j]
+      for (int i = 0; i < mDerivative; i++) {
+        if (!j--) {
+          return;
+        }
+        T d = mD[i][1] + Float_t(2 * (j + 1)) * a;
+        mD[i][1] = mD[i][0];
+        mD[i][0] = a = d;
+      }
+      T b2 = mB1;
+      mB1 = mB0;
+      mB0 = a + mX2 * mB1 - b2;
+    }
+
+    /// Value of the series, or of its derivative
+    T result() const
+    {
+      T res = mB0 - mX * mB1;
+      if (mDerivative) {
+        res -= mD[mDerivative - 1][0] * 0.5f;
+      }
+      return res;
+    }
+
+  private:
+    T mX, mX2;   ///< argument and its double
+    T mB0, mB1;  ///< last terms of the Clenshaw recurrence
+    T mD[2][2];  ///< last coefficients of the 1st and 2nd derivatives
+    int mDerivative; ///< order of the derivative
+};
+
 class Chebyshev3DCalc : public TNamed
 {
 
@@ -164,10 +214,16 @@ class Chebyshev3DCalc : public TNamed
     /// Reads single line from the stream, skipping empty and commented lines. EOF is not expected
     static void readLine(TString &str, FILE *stream);
 
+    /// Evaluate the parameterization at the point par, see below. No scratch memory of the object is used, so
+    /// the same parameterization can be evaluated from several threads
     Float_t Eval(const Float_t *par) const;
 
     Double_t Eval(const Double_t *par) const;
 
+    /// Evaluates the parameterization for n points with the coordinates x0, x1, x2 ALREADY MAPPED to [-1:1]
+    /// interval, processing as many points at once as the SIMD width allows
+    void Eval(const Float_t *x0, const Float_t *x1, const Float_t *x2, Float_t *res, int n) const;
+
   protected:
     Int_t mNumberOfCoefficients;    ///< total number of coeeficients
     Int_t mNumberOfRows;            ///< number of significant rows in the 3D coeffs matrix
@@ -186,11 +242,13 @@ class Chebyshev3DCalc : public TNamed
     // coeffs for col/row
     Float_t *mCoefficients; //[mNumberOfCoefficients] array of Chebyshev coefficients
 
-    Float_t *mTemporaryCoefficients2D; //[mNumberOfColumns] temp. coeffs for 2d summation
-    Float_t *mTemporaryCoefficients1D; //[mNumberOfRows] temp. coeffs for 1d summation
+  private:
+    /// Nested Clenshaw summation of the series, order (if any) giving the order of the derivative in each dimension
+    template <typename T>
+    T evaluateSeries(const T *par, const int *order = nullptr) const;
 
     ClassDefOverride(o2::mathUtils::Chebyshev3DCalc,
-    2) // Class for interpolation of 3D->1 function by Chebyshev parametrization
+    3) // Class for interpolation of 3D->1 function by Chebyshev parametrization
 };
 
 /// Evaluates 1D Chebyshev parameterization. x is the argument mapped to [-1:1] interval
@@ -216,44 +274,37 @@ inline Float_t Chebyshev3DCalc::chebyshevEvaluation1D(Float_t x, const Float_t *
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Float_t Chebyshev3DCalc::Eval(const Float_t *par) const
 {
-  if (!mNumberOfRows) {
-    return 0.;
-  }
-  int ncfRC;
-  for (int id0 = mNumberOfRows; id0--;) {
-    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
-    int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
-    for (int id1 = nCLoc; id1--;) {
-      int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = (ncfRC = mCoefficientBound2D0[id])
-                                      ? chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC)
-                                      : 0.0;
-    }
-    mTemporaryCoefficients1D[id0] = nCLoc > 0 ? chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc) : 0.0;
-  }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return evaluateSeries(par);
 }
 
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Double_t Chebyshev3DCalc::Eval(const Double_t *par) const
 {
-  if (!mNumberOfRows) {
-    return 0.;
-  }
-  int ncfRC;
+  const Float_t parF[3] = { Float_t(par[0]), Float_t(par[1]), Float_t(par[2]) };
+  return evaluateSeries(parF);
+}
+
+template <typename T>
+inline T Chebyshev3DCalc::evaluateSeries(const T *par, const int *order) const
+{
+  ChebyshevSum<T> sum0(par[0], order ? order[0] : 0);
   for (int id0 = mNumberOfRows; id0--;) {
     int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
     int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    ChebyshevSum<T> sum1(par[1], order ? order[1] : 0);
     for (int id1 = nCLoc; id1--;) {
       int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = (ncfRC = mCoefficientBound2D0[id])
-                                      ? chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC)
-                                      : 0.0;
+      const Float_t *coefs = mCoefficients + mCoefficientBound2D1[id];
+      ChebyshevSum<T> sum2(par[2], order ? order[2] : 0);
+      for (int id2 = mCoefficientBound2D0[id]; id2--;) {
+        sum2.add(coefs[id2], id2);
+      }
+      sum1.add(sum2.result(), id1);
     }
-    mTemporaryCoefficients1D[id0] = nCLoc > 0 ? chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc) : 0.0;
+    sum0.add(sum1.result(), id0);
   }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return sum0.result();
 }
 }
 }
@@ -20,6 +20,7 @@
 #include <TRandom.h>          // for TRandom, gRandom
 #include <TString.h>          // for TString
 #include <TSystem.h>          // for TSystem, gSystem
+#include <algorithm>         // for min
 #include <cstdio>            // for printf, fprintf, FILE, fclose, fflush, etc
 #include "MathUtils/Chebyshev3DCalc.h"  // for Chebyshev3DCalc, etc
 #include "FairLogger.h"       // for FairLogger, MESSAGE_ORIGIN
@@ -315,6 +316,24 @@ void Chebyshev3D::Clear(const Option_t *)
   mChebyshevParameter.Delete();
 }
 
+void Chebyshev3D::Eval(const Float_t *const *par, Float_t *const *res, int n) const
+{
+  // the points are mapped to [-1:1] interval by blocks, in a buffer on the stack
+  const int kBlock = 64;
+  Float_t x[3][kBlock];
+  for (int start = 0; start < n; start += kBlock) {
+    const int np = std::min(kBlock, n - start);
+    for (int i = 3; i--;) {
+      for (int ip = 0; ip < np; ip++) {
+        x[i][ip] = mapToInternal(par[i][start + ip], i);
+      }
+    }
+    for (int i = mOutputArrayDimension; i--;) {
+      getChebyshevCalc(i)->Eval(x[0], x[1], x[2], res[i] + start, np);
+    }
+  }
+}
+
 void Chebyshev3D::Print(const Option_t *opt) const
 {
   // print info
@@ -16,6 +16,9 @@
 #include <TSystem.h>  // for TSystem, gSystem
 #include "TNamed.h"   // for TNamed
 #include "TString.h"  // for TString, TString::EStripType::kBoth
+#include <Vc/Vc>
+
+using float_v = Vc::float_v;
 
 using namespace o2::mathUtils;
 
@@ -31,9 +34,7 @@ Chebyshev3DCalc::Chebyshev3DCalc()
     mColumnAtRowBeginning(nullptr),
     mCoefficientBound2D0(nullptr),
     mCoefficientBound2D1(nullptr),
-    mCoefficients(nullptr),
-    mTemporaryCoefficients2D(nullptr),
-    mTemporaryCoefficients1D(nullptr)
+    mCoefficients(nullptr)
 {
 }
 
@@ -48,9 +49,7 @@ Chebyshev3DCalc::Chebyshev3DCalc(const Chebyshev3DCalc &src)
     mColumnAtRowBeginning(nullptr),
     mCoefficientBound2D0(nullptr),
     mCoefficientBound2D1(nullptr),
-    mCoefficients(nullptr),
-    mTemporaryCoefficients2D(nullptr),
-    mTemporaryCoefficients1D(nullptr)
+    mCoefficients(nullptr)
 {
   if (src.mNumberOfColumnsAtRow) {
     mNumberOfColumnsAtRow = new UShort_t[mNumberOfRows];
@@ -82,12 +81,6 @@ Chebyshev3DCalc::Chebyshev3DCalc(const Chebyshev3DCalc &src)
       mCoefficients[i] = src.mCoefficients[i];
     }
   }
-  if (src.mTemporaryCoefficients2D) {
-    mTemporaryCoefficients2D = new Float_t[mNumberOfColumns];
-  }
-  if (src.mTemporaryCoefficients1D) {
-    mTemporaryCoefficients1D = new Float_t[mNumberOfRows];
-  }
 }
 
 Chebyshev3DCalc::Chebyshev3DCalc(FILE *stream)
@@ -100,9 +93,7 @@ Chebyshev3DCalc::Chebyshev3DCalc(FILE *stream)
     mColumnAtRowBeginning(nullptr),
     mCoefficientBound2D0(nullptr),
     mCoefficientBound2D1(nullptr),
-    mCoefficients(nullptr),
-    mTemporaryCoefficients2D(nullptr),
-    mTemporaryCoefficients1D(nullptr)
+    mCoefficients(nullptr)
 {
   loadData(stream);
 }
@@ -147,26 +138,12 @@ Chebyshev3DCalc &Chebyshev3DCalc::operator=(const Chebyshev3DCalc &rhs)
         mCoefficients[i] = rhs.mCoefficients[i];
       }
     }
-    if (rhs.mTemporaryCoefficients2D) {
-      mTemporaryCoefficients2D = new Float_t[mNumberOfColumns];
-    }
-    if (rhs.mTemporaryCoefficients1D) {
-      mTemporaryCoefficients1D = new Float_t[mNumberOfRows];
-    }
   }
   return *this;
 }
 
 void Chebyshev3DCalc::Clear(const Option_t *)
 {
-  if (mTemporaryCoefficients2D) {
-    delete[] mTemporaryCoefficients2D;
-    mTemporaryCoefficients2D = nullptr;
-  }
-  if (mTemporaryCoefficients1D) {
-    delete[] mTemporaryCoefficients1D;
-    mTemporaryCoefficients1D = nullptr;
-  }
   if (mCoefficients) {
     delete[] mCoefficients;
     mCoefficients = nullptr;
@@ -204,74 +181,28 @@ void Chebyshev3DCalc::Print(const Option_t *) const
 
 Float_t Chebyshev3DCalc::evaluateDerivative(int dim, const Float_t *par) const
 {
-  int ncfRC;
-  for (int id0 = mNumberOfRows; id0--;) {
-    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
-    if (!nCLoc) {
-      mTemporaryCoefficients1D[id0] = 0;
-      continue;
-    }
-    //
-    int col0 = mColumnAtRowBeginning[id0]; // beginning of local column in the 2D boundary matrix
-    for (int id1 = nCLoc; id1--;) {
-      int id = id1 + col0;
-      if (!(ncfRC = mCoefficientBound2D0[id])) {
-        mTemporaryCoefficients2D[id1] = 0;
-        continue;
-      }
-      if (dim == 2) {
-        mTemporaryCoefficients2D[id1] =
-          chebyshevEvaluation1Derivative(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC);
-      } else {
-        mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC);
-      }
-    }
-    if (dim == 1) {
-      mTemporaryCoefficients1D[id0] = chebyshevEvaluation1Derivative(par[1], mTemporaryCoefficients2D, nCLoc);
-    } else {
-      mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
-    }
-  }
-  return (dim == 0) ? chebyshevEvaluation1Derivative(par[0], mTemporaryCoefficients1D, mNumberOfRows)
-                    : chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  const int order[3] = { dim == 0, dim == 1, dim == 2 };
+  return evaluateSeries(par, order);
 }
 
 Float_t Chebyshev3DCalc::evaluateDerivative2(int dim1, int dim2, const Float_t *par) const
 {
-  Bool_t same = dim1 == dim2;
-  int ncfRC;
-  for (int id0 = mNumberOfRows; id0--;) {
-    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
-    if (!nCLoc) {
-      mTemporaryCoefficients1D[id0] = 0;
-      continue;
-    }
-    int col0 = mColumnAtRowBeginning[id0]; // beginning of local column in the 2D boundary matrix
-    for (int id1 = nCLoc; id1--;) {
-      int id = id1 + col0;
-      if (!(ncfRC = mCoefficientBound2D0[id])) {
-        mTemporaryCoefficients2D[id1] = 0;
-        continue;
-      }
-      if (dim1 == 2 || dim2 == 2) {
-        mTemporaryCoefficients2D[id1] =
-          same ? chebyshevEvaluation1Derivative2(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC)
-               : chebyshevEvaluation1Derivative(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC);
-      } else {
-        mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], ncfRC);
-      }
-    }
-    if (dim1 == 1 || dim2 == 1) {
-      mTemporaryCoefficients1D[id0] = same ? chebyshevEvaluation1Derivative2(par[1], mTemporaryCoefficients2D, nCLoc)
-                                           : chebyshevEvaluation1Derivative(par[1], mTemporaryCoefficients2D, nCLoc);
-    } else {
-      mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
-    }
+  const int order[3] = { (dim1 == 0) + (dim2 == 0), (dim1 == 1) + (dim2 == 1), (dim1 == 2) + (dim2 == 2) };
+  return evaluateSeries(par, order);
+}
+
+void Chebyshev3DCalc::Eval(const Float_t *x0, const Float_t *x1, const Float_t *x2, Float_t *res, int n) const
+{
+  int i = 0;
+  for (; i + int(float_v::Size) <= n; i += float_v::Size) {
+    const float_v par[3] = { float_v(x0 + i, Vc::Unaligned), float_v(x1 + i, Vc::Unaligned),
+                             float_v(x2 + i, Vc::Unaligned) };
+    evaluateSeries(par).store(res + i, Vc::Unaligned);
+  }
+  for (; i < n; i++) {
+    const Float_t par[3] = { x0[i], x1[i], x2[i] };
+    res[i] = evaluateSeries(par);
   }
-  return (dim1 == 0 || dim2 == 0)
-         ? (same ? chebyshevEvaluation1Derivative2(par[0], mTemporaryCoefficients1D, mNumberOfRows)
-                 : chebyshevEvaluation1Derivative(par[0], mTemporaryCoefficients1D, mNumberOfRows))
-         : chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
 }
 
 #ifdef _INC_CREATION_Chebyshev3D_
@@ -404,14 +335,9 @@ void Chebyshev3DCalc::initializeRows(int nr)
     delete[] mColumnAtRowBeginning;
     mColumnAtRowBeginning = nullptr;
   }
-  if (mTemporaryCoefficients1D) {
-    delete[] mTemporaryCoefficients1D;
-    mTemporaryCoefficients1D = nullptr;
-  }
   mNumberOfRows = nr;
   if (mNumberOfRows) {
     mNumberOfColumnsAtRow = new UShort_t[mNumberOfRows];
-    mTemporaryCoefficients1D = new Float_t[mNumberOfRows];
     mColumnAtRowBeginning = new UShort_t[mNumberOfRows];
     for (int i = mNumberOfRows; i--;) {
       mNumberOfColumnsAtRow[i] = mColumnAtRowBeginning[i] = 0;
@@ -422,11 +348,6 @@ void Chebyshev3DCalc::initializeRows(int nr)
 void Chebyshev3DCalc::initializeColumns(int nc)
 {
   mNumberOfColumns = nc;
-  if (mTemporaryCoefficients2D) {
-    delete[] mTemporaryCoefficients2D;
-    mTemporaryCoefficients2D = nullptr;
-  }
-  if (mNumberOfColumns) { mTemporaryCoefficients2D = new Float_t[mNumberOfColumns]; }
 }
 
 void Chebyshev3DCalc::initializeElementBound2D(int ne)
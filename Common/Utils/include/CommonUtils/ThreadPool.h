@@ -0,0 +1,93 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ThreadPool.h
+/// \brief Definition of a persistent work stealing thread pool
+
+#ifndef ALICEO2_COMMON_UTILS_THREADPOOL_H_
+#define ALICEO2_COMMON_UTILS_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2 {
+namespace utils {
+
+/// \class ThreadPool
+/// Persistent pool of worker threads, which are started once and reused for every batch of tasks.
+/// The tasks of a batch are dealt out round robin to one queue per worker. Each worker takes the tasks
+/// from the front of its own queue and, once that is empty, steals from the back of the other queues.
+/// The calling thread takes part in the processing as the last worker.
+class ThreadPool {
+  public:
+    /// Task, called with the task index and the index of the worker which executes it
+    using Task = std::function<void(size_t task, int worker)>;
+
+    /// Constructor
+    /// \param nThreads Number of threads including the calling one, 0 to use all available cores
+    explicit ThreadPool(int nThreads = 0);
+
+    /// Destructor, stops and joins all worker threads
+    ~ThreadPool();
+
+    /// Get the number of workers, i.e. the number of threads including the calling one
+    /// \return Number of workers
+    int getNumberOfWorkers() const { return static_cast<int>(mQueues.size()); }
+
+    /// Execute a batch of tasks and wait until all of them are done
+    /// \param nTasks Number of tasks, which are executed in the order of their index within each queue
+    /// \param task Function to be called for each task
+    void run(size_t nTasks, const Task &task);
+
+  private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    /// Task queue of one worker
+    struct Queue {
+      std::mutex         mutex;
+      std::deque<size_t> tasks;
+    };
+
+    /// Main loop of the worker threads
+    /// \param worker Index of the worker
+    void workerLoop(int worker);
+
+    /// Get a task from the own queue, or steal one from another worker
+    /// \param worker Index of the worker
+    /// \param task Index of the task
+    /// \return false if all queues are empty
+    bool getTask(int worker, size_t &task);
+
+    /// Execute all tasks which are available to a worker
+    /// \param worker Index of the worker
+    void executeTasks(int worker);
+
+    std::vector<std::unique_ptr<Queue>> mQueues;       ///< Task queues, one per worker
+    std::vector<std::thread>            mThreads;      ///< Worker threads
+    const Task                          *mTask;        ///< Task of the current batch
+    std::atomic<size_t>                 mPending;      ///< Number of not yet finished tasks of the current batch
+    std::mutex                          mMutex;        ///< Mutex protecting the batch state
+    std::condition_variable             mWakeUp;       ///< Signals a new batch to the workers
+    std::condition_variable             mDone;         ///< Signals the end of a batch to the caller
+    size_t                              mBatch;        ///< Counter of the batches
+    bool                                mStop;         ///< Stop flag for the worker threads
+};
+
+}
+}
+
+#endif // ALICEO2_COMMON_UTILS_THREADPOOL_H_
@@ -0,0 +1,127 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ThreadPool.cxx
+/// \brief Implementation of a persistent work stealing thread pool
+
+#include "CommonUtils/ThreadPool.h"
+
+#include <algorithm>
+
+using namespace o2::utils;
+
+ThreadPool::ThreadPool(int nThreads)
+  : mQueues(),
+    mThreads(),
+    mTask(nullptr),
+    mPending(0),
+    mMutex(),
+    mWakeUp(),
+    mDone(),
+    mBatch(0),
+    mStop(false)
+{
+  if (nThreads <= 0) {
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < nThreads; ++i) {
+    mQueues.emplace_back(new Queue);
+  }
+  /// the last worker is the calling thread
+  for (int i = 0; i < nThreads - 1; ++i) {
+    mThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mWakeUp.notify_all();
+  for (auto &thread : mThreads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::run(size_t nTasks, const Task &task)
+{
+  if (nTasks == 0) return;
+  mTask = &task;
+  mPending = nTasks;
+  const int nWorkers = getNumberOfWorkers();
+  for (int worker = 0; worker < nWorkers; ++worker) {
+    std::lock_guard<std::mutex> lock(mQueues[worker]->mutex);
+    for (size_t i = worker; i < nTasks; i += nWorkers) {
+      mQueues[worker]->tasks.push_back(i);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    ++mBatch;
+  }
+  mWakeUp.notify_all();
+
+  executeTasks(nWorkers - 1);
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mDone.wait(lock, [this]() { return mPending == 0; });
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+  size_t batch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWakeUp.wait(lock, [this, batch]() { return mStop || mBatch != batch; });
+      if (mStop) return;
+      batch = mBatch;
+    }
+    executeTasks(worker);
+  }
+}
+
+bool ThreadPool::getTask(int worker, size_t &task)
+{
+  {
+    Queue &queue = *mQueues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  const int nWorkers = getNumberOfWorkers();
+  for (int i = 1; i < nWorkers; ++i) {
+    Queue &victim = *mQueues[(worker + i) % nWorkers];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::executeTasks(int worker)
+{
+  size_t task;
+  while (getTask(worker, task)) {
+    (*mTask)(task, worker);
+    if (--mPending == 0) {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mDone.notify_all();
+    }
+  }
+}
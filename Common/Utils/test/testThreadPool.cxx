@@ -0,0 +1,65 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testThreadPool.cxx
+/// \brief This task tests the work stealing ThreadPool
+
+#define BOOST_TEST_MODULE Test ThreadPool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "CommonUtils/ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace o2 {
+namespace utils {
+
+  /// \brief Test of the ThreadPool
+  /// Several batches are executed and we check that each task runs exactly once
+  BOOST_AUTO_TEST_CASE(ThreadPool_test)
+  {
+    for (int nThreads : {1, 2, 4}) {
+      ThreadPool pool(nThreads);
+      BOOST_CHECK(pool.getNumberOfWorkers() == nThreads);
+      for (int batch = 0; batch < 100; ++batch) {
+        std::vector<std::atomic<int>> executed(37 + batch);
+        for (auto& e : executed) e = 0;
+        std::atomic<int> invalidWorker(0);
+        pool.run(executed.size(), [&executed, &invalidWorker, nThreads](size_t task, int worker) {
+          if (worker < 0 || worker >= nThreads) ++invalidWorker;
+          ++executed[task];
+        });
+        BOOST_REQUIRE(invalidWorker == 0);
+        for (auto& e : executed) BOOST_REQUIRE(e == 1);
+      }
+    }
+  }
+
+  /// \brief Test of independent pools
+  /// Two pools used side by side from different threads must not interfere
+  BOOST_AUTO_TEST_CASE(ThreadPool_independent_test)
+  {
+    ThreadPool first(3), second(2);
+    std::vector<std::atomic<int>> executedFirst(1000), executedSecond(1000);
+    for (auto& e : executedFirst) e = 0;
+    for (auto& e : executedSecond) e = 0;
+    std::thread other([&second, &executedSecond]() {
+      second.run(executedSecond.size(), [&executedSecond](size_t task, int) { ++executedSecond[task]; });
+    });
+    first.run(executedFirst.size(), [&executedFirst](size_t task, int) { ++executedFirst[task]; });
+    other.join();
+    for (auto& e : executedFirst) BOOST_REQUIRE(e == 1);
+    for (auto& e : executedSecond) BOOST_REQUIRE(e == 1);
+  }
+}
+}
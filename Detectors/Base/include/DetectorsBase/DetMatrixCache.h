@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <array>
+#include <mutex>
 #include "MathUtils/Cartesian3D.h"
 #include "DetectorsBase/DetID.h"
 #include "Rtypes.h"
@@ -24,7 +25,10 @@ namespace o2
 namespace Base
 {
 
-/// MatrixCache is a vector of cached transform matrices (per sensor) for specific Transformation type
+/// MatrixCache is a vector of cached transform matrices (per sensor) for specific Transformation type.
+/// A flat float copy of the matrices (the 3x3 rotation and the translation of each sensor, one array per
+/// element) is kept alongside, to transform batches of points with SIMD kernels instead of one
+/// Transform3D call per point.
  
 template <typename T = o2::Base::Transform3D>
 class MatrixCache {
@@ -38,11 +42,19 @@ class MatrixCache {
   MatrixCache& operator=(const MatrixCache& src) = delete;
  
   /// set the size of the cache
-  void setSize(int s)  {if (!mCache.size()) mCache.resize(s);}
+  void setSize(int s)  {
+    if (!mCache.size()) {
+      mCache.resize(s);
+      fillFlatMatrices();
+    }
+  }
 
   /// get the size of the cache
   int getSize() const {return mCache.size();}
 
+  /// elements of the flat copy of the matrices: rows of the rotation, each followed by the translation
+  enum FlatElement { kXX, kXY, kXZ, kDX, kYX, kYY, kYZ, kDY, kZX, kZY, kZZ, kDZ, kNFlatElements };
+
   /// assign matrix to a slot
   void setMatrix(const T& mat, int sensID) {
     // assign matrix for given sensor. The cache must be booked in advance 
@@ -50,14 +62,33 @@ class MatrixCache {
       LOG(FATAL) << "SensID " << sensID << " exceeds cache size of " << mCache.size() << FairLogger::endl;
     }
     mCache[sensID] = mat;
+    fillFlatMatrices(); // e.g. after reading the cache from file
+    setFlatMatrix(sensID);
   }
 
   const T& getMatrix(int sensID)  const {return mCache[sensID];}
 
   bool isFilled() const {return !mCache.empty();}
-  
+
+  /// apply to the n points "in" the matrices of the sensors "sensIDs" and store the results in "out",
+  /// which may be the same array as "in". The points should be grouped by sensor, so that the matrix
+  /// of a sensor is broadcast to all SIMD lanes rather than gathered lane by lane
+  void transformPoints(const int* sensIDs, const Point3D<float>* in, Point3D<float>* out, int n) const;
+  /// same for n points of the same sensor
+  void transformPoints(int sensID, const Point3D<float>* in, Point3D<float>* out, int n) const;
+  /// same with the inverse transformations, as given by operator^ of the matrices
+  void inverseTransformPoints(const int* sensIDs, const Point3D<float>* in, Point3D<float>* out, int n) const;
+  void inverseTransformPoints(int sensID, const Point3D<float>* in, Point3D<float>* out, int n) const;
+
  private:
+  void setFlatMatrix(int sensID);
+  void fillFlatMatrices() const;
+  template <bool Inverse, typename SensIDs>
+  void transformPointsImpl(const SensIDs& sensIDs, const Point3D<float>* in, Point3D<float>* out, int n) const;
+
   std::vector<T> mCache;
+  mutable std::array<std::vector<float>, kNFlatElements> mFlat; //! flat float copy of the matrices, per element
+  mutable std::once_flag mFlatFilled;                            //! set once mFlat is built from mCache
    ClassDefNV(MatrixCache,1);
 };
 
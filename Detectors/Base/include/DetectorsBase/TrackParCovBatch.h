@@ -0,0 +1,87 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TrackParCovBatch.h
+/// \brief Batch of tracks with covariance stored as structure of arrays, processed with SIMD kernels
+
+#ifndef ALICEO2_BASE_TRACKPARCOVBATCH
+#define ALICEO2_BASE_TRACKPARCOVBATCH
+
+#include <array>
+#include <vector>
+
+#include "DetectorsBase/Track.h"
+
+namespace o2
+{
+namespace Base
+{
+namespace Track
+{
+/// Each parameter and covariance element of the tracks is stored in its own array, so that the
+/// propagation, rotation and update kernels process as many tracks per instruction as the SIMD
+/// width allows. They give the results of the corresponding TrackParCov methods within the float
+/// precision (the scalar code evaluates part of the covariance in double precision).
+///
+/// Each track has a status: the kernels skip the tracks flagged as failed, and flag the tracks
+/// on which they fail, leaving their parameters unchanged.
+class TrackParCovBatch
+{
+ public:
+  TrackParCovBatch() = default;
+  explicit TrackParCovBatch(int n) { Resize(n); }
+
+  int GetSize() const { return mSize; }
+  void Resize(int n);
+  void Clear() { Resize(0); }
+
+  // access to the tracks, setting a track flags it as OK
+  void SetTrack(int i, const TrackParCov& track);
+  int AddTrack(const TrackParCov& track);
+  TrackParCov GetTrack(int i) const;
+
+  bool IsOK(int i) const { return mStatus[i] != 0.f; }
+  void SetOK(int i, bool ok = true) { mStatus[i] = ok ? 1.f : 0.f; }
+  int GetNumberOfOK() const;
+
+  float GetX(int i) const { return mX[i]; }
+  float GetAlpha(int i) const { return mAlpha[i]; }
+  float GetParam(int i, int par) const { return mP[par][i]; }
+  float GetCov(int i, int el) const { return mC[el][i]; }
+
+  // parameters + covmat manipulation, these return the number of tracks still OK
+  int Rotate(float alpha);
+  int Rotate(const float* alpha);
+  int PropagateTo(float xk, float b);
+  int PropagateTo(const float* xk, float b);
+
+  /// chi2 of the space points "y","z" with the covariance "sigY2","sigZY","sigZ2", kVeryBig for the failed tracks
+  void GetPredictedChi2(const float* y, const float* z, const float* sigY2, const float* sigZY, const float* sigZ2,
+                        float* chi2) const;
+  int Update(const float* y, const float* z, const float* sigY2, const float* sigZY, const float* sigZ2);
+
+ private:
+  template <typename XK>
+  int propagateTo(const XK& xk, float b);
+  template <typename Alpha>
+  int rotate(const Alpha& alpha);
+
+  int mSize = 0;                                  ///< number of tracks
+  std::vector<float> mStatus;                     ///< 1 for the tracks OK, 0 for the failed ones and the padding
+  std::vector<float> mX;                          ///< X of track evaluation
+  std::vector<float> mAlpha;                      ///< track frame angle
+  std::array<std::vector<float>, kNParams> mP;    ///< 5 parameters: Y,Z,sin(phi),tg(lambda),q/pT
+  std::array<std::vector<float>, kCovMatSize> mC; ///< 15 covariance matrix elements
+};
+}
+}
+}
+
+#endif
@@ -11,6 +11,9 @@
 #include "DetectorsBase/DetMatrixCache.h"
 #include "DetectorsBase/Utils.h"
 #include <TGeoMatrix.h>
+#include <Vc/Vc>
+#include <algorithm>
+#include <mutex>
 
 using namespace o2::Base;
 using namespace o2::Base::Utils;
@@ -19,6 +22,155 @@ ClassImp(o2::Base::MatrixCache<o2::Base::Transform3D>);
 ClassImp(o2::Base::MatrixCache<o2::Base::Rotation2D>);
 ClassImp(o2::Base::DetMatrixCache);
 
+namespace
+{
+using float_v = Vc::float_v;
+
+/// sensor ID of all the points of a single sensor batch
+struct SingleSensor {
+  int id;
+  int operator[](int) const { return id; }
+};
+
+/// rotation and translation of the matrix in the order of MatrixCache::FlatElement
+void getFlatComponents(const Transform3D& mat, float* el)
+{
+  double cmp[MatrixCache<Transform3D>::kNFlatElements];
+  mat.GetComponents(cmp, cmp + MatrixCache<Transform3D>::kNFlatElements);
+  std::copy(cmp, cmp + MatrixCache<Transform3D>::kNFlatElements, el);
+}
+
+void getFlatComponents(const Rotation2D& mat, float* el)
+{
+  float cs, sn;
+  mat.getComponents(cs, sn);
+  const float cmp[MatrixCache<Rotation2D>::kNFlatElements] = { cs, -sn, 0.f, 0.f, sn, cs, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+  std::copy(cmp, cmp + MatrixCache<Rotation2D>::kNFlatElements, el);
+}
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::setFlatMatrix(int sensID)
+{
+  // update the flat copy of the matrix of the sensor
+  float el[kNFlatElements];
+  getFlatComponents(mCache[sensID], el);
+  for (int i = 0; i < kNFlatElements; i++) {
+    mFlat[i][sensID] = el[i];
+  }
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::fillFlatMatrices() const
+{
+  // build the flat copy of all the matrices on the first call, which is setSize for a new cache.
+  // Being transient, the copy is missing after reading the cache from file and is then built by the
+  // first setMatrix or transformation. Later calls only check the once flag of the cache
+  std::call_once(mFlatFilled, [this]() {
+    float el[kNFlatElements];
+    for (auto& flat : mFlat) {
+      flat.resize(mCache.size());
+    }
+    for (size_t sensID = 0; sensID < mCache.size(); sensID++) {
+      getFlatComponents(mCache[sensID], el);
+      for (int i = 0; i < kNFlatElements; i++) {
+        mFlat[i][sensID] = el[i];
+      }
+    }
+  });
+}
+
+//_______________________________________________________
+template <typename T>
+template <bool Inverse, typename SensIDs>
+void MatrixCache<T>::transformPointsImpl(const SensIDs& sensIDs, const Point3D<float>* in, Point3D<float>* out,
+                                         int n) const
+{
+  // transform the points by vectors of float_v::Size, the last vector being padded with the last point.
+  // The matrix is broadcast when all the lanes belong to the same sensor, otherwise its elements are
+  // gathered lane by lane
+  constexpr int kSize = float_v::Size;
+  fillFlatMatrices();
+  float xyz[3][kSize], elLanes[kNFlatElements][kSize];
+  for (int i = 0; i < n; i += kSize) {
+    const int nl = std::min(kSize, n - i);
+    bool sameSensor = true;
+    for (int l = 0; l < kSize; l++) {
+      const int ip = i + std::min(l, nl - 1);
+      xyz[0][l] = in[ip].X();
+      xyz[1][l] = in[ip].Y();
+      xyz[2][l] = in[ip].Z();
+      sameSensor &= sensIDs[ip] == sensIDs[i];
+    }
+    float_v el[kNFlatElements];
+    if (sameSensor) {
+      for (int k = 0; k < kNFlatElements; k++) {
+        el[k] = float_v(mFlat[k][sensIDs[i]]);
+      }
+    } else {
+      for (int l = 0; l < kSize; l++) {
+        const int sensID = sensIDs[i + std::min(l, nl - 1)];
+        for (int k = 0; k < kNFlatElements; k++) {
+          elLanes[k][l] = mFlat[k][sensID];
+        }
+      }
+      for (int k = 0; k < kNFlatElements; k++) {
+        el[k] = float_v(elLanes[k], Vc::Unaligned);
+      }
+    }
+    float_v x(xyz[0], Vc::Unaligned), y(xyz[1], Vc::Unaligned), z(xyz[2], Vc::Unaligned);
+    if (Inverse) { // transposed rotation of the point minus the translation
+      x -= el[kDX];
+      y -= el[kDY];
+      z -= el[kDZ];
+      (el[kXX] * x + el[kYX] * y + el[kZX] * z).store(xyz[0], Vc::Unaligned);
+      (el[kXY] * x + el[kYY] * y + el[kZY] * z).store(xyz[1], Vc::Unaligned);
+      (el[kXZ] * x + el[kYZ] * y + el[kZZ] * z).store(xyz[2], Vc::Unaligned);
+    } else {
+      (el[kXX] * x + el[kXY] * y + el[kXZ] * z + el[kDX]).store(xyz[0], Vc::Unaligned);
+      (el[kYX] * x + el[kYY] * y + el[kYZ] * z + el[kDY]).store(xyz[1], Vc::Unaligned);
+      (el[kZX] * x + el[kZY] * y + el[kZZ] * z + el[kDZ]).store(xyz[2], Vc::Unaligned);
+    }
+    for (int l = 0; l < nl; l++) {
+      out[i + l].SetXYZ(xyz[0][l], xyz[1][l], xyz[2][l]);
+    }
+  }
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::transformPoints(const int* sensIDs, const Point3D<float>* in, Point3D<float>* out, int n) const
+{
+  transformPointsImpl<false>(sensIDs, in, out, n);
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::transformPoints(int sensID, const Point3D<float>* in, Point3D<float>* out, int n) const
+{
+  transformPointsImpl<false>(SingleSensor{ sensID }, in, out, n);
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::inverseTransformPoints(const int* sensIDs, const Point3D<float>* in, Point3D<float>* out,
+                                            int n) const
+{
+  transformPointsImpl<true>(sensIDs, in, out, n);
+}
+
+//_______________________________________________________
+template <typename T>
+void MatrixCache<T>::inverseTransformPoints(int sensID, const Point3D<float>* in, Point3D<float>* out, int n) const
+{
+  transformPointsImpl<true>(SingleSensor{ sensID }, in, out, n);
+}
+
+template class o2::Base::MatrixCache<o2::Base::Transform3D>;
+template class o2::Base::MatrixCache<o2::Base::Rotation2D>;
+
 
 //_______________________________________________________
 void DetMatrixCache::setSize(int s)
@@ -0,0 +1,469 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "DetectorsBase/TrackParCovBatch.h"
+
+#include <algorithm>
+#include <Vc/Vc>
+
+using std::array;
+using namespace o2::Base::Track;
+using namespace o2::Base::Constants;
+
+using float_v = Vc::float_v;
+using float_m = Vc::float_m;
+// the scalar code evaluates the covariance matrix in double precision, with the same number of lanes here
+using double_v = Vc::SimdArray<double, float_v::Size>;
+
+namespace
+{
+constexpr int kLanes = float_v::Size;
+
+// the arrays of the batch are padded to a multiple of the SIMD width
+inline int paddedSize(int n) { return (n + kLanes - 1) / kLanes * kLanes; }
+
+inline float_v load(const std::vector<float>& arr, int i) { return float_v(arr.data() + i, Vc::Unaligned); }
+
+inline void store(std::vector<float>& arr, int i, const float_v& v, const float_m& m)
+{
+  // store the lanes of v selected by m
+  Vc::iif(m, v, load(arr, i)).store(arr.data() + i, Vc::Unaligned);
+}
+
+inline double_v toDouble(const float_v& v) { return Vc::simd_cast<double_v>(v); }
+
+inline float_v toFloat(const double_v& v) { return Vc::simd_cast<float_v>(v); }
+
+inline float_v loadInput(const float* arr, int i, int n)
+{
+  // load the elements i...i+kLanes of an input array of size n, the lanes beyond its end are set to 0
+  if (i + kLanes <= n) {
+    return float_v(arr + i, Vc::Unaligned);
+  }
+  float tmp[kLanes] = { 0.f };
+  std::copy(arr + i, arr + n, tmp);
+  return float_v(tmp, Vc::Unaligned);
+}
+
+inline void storeOutput(float* arr, int i, int n, const float_v& v)
+{
+  // store the lanes of v to an output array of size n
+  if (i + kLanes <= n) {
+    v.store(arr + i, Vc::Unaligned);
+    return;
+  }
+  float tmp[kLanes];
+  v.store(tmp, Vc::Unaligned);
+  std::copy(tmp, tmp + n - i, arr + i);
+}
+
+constexpr int covIndex(int i, int j) { return i * (i + 1) / 2 + j; }
+
+void checkCovariance(float_v* c)
+{
+  // SIMD version of TrackParCov::CheckCovariance
+  constexpr int kDiag[kNParams] = { kSigY2, kSigZ2, kSigSnp2, kSigTgl2, kSigQ2Pt2 };
+  constexpr float kMax[kNParams] = { kCY2max, kCZ2max, kCSnp2max, kCTgl2max, kC1Pt2max };
+  for (int ip = 0; ip < kNParams; ip++) {
+    float_v& diag = c[kDiag[ip]];
+    diag = Vc::abs(diag);
+    const float_m large = diag > kMax[ip];
+    if (large.isEmpty()) {
+      continue;
+    }
+    const float_v scl = Vc::iif(large, Vc::sqrt(kMax[ip] / diag), float_v(1.f));
+    diag(large) = kMax[ip];
+    for (int jp = 0; jp < kNParams; jp++) {
+      if (jp != ip) {
+        c[jp < ip ? covIndex(ip, jp) : covIndex(jp, ip)] *= scl;
+      }
+    }
+  }
+}
+}
+
+//______________________________________________________________
+void TrackParCovBatch::Resize(int n)
+{
+  // resize the batch, the new tracks are flagged as failed until they are set
+  const int padded = paddedSize(n);
+  mStatus.resize(padded);
+  std::fill(mStatus.begin() + std::min(n, mSize), mStatus.end(), 0.f);
+  mX.resize(padded);
+  mAlpha.resize(padded);
+  for (auto& p : mP) {
+    p.resize(padded);
+  }
+  for (auto& c : mC) {
+    c.resize(padded);
+  }
+  mSize = n;
+}
+
+//______________________________________________________________
+void TrackParCovBatch::SetTrack(int i, const TrackParCov& track)
+{
+  mStatus[i] = 1.f;
+  mX[i] = track.GetX();
+  mAlpha[i] = track.GetAlpha();
+  for (int ip = 0; ip < kNParams; ip++) {
+    mP[ip][i] = track.GetParam()[ip];
+  }
+  const array<float, kCovMatSize> cov = {
+    track.GetSigmaY2(), track.GetSigmaZY(), track.GetSigmaZ2(), track.GetSigmaSnpY(), track.GetSigmaSnpZ(),
+    track.GetSigmaSnp2(), track.GetSigmaTglY(), track.GetSigmaTglZ(), track.GetSigmaTglSnp(), track.GetSigmaTgl2(),
+    track.GetSigma1PtY(), track.GetSigma1PtZ(), track.GetSigma1PtSnp(), track.GetSigma1PtTgl(), track.GetSigma1Pt2()
+  };
+  for (int ic = 0; ic < kCovMatSize; ic++) {
+    mC[ic][i] = cov[ic];
+  }
+}
+
+//______________________________________________________________
+int TrackParCovBatch::AddTrack(const TrackParCov& track)
+{
+  Resize(mSize + 1);
+  SetTrack(mSize - 1, track);
+  return mSize - 1;
+}
+
+//______________________________________________________________
+TrackParCov TrackParCovBatch::GetTrack(int i) const
+{
+  array<float, kNParams> par;
+  array<float, kCovMatSize> cov;
+  for (int ip = 0; ip < kNParams; ip++) {
+    par[ip] = mP[ip][i];
+  }
+  for (int ic = 0; ic < kCovMatSize; ic++) {
+    cov[ic] = mC[ic][i];
+  }
+  return TrackParCov(mX[i], mAlpha[i], par, cov);
+}
+
+//______________________________________________________________
+int TrackParCovBatch::GetNumberOfOK() const
+{
+  return mSize - std::count(mStatus.begin(), mStatus.begin() + mSize, 0.f);
+}
+
+//______________________________________________________________
+int TrackParCovBatch::PropagateTo(float xk, float b)
+{
+  // Propagate all tracks to the plane X=xk (cm) in the field "b" (kG)
+  const float_v xkv(xk);
+  return propagateTo([&xkv](int) { return xkv; }, b);
+}
+
+//______________________________________________________________
+int TrackParCovBatch::PropagateTo(const float* xk, float b)
+{
+  // Propagate each track i to the plane X=xk[i] (cm) in the field "b" (kG)
+  return propagateTo([this, xk](int i) { return loadInput(xk, i, mSize); }, b);
+}
+
+//______________________________________________________________
+template <typename XK>
+int TrackParCovBatch::propagateTo(const XK& xkAt, float b)
+{
+  // SIMD version of TrackParCov::PropagateTo
+  const bool noField = fabs(b) < kAlmost0;
+  int nOK = 0;
+  for (int i = 0; i < mSize; i += kLanes) {
+    float_m ok = load(mStatus, i) > 0.f;
+    if (ok.isEmpty()) {
+      continue;
+    }
+    const float_v xk = xkAt(i), dx = xk - load(mX, i);
+    const float_v snp = load(mP[kSnp], i), tgl = load(mP[kTgl], i), q2pt = load(mP[kQ2Pt], i);
+    const float_v crv = noField ? float_v(0.f) : q2pt * b * kB2C;
+    const float_v x2r = crv * dx;
+    const float_v f1 = snp, f2 = f1 + x2r;
+    const float_v r1 = Vc::sqrt((1.f - f1) * (1.f + f1)), r2 = Vc::sqrt((1.f - f2) * (1.f + f2));
+    // the tracks already at xk are left as they are
+    float_m move = ok && Vc::abs(dx) >= kAlmost0;
+    const float_m fail = move && (Vc::abs(f1) > kAlmost1 || Vc::abs(f2) > kAlmost1 || Vc::abs(q2pt) < kAlmost0 ||
+                                  !(Vc::abs(r1) >= kAlmost0) || !(Vc::abs(r2) >= kAlmost0));
+    if (!fail.isEmpty()) {
+      ok &= !fail;
+      move &= !fail;
+      store(mStatus, i, float_v(0.f), fail);
+    }
+    nOK += ok.count();
+    if (move.isEmpty()) {
+      continue;
+    }
+
+    const double_v dxd = toDouble(dx), dy2dx = toDouble((f1 + f2) / (r1 + r2));
+    const float_v z = load(mP[kZ], i);
+    float_v znew = toFloat(toDouble(z) + dxd * (toDouble(r2) + toDouble(f2) * dy2dx) * toDouble(tgl));
+    const float_m arc = move && Vc::abs(x2r) >= 0.05f;
+    if (!arc.isEmpty()) {
+      // at large dx/R the Z propagation along the arc, see TrackParCov::PropagateTo
+      float_v rot = Vc::asin(r1 * f2 - r2 * f1);
+      const float_m largeRot = f1 * f1 + f2 * f2 > 1.f && f1 * f2 < 0.f;
+      rot(largeRot) = Vc::iif(f2 > 0.f, kPI - rot, -kPI - rot);
+      znew(arc) = z + tgl / crv * rot;
+    }
+    store(mX, i, xk, move);
+    store(mP[kY], i, toFloat(toDouble(load(mP[kY], i)) + dxd * dy2dx), move);
+    store(mP[kZ], i, znew, move);
+    store(mP[kSnp], i, snp + x2r, move);
+
+    double_v c[kCovMatSize];
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      c[ic] = toDouble(load(mC[ic], i));
+    }
+    double_v &c00 = c[kSigY2], &c10 = c[kSigZY], &c11 = c[kSigZ2], &c20 = c[kSigSnpY], &c21 = c[kSigSnpZ],
+             &c22 = c[kSigSnp2], &c30 = c[kSigTglY], &c31 = c[kSigTglZ], &c32 = c[kSigTglSnp], &c33 = c[kSigTgl2],
+             &c40 = c[kSigQ2PtY], &c41 = c[kSigQ2PtZ], &c42 = c[kSigQ2PtSnp], &c43 = c[kSigQ2PtTgl],
+             &c44 = c[kSigQ2Pt2];
+
+    const double_v rinv = 1. / toDouble(r1);
+    const double_v r3inv = rinv * rinv * rinv;
+    const double_v f24 = toDouble(dx * b * kB2C);
+    const double_v f02 = dxd * r3inv;
+    const double_v f04 = 0.5 * f24 * f02;
+    const double_v f12 = f02 * toDouble(tgl) * toDouble(f1);
+    const double_v f14 = 0.5 * f24 * f12;
+    const double_v f13 = dxd * rinv;
+
+    // b = C*ft
+    const double_v b00 = f02 * c20 + f04 * c40, b01 = f12 * c20 + f14 * c40 + f13 * c30;
+    const double_v b02 = f24 * c40;
+    const double_v b10 = f02 * c21 + f04 * c41, b11 = f12 * c21 + f14 * c41 + f13 * c31;
+    const double_v b12 = f24 * c41;
+    const double_v b20 = f02 * c22 + f04 * c42, b21 = f12 * c22 + f14 * c42 + f13 * c32;
+    const double_v b22 = f24 * c42;
+    const double_v b40 = f02 * c42 + f04 * c44, b41 = f12 * c42 + f14 * c44 + f13 * c43;
+    const double_v b42 = f24 * c44;
+    const double_v b30 = f02 * c32 + f04 * c43, b31 = f12 * c32 + f14 * c43 + f13 * c33;
+    const double_v b32 = f24 * c43;
+
+    // a = f*b = f*C*ft
+    const double_v a00 = f02 * b20 + f04 * b40, a01 = f02 * b21 + f04 * b41, a02 = f02 * b22 + f04 * b42;
+    const double_v a11 = f12 * b21 + f14 * b41 + f13 * b31, a12 = f12 * b22 + f14 * b42 + f13 * b32;
+    const double_v a22 = f24 * b42;
+
+    // F*C*Ft = C + (b + bt + a)
+    c00 += b00 + b00 + a00;
+    c10 += b10 + b01 + a01;
+    c20 += b20 + b02 + a02;
+    c30 += b30;
+    c40 += b40;
+    c11 += b11 + b11 + a11;
+    c21 += b21 + b12 + a12;
+    c31 += b31;
+    c41 += b41;
+    c22 += b22 + b22 + a22;
+    c32 += b32;
+    c42 += b42;
+
+    float_v cf[kCovMatSize];
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      cf[ic] = toFloat(c[ic]);
+    }
+    checkCovariance(cf);
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      store(mC[ic], i, cf[ic], move);
+    }
+  }
+  return nOK;
+}
+//______________________________________________________________
+int TrackParCovBatch::Rotate(float alpha)
+{
+  // rotate all tracks to alpha frame
+  Utils::BringToPMPi(alpha);
+  const float_v alphav(alpha);
+  return rotate([&alphav](int) { return alphav; });
+}
+
+//______________________________________________________________
+int TrackParCovBatch::Rotate(const float* alpha)
+{
+  // rotate each track i to alpha[i] frame
+  return rotate([this, alpha](int i) {
+    float_v a = loadInput(alpha, i, mSize);
+    a(a > kPI) -= k2PI;
+    return a;
+  });
+}
+
+//______________________________________________________________
+template <typename Alpha>
+int TrackParCovBatch::rotate(const Alpha& alphaAt)
+{
+  // SIMD version of TrackParCov::Rotate
+  int nOK = 0;
+  for (int i = 0; i < mSize; i += kLanes) {
+    float_m ok = load(mStatus, i) > 0.f;
+    if (ok.isEmpty()) {
+      continue;
+    }
+    const float_v alpha = alphaAt(i), snp = load(mP[kSnp], i);
+    float_v ca, sa;
+    Vc::sincos(alpha - load(mAlpha, i), &sa, &ca);
+    float_v csp = Vc::sqrt((1.f - snp) * (1.f + snp));
+    // the rotation must not invalidate the track model (cos(local_phi)>=0, i.e. particle
+    // direction in local frame is along the X axis)
+    const float_v tmp = snp * ca - csp * sa;
+    const float_m fail =
+      ok && (Vc::abs(snp) > kAlmost1 || csp * ca + snp * sa < 0.f || Vc::abs(tmp) > kAlmost1);
+    if (!fail.isEmpty()) {
+      ok &= !fail;
+      store(mStatus, i, float_v(0.f), fail);
+    }
+    nOK += ok.count();
+    if (ok.isEmpty()) {
+      continue;
+    }
+
+    const float_v xold = load(mX, i), yold = load(mP[kY], i);
+    store(mAlpha, i, alpha, ok);
+    store(mX, i, xold * ca + yold * sa, ok);
+    store(mP[kY], i, -xold * sa + yold * ca, ok);
+    store(mP[kSnp], i, tmp, ok);
+
+    csp(Vc::abs(csp) < kAlmost0) = kAlmost0;
+    const float_v rr = ca + snp / csp * sa;
+
+    float_v c[kCovMatSize];
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      c[ic] = load(mC[ic], i);
+    }
+    c[kSigY2] *= (ca * ca);
+    c[kSigZY] *= ca;
+    c[kSigSnpY] *= ca * rr;
+    c[kSigSnpZ] *= rr;
+    c[kSigSnp2] *= rr * rr;
+    c[kSigTglY] *= ca;
+    c[kSigTglSnp] *= rr;
+    c[kSigQ2PtY] *= ca;
+    c[kSigQ2PtSnp] *= rr;
+
+    checkCovariance(c);
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      store(mC[ic], i, c[ic], ok);
+    }
+  }
+  return nOK;
+}
+
+//______________________________________________________________
+void TrackParCovBatch::GetPredictedChi2(const float* y, const float* z, const float* sigY2, const float* sigZY,
+                                        const float* sigZ2, float* chi2) const
+{
+  // SIMD version of TrackParCov::GetPredictedChi2
+  for (int i = 0; i < mSize; i += kLanes) {
+    const float_v sdd = load(mC[kSigY2], i) + loadInput(sigY2, i, mSize);
+    const float_v sdz = load(mC[kSigZY], i) + loadInput(sigZY, i, mSize);
+    const float_v szz = load(mC[kSigZ2], i) + loadInput(sigZ2, i, mSize);
+    const float_v det = sdd * szz - sdz * sdz;
+    const float_v d = load(mP[kY], i) - loadInput(y, i, mSize);
+    const float_v dz = load(mP[kZ], i) - loadInput(z, i, mSize);
+    const float_m ok = load(mStatus, i) > 0.f && Vc::abs(det) >= kAlmost0;
+    storeOutput(chi2, i, mSize, Vc::iif(ok, (d * (szz * d - sdz * dz) + dz * (sdd * dz - d * sdz)) / det,
+                                        float_v(kVeryBig)));
+  }
+}
+
+//______________________________________________________________
+int TrackParCovBatch::Update(const float* y, const float* z, const float* sigY2, const float* sigZY,
+                             const float* sigZ2)
+{
+  // SIMD version of TrackParCov::Update, with the space points "y","z" having
+  // the covariance matrices "sigY2","sigZY","sigZ2"
+  int nOK = 0;
+  for (int i = 0; i < mSize; i += kLanes) {
+    float_m ok = load(mStatus, i) > 0.f;
+    if (ok.isEmpty()) {
+      continue;
+    }
+    double_v c[kCovMatSize];
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      c[ic] = toDouble(load(mC[ic], i));
+    }
+    double_v &cm00 = c[kSigY2], &cm10 = c[kSigZY], &cm11 = c[kSigZ2], &cm20 = c[kSigSnpY], &cm21 = c[kSigSnpZ],
+             &cm22 = c[kSigSnp2], &cm30 = c[kSigTglY], &cm31 = c[kSigTglZ], &cm32 = c[kSigTglSnp], &cm33 = c[kSigTgl2],
+             &cm40 = c[kSigQ2PtY], &cm41 = c[kSigQ2PtZ], &cm42 = c[kSigQ2PtSnp], &cm43 = c[kSigQ2PtTgl],
+             &cm44 = c[kSigQ2Pt2];
+
+    double_v r00 = toDouble(loadInput(sigY2, i, mSize) + load(mC[kSigY2], i));
+    double_v r01 = toDouble(loadInput(sigZY, i, mSize) + load(mC[kSigZY], i));
+    double_v r11 = toDouble(loadInput(sigZ2, i, mSize) + load(mC[kSigZ2], i));
+    const double_v det = r00 * r11 - r01 * r01;
+    const double_v detI = 1. / det;
+    const double_v tmp = r00;
+    r00 = r11 * detI;
+    r11 = tmp * detI;
+    r01 = -r01 * detI;
+
+    const double_v k00 = cm00 * r00 + cm10 * r01, k01 = cm00 * r01 + cm10 * r11;
+    const double_v k10 = cm10 * r00 + cm11 * r01, k11 = cm10 * r01 + cm11 * r11;
+    const double_v k20 = cm20 * r00 + cm21 * r01, k21 = cm20 * r01 + cm21 * r11;
+    const double_v k30 = cm30 * r00 + cm31 * r01, k31 = cm30 * r01 + cm31 * r11;
+    const double_v k40 = cm40 * r00 + cm41 * r01, k41 = cm40 * r01 + cm41 * r11;
+
+    const double_v dy = toDouble(loadInput(y, i, mSize) - load(mP[kY], i));
+    const double_v dz = toDouble(loadInput(z, i, mSize) - load(mP[kZ], i));
+    const double_v sf = toDouble(load(mP[kSnp], i)) + k20 * dy + k21 * dz;
+    const float_m fail = ok && (!(Vc::abs(toFloat(det)) >= kAlmost0) || Vc::abs(toFloat(sf)) > kAlmost1);
+    if (!fail.isEmpty()) {
+      ok &= !fail;
+      store(mStatus, i, float_v(0.f), fail);
+    }
+    nOK += ok.count();
+    if (ok.isEmpty()) {
+      continue;
+    }
+
+    store(mP[kY], i, toFloat(toDouble(load(mP[kY], i)) + (k00 * dy + k01 * dz)), ok);
+    store(mP[kZ], i, toFloat(toDouble(load(mP[kZ], i)) + (k10 * dy + k11 * dz)), ok);
+    store(mP[kSnp], i, toFloat(sf), ok);
+    store(mP[kTgl], i, toFloat(toDouble(load(mP[kTgl], i)) + (k30 * dy + k31 * dz)), ok);
+    store(mP[kQ2Pt], i, toFloat(toDouble(load(mP[kQ2Pt], i)) + (k40 * dy + k41 * dz)), ok);
+
+    // the covariance is rounded to float after each update, as in the scalar code
+    const double_v c01 = cm10, c02 = cm20, c03 = cm30, c04 = cm40;
+    const double_v c12 = cm21, c13 = cm31, c14 = cm41;
+    auto update = [](double_v& cm, const double_v& v) { cm = toDouble(toFloat(cm - v)); };
+
+    update(cm00, k00 * cm00 + k01 * cm10);
+    update(cm10, k00 * c01 + k01 * cm11);
+    update(cm20, k00 * c02 + k01 * c12);
+    update(cm30, k00 * c03 + k01 * c13);
+    update(cm40, k00 * c04 + k01 * c14);
+
+    update(cm11, k10 * c01 + k11 * cm11);
+    update(cm21, k10 * c02 + k11 * c12);
+    update(cm31, k10 * c03 + k11 * c13);
+    update(cm41, k10 * c04 + k11 * c14);
+
+    update(cm22, k20 * c02 + k21 * c12);
+    update(cm32, k20 * c03 + k21 * c13);
+    update(cm42, k20 * c04 + k21 * c14);
+
+    update(cm33, k30 * c03 + k31 * c13);
+    update(cm43, k30 * c04 + k31 * c14);
+
+    update(cm44, k40 * c04 + k41 * c14);
+
+    float_v cf[kCovMatSize];
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      cf[ic] = toFloat(c[ic]);
+    }
+    checkCovariance(cf);
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      store(mC[ic], i, cf[ic], ok);
+    }
+  }
+  return nOK;
+}
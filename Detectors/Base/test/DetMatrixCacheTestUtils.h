@@ -0,0 +1,73 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DetMatrixCacheTestUtils.h
+/// \brief Random matrices and points shared by the tests and benchmarks of the MatrixCache
+
+#ifndef ALICEO2_BASE_DETMATRIXCACHETESTUTILS_H_
+#define ALICEO2_BASE_DETMATRIXCACHETESTUTILS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <Math/GenVector/Rotation3D.h>
+#include <Math/GenVector/RotationZYX.h>
+#include "DetectorsBase/DetMatrixCache.h"
+
+namespace o2
+{
+namespace Base
+{
+namespace test
+{
+
+/// Fill the cache with random sensor matrices, with translations up to 50 cm as for ITS and MFT
+inline void fillCache(MatrixCache<Transform3D>& cache, int nSensors, std::mt19937& gen)
+{
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI), pos(-50., 50.);
+  cache.setSize(nSensors);
+  for (int i = 0; i < nSensors; i++) {
+    const ROOT::Math::Rotation3D rot(ROOT::Math::RotationZYX(angle(gen), angle(gen) / 2, angle(gen)));
+    cache.setMatrix(Transform3D(rot, Transform3D::Vector(pos(gen), pos(gen), pos(gen))), i);
+  }
+}
+
+inline void fillCache(MatrixCache<Rotation2D>& cache, int nSensors, std::mt19937& gen)
+{
+  std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+  cache.setSize(nSensors);
+  for (int i = 0; i < nSensors; i++) {
+    cache.setMatrix(Rotation2D(angle(gen)), i);
+  }
+}
+
+/// Generate n points grouped by sensor, each sensor getting a random number of points
+inline void generatePoints(int n, int nSensors, std::mt19937& gen, std::vector<Point3D<float>>& points,
+                    std::vector<int>& sensIDs)
+{
+  std::uniform_real_distribution<float> pos(-50.f, 50.f);
+  std::uniform_int_distribution<int> sensor(0, nSensors - 1), nPoints(1, 20);
+  points.clear();
+  sensIDs.clear();
+  while (int(points.size()) < n) {
+    const int id = sensor(gen);
+    for (int i = std::min(nPoints(gen), n - int(points.size())); i--;) {
+      points.emplace_back(pos(gen), pos(gen), pos(gen));
+      sensIDs.push_back(id);
+    }
+  }
+}
+
+} // namespace test
+} // namespace Base
+} // namespace o2
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TrackParCovBatchTestUtils.h
+/// \brief Track generation shared by the tests and benchmarks of the TrackParCovBatch
+
+#ifndef ALICEO2_BASE_TRACKPARCOVBATCHTESTUTILS_H_
+#define ALICEO2_BASE_TRACKPARCOVBATCHTESTUTILS_H_
+
+#include <array>
+#include <random>
+#include <vector>
+#include "DetectorsBase/TrackParCovBatch.h"
+
+namespace o2
+{
+namespace Base
+{
+namespace Track
+{
+namespace test
+{
+
+/// Alpha of the frame of a sector, in [-pi,pi]
+inline float sectorAlpha(int sec)
+{
+  float alpha = Utils::Sector2Angle(sec) * Constants::kDeg2Rad;
+  Utils::BringToPMPi(alpha);
+  return alpha;
+}
+
+/// Generate n tracks at X=x, with random direction and pt>0.2 GeV, and a positive definite covariance, in the
+/// given sector or in a random one
+inline std::vector<TrackParCov> generateTracks(int n, float x, std::mt19937& gen, int sec = -1)
+{
+  std::uniform_real_distribution<float> flat(-1.f, 1.f), sigma(0.001f, 0.1f);
+  std::uniform_int_distribution<int> sector(0, Constants::kNSectors - 1);
+  std::vector<TrackParCov> tracks;
+  for (int i = 0; i < n; i++) {
+    const std::array<float, kNParams> par = { flat(gen), 10.f * flat(gen), 0.9f * flat(gen), flat(gen),
+                                              5.f * flat(gen) };
+    std::array<float, kNParams> sig;
+    for (auto& s : sig) {
+      s = sigma(gen);
+    }
+    std::array<float, kCovMatSize> cov;
+    for (int i1 = 0, ic = 0; i1 < kNParams; i1++) {
+      for (int i2 = 0; i2 <= i1; i2++, ic++) {
+        cov[ic] = sig[i1] * sig[i2] * (i1 == i2 ? 1.f : 0.2f * flat(gen));
+      }
+    }
+    tracks.emplace_back(x, sectorAlpha(sec < 0 ? sector(gen) : sec), par, cov);
+  }
+  return tracks;
+}
+
+/// Fill the batch with the tracks
+inline void fillBatch(TrackParCovBatch& batch, const std::vector<TrackParCov>& tracks)
+{
+  batch.Resize(tracks.size());
+  for (size_t i = 0; i < tracks.size(); i++) {
+    batch.SetTrack(i, tracks[i]);
+  }
+}
+
+} // namespace test
+} // namespace Track
+} // namespace Base
+} // namespace o2
+
+#endif
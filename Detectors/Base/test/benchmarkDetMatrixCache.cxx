@@ -0,0 +1,49 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkDetMatrixCache.cxx
+/// \brief Benchmark of the batched Local to Tracking transformation of clusters against the one of Transform3D
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DetectorsBase/DetMatrixCache.h"
+#include "DetMatrixCacheTestUtils.h"
+
+using namespace o2::Base;
+
+int main()
+{
+  std::mt19937 gen(2);
+  const int nSensors = 24120; // number of ITS chips
+  MatrixCache<Transform3D> cache;
+  test::fillCache(cache, nSensors, gen);
+  for (int n : { 10000, 1000000 }) {
+    std::vector<Point3D<float>> points, out(n);
+    std::vector<int> sensIDs;
+    test::generatePoints(n, nSensors, gen, points, sensIDs);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < n; i++) {
+      out[i] = cache.getMatrix(sensIDs[i]) ^ (points[i]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double refTime = std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    cache.inverseTransformPoints(sensIDs.data(), points.data(), out.data(), n);
+    end = std::chrono::high_resolution_clock::now();
+    const double time = std::chrono::duration<double>(end - start).count();
+    std::cout << n << " points transformed: batch " << time * 1e3 << " ms, Transform3D " << refTime * 1e3 << " ms"
+              << std::endl;
+  }
+  return 0;
+}
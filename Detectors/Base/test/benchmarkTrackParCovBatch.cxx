@@ -0,0 +1,59 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkTrackParCovBatch.cxx
+/// \brief Benchmark of the propagation and update of the TrackParCovBatch against the ones of TrackParCov
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DetectorsBase/TrackParCovBatch.h"
+#include "TrackParCovBatchTestUtils.h"
+
+using namespace o2::Base::Track;
+
+int main()
+{
+  std::mt19937 gen(4);
+  const float kRadius[] = { 2.3f, 3.1f, 3.9f, 19.6f, 24.6f, 34.4f, 39.3f };
+  for (int n : { 1000, 100000 }) {
+    auto tracks = test::generateTracks(n, 1.f, gen);
+    TrackParCovBatch batch;
+    test::fillBatch(batch, tracks);
+    std::vector<float> y(n), z(n), sigY2(n, 1e-4f), sigZY(n, 0.f), sigZ2(n, 1e-4f);
+
+    // propagation through the ITS layers, with an update on each of them
+    double time = 0, refTime = 0;
+    for (float x : kRadius) {
+      auto start = std::chrono::high_resolution_clock::now();
+      for (auto& track : tracks) {
+        if (track.PropagateTo(x, 5.f)) {
+          track.Update({ track.GetY(), track.GetZ() }, { 1e-4f, 0.f, 1e-4f });
+        }
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      refTime += std::chrono::duration<double>(end - start).count();
+
+      start = std::chrono::high_resolution_clock::now();
+      batch.PropagateTo(x, 5.f);
+      for (int i = 0; i < n; i++) {
+        y[i] = batch.GetParam(i, kY);
+        z[i] = batch.GetParam(i, kZ);
+      }
+      batch.Update(y.data(), z.data(), sigY2.data(), sigZY.data(), sigZ2.data());
+      end = std::chrono::high_resolution_clock::now();
+      time += std::chrono::duration<double>(end - start).count();
+    }
+    std::cout << n << " tracks propagated and updated on " << sizeof(kRadius) / sizeof(float)
+              << " layers: batch " << time * 1e3 << " ms, TrackParCov " << refTime * 1e3 << " ms" << std::endl;
+  }
+  return 0;
+}
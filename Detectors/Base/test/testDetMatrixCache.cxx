@@ -0,0 +1,130 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test DetMatrixCache
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <TFile.h>
+#include "DetectorsBase/DetMatrixCache.h"
+#include "DetMatrixCacheTestUtils.h"
+
+using namespace o2::Base;
+using test::fillCache;
+using test::generatePoints;
+
+namespace {
+
+/// Compare the batched transformations of the points, grouped by sensor or not, with the ones of the matrices
+template <typename T>
+void checkTransforms(const MatrixCache<T>& cache, std::vector<Point3D<float>> points, std::vector<int> sensIDs,
+                     std::mt19937& gen)
+{
+  const int n = points.size();
+  std::vector<Point3D<float>> out(n);
+  for (bool grouped : { true, false }) {
+    if (!grouped) {
+      std::vector<int> order(n);
+      std::iota(order.begin(), order.end(), 0);
+      std::shuffle(order.begin(), order.end(), gen);
+      auto points0 = points;
+      auto sensIDs0 = sensIDs;
+      for (int i = 0; i < n; i++) {
+        points[i] = points0[order[i]];
+        sensIDs[i] = sensIDs0[order[i]];
+      }
+    }
+    for (bool inverse : { false, true }) {
+      if (inverse) {
+        cache.inverseTransformPoints(sensIDs.data(), points.data(), out.data(), n);
+      } else {
+        cache.transformPoints(sensIDs.data(), points.data(), out.data(), n);
+      }
+      for (int i = 0; i < n; i++) {
+        const auto& mat = cache.getMatrix(sensIDs[i]);
+        const auto ref = inverse ? mat ^ (points[i]) : mat(points[i]);
+        BOOST_CHECK_SMALL(out[i].X() - ref.X(), 1e-4f);
+        BOOST_CHECK_SMALL(out[i].Y() - ref.Y(), 1e-4f);
+        BOOST_CHECK_SMALL(out[i].Z() - ref.Z(), 1e-4f);
+      }
+    }
+  }
+
+  // points of a single sensor, transformed in place
+  const int id = sensIDs[0];
+  out = points;
+  cache.inverseTransformPoints(id, out.data(), out.data(), n);
+  cache.transformPoints(id, out.data(), out.data(), n);
+  for (int i = 0; i < n; i++) {
+    BOOST_CHECK_SMALL(out[i].X() - points[i].X(), 1e-4f);
+    BOOST_CHECK_SMALL(out[i].Y() - points[i].Y(), 1e-4f);
+    BOOST_CHECK_SMALL(out[i].Z() - points[i].Z(), 1e-4f);
+  }
+}
+}
+
+/// @brief Compare the batched transformations of the points with the ones of Transform3D and Rotation2D
+BOOST_AUTO_TEST_CASE(MatrixCache_transformPoints)
+{
+  std::mt19937 gen(1);
+  const int nSensors = 100;
+  MatrixCache<Transform3D> cache3D;
+  MatrixCache<Rotation2D> cache2D;
+  fillCache(cache3D, nSensors, gen);
+  fillCache(cache2D, nSensors, gen);
+  std::vector<Point3D<float>> points;
+  std::vector<int> sensIDs;
+  // a number of points which is not a multiple of the SIMD width
+  generatePoints(1003, nSensors, gen, points, sensIDs);
+  checkTransforms(cache3D, points, sensIDs, gen);
+  checkTransforms(cache2D, points, sensIDs, gen);
+}
+
+/// @brief Check the batched transformations of caches read from file, whose flat copies of the matrices are not stored
+BOOST_AUTO_TEST_CASE(MatrixCache_ROOTIO)
+{
+  std::mt19937 gen(3);
+  const int nSensors = 100;
+  {
+    MatrixCache<Transform3D> cache3D;
+    MatrixCache<Rotation2D> cache2D;
+    fillCache(cache3D, nSensors, gen);
+    fillCache(cache2D, nSensors, gen);
+    TFile fout("MatrixCacheIO.root", "RECREATE");
+    fout.WriteObject(&cache3D, "cache3D");
+    fout.WriteObject(&cache2D, "cache2D");
+    fout.Close();
+  }
+
+  TFile fin("MatrixCacheIO.root");
+  MatrixCache<Transform3D>* cache3D = nullptr;
+  MatrixCache<Rotation2D>* cache2D = nullptr;
+  fin.GetObject("cache3D", cache3D);
+  fin.GetObject("cache2D", cache2D);
+  fin.Close();
+  BOOST_REQUIRE(cache3D != nullptr && cache2D != nullptr);
+  BOOST_CHECK_EQUAL(cache3D->getSize(), nSensors);
+  BOOST_CHECK_EQUAL(cache2D->getSize(), nSensors);
+
+  std::vector<Point3D<float>> points;
+  std::vector<int> sensIDs;
+  generatePoints(1003, nSensors, gen, points, sensIDs);
+  checkTransforms(*cache3D, points, sensIDs, gen);
+  checkTransforms(*cache2D, points, sensIDs, gen);
+
+  // a matrix assigned after reading refills the flat copy
+  cache2D->setMatrix(Rotation2D(0.5f), 0);
+  checkTransforms(*cache2D, points, sensIDs, gen);
+  delete cache3D;
+  delete cache2D;
+}
@@ -0,0 +1,157 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TrackParCovBatch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <cmath>
+#include "DetectorsBase/TrackParCovBatch.h"
+#include "TrackParCovBatchTestUtils.h"
+
+using namespace o2::Base;
+using namespace o2::Base::Track;
+using test::sectorAlpha;
+using test::generateTracks;
+using test::fillBatch;
+
+namespace {
+
+std::array<float, kCovMatSize> getCov(const TrackParCov& t)
+{
+  return { t.GetSigmaY2(), t.GetSigmaZY(), t.GetSigmaZ2(), t.GetSigmaSnpY(), t.GetSigmaSnpZ(),
+           t.GetSigmaSnp2(), t.GetSigmaTglY(), t.GetSigmaTglZ(), t.GetSigmaTglSnp(), t.GetSigmaTgl2(),
+           t.GetSigma1PtY(), t.GetSigma1PtZ(), t.GetSigma1PtSnp(), t.GetSigma1PtTgl(), t.GetSigma1Pt2() };
+}
+
+/// Compare the tracks and their status in the batch with the ones given by the scalar code
+void checkTracks(const TrackParCovBatch& batch, const std::vector<TrackParCov>& tracks, const std::vector<bool>& ok)
+{
+  BOOST_REQUIRE_EQUAL(batch.GetSize(), int(tracks.size()));
+  int nOK = 0;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    BOOST_CHECK_EQUAL(batch.IsOK(i), bool(ok[i]));
+    nOK += ok[i];
+    const auto& ref = tracks[i];
+    BOOST_CHECK_SMALL(batch.GetX(i) - ref.GetX(), 1e-5f * (1.f + std::abs(ref.GetX())));
+    BOOST_CHECK_SMALL(batch.GetAlpha(i) - ref.GetAlpha(), 1e-5f);
+    for (int ip = 0; ip < kNParams; ip++) {
+      BOOST_CHECK_SMALL(batch.GetParam(i, ip) - ref.GetParam()[ip], 1e-4f * (1.f + std::abs(ref.GetParam()[ip])));
+    }
+    const auto cov = getCov(ref);
+    for (int i1 = 0, ic = 0; i1 < kNParams; i1++) {
+      for (int i2 = 0; i2 <= i1; i2++, ic++) {
+        const float scale = std::sqrt(cov[i1 * (i1 + 3) / 2] * cov[i2 * (i2 + 3) / 2]);
+        BOOST_CHECK_SMALL(batch.GetCov(i, ic) - cov[ic], 1e-4f * scale);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(batch.GetNumberOfOK(), nOK);
+}
+}
+
+/// @brief Compare the propagation of the batch with the one of TrackParCov, with and without field
+BOOST_AUTO_TEST_CASE(TrackParCovBatch_propagate)
+{
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> radius(3.f, 45.f);
+  for (float b : { 5.f, 0.f }) {
+    // a number of tracks which is not a multiple of the SIMD width
+    auto tracks = generateTracks(1003, 4.f, gen);
+    TrackParCovBatch batch;
+    fillBatch(batch, tracks);
+    std::vector<bool> ok(tracks.size(), true);
+
+    // common X, a large fraction of the low pt tracks fail
+    for (size_t i = 0; i < tracks.size(); i++) {
+      ok[i] = tracks[i].PropagateTo(40.f, b);
+    }
+    BOOST_CHECK_EQUAL(batch.PropagateTo(40.f, b), std::count(ok.begin(), ok.end(), true));
+    checkTracks(batch, tracks, ok);
+
+    // X of each track, the failed tracks are skipped
+    std::vector<float> xk(tracks.size());
+    for (size_t i = 0; i < tracks.size(); i++) {
+      xk[i] = radius(gen);
+      ok[i] = ok[i] && tracks[i].PropagateTo(xk[i], b);
+    }
+    BOOST_CHECK_EQUAL(batch.PropagateTo(xk.data(), b), std::count(ok.begin(), ok.end(), true));
+    checkTracks(batch, tracks, ok);
+  }
+}
+
+/// @brief Compare the rotation of the batch with the one of TrackParCov
+BOOST_AUTO_TEST_CASE(TrackParCovBatch_rotate)
+{
+  std::mt19937 gen(2);
+  auto tracks = generateTracks(501, 10.f, gen, 2);
+  TrackParCovBatch batch;
+  fillBatch(batch, tracks);
+  std::vector<bool> ok(tracks.size(), true);
+
+  // rotation to the next sector, a few tracks fail
+  const float alpha = sectorAlpha(3);
+  std::vector<float> alphas(tracks.size());
+  for (size_t i = 0; i < tracks.size(); i++) {
+    ok[i] = tracks[i].Rotate(alpha);
+  }
+  BOOST_CHECK_EQUAL(batch.Rotate(alpha), std::count(ok.begin(), ok.end(), true));
+  checkTracks(batch, tracks, ok);
+
+  // rotation to the sectors 2, 3 and 4
+  for (size_t i = 0; i < tracks.size(); i++) {
+    alphas[i] = sectorAlpha(3 + (i % 3) - 1);
+    ok[i] = ok[i] && tracks[i].Rotate(alphas[i]);
+  }
+  BOOST_CHECK_EQUAL(batch.Rotate(alphas.data()), std::count(ok.begin(), ok.end(), true));
+  checkTracks(batch, tracks, ok);
+}
+
+/// @brief Compare the chi2 and the update with space points of the batch with the ones of TrackParCov
+BOOST_AUTO_TEST_CASE(TrackParCovBatch_update)
+{
+  std::mt19937 gen(3);
+  std::normal_distribution<float> gaus;
+  auto tracks = generateTracks(777, 20.f, gen);
+  TrackParCovBatch batch;
+  fillBatch(batch, tracks);
+  const int n = tracks.size();
+  std::vector<float> y(n), z(n), sigY2(n), sigZY(n), sigZ2(n), chi2(n);
+  for (int i = 0; i < n; i++) {
+    sigY2[i] = 1e-4f * (1.f + i % 5);
+    sigZ2[i] = 2e-4f * (1.f + i % 3);
+    sigZY[i] = 0.1f * std::sqrt(sigY2[i] * sigZ2[i]);
+    y[i] = tracks[i].GetY() + 0.1f * gaus(gen);
+    z[i] = tracks[i].GetZ() + 0.1f * gaus(gen);
+  }
+  // some tracks are flagged as failed before, they must be skipped
+  std::vector<bool> ok(n, true);
+  for (int i = 0; i < n; i += 10) {
+    batch.SetOK(i, false);
+    ok[i] = false;
+  }
+
+  batch.GetPredictedChi2(y.data(), z.data(), sigY2.data(), sigZY.data(), sigZ2.data(), chi2.data());
+  for (int i = 0; i < n; i++) {
+    if (ok[i]) {
+      BOOST_CHECK_CLOSE(chi2[i], tracks[i].GetPredictedChi2({ y[i], z[i] }, { sigY2[i], sigZY[i], sigZ2[i] }), 1e-2);
+    } else {
+      BOOST_CHECK_EQUAL(chi2[i], Constants::kVeryBig);
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    ok[i] = ok[i] && tracks[i].Update({ y[i], z[i] }, { sigY2[i], sigZY[i], sigZ2[i] });
+  }
+  BOOST_CHECK_EQUAL(batch.Update(y.data(), z.data(), sigY2.data(), sigZY.data(), sigZ2.data()),
+                    std::count(ok.begin(), ok.end(), true));
+  checkTracks(batch, tracks, ok);
+}
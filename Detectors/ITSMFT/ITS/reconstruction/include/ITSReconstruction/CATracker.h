@@ -21,10 +21,12 @@
 
 #include <vector>
 #include <array>
+#include <memory>
 
 #include "ITSReconstruction/CAaux.h"
 #include "ITSReconstruction/CATrackingStation.h"
 #include "DetectorsBase/Track.h"
+#include "CommonUtils/ThreadPool.h"
 
 namespace o2 {
   namespace ITS {
@@ -33,6 +35,9 @@ namespace o2 {
 
       class Tracker {
         public:
+          /// Stages of the pattern recognition, timed separately
+          enum Stage {kDoublets, kCells, kNeighbours, kRoads, kFit, kNStages};
+          //
           Tracker(TrackingStation *stations[7]);
           // These functions must be implemented
           int Clusters2Tracks();
@@ -52,6 +57,18 @@ namespace o2 {
           float    GetY() const { return mVertex[1]; }
           float    GetZ() const { return mVertex[2]; }
           template<typename F> void SetVertex(F v[3]) { for(int i=0;i<3;++i) mVertex[i]=v[i]; }
+          void     SetBz(float bz) { mBz = bz; }
+          //
+          /// Set the number of threads for the doublet, cell and neighbour finding and the road fitting,
+          /// 0 to use all available cores. The results do not depend on the number of threads.
+          void     SetNumberOfThreads(int n);
+          int      GetNumberOfThreads() const { return mNumberOfThreads; }
+          /// Wall clock time in seconds spent in a stage since the clusters were loaded
+          double   GetStageTime(int stage) const { return mStageTime[stage]; }
+          /// Doublets between the layers l and l+1 and cells starting on layer l of the last iteration
+          const std::vector<Doublets>& GetDoublets(int l) const { return mDoublets[l]; }
+          const std::vector<Cell>&     GetCells(int l)    const { return mCells[l]; }
+          const std::vector<Track>&    GetCandidates(int i) const { return mCandidates[i]; }
         private:
           Tracker(const Tracker&);
           Tracker &operator=(const Tracker &tr);
@@ -60,6 +77,11 @@ namespace o2 {
           void   CellsTreeTraversal(std::vector<Road> &roads, const int &iD, const int &doubl);
           void   FindTracksCA(int iteration);
           void   MakeCells(int iteration);
+          void   MakeDoublets(int l);
+          void   MakeCellsOnLayer(int l);
+          void   MakeNeighbours(int l);
+          void   FitRoads(std::vector<Road> &roads, int level);
+          template<typename F> int RunInChunks(int n, const F &f);
           bool   RefitAt(float xx, Track* t);
           void   SetCuts(int it);
           void   SetLabel(Track &t, float wrong);
@@ -72,6 +94,20 @@ namespace o2 {
           std::vector<Doublets>      mDoublets[6];
           std::vector<Cell>          mCells[5];
           std::vector<Track>         mCandidates[4];
+          // Offsets of the doublets of each cluster of layer l in mDoublets[l], the doublets of cluster i
+          // are [lut[i],lut[i+1])
+          std::vector<int>           mDoubletsLUT[6];
+          // Cells of layer l ordered by their outer doublet, with the offsets of each doublet
+          std::vector<int>           mInnerCells;
+          std::vector<int>           mInnerCellsLUT;
+          // Output of the chunks which are processed in parallel, compacted after each stage
+          std::vector<std::vector<Doublets>> mChunkDoublets;
+          std::vector<std::vector<Cell>>     mChunkCells;
+          std::vector<std::vector<Track>>    mChunkTracks;
+          std::vector<std::vector<int>>      mFoundBins;  // per thread output of the cluster selection
+          int                                mNumberOfThreads;
+          std::unique_ptr<o2::utils::ThreadPool> mThreadPool;
+          double                             mStageTime[kNStages];
           bool                  mSAonly;             // true if the standalone tracking only
           // Cuts
           float mCPhi;
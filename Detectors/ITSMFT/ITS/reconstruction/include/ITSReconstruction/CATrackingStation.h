@@ -69,6 +69,8 @@ namespace o2 {
           void GetBinZPhi(int ipz,int &iz,int &iphi) const {iz = GetBinZ(ipz); iphi=GetBinPhi(ipz);}
           //
           int  SelectClusters(float zmin,float zmax,float phimin,float phimax);
+          int  SelectBins(float zmin,float zmax,float phimin,float phimax,std::vector<int> &bins) const;
+          int  GetBinClusters(int bin, int &first) const;
           int  GetNFoundBins()                  const {return mFoundBins.size();}
           int  GetFoundBin(int i)               const {return mFoundBins[i];}
           int  GetFoundBinClusters(int i, int &first)  const;
@@ -100,10 +102,6 @@ namespace o2 {
           int   mNZBins;             // N cells in Z
           int   mNPhiBins;           // N cells in Phi
           //
-          int   mQueryZBmin;         // min bin in Z of the query
-          int   mQueryZBmax;         // max bin in Z of the query
-          int   mQueryPhiBmin;       // min bin in phi of the query
-          int   mQueryPhiBmax;       // max bin in phi of the query
           ClBinInfo_t* mBins;           // 2D (z,phi) grid of clusters binned in z,phi
           int* mOccBins;              // id's of bins with non-0 occupancy
           int  mNOccBins;             // number of occupied bins
@@ -120,9 +118,15 @@ namespace o2 {
       inline int TrackingStation::GetFoundBinClusters(int i, int &first)  const {
         // set the entry of the first cl.info in the mSortedClInfo
         // and return n clusters in the bin
-        ClBinInfo_t& bin = mBins[GetFoundBin(i)];
-        first = bin.first;
-        return bin.ncl;
+        return GetBinClusters(GetFoundBin(i),first);
+      }
+
+      inline int TrackingStation::GetBinClusters(int bin, int &first)  const {
+        // set the entry of the first cl.info of the bin in the mSortedClInfo
+        // and return n clusters in the bin
+        const ClBinInfo_t& binInfo = mBins[bin];
+        first = binInfo.first;
+        return binInfo.ncl;
       }
 
       inline ClsInfo_t* TrackingStation::GetNextClusterInfo() {
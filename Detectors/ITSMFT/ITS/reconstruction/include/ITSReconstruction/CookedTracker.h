@@ -21,9 +21,11 @@
 //-------------------------------------------------------------------------
 
 #include <vector>
+#include <memory>
 #include "ITSBase/GeometryTGeo.h"
 #include "MathUtils/Cartesian3D.h"
 #include "ITSReconstruction/CookedTrack.h"
+#include "CommonUtils/ThreadPool.h"
 
 namespace o2
 {
@@ -73,7 +75,7 @@ public:
   Double_t getBz() const;
   void setBz(Double_t bz) { mBz = bz; }
 
-  void setNumberOfThreads(Int_t n) { mNumOfThreads=n; }
+  void setNumberOfThreads(Int_t n);
   Int_t getNumberOfThreads() const { return mNumOfThreads; }
   
   // These functions must be implemented
@@ -92,16 +94,50 @@ public:
   
   // internal helper classes
   class ThreadData;
-  class Layer;
+  class Layer
+  {
+   public:
+    Layer();
+    Layer(const Layer&) = delete;
+    Layer& operator=(const Layer& tr) = delete;
+
+    void init();
+    Bool_t insertCluster(const Cluster* c);
+    void setR(Double_t r) { mR = r; }
+    void unloadClusters();
+    void selectClusters(std::vector<Int_t> &s, Float_t phi, Float_t dy, Float_t z, Float_t dz) const;
+    Int_t findClusterIndex(Double_t z) const;
+    Float_t getR() const { return mR; }
+    const Cluster* getCluster(Int_t i) const { return mClusters[i]; }
+    Float_t getAlphaRef(Int_t i) const { return mAlphaRef[i]; }
+    Float_t getClusterPhi(Int_t i) const { return mPhi[i]; }
+    Int_t getNumberOfClusters() const { return mClusters.size(); }
+    void  setGeometry(o2::ITS::GeometryTGeo* geom) { mGeom = geom; }
+
+   protected:
+    enum {kNSectors=21};
+
+    Float_t mR; ///< mean radius of this layer
+    const o2::ITS::GeometryTGeo* mGeom = nullptr; /// interface to geometry
+    std::vector<const Cluster*>mClusters;          ///< All clusters
+    std::vector<Float_t> mAlphaRef;          ///< alpha of the reference plane
+    std::vector<Float_t> mPhi;               ///< cluster phi
+    std::vector<Int_t> mSectors[kNSectors];  ///< Cluster indices sector-by-sector
+  };
 
  protected:
   static constexpr int kNLayers = 7;
   void loadClusters(const std::vector<Cluster> &clusters);
   void unloadClusters();
   
-  std::vector<CookedTrack> trackInThread(Int_t first, Int_t last);
-  void makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_t last);
-  void trackSeeds(std::vector<CookedTrack> &seeds);
+  void makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_t last) const;
+  void trackSeeds(std::vector<CookedTrack> &seeds) const;
+  void trackSeed(CookedTrack &track, Int_t index, const std::vector<Int_t> *usedBy, std::vector<Int_t> *selec,
+                 std::vector<Int_t> *checked) const;
+  void markUsed(const CookedTrack &track, Int_t index, std::vector<Int_t> *usedBy,
+                std::vector<Int_t> *marked = nullptr) const;
+  void runTasks(size_t nTasks, const o2::utils::ThreadPool::Task &task);
+  const Layer& getLayer(Int_t i) const { return mLayers[i]; }
 
   Bool_t attachCluster(Int_t& volID, Int_t nl, Int_t ci, CookedTrack& t, const CookedTrack& o) const;
 
@@ -112,7 +148,10 @@ public:
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> *mClsLabels = nullptr; /// Cluster MC labels
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> *mTrkLabels = nullptr; /// Track MC labels
   
+  enum {kNChunks=64}; ///< Number of chunks of seeding clusters or seeds, for the load balancing
+  enum {kNSeedsPerBlock=256}; ///< Number of seeds tracked in parallel before resolving their shared clusters
   Int_t mNumOfThreads; ///< Number of tracking threads
+  std::unique_ptr<o2::utils::ThreadPool> mThreadPool; ///< Persistent pool of the tracking threads
   
   Double_t mBz;///< Effective Z-component of the magnetic field (kG)
   Double_t mX; ///< X-coordinate of the primary vertex
@@ -123,39 +162,11 @@ public:
   Double_t mSigmaY; ///< error of the primary vertex position in Y
   Double_t mSigmaZ; ///< error of the primary vertex position in Z
 
-  static Layer sLayers[kNLayers];  ///< Layers filled with clusters
-  std::vector<CookedTrack> mSeeds; ///< Track seeds
-};
-
-class CookedTracker::Layer
-{
- public:
-  Layer();
-  Layer(const Layer&) = delete;
-  Layer& operator=(const Layer& tr) = delete;
-
-  void init();
-  Bool_t insertCluster(const Cluster* c);
-  void setR(Double_t r) { mR = r; }
-  void unloadClusters();
-  void selectClusters(std::vector<Int_t> &s, Float_t phi, Float_t dy, Float_t z, Float_t dz);
-  Int_t findClusterIndex(Double_t z) const;
-  Float_t getR() const { return mR; }
-  const Cluster* getCluster(Int_t i) const { return mClusters[i]; }
-  Float_t getAlphaRef(Int_t i) const { return mAlphaRef[i]; }
-  Float_t getClusterPhi(Int_t i) const { return mPhi[i]; }
-  Int_t getNumberOfClusters() const { return mClusters.size(); }
-  void  setGeometry(o2::ITS::GeometryTGeo* geom) { mGeom = geom; }
-
- protected:
-  enum {kNSectors=21};
-
-  Float_t mR; ///< mean radius of this layer
-  const o2::ITS::GeometryTGeo* mGeom = nullptr; /// interface to geometry
-  std::vector<const Cluster*>mClusters;          ///< All clusters
-  std::vector<Float_t> mAlphaRef;          ///< alpha of the reference plane
-  std::vector<Float_t> mPhi;               ///< cluster phi
-  std::vector<Int_t> mSectors[kNSectors];  ///< Cluster indices sector-by-sector
+  Layer mLayers[kNLayers];  ///< Layers filled with clusters
+  std::vector<std::vector<CookedTrack>> mChunkSeeds; ///< Seeds made from each chunk of seeding clusters
+  std::vector<CookedTrack> mSeeds;  ///< Sorted seeds, then the found tracks
+  std::vector<CookedTrack> mTracks; ///< Tracks found from the seeds by the threads
+  std::vector<std::vector<Int_t>> mChecked; ///< Clusters checked for each seed by the threads, with the used flag
 };
 }
 }
@@ -31,6 +31,9 @@
 // STD
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <iterator>
+#include <thread>
 // ROOT
 #include <TMath.h>
 #include <Riostream.h>
@@ -70,6 +73,17 @@ const float kmaxDZ1[6] = {1.f,1.f,1.5f,1.5f,1.5f,1.5f};
 const float kDoublTanL1 = 0.05f;
 const float kDoublPhi1 = 0.2f;
 
+// number of chunks per thread in which the clusters, doublets, cells and roads are split
+const int kChunksPerThread = 4;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+  double SecondsSince(const Clock::time_point &start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+}
+
   Tracker::Tracker(TrackingStation* stations[7])
   :mLayer(stations)
   ,mUsedClusters()
@@ -77,6 +91,16 @@ const float kDoublPhi1 = 0.2f;
   ,mPhiCut(1)
   ,mZCut(0.5f)
   ,mCandidates()
+  ,mDoubletsLUT()
+  ,mInnerCells()
+  ,mInnerCellsLUT()
+  ,mChunkDoublets(1)
+  ,mChunkCells(1)
+  ,mChunkTracks(1)
+  ,mFoundBins(1)
+  ,mNumberOfThreads(1)
+  ,mThreadPool()
+  ,mStageTime()
   ,mSAonly(true)
   ,mCPhi()
   ,mCDTanL()
@@ -86,10 +110,39 @@ const float kDoublPhi1 = 0.2f;
   ,mCDCAxy()
   ,mCDN()
    ,mCDP()
-   ,mCDZ() {
+   ,mCDZ()
+   ,mVertex()
+   ,mBz(0.f) {
      // This default constructor needs to be provided
    }
 
+void Tracker::SetNumberOfThreads(int n) {
+  if (n <= 0) n = std::max(1u, std::thread::hardware_concurrency());
+  mNumberOfThreads = n;
+  mThreadPool.reset(n > 1 ? new o2::utils::ThreadPool(n) : nullptr);
+  const int nChunks = n > 1 ? kChunksPerThread * n : 1;
+  mChunkDoublets.resize(nChunks);
+  mChunkCells.resize(nChunks);
+  mChunkTracks.resize(nChunks);
+  mFoundBins.resize(n);
+}
+
+template<typename F>
+int Tracker::RunInChunks(int n, const F &f) {
+  // Split the range [0,n) in contiguous chunks and call f(chunk,begin,end,thread) for each of them,
+  // in parallel if there is a thread pool. The chunks only depend on n and on the number of threads,
+  // the outputs of the chunks are concatenated in their order to get the same result as in serial.
+  const int nChunks = mThreadPool ? std::max(1, std::min(n, kChunksPerThread * mNumberOfThreads)) : 1;
+  if (nChunks == 1) {
+    f(0, 0, n, 0);
+    return 1;
+  }
+  mThreadPool->run(nChunks, [&](size_t chunk, int thread) {
+    f(chunk, long(n) * chunk / nChunks, long(n) * (chunk + 1) / nChunks, thread);
+  });
+  return nChunks;
+}
+
 bool Tracker::CellParams(int l, const ClsInfo_t& c1, const ClsInfo_t& c2, const ClsInfo_t& c3,
     float &curv, array<float,3> &n) {
   // Calculation of cell params and filtering using a DCA cut wrt beam line position.
@@ -254,6 +307,7 @@ void Tracker::FindTracksCA(int iteration) {
   // at least 4 points.
   const int itLevelLimit[3] = {4, 4, 1};
   for (int level = 5; level > itLevelLimit[iteration]; --level) {
+    auto start = Clock::now();
     vector<Road> roads;
     // Road finding. For each cell at level $(level) a loop on their neighbours to start building
     // the roads.
@@ -278,8 +332,21 @@ void Tracker::FindTracksCA(int iteration) {
       }
     }
 
-    // Roads fitting
-    for (size_t iR = 0; iR < roads.size(); ++iR) {
+    mStageTime[kRoads] += SecondsSince(start);
+
+    start = Clock::now();
+    FitRoads(roads, level);
+    mStageTime[kFit] += SecondsSince(start);
+  }
+}
+
+void Tracker::FitRoads(vector<Road> &roads, int level) {
+  // Roads fitting, the roads are split in chunks fitted in parallel and the candidates of the chunks
+  // are appended in the order of the roads
+  const int nChunks = RunInChunks(roads.size(), [&](int chunk, int begin, int end, int) {
+    vector<Track> &tracks = mChunkTracks[chunk];
+    tracks.clear();
+    for (int iR = begin; iR < end; ++iR) {
       if (roads[iR].N != level)
         continue;
       int indices[7] = {-1};
@@ -317,8 +384,11 @@ void Tracker::FindTracksCA(int iteration) {
       };
       Track tt{x,alp,par,cov,indices};
       if (RefitAt(2.1, &tt))
-        mCandidates[level - 2].push_back(tt);
+        tracks.push_back(tt);
     }
+  });
+  for (int chunk = 0; chunk < nChunks; ++chunk) {
+    mCandidates[level - 2].insert(mCandidates[level - 2].end(), mChunkTracks[chunk].begin(), mChunkTracks[chunk].end());
   }
 }
 
@@ -332,127 +402,176 @@ int Tracker::LoadClusters() {
     mLayer[iL]->SortClusters(mVertex);
     mUsedClusters[iL].resize(mLayer[iL]->GetNClusters(),false);
   }
+  std::fill(mStageTime, mStageTime + kNStages, 0.);
   return 0;
 }
 
 void Tracker::MakeCells(int iteration) {
-
+  // Tracklet finding and association. Each stage is split in chunks processed in parallel: the
+  // clusters of a layer are sorted in phi, so that the chunks of clusters are phi sectors, and the
+  // doublets and cells inherit this order.
   SetCuts(iteration);
-  if (iteration >= 1) {
-    for (int i = 0; i < 5; ++i)
-      vector<Cell>().swap(mCells[i]);
-    for (int i = 0; i < 6; ++i)
-      vector<Doublets>().swap(mDoublets[i]);
-  }
 
-  // Trick to speed up the navigation of the doublets array. The lookup table is build like:
-  // dLUT[l][i] = n;
-  // where n is the index inside mDoublets[l+1] of the first doublets that uses the point
-  // mLayer[l+1][i]
-  vector<int> dLUT[5];
+  auto start = Clock::now();
   for (int iL = 0; iL < 6; ++iL) {
-    if (mLayer[iL]->GetNClusters() == 0) continue;
-    if (iL < 5)
-      dLUT[iL].resize((*mLayer[iL + 1]).GetNClusters(),-1);
-    if (dLUT[iL - 1].size() == 0u)
-      continue;
-    for (int iC = 0; iC < mLayer[iL]->GetNClusters(); ++iC) {
-      const ClsInfo_t& cls = mLayer[iL]->GetClusterInfo(iC);
+    MakeDoublets(iL);
+  }
+  mStageTime[kDoublets] += SecondsSince(start);
+
+  start = Clock::now();
+  for (int iD = 0; iD < 5; ++iD) {
+    MakeCellsOnLayer(iD);
+  }
+  mStageTime[kCells] += SecondsSince(start);
+
+  // The level of the cells of a layer depends on the one of the cells of the previous layer
+  start = Clock::now();
+  for (int iD = 0; iD < 4; ++iD) {
+    MakeNeighbours(iD);
+  }
+  mStageTime[kNeighbours] += SecondsSince(start);
+}
+
+void Tracker::MakeDoublets(int iL) {
+  // Doublets between the clusters of the layers iL and iL+1. The doublets of each chunk of clusters
+  // are collected in its scratch vector, the prefix sum of the number of doublets per cluster gives
+  // the lookup table mDoubletsLUT[iL], which is used to copy the chunks to the flat mDoublets[iL].
+  const TrackingStation &layer0 = *mLayer[iL];
+  const TrackingStation &layer1 = *mLayer[iL + 1];
+  const int nClusters = layer0.GetNClusters();
+  vector<int> &lut = mDoubletsLUT[iL];
+  lut.assign(nClusters + 1, 0);
+
+  RunInChunks(nClusters, [&](int chunk, int begin, int end, int thread) {
+    vector<Doublets> &doublets = mChunkDoublets[chunk];
+    vector<int> &bins = mFoundBins[thread];
+    doublets.clear();
+    for (int iC = begin; iC < end; ++iC) {
       if (mUsedClusters[iL][iC]) {
         continue;
       }
+      const ClsInfo_t& cls = layer0.GetClusterInfo(iC);
       const float tanL = (cls.z - GetZ()) / cls.r;
       const float extz = tanL * (mkR[iL + 1] - cls.r) + cls.z;
-      const int nClust = mLayer[iL + 1]->SelectClusters(extz - 2 * mCZ, extz + 2 * mCZ,
-          cls.phi - mCPhi, cls.phi + mCPhi);
-      bool first = true;
-
-      for (int iC2 = 0; iC2 < nClust; ++iC2) {
-        const int iD2 = mLayer[iL + 1]->GetNextClusterInfoID();
-        const ClsInfo_t& cls2 = mLayer[iL + 1]->GetClusterInfo(iD2);
-        if (mUsedClusters[iL + 1][iC2]) {
-          continue;
-        }
-        const float dz = tanL * (cls2.r - cls.r) + cls.z - cls2.z;
-        if (fabs(dz) < mCDZ[iL] && CompareAngles(cls.phi, cls2.phi, mCPhi)) {
-          if (first && iL > 0) {
-            dLUT[iL - 1][iC] = mDoublets[iL].size();
-            first = false;
+      const size_t nDoublets = doublets.size();
+      layer1.SelectBins(extz - 2 * mCZ, extz + 2 * mCZ, cls.phi - mCPhi, cls.phi + mCPhi, bins);
+
+      for (const int bin : bins) {
+        int first = 0;
+        const int nClust = layer1.GetBinClusters(bin, first);
+        for (int iD2 = first; iD2 < first + nClust; ++iD2) {
+          if (mUsedClusters[iL + 1][iD2]) {
+            continue;
+          }
+          const ClsInfo_t& cls2 = layer1.GetClusterInfo(iD2);
+          const float dz = tanL * (cls2.r - cls.r) + cls.z - cls2.z;
+          if (fabs(dz) < mCDZ[iL] && CompareAngles(cls.phi, cls2.phi, mCPhi)) {
+            const float dTanL = (cls.z - cls2.z) / (cls.r - cls2.r);
+            const float phi = atan2(cls.y - cls2.y, cls.x - cls2.x);
+            doublets.emplace_back(iC,iD2,dTanL,phi);
           }
-          const float dTanL = (cls.z - cls2.z) / (cls.r - cls2.r);
-          const float phi = atan2(cls.y - cls2.y, cls.x - cls2.x);
-          mDoublets[iL].emplace_back(iC,iD2,dTanL,phi);
         }
       }
-      mLayer[iL + 1]->ResetFoundIterator();
+      lut[iC + 1] = doublets.size() - nDoublets;
     }
-  }
+  });
 
-  // Trick to speed up the navigation of the cells array. The lookup table is build like:
-  // tLUT[l][i] = n;
-  // where n is the index inside mCells[l+1] of the first cells that uses the doublet
-  // mDoublets[l+1][i]
-  vector<int> tLUT[4];
-  tLUT[0].resize(mDoublets[1].size(),-1);
-  tLUT[1].resize(mDoublets[2].size(),-1);
-  tLUT[2].resize(mDoublets[3].size(),-1);
-  tLUT[3].resize(mDoublets[4].size(),-1);
+  for (int iC = 0; iC < nClusters; ++iC) {
+    lut[iC + 1] += lut[iC];
+  }
+  mDoublets[iL].resize(lut[nClusters]);
+  RunInChunks(nClusters, [&](int chunk, int begin, int, int) {
+    std::copy(mChunkDoublets[chunk].begin(), mChunkDoublets[chunk].end(), mDoublets[iL].begin() + lut[begin]);
+  });
+}
 
-  for (int iD = 0; iD < 5; ++iD) {
-    if (mDoublets[iD + 1].size() == 0u || mDoublets[iD].size() == 0u) continue;
-
-    for (size_t iD0 = 0; iD0 < mDoublets[iD].size(); ++iD0) {
-      const int idx = mDoublets[iD][iD0].y;
-      bool first = true;
-      if (dLUT[iD][idx] == -1) continue;
-      for (size_t iD1 = dLUT[iD][idx]; iD1 < mDoublets[iD + 1].size(); ++iD1) {
-        if (idx != mDoublets[iD + 1][iD1].x) break;
-        if (fabs(mDoublets[iD][iD0].tanL - mDoublets[iD + 1][iD1].tanL) < mCDTanL &&
-            fabs(mDoublets[iD][iD0].phi - mDoublets[iD + 1][iD1].phi) < mCDPhi) {
-          const float tan = 0.5f * (mDoublets[iD][iD0].tanL + mDoublets[iD + 1][iD1].tanL);
-          const float extz = -tan * (*mLayer[iD])[mDoublets[iD][iD0].x].r +
-            (*mLayer[iD])[mDoublets[iD][iD0].x].z;
+void Tracker::MakeCellsOnLayer(int iD) {
+  // Cells made of a doublet of the layer iD and of a doublet of the layer iD+1 starting on its outer
+  // cluster, which are found through the lookup table of the doublets of the layer iD+1
+  const vector<Doublets> &doublets0 = mDoublets[iD];
+  const vector<Doublets> &doublets1 = mDoublets[iD + 1];
+  const vector<int> &lut1 = mDoubletsLUT[iD + 1];
+  mCells[iD].clear();
+  if (doublets0.empty() || doublets1.empty()) return;
+
+  size_t nCells = 0;
+  const int nChunks = RunInChunks(doublets0.size(), [&](int chunk, int begin, int end, int) {
+    vector<Cell> &cells = mChunkCells[chunk];
+    cells.clear();
+    for (int iD0 = begin; iD0 < end; ++iD0) {
+      const Doublets &d0 = doublets0[iD0];
+      for (int iD1 = lut1[d0.y]; iD1 < lut1[d0.y + 1]; ++iD1) {
+        const Doublets &d1 = doublets1[iD1];
+        if (fabs(d0.tanL - d1.tanL) < mCDTanL && fabs(d0.phi - d1.phi) < mCDPhi) {
+          const float tan = 0.5f * (d0.tanL + d1.tanL);
+          const float extz = -tan * (*mLayer[iD])[d0.x].r + (*mLayer[iD])[d0.x].z;
           if (fabs(extz - GetZ()) < mCDCAz[iD]) {
             float curv = 0.f;
             array<float,3> n {0.f};
-            if (CellParams(iD,(*mLayer[iD])[mDoublets[iD][iD0].x],(*mLayer[iD + 1])[mDoublets[iD][iD0].y],
-                  (*mLayer[iD + 2])[mDoublets[iD + 1][iD1].y],curv,n)) {
-              if (first && iD > 0) {
-                tLUT[iD - 1][iD0] = mCells[iD].size();
-                first = false;
-              }
-              mCells[iD].emplace_back(mDoublets[iD][iD0].x,mDoublets[iD][iD0].y,
-                    mDoublets[iD + 1][iD1].y,iD0,iD1,curv,n);
+            if (CellParams(iD,(*mLayer[iD])[d0.x],(*mLayer[iD + 1])[d0.y],(*mLayer[iD + 2])[d1.y],curv,n)) {
+              cells.emplace_back(d0.x,d0.y,d1.y,iD0,iD1,curv,n);
             }
           }
         }
       }
     }
+  });
+
+  // The cells own the list of their neighbours, they are moved rather than copied
+  for (int chunk = 0; chunk < nChunks; ++chunk) {
+    nCells += mChunkCells[chunk].size();
+  }
+  mCells[iD].reserve(nCells);
+  for (int chunk = 0; chunk < nChunks; ++chunk) {
+    mCells[iD].insert(mCells[iD].end(), std::make_move_iterator(mChunkCells[chunk].begin()),
+        std::make_move_iterator(mChunkCells[chunk].end()));
   }
+}
 
+void Tracker::MakeNeighbours(int iD) {
   // Adjacent cells: cells that share 2 points. In the following code adjacent cells are combined.
   // If they meet some requirements (~ same curvature, ~ same n) the innermost cell id is added
   // to the list of neighbours of the outermost cell. When the cell is added to the neighbours of
   // the outermost cell the "level" of the latter is set to the level of the innermost one + 1.
   // ( only if $(level of the innermost) + 1 > $(level of the outermost) )
-  for (int iD = 0; iD < 4; ++iD) {
-    if (mCells[iD + 1].size() == 0u || tLUT[iD].size() == 0u) continue; // TODO: dealing with holes
-    for (size_t c0 = 0; c0 < mCells[iD].size(); ++c0) {
-      const int idx = mCells[iD][c0].d1();
-      if (tLUT[iD][idx] == -1) continue;
-      for (size_t c1 = tLUT[iD][idx]; c1 < mCells[iD + 1].size(); ++c1) {
-        if (idx != mCells[iD + 1][c1].d0()) break;
-        auto& n0 = mCells[iD][c0].GetN();
-        auto& n1 = mCells[iD + 1][c1].GetN();
+  // The outermost cells are processed in parallel, each one looks up the innermost cells ending
+  // with its first doublet.
+  vector<Cell> &cells0 = mCells[iD];
+  vector<Cell> &cells1 = mCells[iD + 1];
+  if (cells0.empty() || cells1.empty()) return; // TODO: dealing with holes
+
+  // Counting sort of the innermost cells by their outer doublet, keeping the order of the cells
+  // sharing a doublet: the cells of doublet i are mInnerCells[mInnerCellsLUT[i],mInnerCellsLUT[i+1])
+  const int nDoublets = mDoublets[iD + 1].size();
+  mInnerCellsLUT.assign(nDoublets + 1, 0);
+  for (const Cell &cell : cells0) {
+    ++mInnerCellsLUT[cell.d1()];
+  }
+  for (int i = 0; i < nDoublets; ++i) {
+    mInnerCellsLUT[i + 1] += mInnerCellsLUT[i];
+  }
+  mInnerCells.resize(cells0.size());
+  for (int c0 = cells0.size() - 1; c0 >= 0; --c0) {
+    mInnerCells[--mInnerCellsLUT[cells0[c0].d1()]] = c0;
+  }
+
+  RunInChunks(cells1.size(), [&](int, int begin, int end, int) {
+    for (int c1 = begin; c1 < end; ++c1) {
+      Cell &cell1 = cells1[c1];
+      const int idx = cell1.d0();
+      for (int i = mInnerCellsLUT[idx]; i < mInnerCellsLUT[idx + 1]; ++i) {
+        const int c0 = mInnerCells[i];
+        auto& n0 = cells0[c0].GetN();
+        auto& n1 = cell1.GetN();
         const float dn2 = ((n0[0] - n1[0]) * (n0[0] - n1[0]) + (n0[1] - n1[1]) * (n0[1] - n1[1]) +
             (n0[2] - n1[2]) * (n0[2] - n1[2]));
-        const float dp = fabs(mCells[iD][c0].GetCurvature() - mCells[iD + 1][c1].GetCurvature());
+        const float dp = fabs(cells0[c0].GetCurvature() - cell1.GetCurvature());
         if (dn2 < mCDN[iD] && dp < mCDP[iD]) {
-          mCells[iD + 1][c1].Combine(mCells[iD][c0], c0);
+          cell1.Combine(cells0[c0], c0);
         }
       }
     }
-  }
+  });
 }
 
 int Tracker::PropagateBack() {
@@ -620,8 +739,10 @@ void Tracker::UnloadClusters() {
   /// This function unloads ITSU clusters from the memory
   for (int i = 0;i < 7;++i)
     mUsedClusters[i].clear();
-  for (int i = 0; i < 6; ++i)
+  for (int i = 0; i < 6; ++i) {
     mDoublets[i].clear();
+    mDoubletsLUT[i].clear();
+  }
   for (int i = 0; i < 5; ++i)
     mCells[i].clear();
   for (int i = 0; i < 4; ++i)
@@ -55,10 +55,6 @@ TrackingStation::TrackingStation() :
   ,mDPhiInv(-1)
   ,mNZBins(20)
   ,mNPhiBins(20)
-  ,mQueryZBmin(-1)
-  ,mQueryZBmax(-1)
-  ,mQueryPhiBmin(-1)
-  ,mQueryPhiBmax(-1)
   ,mBins(nullptr)
   ,mOccBins(nullptr)
   ,mNOccBins(0)
@@ -82,10 +78,6 @@ TrackingStation::TrackingStation() :
   ,mDPhiInv(-1)
   ,mNZBins(nzbins)
   ,mNPhiBins(nphibins)
-  ,mQueryZBmin(-1)
-  ,mQueryZBmax(-1)
-  ,mQueryPhiBmin(-1)
-  ,mQueryPhiBmax(-1)
   ,mBins(nullptr)
   ,mOccBins(nullptr)
   ,mNOccBins(0)
@@ -255,62 +247,44 @@ mBins[mOccBins[i]].ncl,fBins[fOccBins[i]].first);
 
 int TrackingStation::SelectClusters(float zmin,float zmax,float phimin,float phimax) {
   // prepare occupied bins in the requested region
+  mNFoundClusters = SelectBins(zmin,zmax,phimin,phimax,mFoundBins);
+  mFoundClusterIterator = mFoundBinIterator = 0;
+  return mNFoundClusters;
+}
+
+int TrackingStation::SelectBins(float zmin,float zmax,float phimin,float phimax,std::vector<int> &bins) const {
+  // fill the occupied bins in the requested region, does not modify the station and can be
+  // called concurrently with different output vectors
+  bins.clear();
   if (!mNOccBins) return 0;
   if (zmax < mZMin || zmin > mZMax || zmin > zmax) return 0;
-  mFoundBins.clear();
-  mQueryZBmin = GetZBin(zmin);
-  if (mQueryZBmin < 0) mQueryZBmin = 0;
-  mQueryZBmax = GetZBin(zmax);
-  if (mQueryZBmax >= mNZBins) mQueryZBmax = mNZBins - 1;
+  int queryZBmin = GetZBin(zmin);
+  if (queryZBmin < 0) queryZBmin = 0;
+  int queryZBmax = GetZBin(zmax);
+  if (queryZBmax >= mNZBins) queryZBmax = mNZBins - 1;
   BringTo02Pi(phimin);
   BringTo02Pi(phimax);
-  mQueryPhiBmin = GetPhiBin(phimin);
-  mQueryPhiBmax = GetPhiBin(phimax);
-  int dbz = 0;
-  mNFoundClusters = 0;
-  int nbcheck = mQueryPhiBmax - mQueryPhiBmin + 1; //TODO:(MP) check if a circular buffer is feasible
-  if (nbcheck > 0) { // no wrapping around 0-2pi, fast case
-    for (int ip = mQueryPhiBmin;ip <= mQueryPhiBmax;ip++) {
-      int binID = GetBinIndex(mQueryZBmin,ip);
-      if ( !(dbz = (mQueryZBmax-mQueryZBmin)) ) { // just one Z bin in the query range
-        ClBinInfo_t& binInfo = mBins[binID];
-        if (!binInfo.ncl) continue;
-        mNFoundClusters += binInfo.ncl;
-        mFoundBins.push_back(binID);
-        continue;
-      }
-      int binMax = binID + dbz;
-      for ( ; binID <= binMax; binID++) {
-        ClBinInfo_t& binInfo = mBins[binID];
-        if (!binInfo.ncl) continue;
-        mNFoundClusters += binInfo.ncl;
-        mFoundBins.push_back(binID);
-      }
-    }
-  } else {  // wrapping
-    nbcheck += mNPhiBins;
-    for (int ip0 = 0;ip0 <= nbcheck;ip0++) {
-      int ip = mQueryPhiBmin + ip0;
-      if (ip >= mNPhiBins) ip -= mNPhiBins;
-      int binID = GetBinIndex(mQueryZBmin,ip);
-      if ( !(dbz = (mQueryZBmax - mQueryZBmin)) ) { // just one Z bin in the query range
-        ClBinInfo_t& binInfo = mBins[binID];
-        if (!binInfo.ncl) continue;
-        mNFoundClusters += binInfo.ncl;
-        mFoundBins.push_back(binID);
-        continue;
-      }
-      int binMax = binID + dbz;
-      for (;binID <= binMax;binID++) {
-        ClBinInfo_t& binInfo = mBins[binID];
-        if (!binInfo.ncl) continue;
-        mNFoundClusters += binInfo.ncl;
-        mFoundBins.push_back(binID);
-      }
+  const int queryPhiBmin = GetPhiBin(phimin);
+  const int queryPhiBmax = GetPhiBin(phimax);
+  const int dbz = queryZBmax - queryZBmin;
+  int nFoundClusters = 0;
+  int nbcheck = queryPhiBmax - queryPhiBmin + 1; //TODO:(MP) check if a circular buffer is feasible
+  if (nbcheck <= 0) { // wrapping around 0-2pi
+    nbcheck += mNPhiBins + 1;
+  }
+  for (int ip0 = 0;ip0 < nbcheck;ip0++) {
+    int ip = queryPhiBmin + ip0;
+    if (ip >= mNPhiBins) ip -= mNPhiBins;
+    int binID = GetBinIndex(queryZBmin,ip);
+    const int binMax = binID + dbz;
+    for (;binID <= binMax;binID++) {
+      const ClBinInfo_t& binInfo = mBins[binID];
+      if (!binInfo.ncl) continue;
+      nFoundClusters += binInfo.ncl;
+      bins.push_back(binID);
     }
   }
-  mFoundClusterIterator = mFoundBinIterator = 0;
-  return mNFoundClusters;
+  return nFoundClusters;
 }
 
 int TrackingStation::GetNextClusterInfoID() {
@@ -16,8 +16,11 @@
 //                     A stand-alone ITS tracker
 //    The pattern recongintion based on the "cooked covariance" approach
 //-------------------------------------------------------------------------
-#include <future>
 #include <chrono>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <limits>
 
 #include <TGeoGlobalMagField.h>
 #include <TMath.h>
@@ -61,6 +64,10 @@ const Double_t kRoadY = 0.2;
 const Double_t kRoadZ = 0.7;
 // Minimal number of attached clusters
 const Int_t kminNumberOfClusters = 4;
+// Marks in CookedTracker::trackSeed a cluster which is not used, and a used cluster in the list of
+// the checked ones
+const Int_t kNotUsed = std::numeric_limits<Int_t>::max();
+const Int_t kUsedBit = 1 << 30;
 
 //************************************************
 // TODO:
@@ -69,9 +76,7 @@ const Int_t kminNumberOfClusters = 4;
 // Precalculate cylidnrical (r,phi) for the clusters;
 // use exact r's for the clusters
 
-CookedTracker::Layer CookedTracker::sLayers[CookedTracker::kNLayers];
-
-CookedTracker::CookedTracker(Int_t n) : mNumOfThreads(n), mBz(0.)
+CookedTracker::CookedTracker(Int_t n) : mNumOfThreads(1), mBz(0.)
 {
   //--------------------------------------------------------------------
   // This default constructor needs to be provided
@@ -79,13 +84,40 @@ CookedTracker::CookedTracker(Int_t n) : mNumOfThreads(n), mBz(0.)
   const Double_t klRadius[7] = { 2.34, 3.15, 3.93, 19.61, 24.55, 34.39, 39.34 }; // tdr6
 
   for (Int_t i = 0; i < kNLayers; i++)
-    sLayers[i].setR(klRadius[i]);
+    mLayers[i].setR(klRadius[i]);
 
   // Some default primary vertex
   Double_t xyz[] = { 0., 0., 0. };
   Double_t ers[] = { 2., 2., 2. };
 
   setVertex(xyz, ers);
+
+  setNumberOfThreads(n);
+}
+
+//__________________________________________________________________________
+void CookedTracker::setNumberOfThreads(Int_t n)
+{
+  //--------------------------------------------------------------------
+  // Set the number of tracking threads, 0 to use all available cores.
+  // The threads are kept in a pool between the calls to process().
+  //--------------------------------------------------------------------
+  if (n <= 0) n = std::max(1u, std::thread::hardware_concurrency());
+  mNumOfThreads = n;
+  mThreadPool.reset(n > 1 ? new o2::utils::ThreadPool(n) : nullptr);
+}
+
+//__________________________________________________________________________
+void CookedTracker::runTasks(size_t nTasks, const o2::utils::ThreadPool::Task &task)
+{
+  //--------------------------------------------------------------------
+  // Execute the tasks on the thread pool, or sequentially with one thread
+  //--------------------------------------------------------------------
+  if (mThreadPool) {
+    mThreadPool->run(nTasks, task);
+    return;
+  }
+  for (size_t i = 0; i < nTasks; i++) task(i, 0);
 }
 
 //__________________________________________________________________________
@@ -272,7 +304,7 @@ static CookedTrack cookSeed
   return CookedTrack(x3, alpha, par, cov);
 }
 
-void CookedTracker::makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_t last)
+void CookedTracker::makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_t last) const
 {
   //--------------------------------------------------------------------
   // This is the main pattern recongition function.
@@ -280,9 +312,9 @@ void CookedTracker::makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_
   //--------------------------------------------------------------------
   const Double_t zv = getZ();
 
-  Layer& layer1 = sLayers[kSeedingLayer1];
-  Layer& layer2 = sLayers[kSeedingLayer2];
-  Layer& layer3 = sLayers[kSeedingLayer3];
+  const Layer& layer1 = mLayers[kSeedingLayer1];
+  const Layer& layer2 = mLayers[kSeedingLayer2];
+  const Layer& layer3 = mLayers[kSeedingLayer3];
 
   const Double_t maxC = TMath::Abs(getBz() * kB2C / kminPt);
   const Double_t kpWin = TMath::ASin(0.5 * maxC * layer1.getR()) - TMath::ASin(0.5 * maxC * layer2.getR());
@@ -379,106 +411,120 @@ void CookedTracker::makeSeeds(std::vector<CookedTrack> &seeds, Int_t first, Int_
   */
 }
 
-void CookedTracker::trackSeeds(std::vector<CookedTrack> &seeds)
+void CookedTracker::trackSeeds(std::vector<CookedTrack> &seeds) const
 {
   //--------------------------------------------------------------------
   // Loop over a subset of track seeds
   //--------------------------------------------------------------------
-  std::vector<bool>  used[kSeedingLayer2];
+  std::vector<Int_t> usedBy[kSeedingLayer2];
   std::vector<Int_t> selec[kSeedingLayer2];
   for (Int_t l = kSeedingLayer2 - 1; l >= 0; l--) {
-    Int_t n=sLayers[l].getNumberOfClusters();
-    used[l].resize(n,false);
+    Int_t n=mLayers[l].getNumberOfClusters();
+    usedBy[l].resize(n,kNotUsed);
     selec[l].reserve(n/100);
   }
 
-  for (auto &track : seeds) {
-    Double_t x = track.getX();
-    Double_t y = track.getY();
-    Double_t phi = track.getAlpha() + TMath::ATan2(y, x);
-    const Float_t pi2 = 2. * TMath::Pi();
-    if (phi < 0.)
-      phi += pi2;
-    else if (phi >= pi2)
-      phi -= pi2;
-
-    Double_t z = track.getZ();
-    Double_t crv = track.getCurvature(getBz());
-    Double_t tgl = track.getTgl();
-    Double_t r1 = sLayers[kSeedingLayer2].getR();
-    
-    for (Int_t l = kSeedingLayer2 - 1; l >= 0; l--) {
-      Double_t r2 = sLayers[l].getR();
-      phi += 0.5 * crv * (r2 - r1);
-      z += tgl / (0.5 * crv) * (TMath::ASin(0.5 * crv * r2) - TMath::ASin(0.5 * crv * r1));
-      selec[l].clear();
-      sLayers[l].selectClusters(selec[l], phi, kRoadY, z, kRoadZ);
-      r1 = r2;
-    }
+  for (size_t i = 0; i < seeds.size(); i++) {
+    trackSeed(seeds[i], i, usedBy, selec, nullptr);
+    markUsed(seeds[i], i, usedBy);
+  }
+
+}
+
+void CookedTracker::trackSeed(CookedTrack &track, Int_t index, const std::vector<Int_t> *usedBy,
+                              std::vector<Int_t> *selec, std::vector<Int_t> *checked) const
+{
+  //--------------------------------------------------------------------
+  // Replace the seed number "index" by its best prolongation to the
+  // inner layers, skipping the clusters used by the previous seeds.
+  // Every cluster whose use is checked is appended to "checked", if
+  // given, with kUsedBit set if it is used: the track is the same for
+  // any "usedBy" giving the same answers for all these clusters
+  //--------------------------------------------------------------------
+  auto isUsed = [&](Int_t l, Int_t ci) {
+    Bool_t used = usedBy[l][ci] < index;
+    if (checked) checked->push_back((l << 28) + ci + (used ? kUsedBit : 0));
+    return used;
+  };
+
+  Double_t x = track.getX();
+  Double_t y = track.getY();
+  Double_t phi = track.getAlpha() + TMath::ATan2(y, x);
+  const Float_t pi2 = 2. * TMath::Pi();
+  if (phi < 0.)
+    phi += pi2;
+  else if (phi >= pi2)
+    phi -= pi2;
+
+  Double_t z = track.getZ();
+  Double_t crv = track.getCurvature(getBz());
+  Double_t tgl = track.getTgl();
+  Double_t r1 = mLayers[kSeedingLayer2].getR();
+
+  for (Int_t l = kSeedingLayer2 - 1; l >= 0; l--) {
+    Double_t r2 = mLayers[l].getR();
+    phi += 0.5 * crv * (r2 - r1);
+    z += tgl / (0.5 * crv) * (TMath::ASin(0.5 * crv * r2) - TMath::ASin(0.5 * crv * r1));
+    selec[l].clear();
+    mLayers[l].selectClusters(selec[l], phi, kRoadY, z, kRoadZ);
+    r1 = r2;
+  }
 
-    CookedTrack best(track);
+  CookedTrack best(track);
 
-    Int_t volID = -1;
-    Int_t ci = -1;
-    CookedTrack t3(track);
-    for ( auto &ci3 : selec[3] ) {
-      if (used[3][ci3]) continue;
-      if (!attachCluster(volID, 3, ci3, t3, track))
+  Int_t volID = -1;
+  CookedTrack t3(track);
+  for ( auto &ci3 : selec[3] ) {
+    if (isUsed(3, ci3)) continue;
+    if (!attachCluster(volID, 3, ci3, t3, track))
+      continue;
+
+    CookedTrack t2(t3);
+    for ( auto &ci2 : selec[2] ) {
+      if (isUsed(2, ci2)) continue;
+      if (!attachCluster(volID, 2, ci2, t2, t3))
         continue;
 
-      CookedTrack t2(t3);
-      for ( auto &ci2 : selec[2] ) {
-	if (used[2][ci2]) continue;
-        if (!attachCluster(volID, 2, ci2, t2, t3))
+      CookedTrack t1(t2);
+      for ( auto &ci1 : selec[1] ) {
+        if (isUsed(1, ci1)) continue;
+        if (!attachCluster(volID, 1, ci1, t1, t2))
           continue;
 
-        CookedTrack t1(t2);
-        for ( auto &ci1 : selec[1] ) {
-	  if (used[1][ci1]) continue;
-          if (!attachCluster(volID, 1, ci1, t1, t2))
+        CookedTrack t0(t1);
+        for ( auto &ci0 : selec[0] ) {
+          if (isUsed(0, ci0)) continue;
+          if (!attachCluster(volID, 0, ci0, t0, t1))
             continue;
-
-          CookedTrack t0(t1);
-          for ( auto &ci0 : selec[0] ) {
-	    if (used[0][ci0]) continue;
-            if (!attachCluster(volID, 0, ci0, t0, t1))
-              continue;
-            if (t0.isBetter(best, kmaxChi2PerTrack)) {
-              best = t0;
-            }
-            volID = -1;
+          if (t0.isBetter(best, kmaxChi2PerTrack)) {
+            best = t0;
           }
+          volID = -1;
         }
       }
     }
-
-    if (best.getNumberOfClusters() >= kminNumberOfClusters) {
-      Int_t noc = best.getNumberOfClusters();
-      for (Int_t ic = 3; ic < noc; ic++) {
-        Int_t index = best.getClusterIndex(ic);
-        Int_t l = (index & 0xf0000000) >> 28, c = (index & 0x0fffffff);
-        used[l][c]=true;
-      }
-    }
-    track = best;
   }
 
+  track = best;
 }
 
-std::vector<CookedTrack> CookedTracker::trackInThread(Int_t first, Int_t last)
+void CookedTracker::markUsed(const CookedTrack &track, Int_t index, std::vector<Int_t> *usedBy,
+                             std::vector<Int_t> *marked) const
 {
   //--------------------------------------------------------------------
-  // This function is passed to a tracking thread
-  //--------------------------------------------------------------------
-  std::vector<CookedTrack> seeds;
-  seeds.reserve(last-first+1);
-  
-  makeSeeds(seeds, first, last);
-  std::sort(seeds.begin(), seeds.end());
-
-  trackSeeds(seeds);
-  
-  return seeds;
+  // Mark the clusters of the inner layers attached to the good track
+  // number "index" as used, unless a previous track uses them already.
+  // The clusters which were not used yet are appended to "marked", if
+  // given
+  //--------------------------------------------------------------------
+  Int_t noc = track.getNumberOfClusters();
+  if (noc < kminNumberOfClusters) return;
+  for (Int_t ic = 3; ic < noc; ic++) {
+    Int_t ci = track.getClusterIndex(ic);
+    Int_t l = (ci & 0xf0000000) >> 28, c = (ci & 0x0fffffff);
+    if (usedBy[l][c] == kNotUsed && marked) marked->push_back(ci);
+    usedBy[l][c] = std::min(usedBy[l][c], index);
+  }
 }
 
 void CookedTracker::process(const std::vector<Cluster> &clusters, std::vector<CookedTrack> &tracks)
@@ -495,7 +541,6 @@ void CookedTracker::process(const std::vector<Cluster> &clusters, std::vector<Co
   // Seeding with the triggered primary vertex
   Double_t xyz[3]{ 0, 0, 0 }; // FIXME
   setVertex(xyz);
-  //mSeeds = makeSeeds(0, sLayers[kSeedingLayer1].getNumberOfClusters());
 
   // Seeding with the pileup primary vertices
   /* FIXME
@@ -515,32 +560,109 @@ void CookedTracker::process(const std::vector<Cluster> &clusters, std::vector<Co
   LOG(INFO)<<"Loading time: "<<diff.count()<<" s"<<FairLogger::endl;
 
 
-  std::vector<std::future<std::vector<CookedTrack>>> futures(mNumOfThreads);
-  std::vector<std::vector<CookedTrack>> seedArray(mNumOfThreads);
-  
-  Int_t numOfClusters = sLayers[kSeedingLayer1].getNumberOfClusters();
-  for (Int_t t=0,first=0; t<mNumOfThreads; t++) {
-    Int_t rem = t < (numOfClusters % mNumOfThreads) ? 1 : 0;
-    Int_t last = first + (numOfClusters/mNumOfThreads) + rem;
-    futures[t] = std::async(std::launch::async, &CookedTracker::trackInThread, this, first, last);
-    first = last;
+  // The seeds are made from chunks of the seeding clusters, which are picked up by the threads as
+  // they become idle, and sorted all together as with a single chunk.
+  Int_t numOfClusters = mLayers[kSeedingLayer1].getNumberOfClusters();
+  Int_t nChunks = std::max(1, std::min(numOfClusters, Int_t(kNChunks)));
+  if (Int_t(mChunkSeeds.size()) < nChunks) mChunkSeeds.resize(nChunks);
+
+  runTasks(nChunks, [&](size_t chunk, int) {
+    Int_t first = Long64_t(numOfClusters)*chunk/nChunks, last = Long64_t(numOfClusters)*(chunk + 1)/nChunks;
+    auto &seeds = mChunkSeeds[chunk];
+    seeds.clear();
+    seeds.reserve(last-first+1);
+    makeSeeds(seeds, first, last);
+  });
+  mSeeds.clear();
+  for (Int_t c=0; c<nChunks; c++) {
+    mSeeds.insert(mSeeds.end(), mChunkSeeds[c].begin(), mChunkSeeds[c].end());
   }
-  
-  Int_t nSeeds = 0, ngood=0;
-  for (Int_t t=0; t<mNumOfThreads; t++) {
-    seedArray[t] = futures[t].get();
-    nSeeds += seedArray[t].size();
-    for (auto &track : seedArray[t]) {
-      if (track.getNumberOfClusters() < kminNumberOfClusters) continue;
+  std::sort(mSeeds.begin(), mSeeds.end());
+  const Int_t nSeeds = mSeeds.size();
+
+  // A cluster used by a track is excluded for all the following seeds. With several threads, the
+  // sorted seeds are processed in blocks, whose seeds are first tracked in parallel excluding the
+  // clusters of the previous blocks only. Then, while the tracks of some seeds use a cluster which
+  // was checked with a different answer for a following seed of the block, these seeds are tracked
+  // again in parallel. This converges to the tracks of the single thread sequence, so that they do
+  // not depend on the number of threads.
+  if (!mThreadPool) {
+    trackSeeds(mSeeds);
+  } else {
+    std::vector<Int_t> usedBy[kSeedingLayer2];
+    for (Int_t l = kSeedingLayer2 - 1; l >= 0; l--) {
+      usedBy[l].resize(mLayers[l].getNumberOfClusters(), kNotUsed);
+    }
+    if (Int_t(mChecked.size()) < nSeeds) mChecked.resize(nSeeds);
+    mTracks.resize(nSeeds);
+    std::vector<Int_t> pending, marked;
+
+    for (Int_t begin = 0; begin < nSeeds; begin += kNSeedsPerBlock) {
+      const Int_t end = std::min(nSeeds, begin + Int_t(kNSeedsPerBlock));
+      pending.resize(end - begin);
+      std::iota(pending.begin(), pending.end(), begin);
+      marked.clear();
+
+      while (!pending.empty()) {
+        const Int_t nPending = pending.size();
+        nChunks = std::min(nPending, Int_t(kNChunks));
+        runTasks(nChunks, [&](size_t chunk, int) {
+          std::vector<Int_t> selec[kSeedingLayer2];
+          for (Int_t k = Long64_t(nPending)*chunk/nChunks; k < Long64_t(nPending)*(chunk + 1)/nChunks; k++) {
+            Int_t i = pending[k];
+            mTracks[i] = mSeeds[i];
+            mChecked[i].clear();
+            trackSeed(mTracks[i], i, usedBy, selec, &mChecked[i]);
+          }
+        });
+
+        // the clusters used by the tracks of the block are marked again
+        for (auto ci : marked) {
+          usedBy[(ci & 0xf0000000) >> 28][ci & 0x0fffffff] = kNotUsed;
+        }
+        marked.clear();
+        for (Int_t i=begin; i<end; i++) {
+          markUsed(mTracks[i], i, usedBy, &marked);
+        }
+        pending.clear();
+        for (Int_t i=begin; i<end; i++) {
+          if (std::any_of(mChecked[i].begin(), mChecked[i].end(), [&](Int_t ci) {
+                Int_t l = (ci & 0x30000000) >> 28, c = (ci & 0x0fffffff);
+                return (usedBy[l][c] < i) != Bool_t(ci & kUsedBit); })) {
+            pending.push_back(i);
+          }
+        }
+      }
+    }
+    mSeeds.swap(mTracks);
+  }
+  mSeeds.erase(std::remove_if(mSeeds.begin(), mSeeds.end(),
+    [](const CookedTrack &t) { return t.getNumberOfClusters() < kminNumberOfClusters; }), mSeeds.end());
+
+  // The tracks are labelled by chunks and written directly at their final position in the output
+  Int_t ngood=0;
+  const Int_t nTracks = mSeeds.size();
+  const size_t firstTrack = tracks.size();
+  tracks.resize(firstTrack + nTracks);
+  std::vector<Label> labels(mTrkLabels ? nTracks : 0);
+
+  nChunks = std::max(1, std::min(nTracks, Int_t(kNChunks)));
+  runTasks(nChunks, [&](size_t chunk, int) {
+    Int_t first = Long64_t(nTracks)*chunk/nChunks, last = Long64_t(nTracks)*(chunk + 1)/nChunks;
+    for (Int_t i=first; i<last; i++) {
+      auto &track = mSeeds[i];
       if (mTrkLabels) {
-         Label label = cookLabel(track, 0.); // For comparison only
-         if (label.getTrackID() >= 0) ngood++;
-         Int_t idx=tracks.size();
-	 mTrkLabels->addElement(idx,label);
+        labels[i] = cookLabel(track, 0.); // For comparison only
       }
       setExternalIndices(track);
-      tracks.push_back(track);
+      tracks[firstTrack + i] = track;
     }
+  });
+
+  // The MC truth container is filled sequentially, in the order of the tracks
+  for (size_t i=0; i<labels.size(); i++) {
+    if (labels[i].getTrackID() >= 0) ngood++;
+    mTrkLabels->addElement(firstTrack + i, labels[i]);
   }
 
   end = std::chrono::system_clock::now();
@@ -629,7 +751,7 @@ refitAt(Double_t xx, CookedTrack *t, const CookedTrack *c) {
         Double_t chi2=t->getPredictedChi2(cl);
         if (chi2 < kmaxChi2PerCluster) t->update(cl, chi2, idx);
      } else {
-        Double_t r=sLayers[i].getR();
+        Double_t r=mLayers[i].getR();
         Double_t phi,z;
         if (!t->GetPhiZat(r,phi,z)) {
            //Warning("refitAt","failed to estimate track !\n");
@@ -709,19 +831,11 @@ void CookedTracker::loadClusters(const std::vector<Cluster> &clusters)
     //    if ((layer == kSeedingLayer1) || (layer == kSeedingLayer2) || (layer == kSeedingLayer3))
     //      c->goToFrameGlo();
 
-    if (!sLayers[layer].insertCluster(&c))
+    if (!mLayers[layer].insertCluster(&c))
       continue;
   }
 
-  std::vector<std::future<void>> fut;
-  for (Int_t l = 0; l < kNLayers; l+=mNumOfThreads) {
-    for (Int_t t = 0; t < mNumOfThreads; t++) {
-      if (l+t >= kNLayers) break;
-      auto f=std::async(std::launch::async, &CookedTracker::Layer::init, sLayers+(l+t));
-      fut.push_back(std::move(f));
-    }
-    for (Int_t t = 0; t < fut.size(); t++) fut[t].wait();
-  }
+  runTasks(kNLayers, [this](size_t l, int) { mLayers[l].init(); });
 }
 
 void CookedTracker::unloadClusters()
@@ -730,7 +844,7 @@ void CookedTracker::unloadClusters()
   // This function unloads ITSU clusters from the RAM
   //--------------------------------------------------------------------
   for (Int_t i = 0; i < kNLayers; i++)
-    sLayers[i].unloadClusters();
+    mLayers[i].unloadClusters();
 }
 
 const Cluster* CookedTracker::getCluster(Int_t index) const
@@ -740,7 +854,7 @@ const Cluster* CookedTracker::getCluster(Int_t index) const
   //--------------------------------------------------------------------
   Int_t l = (index & 0xf0000000) >> 28;
   Int_t c = (index & 0x0fffffff) >> 00;
-  return sLayers[l].getCluster(c);
+  return mLayers[l].getCluster(c);
 }
 
 CookedTracker::Layer::Layer() : mR(0)
@@ -811,7 +925,7 @@ Int_t CookedTracker::Layer::findClusterIndex(Double_t z) const
 }
 
 void
-CookedTracker::Layer::selectClusters(std::vector<Int_t>&selec, Float_t phi, Float_t dy, Float_t z, Float_t dz)
+CookedTracker::Layer::selectClusters(std::vector<Int_t>&selec, Float_t phi, Float_t dy, Float_t z, Float_t dz) const
 {
   //--------------------------------------------------------------------
   // This function selects clusters within the "road"
@@ -855,7 +969,7 @@ Bool_t CookedTracker::attachCluster(Int_t& volID, Int_t nl, Int_t ci, CookedTrac
   //--------------------------------------------------------------------
   // Try to attach a clusters with index ci to running track hypothesis
   //--------------------------------------------------------------------
-  Layer& layer = sLayers[nl];
+  const Layer& layer = mLayers[nl];
   const Cluster* c = layer.getCluster(ci);
 
   Int_t vid = c->getSensorID();
@@ -887,5 +1001,5 @@ void CookedTracker::setGeometry(o2::ITS::GeometryTGeo* geom)
 {
   /// attach geometry interface
   mGeom = geom;
-  for (Int_t i = 0; i < kNLayers; i++) sLayers[i].setGeometry(geom);
+  for (Int_t i = 0; i < kNLayers; i++) mLayers[i].setGeometry(geom);
 }
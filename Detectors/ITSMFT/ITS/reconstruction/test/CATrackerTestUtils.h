@@ -0,0 +1,110 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CATrackerTestUtils.h
+/// \brief Event generation and tracker runs shared by the tests and benchmarks of the CA tracker
+
+#ifndef ALICEO2_ITS_CA_TRACKERTESTUTILS_H_
+#define ALICEO2_ITS_CA_TRACKERTESTUTILS_H_
+
+#include "ITSReconstruction/CATracker.h"
+#include "ITSReconstruction/CATrackingStation.h"
+#include "DetectorsBase/Constants.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace o2 {
+namespace ITS {
+namespace CA {
+namespace test {
+
+  /// Radii of the 7 layers
+  const float kRadius[7] = {2.33959,3.14076,3.91924,19.6213,24.5597,34.388,39.3329};
+
+  /// Tracking station filled with the given clusters, all belonging to a single sensor
+  class TestStation : public TrackingStation {
+    public:
+      TestStation(int id, const std::vector<ClsInfo_t>& clusters)
+        : TrackingStation(id, -kRadius[id] - 1.f, kRadius[id] + 1.f, 40, 64)
+      {
+        mDZInv = mNZBins / (mZMax - mZMin);
+        mDPhiInv = mNPhiBins / o2::Base::Constants::k2PI;
+        mBins = new ClBinInfo_t[mNZBins * mNPhiBins]();
+        mOccBins = new int[mNZBins * mNPhiBins]();
+        mNClusters = clusters.size();
+        mIndex.push_back(0);
+        mDetectors.push_back(ITSDetInfo_t{0, kRadius[id], kRadius[id], 0.f, 0.f, 1.f});
+        for (auto cl : clusters) {
+          cl.zphibin = GetBinIndex(GetZBin(cl.z), GetPhiBin(cl.phi));
+          mSortedClInfo.push_back(cl);
+        }
+      }
+  };
+
+  /// Generate the clusters of nTracks tracks from the origin on circles of radius > 50 cm, plus
+  /// nNoise noise clusters per layer
+  inline std::vector<std::unique_ptr<TestStation>> makeEvent(int nTracks, int nNoise, std::mt19937& gen)
+  {
+    std::uniform_real_distribution<float> phi(0, o2::Base::Constants::k2PI), tanL(-0.8, 0.8), flat(-1, 1);
+    std::uniform_real_distribution<float> radius(50, 1000);
+    std::vector<ClsInfo_t> clusters[7];
+    auto addCluster = [&clusters](int layer, float r, float phi, float z, int label) {
+      ClsInfo_t cl;
+      cl.x = r * std::cos(phi);
+      cl.y = r * std::sin(phi);
+      cl.z = z;
+      cl.r = r;
+      cl.phi = std::atan2(cl.y, cl.x);
+      if (cl.phi < 0) cl.phi += o2::Base::Constants::k2PI;
+      cl.cov = {{1e-6f, 0.f, 1e-6f}};
+      cl.detid = 0;
+      cl.label = label;
+      clusters[layer].push_back(cl);
+    };
+    for (int iTrack = 0; iTrack < nTracks; ++iTrack) {
+      const float phi0 = phi(gen), t = tanL(gen), R = radius(gen), charge = flat(gen) < 0 ? -1 : 1;
+      for (int iL = 0; iL < 7; ++iL) {
+        addCluster(iL, kRadius[iL], phi0 + charge * std::asin(kRadius[iL] / (2 * R)), t * kRadius[iL], iTrack);
+      }
+    }
+    for (int iL = 0; iL < 7; ++iL) {
+      for (int iNoise = 0; iNoise < nNoise; ++iNoise) {
+        addCluster(iL, kRadius[iL], phi(gen), kRadius[iL] * flat(gen), -1);
+      }
+    }
+    std::vector<std::unique_ptr<TestStation>> stations;
+    for (int iL = 0; iL < 7; ++iL) {
+      stations.emplace_back(new TestStation(iL, clusters[iL]));
+    }
+    return stations;
+  }
+
+  /// Run the tracker on an event with the given number of threads
+  inline std::unique_ptr<Tracker> runTracker(std::vector<std::unique_ptr<TestStation>>& event, TrackingStation* layers[7], int nThreads)
+  {
+    for (int iL = 0; iL < 7; ++iL) layers[iL] = event[iL].get();
+    std::unique_ptr<Tracker> tracker(new Tracker(layers));
+    float vertex[3] = {0.f, 0.f, 0.f};
+    tracker->SetVertex(vertex);
+    tracker->SetBz(5.f);
+    tracker->SetNumberOfThreads(nThreads);
+    tracker->LoadClusters();
+    tracker->Clusters2Tracks();
+    return tracker;
+  }
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkCATracker.cxx
+/// \brief Benchmark of the stages of the CA tracker for a growing number of threads
+
+#include "ITSReconstruction/CATracker.h"
+#include "CATrackerTestUtils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace o2::ITS::CA;
+
+int main()
+{
+  const int nCores = std::max(1u, std::thread::hardware_concurrency());
+  const char* stages[Tracker::kNStages] = {"doublets", "cells", "neighbours", "roads", "fit"};
+
+  for (int nTracks : {500, 2000}) {
+    for (int nThreads = 1; ; nThreads = std::min(2*nThreads, nCores)) {
+      std::mt19937 gen(1);
+      auto event = test::makeEvent(nTracks, nTracks, gen);
+      TrackingStation* layers[7];
+      auto tracker = test::runTracker(event, layers, nThreads);
+
+      double total = 0;
+      std::cout << nTracks << " tracks, " << nThreads << " threads:";
+      for (int stage = 0; stage < Tracker::kNStages; ++stage) {
+        std::cout << " " << stages[stage] << " " << tracker->GetStageTime(stage)*1e3 << " ms";
+        total += tracker->GetStageTime(stage);
+      }
+      std::cout << ", total " << total*1e3 << " ms" << std::endl;
+      if (nThreads == nCores) break;
+    }
+  }
+  return 0;
+}
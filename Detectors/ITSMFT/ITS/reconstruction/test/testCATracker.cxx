@@ -0,0 +1,92 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testCATracker.cxx
+/// \brief This task checks that the parallel CA tracker gives the same result as the serial one
+
+#define BOOST_TEST_MODULE Test ITS CATracker
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSReconstruction/CATracker.h"
+#include "ITSReconstruction/CATrackingStation.h"
+#include "CATrackerTestUtils.h"
+
+#include <vector>
+#include <memory>
+#include <random>
+
+namespace o2 {
+namespace ITS {
+namespace CA {
+
+  using test::makeEvent;
+  using test::runTracker;
+
+  /// @brief Compare the doublets, cells and track candidates found with 1 and 4 threads
+  BOOST_AUTO_TEST_CASE(CATracker_parallel)
+  {
+    std::mt19937 gen(5);
+    auto event1 = makeEvent(300, 300, gen);
+    std::mt19937 gen4(5);
+    auto event4 = makeEvent(300, 300, gen4);
+    TrackingStation *layers1[7], *layers4[7];
+    auto tracker1 = runTracker(event1, layers1, 1);
+    auto tracker4 = runTracker(event4, layers4, 4);
+
+    for (int iL = 0; iL < 6; ++iL) {
+      const auto& d1 = tracker1->GetDoublets(iL);
+      const auto& d4 = tracker4->GetDoublets(iL);
+      BOOST_CHECK(!d1.empty());
+      BOOST_REQUIRE_EQUAL(d1.size(), d4.size());
+      for (size_t i = 0; i < d1.size(); ++i) {
+        BOOST_CHECK_EQUAL(d1[i].x, d4[i].x);
+        BOOST_CHECK_EQUAL(d1[i].y, d4[i].y);
+        BOOST_CHECK_EQUAL(d1[i].tanL, d4[i].tanL);
+        BOOST_CHECK_EQUAL(d1[i].phi, d4[i].phi);
+      }
+    }
+
+    for (int iL = 0; iL < 5; ++iL) {
+      auto c1 = tracker1->GetCells(iL);
+      auto c4 = tracker4->GetCells(iL);
+      BOOST_REQUIRE_EQUAL(c1.size(), c4.size());
+      for (size_t i = 0; i < c1.size(); ++i) {
+        BOOST_CHECK_EQUAL(c1[i].x(), c4[i].x());
+        BOOST_CHECK_EQUAL(c1[i].y(), c4[i].y());
+        BOOST_CHECK_EQUAL(c1[i].z(), c4[i].z());
+        BOOST_CHECK_EQUAL(c1[i].d0(), c4[i].d0());
+        BOOST_CHECK_EQUAL(c1[i].d1(), c4[i].d1());
+        BOOST_CHECK_EQUAL(c1[i].GetCurvature(), c4[i].GetCurvature());
+        BOOST_REQUIRE_EQUAL(c1[i].NumberOfNeighbours(), c4[i].NumberOfNeighbours());
+        for (size_t iN = 0; iN < c1[i].NumberOfNeighbours(); ++iN) {
+          BOOST_CHECK_EQUAL(c1[i](iN), c4[i](iN));
+        }
+      }
+    }
+
+    int nCandidates = 0;
+    for (int i = 0; i < 4; ++i) {
+      auto t1 = tracker1->GetCandidates(i);
+      auto t4 = tracker4->GetCandidates(i);
+      BOOST_REQUIRE_EQUAL(t1.size(), t4.size());
+      for (size_t iT = 0; iT < t1.size(); ++iT) {
+        for (int iL = 0; iL < 7; ++iL) {
+          BOOST_CHECK_EQUAL(t1[iT].Clusters()[iL], t4[iT].Clusters()[iL]);
+        }
+      }
+      nCandidates += t1.size();
+    }
+    BOOST_CHECK(nCandidates > 0);
+  }
+
+}
+}
+}
@@ -0,0 +1,236 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testCookedTracker.cxx
+/// \brief This task checks that the cooked tracker gives the tracks of its single thread sequence with any number of
+/// threads and in parallel instances
+
+#define BOOST_TEST_MODULE Test ITS CookedTracker
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSReconstruction/CookedTracker.h"
+#include "ITSReconstruction/CookedTrack.h"
+#include "ITSBase/GeometryTGeo.h"
+#include "ITSMFTReconstruction/Cluster.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "DetectorsBase/Constants.h"
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <cmath>
+
+namespace o2 {
+namespace ITS {
+
+  using o2::ITSMFT::Cluster;
+  using Labels = o2::dataformats::MCTruthContainer<o2::MCCompLabel>;
+
+  const float kRadius[7] = {2.34, 3.15, 3.93, 19.61, 24.55, 34.39, 39.34};
+  const int kNSensors[7] = {12, 16, 20, 24, 30, 42, 48};
+  const float kSigma2 = 0.0005 * 0.0005;
+  const float kBz = 5.;
+
+  /// Geometry made of flat sensors tangent to the layer radii, one per phi sector of each layer,
+  /// whose tracking frames are filled without the TGeo geometry
+  class TestGeometry : public GeometryTGeo {
+    public:
+      TestGeometry() : GeometryTGeo(false)
+      {
+        mNumberOfLayers = 7;
+        for (int iL = 0; iL < 7; ++iL) {
+          for (int iS = 0; iS < kNSensors[iL]; ++iS) {
+            mCacheRefX.push_back(kRadius[iL]);
+            mCacheRefAlpha.push_back(o2::Base::Constants::k2PI * (iS + 0.5f) / kNSensors[iL]);
+          }
+          mLastChipIndex.push_back(mCacheRefX.size() - 1);
+        }
+        const int nSensors = mCacheRefX.size();
+        setSize(nSensors);
+        auto& cache = getCacheT2GRot();
+        cache.setSize(nSensors);
+        for (int i = 0; i < nSensors; ++i) {
+          cache.setMatrix(Rot2D(mCacheRefAlpha[i]), i);
+        }
+      }
+
+      /// Sensor of the layer covering the global azimuth phi
+      int getSensor(int layer, float phi) const
+      {
+        int sector = std::floor(phi / o2::Base::Constants::k2PI * kNSensors[layer]);
+        sector %= kNSensors[layer];
+        if (sector < 0) sector += kNSensors[layer];
+        return getFirstChipIndex(layer) + sector;
+      }
+  };
+
+  /// Generate the clusters of nTracks helices from the origin crossing the 7 layers, plus nNoise noise
+  /// clusters per layer. The MC label of each cluster is stored at the index of the cluster, which is
+  /// also its unique ID.
+  void makeEvent(const TestGeometry& geom, int nTracks, int nNoise, std::vector<Cluster>& clusters, Labels& labels)
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> phi(0, o2::Base::Constants::k2PI), tanL(-0.8, 0.8), pt(0.5, 5), flat(-1, 1);
+    auto addCluster = [&](int sensor, float y, float z, int label) {
+      clusters.emplace_back(sensor, geom.getSensorRefX(sensor), y, z, kSigma2, kSigma2, 0.f);
+      clusters.back().SetUniqueID(clusters.size() - 1);
+      labels.addElement(clusters.size() - 1, o2::MCCompLabel(label));
+    };
+
+    for (int iTrack = 0; iTrack < nTracks; ++iTrack) {
+      // transverse position after an arc length s along the helix of curvature crv
+      const float phi0 = phi(gen), t = tanL(gen), crv = (flat(gen) < 0 ? -1 : 1) * kBz * o2::Base::Constants::kB2C / pt(gen);
+      auto x = [&](double s) { return (std::sin(phi0 + crv * s) - std::sin(phi0)) / crv; };
+      auto y = [&](double s) { return (std::cos(phi0) - std::cos(phi0 + crv * s)) / crv; };
+      for (int iL = 0; iL < 7; ++iL) {
+        const int sensor = geom.getSensor(iL, phi0 + 0.5f * crv * kRadius[iL]);
+        const double alpha = geom.getSensorRefAlpha(sensor), cs = std::cos(alpha), sn = std::sin(alpha);
+        // the helix crosses the plane of the sensor where its X in the tracking frame is the reference X
+        double sMin = 0., sMax = 2. * kRadius[iL];
+        for (int i = 0; i < 60; ++i) {
+          const double s = 0.5 * (sMin + sMax);
+          (x(s) * cs + y(s) * sn < kRadius[iL] ? sMin : sMax) = s;
+        }
+        addCluster(sensor, -x(sMin) * sn + y(sMin) * cs, t * sMin, iTrack);
+      }
+    }
+
+    for (int iL = 0; iL < 7; ++iL) {
+      for (int iNoise = 0; iNoise < nNoise; ++iNoise) {
+        const float halfWidth = kRadius[iL] * std::tan(o2::Base::Constants::kPI / kNSensors[iL]);
+        addCluster(geom.getSensor(iL, phi(gen)), halfWidth * flat(gen), 0.8f * kRadius[iL] * flat(gen), nTracks + iNoise);
+      }
+    }
+  }
+
+  /// Run a new tracker on the clusters with the given number of threads
+  void runTracker(TestGeometry& geom, int nThreads, const std::vector<Cluster>& clusters, const Labels& clsLabels,
+                  std::vector<CookedTrack>& tracks, Labels& trkLabels)
+  {
+    CookedTracker tracker(nThreads);
+    tracker.setGeometry(&geom);
+    tracker.setBz(kBz);
+    tracker.setMCTruthContainers(&clsLabels, &trkLabels);
+    tracker.process(clusters, tracks);
+  }
+
+  /// Tracker running the seeds in one sequence, where the clusters of each track are excluded for all
+  /// the following seeds, as the single thread CookedTracker::process did before the seeds were
+  /// tracked in parallel
+  class ReferenceTracker : public CookedTracker {
+    public:
+      void process(const std::vector<o2::ITSMFT::Cluster>& clusters, std::vector<CookedTrack>& tracks, Labels& labels)
+      {
+        const int kSeedingLayer = 6;           // outermost layer, where the seeds start
+        const int kMinNumberOfClusters = 4;    // of the good tracks
+        loadClusters(clusters);
+        Double_t xyz[3]{ 0, 0, 0 };
+        setVertex(xyz);
+        std::vector<CookedTrack> seeds;
+        makeSeeds(seeds, 0, getLayer(kSeedingLayer).getNumberOfClusters());
+        std::sort(seeds.begin(), seeds.end());
+        trackSeeds(seeds);
+        for (auto& track : seeds) {
+          if (track.getNumberOfClusters() < kMinNumberOfClusters) continue;
+          labels.addElement(tracks.size(), cookLabel(track, 0.));
+          setExternalIndices(track);
+          tracks.push_back(track);
+        }
+        unloadClusters();
+      }
+  };
+
+  /// Check that two sets of tracks and their labels are identical
+  void compareTracks(const std::vector<CookedTrack>& tracks1, const Labels& labels1,
+                     const std::vector<CookedTrack>& tracks2, const Labels& labels2)
+  {
+    BOOST_REQUIRE_EQUAL(tracks1.size(), tracks2.size());
+    BOOST_REQUIRE_EQUAL(labels1.getIndexedSize(), labels2.getIndexedSize());
+    for (size_t i = 0; i < tracks1.size(); ++i) {
+      const auto &t1 = tracks1[i], &t2 = tracks2[i];
+      BOOST_CHECK_EQUAL(t1.getAlpha(), t2.getAlpha());
+      BOOST_CHECK_EQUAL(t1.getX(), t2.getX());
+      BOOST_CHECK_EQUAL(t1.getY(), t2.getY());
+      BOOST_CHECK_EQUAL(t1.getZ(), t2.getZ());
+      BOOST_CHECK_EQUAL(t1.getSnp(), t2.getSnp());
+      BOOST_CHECK_EQUAL(t1.getTgl(), t2.getTgl());
+      BOOST_CHECK_EQUAL(t1.getPt(), t2.getPt());
+      BOOST_REQUIRE_EQUAL(t1.getNumberOfClusters(), t2.getNumberOfClusters());
+      for (int iC = 0; iC < t1.getNumberOfClusters(); ++iC) {
+        BOOST_CHECK_EQUAL(t1.getClusterIndex(iC), t2.getClusterIndex(iC));
+      }
+      const auto l1 = labels1.getLabels(i);
+      const auto l2 = labels2.getLabels(i);
+      BOOST_REQUIRE_EQUAL(l1.size(), l2.size());
+      for (int iL = 0; iL < static_cast<int>(l1.size()); ++iL) {
+        BOOST_CHECK_EQUAL(l1[iL].getTrackID(), l2[iL].getTrackID());
+        BOOST_CHECK_EQUAL(l1[iL].getEventID(), l2[iL].getEventID());
+      }
+    }
+  }
+
+  /// @brief Compare the tracks and labels found with any number of threads with the ones of the single sequence
+  BOOST_AUTO_TEST_CASE(CookedTracker_threads)
+  {
+    TestGeometry geom;
+    std::vector<Cluster> clusters;
+    Labels clsLabels;
+    makeEvent(geom, 500, 500, clusters, clsLabels);
+
+    std::vector<CookedTrack> tracks1;
+    Labels labels1;
+    ReferenceTracker reference;
+    reference.setGeometry(&geom);
+    reference.setBz(kBz);
+    reference.setMCTruthContainers(&clsLabels, nullptr);
+    reference.process(clusters, tracks1, labels1);
+    BOOST_CHECK(tracks1.size() > 0);
+    int nGood = 0;
+    for (size_t i = 0; i < tracks1.size(); ++i) {
+      if (labels1.getLabels(i)[0].getTrackID() >= 0) nGood++;
+    }
+    BOOST_CHECK(nGood > 0);
+
+    for (int nThreads : {1, 2, 4, 0}) {
+      std::vector<CookedTrack> tracks;
+      Labels labels;
+      runTracker(geom, nThreads, clusters, clsLabels, tracks, labels);
+      compareTracks(tracks1, labels1, tracks, labels);
+    }
+  }
+
+  /// @brief Run two multithreaded trackers at the same time on the same clusters and geometry
+  BOOST_AUTO_TEST_CASE(CookedTracker_instances)
+  {
+    TestGeometry geom;
+    std::vector<Cluster> clusters;
+    Labels clsLabels;
+    makeEvent(geom, 500, 500, clusters, clsLabels);
+
+    std::vector<CookedTrack> tracks1;
+    Labels labels1;
+    runTracker(geom, 1, clusters, clsLabels, tracks1, labels1);
+
+    std::vector<CookedTrack> tracks[2];
+    Labels labels[2];
+    std::thread other([&]() { runTracker(geom, 2, clusters, clsLabels, tracks[1], labels[1]); });
+    runTracker(geom, 2, clusters, clsLabels, tracks[0], labels[0]);
+    other.join();
+
+    for (int i = 0; i < 2; ++i) {
+      compareTracks(tracks1, labels1, tracks[i], labels[i]);
+    }
+  }
+
+}
+}
@@ -16,6 +16,9 @@
 #include "ITSMFTReconstruction/Cluster.h"
 #include "ITSMFTBase/GeometryTGeo.h"
 #include "ITSMFTReconstruction/PixelReader.h"
+#include "CommonUtils/ThreadPool.h"
+#include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -33,6 +36,14 @@ namespace dataformats
 namespace ITSMFT
 {
   
+/// \class Clusterer
+/// \brief Cluster finder for the ALPIDE chips of ITS and MFT
+///
+/// The fired pixels of a chip, ordered by column and row, are connected to their neighbours
+/// in the current and the previous column with a union-find structure (union by rank and path
+/// compression), such that merging pre-clusters costs constant time instead of rescanning them.
+/// The pixels are then grouped by cluster with a counting sort and each cluster is built from a
+/// contiguous range of pixels. Optionally the chips are processed in parallel on a thread pool.
 class Clusterer {
   
   using PixelReader = o2::ITSMFT::PixelReader;
@@ -51,34 +62,61 @@ class Clusterer {
   void process(PixelReader &r, std::vector<Cluster> &clusters);
   
   // provide the common ITSMFT::GeometryTGeo to access matrices
+  // if no geometry is set, the clusters are stored in the local frame of the chip
   void setGeometry(const o2::ITSMFT::GeometryTGeo* gm) { mGeometry = gm;}
   void setMCTruthContainer(o2::dataformats::MCTruthContainer<o2::MCCompLabel> *truth) {
     mClsLabels = truth;
   }
+
+  /// set the number of threads used to process the chips, 0 for all available cores
+  void setNumberOfThreads(int n);
+  int getNumberOfThreads() const { return mNumberOfThreads; }
   
  private:
   
   enum {kMaxRow=650}; //Anything larger than the real number of rows (512 for ALPIDE)
-  void initChip();
-  void updateChip(int ip);
-  void finishChip(std::vector<Cluster> &clusters);
+  enum {kChipsPerBatch=1024}; // Number of chips read before they are processed in parallel
+
+  /// Scratch buffers of one worker, reused for all chips
+  struct Workspace {
+    Int_t column1[kMaxRow+2];            ///< pixel index per row of one column
+    Int_t column2[kMaxRow+2];            ///< pixel index per row of the other column
+    std::vector<Int_t> parent;           ///< union-find parent of each pixel
+    std::vector<UChar_t> rank;           ///< union-find rank of each pixel
+    std::vector<Int_t> clusterOfRoot;    ///< cluster index of each union-find root
+    std::vector<Int_t> clusterOfPixel;   ///< cluster index of each pixel
+    std::vector<Int_t> firstPixel;       ///< offset of the pixels of each cluster in sortedPixels
+    std::vector<const PixelData*> sortedPixels; ///< pixels grouped by cluster
+    std::vector<Label> labels;           ///< labels of the clusters of a chip
+    std::vector<UChar_t> nLabels;        ///< number of labels of each cluster of a chip
+    std::vector<Point3D<float>> xyz;     ///< positions of the clusters of a chip, local then tracking frame
+    Workspace();
+  };
+
+  /// Clusters of a single chip, filled by the workers in the parallel mode
+  struct ChipClusters {
+    std::vector<Cluster> clusters;
+    std::vector<Label> labels;
+    std::vector<UChar_t> nLabels;
+  };
+
+  void processChip(const ChipPixelData &chip, Workspace &ws, std::vector<Cluster> &clusters,
+                   std::vector<Label> &labels, std::vector<UChar_t> &nLabels) const;
+  void findClusters(const ChipPixelData &chip, Workspace &ws) const;
+  void addLabels(Int_t firstCluster, const std::vector<Label> &labels, const std::vector<UChar_t> &nLabels);
+  void processParallel(PixelReader &reader, std::vector<Cluster> &clusters);
   void fetchMCLabels(const PixelData* pix, std::array<Label,Cluster::maxLabels> &labels, int &nfilled) const;
 
+  static Int_t findRoot(std::vector<Int_t> &parent, Int_t i);
+  static void unite(std::vector<Int_t> &parent, std::vector<UChar_t> &rank, Int_t i, Int_t j);
+
   ChipPixelData mChipData;   ///< single chip data provided by the reader
-  
-  Int_t mColumn1[kMaxRow+2];
-  Int_t mColumn2[kMaxRow+2];
-  Int_t *mCurr, *mPrev;
-  
-  using NextIndex = Int_t;
-  std::vector< std::pair<NextIndex, const PixelData*> > mPixels;
 
-  using FirstIndex = Int_t;
-  std::vector< FirstIndex > mPreClusterHeads;
-  
-  std::vector<Int_t> mPreClusterIndices;
-  
-  UShort_t mCol = 0xffff;    ///< Column being processed
+  int mNumberOfThreads = 1;                             ///< number of threads processing the chips
+  std::unique_ptr<o2::utils::ThreadPool> mThreadPool;   //!< thread pool for the parallel mode
+  std::vector<std::unique_ptr<Workspace>> mWorkspaces;  //!< scratch buffers, one per thread
+  std::vector<ChipPixelData> mChips;                    //!< batch of chips in the parallel mode
+  std::vector<ChipClusters> mChipClusters;              //!< clusters of the batch of chips in the parallel mode
 
   const o2::ITSMFT::GeometryTGeo* mGeometry = nullptr;    ///< ITS OR MFT upgrade geometry
   o2::dataformats::MCTruthContainer<o2::MCCompLabel> *mClsLabels = nullptr; // Cluster MC labels
@@ -16,6 +16,7 @@
 #include <Rtypes.h>
 #include "ITSMFTBase/Digit.h"
 #include "SimulationDataFormat/MCCompLabel.h"
+#include <vector>
 
 namespace o2
 {
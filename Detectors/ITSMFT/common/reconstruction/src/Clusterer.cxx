@@ -11,6 +11,7 @@
 /// \file Clusterer.cxx
 /// \brief Implementation of the ITS cluster finder
 #include <algorithm>
+#include <thread>
 #include "FairLogger.h"      // for LOG
 
 #include "ITSMFTReconstruction/Clusterer.h"
@@ -22,13 +23,17 @@
 using namespace o2::ITSMFT;
 using Segmentation = o2::ITSMFT::SegmentationAlpide;
 
+//__________________________________________________
+Clusterer::Workspace::Workspace()
+{
+  std::fill(std::begin(column1), std::end(column1), -1);
+  std::fill(std::begin(column2), std::end(column2), -1);
+}
+
 //__________________________________________________
 Clusterer::Clusterer()
-  :mCurr(mColumn2+1)
-  ,mPrev(mColumn1+1)
 {
-  std::fill(std::begin(mColumn1), std::end(mColumn1), -1);
-  std::fill(std::begin(mColumn2), std::end(mColumn2), -1);
+  mWorkspaces.emplace_back(new Workspace);
 
 #ifdef _ClusterTopology_
   LOG(INFO) << "*********************************************************************" << FairLogger::endl;
@@ -39,152 +44,215 @@ Clusterer::Clusterer()
   
 }
 
+//__________________________________________________
+void Clusterer::setNumberOfThreads(int n)
+{
+  if (n <= 0) n = std::max(1u, std::thread::hardware_concurrency());
+  mNumberOfThreads = n;
+  mThreadPool.reset(n > 1 ? new o2::utils::ThreadPool(n) : nullptr);
+  while (static_cast<int>(mWorkspaces.size()) < n) mWorkspaces.emplace_back(new Workspace);
+}
+
 //__________________________________________________
 void Clusterer::process(PixelReader &reader, std::vector<Cluster> &clusters)
 {
   reader.init();
 
+  if (mThreadPool) {
+    processParallel(reader, clusters);
+    return;
+  }
+
+  Workspace &ws = *mWorkspaces[0];
   while (reader.getNextChipData(mChipData)) {
     LOG(DEBUG) <<"ITSClusterer got Chip " << mChipData.chipID << " ROFrame " << mChipData.roFrame
 	       << " Nhits " << mChipData.pixels.size() << FairLogger::endl;
-    initChip();
-    for (int ip=1;ip<mChipData.pixels.size();ip++) updateChip(ip);
-    finishChip(clusters);
+    const Int_t firstCluster = clusters.size();
+    ws.labels.clear();
+    ws.nLabels.clear();
+    processChip(mChipData, ws, clusters, ws.labels, ws.nLabels);
+    addLabels(firstCluster, ws.labels, ws.nLabels);
   }
 
 }
 
 //__________________________________________________
-void Clusterer::initChip()
+void Clusterer::processParallel(PixelReader &reader, std::vector<Cluster> &clusters)
 {
-  mPrev=mColumn1+1;
-  mCurr=mColumn2+1;
-  std::fill(std::begin(mColumn1), std::end(mColumn1), -1);
-  std::fill(std::begin(mColumn2), std::end(mColumn2), -1);
-
-  mPixels.clear();
-  mPreClusterHeads.clear();
-  mPreClusterIndices.clear();
-  PixelReader::PixelData* pix = &mChipData.pixels[0]; 
-  mCol = pix->col;
-  mCurr[pix->row] = 0;
-  //start the first pre-cluster
-  mPreClusterHeads.push_back(0);
-  mPreClusterIndices.push_back(0);
-  mPixels.emplace_back(-1,pix);
+  // the chips are read in batches, clustered in parallel into separate outputs and
+  // appended in the order of the reader, such that the result is the same as for one thread
+  bool more = true;
+  while (more) {
+    size_t nChips = 0;
+    while (nChips < kChipsPerBatch) {
+      if (mChips.size() == nChips) mChips.emplace_back();
+      if (!reader.getNextChipData(mChips[nChips])) {
+        more = false;
+        break;
+      }
+      LOG(DEBUG) <<"ITSClusterer got Chip " << mChips[nChips].chipID << " ROFrame " << mChips[nChips].roFrame
+	         << " Nhits " << mChips[nChips].pixels.size() << FairLogger::endl;
+      ++nChips;
+    }
+    if (mChipClusters.size() < nChips) mChipClusters.resize(nChips);
+
+    mThreadPool->run(nChips, [this](size_t iChip, int worker) {
+      auto &out = mChipClusters[iChip];
+      out.clusters.clear();
+      out.labels.clear();
+      out.nLabels.clear();
+      processChip(mChips[iChip], *mWorkspaces[worker], out.clusters, out.labels, out.nLabels);
+    });
+
+    size_t nClusters = clusters.size();
+    for (size_t iChip = 0; iChip < nChips; ++iChip) nClusters += mChipClusters[iChip].clusters.size();
+    if (nClusters > clusters.capacity()) clusters.reserve(std::max(nClusters, 2*clusters.capacity()));
+
+    for (size_t iChip = 0; iChip < nChips; ++iChip) {
+      auto &out = mChipClusters[iChip];
+      const Int_t firstCluster = clusters.size();
+      for (auto &c : out.clusters) {
+        c.SetUniqueID(clusters.size());
+        clusters.emplace_back(std::move(c));
+      }
+      addLabels(firstCluster, out.labels, out.nLabels);
+    }
+  }
 }
 
 //__________________________________________________
-void Clusterer::updateChip(int ip)
+Int_t Clusterer::findRoot(std::vector<Int_t> &parent, Int_t i)
 {
-  PixelReader::PixelData* pix = &mChipData.pixels[ip]; 
-  if (mCol != pix->col) { // switch the buffers
-    Int_t *tmp = mCurr;
-    mCurr = mPrev;
-    mPrev = tmp;
-    if (pix->col > mCol+1) std::fill(mPrev, mPrev+kMaxRow, -1);
-    std::fill(mCurr, mCurr+kMaxRow, -1);
-    mCol = pix->col;
+  // find the root of the set of pixel i, halving the path on the way
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
   }
+  return i;
+}
+
+//__________________________________________________
+void Clusterer::unite(std::vector<Int_t> &parent, std::vector<UChar_t> &rank, Int_t i, Int_t j)
+{
+  // merge the sets of pixels i and j, the root of higher rank stays the root
+  i = findRoot(parent, i);
+  j = findRoot(parent, j);
+  if (i == j) return;
+  if (rank[i] < rank[j]) std::swap(i, j);
+  parent[j] = i;
+  if (rank[i] == rank[j]) ++rank[i];
+}
+
+//__________________________________________________
+void Clusterer::findClusters(const ChipPixelData &chip, Workspace &ws) const
+{
+  // Connect each pixel to its fired neighbours in the same and in the previous column. The column buffers
+  // hold the pixel index per row, only the rows of the pixels of a column are reset when it is recycled.
+  const auto &pixels = chip.pixels;
+  const Int_t npix = pixels.size();
+  ws.parent.resize(npix);
+  ws.rank.assign(npix, 0);
+
+  Int_t *prev = ws.column1+1, *curr = ws.column2+1;
+  Int_t prevFirst = 0, currFirst = 0; // first pixel of the previous and current column
+  UShort_t col = pixels[0].col;
 
-  Bool_t attached=false;
-  UShort_t row = pix->row;
-  Int_t neighbours[]{mCurr[row-1], mPrev[row], mPrev[row+1], mPrev[row-1]};
-  for (auto pci : neighbours) {
-     if (pci<0) continue;
-     auto &ci = mPreClusterIndices[pci];
-     if (attached) {
-        auto &newci = mPreClusterIndices[mCurr[row]];
-	if (ci < newci) newci = ci;
-	else ci = newci;
-     } else {
-       auto &firstIndex = mPreClusterHeads[ci];
-        mPixels.emplace_back(firstIndex, pix);
-        firstIndex = mPixels.size() - 1;
-	mCurr[row] = pci;
-	attached = true;
-     }
+  for (Int_t ip = 0; ip < npix; ++ip) {
+    const PixelData &pix = pixels[ip];
+    if (pix.col != col) { // switch the buffers
+      for (Int_t i = prevFirst; i < currFirst; ++i) prev[pixels[i].row] = -1;
+      if (pix.col == col+1) {
+        std::swap(prev, curr);
+        prevFirst = currFirst;
+      }
+      else { // the last column is not adjacent
+        for (Int_t i = currFirst; i < ip; ++i) curr[pixels[i].row] = -1;
+        prevFirst = ip;
+      }
+      currFirst = ip;
+      col = pix.col;
+    }
+
+    const UShort_t row = pix.row;
+    ws.parent[ip] = ip;
+    for (auto neighbour : {curr[row-1], curr[row+1], prev[row-1], prev[row], prev[row+1]}) {
+      if (neighbour >= 0) unite(ws.parent, ws.rank, ip, neighbour);
+    }
+    curr[row] = ip;
   }
-  
-  if (attached) return;
+  for (Int_t i = prevFirst; i < npix; ++i) prev[pixels[i].row] = curr[pixels[i].row] = -1;
 
-  //start new precluster
-  mPreClusterHeads.push_back(mPixels.size());
-  mPixels.emplace_back(-1,pix);
-  Int_t lastIndex = mPreClusterIndices.size();
-  mPreClusterIndices.push_back(lastIndex);
-  mCurr[row] = lastIndex;
+  // number the clusters in the order of their first pixel and group the pixels by cluster
+  ws.clusterOfRoot.assign(npix, -1);
+  ws.clusterOfPixel.resize(npix);
+  ws.firstPixel.assign(1, 0);
+  for (Int_t ip = 0; ip < npix; ++ip) {
+    auto &cluster = ws.clusterOfRoot[findRoot(ws.parent, ip)];
+    if (cluster < 0) {
+      cluster = ws.firstPixel.size() - 1;
+      ws.firstPixel.push_back(0);
+    }
+    ws.clusterOfPixel[ip] = cluster;
+    ++ws.firstPixel[cluster+1];
+  }
+  const Int_t nClusters = ws.firstPixel.size() - 1;
+  for (Int_t ic = 0; ic < nClusters; ++ic) ws.firstPixel[ic+1] += ws.firstPixel[ic];
 
+  // the root array is not needed anymore and is reused as insert position of each cluster
+  auto &insert = ws.clusterOfRoot;
+  std::copy(ws.firstPixel.begin(), ws.firstPixel.end()-1, insert.begin());
+  ws.sortedPixels.resize(npix);
+  for (Int_t ip = 0; ip < npix; ++ip) ws.sortedPixels[insert[ws.clusterOfPixel[ip]]++] = &pixels[ip];
 }
 
 //__________________________________________________
-void Clusterer::finishChip(std::vector<Cluster> &clusters)
+void Clusterer::processChip(const ChipPixelData &chip, Workspace &ws, std::vector<Cluster> &clusters,
+                            std::vector<Label> &labels, std::vector<UChar_t> &nLabels) const
 {
   constexpr Float_t SigmaX2 = Segmentation::PitchRow*Segmentation::PitchRow / 12.; //FIXME
   constexpr Float_t SigmaY2 = Segmentation::PitchCol*Segmentation::PitchCol / 12.; //FIXME
+  constexpr int MaxTopologyPixels = Cluster::kMaxPatternBits*2; // pixels considered for the cluster topology
+
+  if (chip.pixels.empty()) return;
+  findClusters(chip, ws);
 
-  std::array<Label,Cluster::maxLabels> labels;
-  std::array<const PixelData*,Cluster::kMaxPatternBits*2> pixArr;
+  std::array<Label,Cluster::maxLabels> clLabels;
   
   Int_t noc = clusters.size();  
-  for (Int_t i1=0; i1<mPreClusterHeads.size(); ++i1) {
-    const auto ci = mPreClusterIndices[i1];
-    if (ci<0) continue;
+  const Int_t firstCluster = noc;
+  const Int_t nClusters = ws.firstPixel.size() - 1;
+  ws.xyz.resize(nClusters);
+  for (Int_t icl=0; icl<nClusters; ++icl) {
+    const PixelData* const* pixArr = &ws.sortedPixels[ws.firstPixel[icl]];
+    int npix = ws.firstPixel[icl+1] - ws.firstPixel[icl];
     UShort_t rowMax=0, rowMin=65535;
     UShort_t colMax=0, colMin=65535;
     Float_t x=0., z=0.;
-    int nlab = 0, npix = 0;
-    Int_t next = mPreClusterHeads[i1];
-    while (next >= 0) {
-      const auto &dig = mPixels[next];
-      const auto pix = dig.second; // PixelReader.PixelData*
+    int nlab = 0;
+    for (int i=0; i<npix; ++i) {
+      const auto pix = pixArr[i];
       x += pix->row;
       z += pix->col;
       if (pix->row < rowMin) rowMin = pix->row;
       if (pix->row > rowMax) rowMax = pix->row;
       if (pix->col < colMin) colMin = pix->col;
       if (pix->col > colMax) colMax = pix->col;
-      if (npix<pixArr.size()) pixArr[npix] = pix;  // needed for cluster topology
-      fetchMCLabels(pix, labels, nlab);      
-      npix++;
-      next = dig.first;
+      if (mClsLabels) fetchMCLabels(pix, clLabels, nlab);
     }
-    mPreClusterIndices[i1] = -1;
-    for (Int_t i2=i1+1; i2<mPreClusterHeads.size(); ++i2) {
-      if (mPreClusterIndices[i2] != ci) continue;
-      next = mPreClusterHeads[i2];
-      while (next >= 0) {
-        const auto &dig = mPixels[next];
-	const auto pix = dig.second; // PixelReader.PixelData*
-	x += pix->row;
-	z += pix->col;
-	if (pix->row < rowMin) rowMin = pix->row;
-	if (pix->row > rowMax) rowMax = pix->row;
-	if (pix->col < colMin) colMin = pix->col;
-	if (pix->col > colMax) colMax = pix->col;
-	if (npix<pixArr.size()) pixArr[npix] = pix;  // needed for cluster topology
-	// add labels
-	fetchMCLabels(pix, labels, nlab);   
-        npix++;
-	next = dig.first;
-      }
-      mPreClusterIndices[i2] = -1;
-    }    
 
-    Point3D<float> xyzLoc( Segmentation::getFirstRowCoordinate() + x*Segmentation::PitchRow/npix, 0.f,
-			   Segmentation::getFirstColCoordinate() + z*Segmentation::PitchCol/npix );
-    auto xyzTra = mGeometry->getMatrixT2L(mChipData.chipID)^(xyzLoc); // inverse transform from Local to Tracking frame
+    ws.xyz[icl].SetXYZ( Segmentation::getFirstRowCoordinate() + x*Segmentation::PitchRow/npix, 0.f,
+			Segmentation::getFirstColCoordinate() + z*Segmentation::PitchCol/npix );
 
     clusters.emplace_back();
     Cluster &c = clusters[noc];
     c.SetUniqueID(noc); // Let the cluster remember its position within the cluster array
-    c.setROFrame(mChipData.roFrame);
-    c.setSensorID(mChipData.chipID);
-    c.setPos(xyzTra);
+    c.setROFrame(chip.roFrame);
+    c.setSensorID(chip.chipID);
     c.setErrors(SigmaX2, SigmaY2, 0.f);
     c.setNxNzN(rowMax-rowMin+1,colMax-colMin+1,npix);
     if (mClsLabels) {
-      for (int i=nlab;i--;) mClsLabels->addElement(noc,labels[i]);
+      for (int i=nlab;i--;) labels.push_back(clLabels[i]);
+      nLabels.push_back(nlab);
     }
     noc++;
 
@@ -209,7 +277,7 @@ void Clusterer::finishChip(std::vector<Cluster> &clusters)
     c.setPatternColSpan(colSpanW,colSpanW<colSpan);
     c.setPatternRowMin(rowMin);
     c.setPatternColMin(colMin);
-    if (npix>pixArr.size()) npix = pixArr.size();
+    if (npix>MaxTopologyPixels) npix = MaxTopologyPixels;
     for (int i=0;i<npix;i++) {
       const auto pix = pixArr[i];
       unsigned short ir = pix->row - rowMin, ic = pix->col - colMin;
@@ -218,6 +286,21 @@ void Clusterer::finishChip(std::vector<Cluster> &clusters)
 #endif //_ClusterTopology_  
     
   }
+
+  // inverse transform from Local to Tracking frame, all at once for the clusters of the chip
+  if (mGeometry) mGeometry->getCacheT2L().inverseTransformPoints(chip.chipID, ws.xyz.data(), ws.xyz.data(), nClusters);
+  for (Int_t icl=0; icl<nClusters; ++icl) clusters[firstCluster+icl].setPos(ws.xyz[icl]);
+}
+
+//__________________________________________________
+void Clusterer::addLabels(Int_t firstCluster, const std::vector<Label> &labels, const std::vector<UChar_t> &nLabels)
+{
+  // transfer the labels of the clusters of a chip to the MC truth container
+  if (!mClsLabels) return;
+  size_t next = 0;
+  for (size_t ic=0; ic<nLabels.size(); ++ic) {
+    for (int i=0; i<nLabels[ic]; ++i) mClsLabels->addElement(firstCluster+ic, labels[next++]);
+  }
 }
 
 //__________________________________________________
@@ -0,0 +1,85 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ClustererTestUtils.h
+/// \brief Chip generation shared by the tests and benchmarks of the ITSMFT Clusterer
+
+#ifndef ALICEO2_ITSMFT_CLUSTERERTESTUTILS_H_
+#define ALICEO2_ITSMFT_CLUSTERERTESTUTILS_H_
+
+#include "ITSMFTReconstruction/PixelReader.h"
+#include "ITSMFTBase/SegmentationAlpide.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+
+#include <random>
+#include <vector>
+
+namespace o2 {
+namespace ITSMFT {
+namespace test {
+
+  using ChipPixelData = PixelReader::ChipPixelData;
+  using Segmentation = SegmentationAlpide;
+
+  /// Reader serving prepared chips
+  class VectorPixelReader : public PixelReader {
+    public:
+      VectorPixelReader(const std::vector<ChipPixelData>& chips) : mChips(chips) {}
+      void init() override { mIdx = 0; }
+      Bool_t getNextChipData(ChipPixelData &chipData) override {
+        if (mIdx >= mChips.size()) return kFALSE;
+        const auto& chip = mChips[mIdx++];
+        chipData.clear();
+        chipData.chipID = chip.chipID;
+        chipData.roFrame = chip.roFrame;
+        chipData.pixels.insert(chipData.pixels.end(), chip.pixels.begin(), chip.pixels.end());
+        return kTRUE;
+      }
+    private:
+      const std::vector<ChipPixelData>& mChips;
+      size_t mIdx = 0;
+  };
+
+  /// Generate a chip with randomly fired pixels with the given occupancy, plus nBlobs clusters of
+  /// up to 4x4 pixels. The pixels of blob i carry label i, the noise pixels label nBlobs.
+  inline ChipPixelData makeChip(int chipID, double occupancy, int nBlobs, std::mt19937& gen)
+  {
+    std::vector<int> label(Segmentation::NPixels, -1);
+    std::vector<bool> fired(Segmentation::NPixels, false);
+    std::uniform_real_distribution<double> flat(0, 1);
+    std::uniform_int_distribution<int> row(0, Segmentation::NRows-4), col(0, Segmentation::NCols-4), size(1, 4);
+    if (occupancy > 0) {
+      for (int i = 0; i < Segmentation::NPixels; ++i) fired[i] = flat(gen) < occupancy;
+    }
+    for (int iBlob = 0; iBlob < nBlobs; ++iBlob) {
+      const int r0 = row(gen), c0 = col(gen), nr = size(gen), nc = size(gen);
+      for (int c = c0; c < c0+nc; ++c) {
+        for (int r = r0; r < r0+nr; ++r) {
+          if (flat(gen) < 0.2) continue;
+          fired[c*Segmentation::NRows + r] = true;
+          label[c*Segmentation::NRows + r] = iBlob;
+        }
+      }
+    }
+    ChipPixelData chip;
+    chip.chipID = chipID;
+    chip.roFrame = 7;
+    for (int i = 0; i < Segmentation::NPixels; ++i) {
+      if (!fired[i]) continue;
+      chip.pixels.emplace_back(i % Segmentation::NRows, i / Segmentation::NRows);
+      chip.pixels.back().labels[0] = o2::MCCompLabel(label[i] >= 0 ? label[i] : nBlobs, chipID);
+    }
+    return chip;
+  }
+}
+}
+}
+
+#endif
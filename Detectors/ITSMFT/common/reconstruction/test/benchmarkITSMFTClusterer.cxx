@@ -0,0 +1,63 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkITSMFTClusterer.cxx
+/// \brief Benchmark of the ITSMFT Clusterer on noisy chips and on chips with a high occupancy of clusters
+
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ClustererTestUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace o2::ITSMFT;
+
+int main()
+{
+  std::mt19937 gen(1);
+  const int nCores = std::max(1u, std::thread::hardware_concurrency());
+
+  struct Input {
+    const char* name;
+    double occupancy;
+    int nBlobs;
+    int nChips;
+  };
+  for (const Input& input : {Input{"noisy chips (1% noise)", 1e-2, 0, 16},
+                             Input{"high occupancy (2000 clusters/chip)", 0., 2000, 64}}) {
+    std::vector<test::ChipPixelData> chips;
+    size_t nPixels = 0;
+    for (int chipID = 0; chipID < input.nChips; ++chipID) {
+      chips.push_back(test::makeChip(chipID, input.occupancy, input.nBlobs, gen));
+      nPixels += chips.back().pixels.size();
+    }
+
+    for (int nThreads = 1; ; nThreads = std::min(2*nThreads, nCores)) {
+      Clusterer clusterer;
+      clusterer.setNumberOfThreads(nThreads);
+      test::VectorPixelReader reader(chips);
+      std::vector<Cluster> clusters;
+      const auto start = std::chrono::high_resolution_clock::now();
+      clusterer.process(reader, clusters);
+      const auto end = std::chrono::high_resolution_clock::now();
+      const double seconds = std::chrono::duration<double>(end-start).count();
+
+      std::cout << input.name << ", " << nThreads << " threads: " << nPixels << " pixels, "
+                << clusters.size() << " clusters in " << seconds*1e3 << " ms, "
+                << nPixels/seconds/1e6 << " Mpixels/s" << std::endl;
+      if (nThreads == nCores) break;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testITSMFTClusterer.cxx
+/// \brief This task tests the ITSMFT Clusterer against a flood fill and the parallel against the sequential processing
+
+#define BOOST_TEST_MODULE Test ITSMFT Clusterer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ITSMFTBase/SegmentationAlpide.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "ClustererTestUtils.h"
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+namespace o2 {
+namespace ITSMFT {
+
+  using ChipPixelData = PixelReader::ChipPixelData;
+  using PixelData = PixelReader::PixelData;
+  using Segmentation = SegmentationAlpide;
+  using Labels = o2::dataformats::MCTruthContainer<o2::MCCompLabel>;
+  using test::VectorPixelReader;
+  using test::makeChip;
+
+  /// Cluster found by the flood fill
+  struct RefCluster {
+    int npix = 0;
+    float x = 0, z = 0;
+    int rowMin = 65535, rowMax = 0, colMin = 65535, colMax = 0;
+  };
+
+  /// Find the 8-connected clusters of a chip with a flood fill, ordered by their first pixel
+  std::vector<RefCluster> floodFill(const ChipPixelData& chip)
+  {
+    std::vector<int> index(Segmentation::NPixels, -1);
+    for (size_t i = 0; i < chip.pixels.size(); ++i) {
+      index[chip.pixels[i].col*Segmentation::NRows + chip.pixels[i].row] = i;
+    }
+    std::vector<bool> done(chip.pixels.size(), false);
+    std::vector<RefCluster> clusters;
+    for (size_t first = 0; first < chip.pixels.size(); ++first) {
+      if (done[first]) continue;
+      RefCluster cl;
+      std::vector<int> stack{int(first)};
+      done[first] = true;
+      while (!stack.empty()) {
+        const auto& pix = chip.pixels[stack.back()];
+        stack.pop_back();
+        cl.npix++;
+        cl.x += pix.row;
+        cl.z += pix.col;
+        cl.rowMin = std::min<int>(cl.rowMin, pix.row);
+        cl.rowMax = std::max<int>(cl.rowMax, pix.row);
+        cl.colMin = std::min<int>(cl.colMin, pix.col);
+        cl.colMax = std::max<int>(cl.colMax, pix.col);
+        for (int dc = -1; dc <= 1; ++dc) {
+          for (int dr = -1; dr <= 1; ++dr) {
+            const int r = pix.row + dr, c = pix.col + dc;
+            if (r < 0 || c < 0 || r >= Segmentation::NRows || c >= Segmentation::NCols) continue;
+            const int i = index[c*Segmentation::NRows + r];
+            if (i >= 0 && !done[i]) {
+              done[i] = true;
+              stack.push_back(i);
+            }
+          }
+        }
+      }
+      clusters.push_back(cl);
+    }
+    return clusters;
+  }
+
+  /// Run the Clusterer on the chips with the given number of threads
+  void runClusterer(const std::vector<ChipPixelData>& chips, int nThreads, std::vector<Cluster>& clusters, Labels* labels)
+  {
+    Clusterer clusterer;
+    clusterer.setNumberOfThreads(nThreads);
+    clusterer.setMCTruthContainer(labels);
+    VectorPixelReader reader(chips);
+    clusterer.process(reader, clusters);
+  }
+
+  /// @brief Compare the clusters with the flood fill for several occupancies
+  BOOST_AUTO_TEST_CASE(Clusterer_reference)
+  {
+    std::mt19937 gen(42);
+    std::vector<ChipPixelData> chips;
+    int chipID = 0;
+    for (double occupancy : {0., 1e-4, 1e-2, 0.1, 0.3}) {
+      for (int nBlobs : {0, 1, 50}) {
+        chips.push_back(makeChip(chipID++, occupancy, nBlobs, gen));
+      }
+    }
+    chips.erase(std::remove_if(chips.begin(), chips.end(), [](const ChipPixelData& c) { return c.pixels.empty(); }), chips.end());
+
+    std::vector<Cluster> clusters;
+    runClusterer(chips, 1, clusters, nullptr);
+
+    size_t iCluster = 0;
+    for (const auto& chip : chips) {
+      for (const auto& ref : floodFill(chip)) {
+        BOOST_REQUIRE(iCluster < clusters.size());
+        const Cluster& c = clusters[iCluster];
+        BOOST_CHECK_EQUAL(c.GetUniqueID(), iCluster);
+        BOOST_CHECK_EQUAL(c.getSensorID(), chip.chipID);
+        BOOST_CHECK_EQUAL(c.getROFrame(), chip.roFrame);
+        BOOST_CHECK_EQUAL(c.getNPix(), ref.npix);
+        BOOST_CHECK_EQUAL(c.getNx(), ref.rowMax - ref.rowMin + 1);
+        BOOST_CHECK_EQUAL(c.getNz(), ref.colMax - ref.colMin + 1);
+        BOOST_CHECK_EQUAL(c.getX(), Segmentation::getFirstRowCoordinate() + ref.x*Segmentation::PitchRow/ref.npix);
+        BOOST_CHECK_EQUAL(c.getZ(), Segmentation::getFirstColCoordinate() + ref.z*Segmentation::PitchCol/ref.npix);
+        ++iCluster;
+      }
+    }
+    BOOST_CHECK_EQUAL(iCluster, clusters.size());
+  }
+
+  /// @brief Check that the parallel processing gives the same clusters and labels as the sequential one
+  BOOST_AUTO_TEST_CASE(Clusterer_parallel)
+  {
+    std::mt19937 gen(7);
+    std::vector<ChipPixelData> chips;
+    for (int chipID = 0; chipID < 2500; ++chipID) {
+      chips.push_back(makeChip(chipID, chipID % 100 == 0 ? 1e-3 : 0., 5, gen));
+    }
+
+    std::vector<Cluster> clusters1, clusters4;
+    Labels labels1, labels4;
+    runClusterer(chips, 1, clusters1, &labels1);
+    runClusterer(chips, 4, clusters4, &labels4);
+
+    BOOST_REQUIRE_EQUAL(clusters1.size(), clusters4.size());
+    for (size_t i = 0; i < clusters1.size(); ++i) {
+      BOOST_CHECK_EQUAL(clusters4[i].GetUniqueID(), i);
+      BOOST_CHECK_EQUAL(clusters4[i].getSensorID(), clusters1[i].getSensorID());
+      BOOST_CHECK_EQUAL(clusters4[i].getNPix(), clusters1[i].getNPix());
+      BOOST_CHECK_EQUAL(clusters4[i].getX(), clusters1[i].getX());
+      BOOST_CHECK_EQUAL(clusters4[i].getZ(), clusters1[i].getZ());
+    }
+
+    BOOST_REQUIRE_EQUAL(labels1.getIndexedSize(), labels4.getIndexedSize());
+    BOOST_REQUIRE_EQUAL(labels1.getNElements(), labels4.getNElements());
+    for (size_t i = 0; i < labels1.getIndexedSize(); ++i) {
+      const auto l1 = labels1.getLabels(i);
+      const auto l4 = labels4.getLabels(i);
+      BOOST_REQUIRE_EQUAL(l1.size(), l4.size());
+      for (int j = 0; j < l1.size(); ++j) {
+        BOOST_CHECK(l1[j] == l4[j]);
+        // the labels of a blob carry the chip ID as event ID
+        BOOST_CHECK_EQUAL(l1[j].getEventID(), clusters1[i].getSensorID());
+      }
+    }
+  }
+
+}
+}
@@ -22,7 +22,6 @@
 #include <exception>
 #include <sstream>
 #include <vector>
-#include <map>
 #include <TObject.h>    // for TObject
 #include <ITSMFTBase/Digit.h>
 #include "SimulationDataFormat/MCCompLabel.h"
@@ -164,8 +163,6 @@ class Chip
       mHits.clear();
     }
 
-    o2::ITSMFT::Digit* findDigit(ULong64_t key);
-    
     /// Access Hit assigned to chip at a given index
     /// @param index Index of the point
     /// @return Hit at given index (nullptr if index is out of bounds)
@@ -228,25 +225,48 @@ class Chip
     /// @return path length between points
     Double_t PathLength(const Hit *p1, const Hit *p2) const;
     
-    o2::ITSMFT::Digit* addDigit(UInt_t roframe, UShort_t row, UShort_t col, float charge, Label lbl, double timestamp);
+    /// Add a charge contribution to a pixel, the contributions are merged into digits when they are stored
+    void      addDigit(UInt_t roframe, UShort_t row, UShort_t col, float charge, Label lbl, double timestamp);
 
+    /// Move the digits with RO Frame <= maxFrame and a charge above threshold to the output array
     void      fillOutputContainer(std::vector<Digit>* digits, UInt_t maxFrame);
+
+    /// Get the number of not yet stored charge contributions
+    size_t    getNumberOfPixelContributions() const { return mPixels.size() - mFirstPixel; }
  
   protected:
+
+    /// Charge contribution to a fired pixel
+    struct PixelContribution {
+      ULong64_t key;        ///< ordering key of the pixel, see Digit::getOrderingKey
+      Double_t  timeStamp;  ///< time stamp of the contribution
+      Label     label;      ///< MC label of the contribution
+      Float_t   charge;     ///< charge of the contribution
+      UInt_t    order;      ///< order of the contribution, to merge the contributions of a pixel in the order they were added
+
+      bool operator<(const PixelContribution& other) const {
+        return key < other.key || (key == other.key && order < other.order);
+      }
+    };
+
+    /// Sort the contributions added since the last call and merge them with the already sorted ones
+    void      sortPixels();
     
     Int_t  mChipIndex = -1;     ///< Chip ID
     const DigiParams* mParams = nullptr;   ///< externally set digitization parameters   
     const o2::Base::Transform3D *mMat = nullptr;     ///< Transformation matrix
     std::vector<const Hit *>mHits;     ///< Hits connnected to the given chip
-    std::map<ULong64_t, o2::ITSMFT::Digit> mDigits; ///< Map of fired pixels, possibly in multiple frames
+    std::vector<PixelContribution> mPixels; //! Charge contributions to fired pixels, possibly in multiple frames
+    size_t mFirstPixel = 0;                 //! First contribution which was not yet stored
+    size_t mNSortedPixels = 0;              //! Number of contributions which are sorted by key
+    UInt_t mNAddedPixels = 0;               //! Counter of the added contributions
 
-    ClassDefNV(Chip,1);
+    ClassDefNV(Chip,2);
 };
 
-inline o2::ITSMFT::Digit* Chip::findDigit(ULong64_t key) {
-  // finds the digit corresponding to global key
-  auto digitentry = mDigits.find(key);
-  return digitentry != mDigits.end() ? &(digitentry->second) : nullptr;
+inline void Chip::addDigit(UInt_t roframe, UShort_t row, UShort_t col, float charge, Label lbl, double timestamp) {
+  // append the contribution, it is merged with the other ones of the same pixel when the digits are stored
+  mPixels.push_back(PixelContribution{Digit::getOrderingKey(roframe,row,col), timestamp, lbl, charge, mNAddedPixels++});
 }
 
 //_______________________________________________________________________
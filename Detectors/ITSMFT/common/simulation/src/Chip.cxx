@@ -16,6 +16,7 @@
 //  Adapted from AliITSUChip by Massimo Masera
 //
 
+#include <algorithm>
 #include <cstring>
 #include <tuple>
 
@@ -49,7 +50,10 @@ Chip &Chip::operator=(const Chip &ref)
     mMat = ref.mMat;
     mChipIndex = ref.mChipIndex;
     mHits = ref.mHits;
-    mDigits = ref.mDigits;
+    mPixels = ref.mPixels;
+    mFirstPixel = ref.mFirstPixel;
+    mNSortedPixels = ref.mNSortedPixels;
+    mNAddedPixels = ref.mNAddedPixels;
   }
   return *this;
 }
@@ -195,44 +199,54 @@ void Chip::MedianHitLocal(const Hit *p1, const Hit *p2, Double_t &x, Double_t &y
   }
 }
 
-//_______________________________________________________________________
-Digit* Chip::addDigit(UInt_t roframe, UShort_t row, UShort_t col, float charge, Label lbl, double timestamp)
+//______________________________________________________________________
+void Chip::sortPixels()
 {
-  auto key = Digit::getOrderingKey(roframe,row,col);
-  auto dig = findDigit(key);
-  if (dig) {
-    dig->addCharge(charge, lbl);
-  }
-  else {
-    auto digIter= mDigits.emplace(std::make_pair
-				  (key,Digit(static_cast<UShort_t>(mChipIndex),roframe, row, col, charge, timestamp)));
-    auto pair = digIter.first;
-    dig = &(pair->second);
-    dig->setLabel(0, lbl);
-  }
-  return dig;
+  // sort the contributions added since the last call and merge them with the already sorted ones
+  if (mNSortedPixels == mPixels.size()) return;
+  const auto first = mPixels.begin() + mFirstPixel;
+  const auto middle = mPixels.begin() + mNSortedPixels;
+  std::sort(middle, mPixels.end());
+  if (first != middle) std::inplace_merge(first, middle, mPixels.end());
+  mNSortedPixels = mPixels.size();
 }
 
 //______________________________________________________________________
 void Chip::fillOutputContainer(std::vector<Digit>* digits, UInt_t maxFrame)
 {
   // transfer digits with RO Frame < maxFrame to the output array
-  if (mDigits.empty()) return;
-  auto itBeg = mDigits.begin();
-  auto iter = itBeg;
+  if (mFirstPixel == mPixels.size()) return;
+  sortPixels();
   ULong64_t maxKey = Digit::getOrderingKey(maxFrame+1,0,0);
-  for (; iter!=mDigits.end(); ++iter) {
-    if (iter->first > maxKey) break; // is the digit ROFrame from the key > the max requested frame
+  auto iter = mPixels.begin() + mFirstPixel;
+  // is the digit ROFrame from the key > the max requested frame
+  const auto end = std::upper_bound(iter, mPixels.end(), maxKey,
+				    [](ULong64_t key, const PixelContribution& pix) { return key < pix.key; });
+  while (iter != end) {
+    // the first contribution creates the digit, the following ones of the same pixel are added in their order
+    const ULong64_t key = iter->key;
+    Digit dig(static_cast<UShort_t>(mChipIndex), static_cast<UInt_t>(key>>(8*sizeof(UInt_t))),
+	      key & 0xffff, (key>>(8*sizeof(Short_t))) & 0xffff, iter->charge, iter->timeStamp);
+    dig.setLabel(0, iter->label);
+    for (++iter; iter != end && iter->key == key; ++iter) {
+      dig.addCharge(iter->charge, iter->label);
+    }
     // apply thrshold
-    Digit &dig = iter->second;
-    //printf("Chip%d Fr:%d Q:%f R:%d C:%d\n",dig.getChipIndex(),dig.getROFrame(),dig.getCharge(), dig.getRow(),dig.getColumn());
-
     if (dig.getCharge()>mParams->getChargeThreshold() ) {
       digits->emplace_back(dig);
     }
   }
 
-  //  if (iter!=mDigits.end()) iter--;
-  mDigits.erase(itBeg, iter);
-  
+  // the buffer is recycled, the remaining contributions are moved to its front once they are less than half of it
+  mFirstPixel = end - mPixels.begin();
+  if (mFirstPixel == mPixels.size()) {
+    mPixels.clear();
+    mFirstPixel = mNSortedPixels = 0;
+    mNAddedPixels = 0;
+  }
+  else if (2*mFirstPixel > mPixels.size()) {
+    mPixels.erase(mPixels.begin(), mPixels.begin() + mFirstPixel);
+    mFirstPixel = 0;
+    mNSortedPixels = mPixels.size();
+  }
 }
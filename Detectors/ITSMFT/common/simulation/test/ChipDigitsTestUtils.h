@@ -0,0 +1,112 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ChipDigitsTestUtils.h
+/// \brief Hit generation and map based digit store shared by the tests and benchmarks of the Chip digits
+
+#ifndef ALICEO2_ITSMFT_CHIPDIGITSTESTUTILS_H_
+#define ALICEO2_ITSMFT_CHIPDIGITSTESTUTILS_H_
+
+#include "ITSMFTBase/Digit.h"
+#include "ITSMFTBase/SegmentationAlpide.h"
+#include "ITSMFTSimulation/DigiParams.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace o2 {
+namespace ITSMFT {
+namespace test {
+
+using Label = o2::MCCompLabel;
+
+/// Digit store of a chip as a map of fired pixels, as used before the flat pixel buffer
+class MapDigitStore
+{
+ public:
+  MapDigitStore(const DigiParams* par, Int_t chipindex) : mParams(par), mChipIndex(chipindex) {}
+
+  void addDigit(UInt_t roframe, UShort_t row, UShort_t col, float charge, Label lbl, double timestamp)
+  {
+    auto key = Digit::getOrderingKey(roframe,row,col);
+    auto digitentry = mDigits.find(key);
+    if (digitentry != mDigits.end()) {
+      digitentry->second.addCharge(charge, lbl);
+    }
+    else {
+      auto digIter = mDigits.emplace(std::make_pair
+				     (key,Digit(static_cast<UShort_t>(mChipIndex),roframe, row, col, charge, timestamp)));
+      digIter.first->second.setLabel(0, lbl);
+    }
+  }
+
+  void fillOutputContainer(std::vector<Digit>* digits, UInt_t maxFrame)
+  {
+    if (mDigits.empty()) return;
+    auto itBeg = mDigits.begin();
+    auto iter = itBeg;
+    ULong64_t maxKey = Digit::getOrderingKey(maxFrame+1,0,0);
+    for (; iter!=mDigits.end(); ++iter) {
+      if (iter->first > maxKey) break;
+      if (iter->second.getCharge()>mParams->getChargeThreshold() ) {
+	digits->emplace_back(iter->second);
+      }
+    }
+    mDigits.erase(itBeg, iter);
+  }
+
+ private:
+  const DigiParams* mParams;
+  Int_t mChipIndex;
+  std::map<ULong64_t, Digit> mDigits;
+};
+
+/// Charge contribution of a hit to a pixel
+struct Contribution {
+  UInt_t roframe;
+  UShort_t row, col;
+  float charge;
+  Label label;
+  double timestamp;
+};
+
+/// Generate the contributions of nHits hits to one chip in a RO frame, each hit fires a 3x3 cluster
+/// and may also be seen in the next frame, plus nNoise noise pixels
+inline std::vector<Contribution> generateFrame(UInt_t roframe, int nHits, int nNoise, std::mt19937& gen)
+{
+  std::uniform_int_distribution<int> row(1, SegmentationAlpide::NRows-2), col(1, SegmentationAlpide::NCols-2);
+  std::uniform_real_distribution<float> charge(0, 300);
+  std::uniform_int_distribution<int> track(0, 20);
+  std::vector<Contribution> contributions;
+  for (int iHit = 0; iHit < nHits; ++iHit) {
+    const int r = row(gen), c = col(gen);
+    const Label label(track(gen), roframe, 0);
+    const UInt_t nFrames = (iHit % 4 == 0) ? 2 : 1;
+    for (UInt_t frame = roframe; frame < roframe + nFrames; ++frame) {
+      for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+          contributions.push_back(Contribution{frame, UShort_t(r+dr), UShort_t(c+dc), charge(gen), label, 1000.*roframe + iHit});
+        }
+      }
+    }
+  }
+  for (int iNoise = 0; iNoise < nNoise; ++iNoise) {
+    contributions.push_back(Contribution{roframe, UShort_t(row(gen)), UShort_t(col(gen)), 165.f, Label(-1,0,0), 1000.*roframe});
+  }
+  return contributions;
+}
+
+}
+}
+}
+
+#endif
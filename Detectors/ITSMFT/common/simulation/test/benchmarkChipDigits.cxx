@@ -0,0 +1,72 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkChipDigits.cxx
+/// \brief Benchmark of the pixel buffer of the Chip against the map for a production-like number of chips and pileup
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ITSMFTSimulation/Chip.h"
+#include "ITSMFTSimulation/DigiParams.h"
+#include "ChipDigitsTestUtils.h"
+
+using namespace o2::ITSMFT;
+
+int main()
+{
+  DigiParams params;
+  std::mt19937 gen(1);
+  const int nChips = 200;
+  const UInt_t nFrames = 20;
+
+  for (int nHits : {10, 200}) {
+    std::vector<std::vector<test::Contribution>> frames;
+    size_t nContributions = 0;
+    for (UInt_t roframe = 0; roframe < nFrames; ++roframe) {
+      frames.push_back(test::generateFrame(roframe, nHits, 5, gen));
+      nContributions += frames.back().size();
+    }
+
+    std::vector<Chip> chips;
+    std::vector<test::MapDigitStore> references;
+    for (int i = 0; i < nChips; ++i) {
+      chips.emplace_back(&params, i, nullptr);
+      references.emplace_back(&params, i);
+    }
+
+    std::vector<Digit> digits, refDigits;
+    double time = 0, refTime = 0;
+    for (UInt_t roframe = 0; roframe < nFrames; ++roframe) {
+      const auto& contributions = frames[roframe];
+      auto start = std::chrono::high_resolution_clock::now();
+      for (auto& chip : chips) {
+        for (const auto& c : contributions) chip.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+        chip.fillOutputContainer(&digits, roframe);
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      time += std::chrono::duration<double>(end-start).count();
+
+      start = std::chrono::high_resolution_clock::now();
+      for (auto& reference : references) {
+        for (const auto& c : contributions) reference.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+        reference.fillOutputContainer(&refDigits, roframe);
+      }
+      end = std::chrono::high_resolution_clock::now();
+      refTime += std::chrono::duration<double>(end-start).count();
+    }
+
+    std::cout << nChips << " chips, " << nFrames << " RO frames with " << nHits << " hits per chip: "
+              << nChips*nContributions << " contributions, pixel buffer " << digits.size() << " digits in "
+              << time*1e3 << " ms, map " << refDigits.size() << " digits in " << refTime*1e3 << " ms" << std::endl;
+  }
+  return 0;
+}
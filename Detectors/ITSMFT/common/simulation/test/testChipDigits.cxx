@@ -0,0 +1,83 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ChipDigits
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "ITSMFTSimulation/Chip.h"
+#include "ITSMFTSimulation/DigiParams.h"
+#include "ChipDigitsTestUtils.h"
+
+using namespace o2::ITSMFT;
+using test::MapDigitStore;
+using test::generateFrame;
+
+namespace {
+
+void checkDigits(const std::vector<Digit>& digits, const std::vector<Digit>& reference)
+{
+  BOOST_REQUIRE_EQUAL(digits.size(), reference.size());
+  for (size_t i = 0; i < digits.size(); ++i) {
+    BOOST_CHECK_EQUAL(digits[i].getChipIndex(), reference[i].getChipIndex());
+    BOOST_CHECK_EQUAL(digits[i].getROFrame(), reference[i].getROFrame());
+    BOOST_CHECK_EQUAL(digits[i].getRow(), reference[i].getRow());
+    BOOST_CHECK_EQUAL(digits[i].getColumn(), reference[i].getColumn());
+    BOOST_CHECK_EQUAL(digits[i].getCharge(), reference[i].getCharge());
+    BOOST_CHECK_EQUAL(digits[i].GetTimeStamp(), reference[i].GetTimeStamp());
+    for (int j = 0; j < Digit::maxLabels; ++j) {
+      BOOST_CHECK(digits[i].getLabel(j) == reference[i].getLabel(j));
+    }
+  }
+}
+
+}
+
+/// @brief Compare the digits of the pixel buffer with the ones of the map in continuous and triggered mode
+BOOST_AUTO_TEST_CASE(ChipDigits_reference)
+{
+  DigiParams params;
+  std::mt19937 gen(3);
+
+  // continuous readout: the hits of a frame may contribute to the next one, the frames are stored one by one
+  for (int nHits : {1, 50, 2000}) {
+    Chip chip(&params, 5, nullptr);
+    MapDigitStore reference(&params, 5);
+    std::vector<Digit> digits, refDigits;
+    for (UInt_t roframe = 0; roframe < 10; ++roframe) {
+      for (const auto& c : generateFrame(roframe, nHits, nHits/10, gen)) {
+        chip.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+        reference.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+      }
+      chip.fillOutputContainer(&digits, roframe);
+      reference.fillOutputContainer(&refDigits, roframe);
+      checkDigits(digits, refDigits);
+    }
+    chip.fillOutputContainer(&digits, 10);
+    reference.fillOutputContainer(&refDigits, 10);
+    checkDigits(digits, refDigits);
+    BOOST_CHECK_EQUAL(chip.getNumberOfPixelContributions(), 0);
+  }
+
+  // triggered readout: all frames are stored at once
+  Chip chip(&params, 7, nullptr);
+  MapDigitStore reference(&params, 7);
+  std::vector<Digit> digits, refDigits;
+  for (UInt_t roframe = 0; roframe < 3; ++roframe) {
+    for (const auto& c : generateFrame(roframe, 500, 50, gen)) {
+      chip.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+      reference.addDigit(c.roframe, c.row, c.col, c.charge, c.label, c.timestamp);
+    }
+  }
+  chip.fillOutputContainer(&digits, 3);
+  reference.fillOutputContainer(&refDigits, 3);
+  checkDigits(digits, refDigits);
+}
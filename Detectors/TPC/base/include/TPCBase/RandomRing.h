@@ -19,7 +19,10 @@
 /// The idea is to create a set of random numbers that can be
 /// reused in order to save computing time.
 /// The numbers can then be used as a continuous stream in
-/// a ring buffer
+/// a ring buffer.
+/// The random numbers are never modified once they are filled, such that
+/// copies of a ring share them and only have their own position.
+/// A copy can be restricted to a disjoint part of the ring, see setStream.
 ///
 /// origin: TPC
 /// @author Jens Wiechula, Jens.Wiechula@cern.ch
@@ -30,6 +33,8 @@
 #include <boost/format.hpp>
 
 #include "Vc/Vc"
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "TF1.h"
@@ -49,6 +54,10 @@ class RandomRing
       CustomTF1,             ///< Custom TF1 function to be used
       None                   ///< Not selected, yet
     };
+
+    /// buffer holding the random numbers
+    using Buffer = std::vector<float, Vc::Allocator<float>>;
+
     /// constructor
     /// @param [in] size size of the ring buffer
     RandomRing();
@@ -73,14 +82,24 @@ class RandomRing
     /// @param [in] size size of the ring buffer
     void initialize(TF1 &function, const size_t size = 500000);
 
+    /// copy constructor
+    /// The copy shares the random numbers with the original ring
+    /// and starts at the same position
+    RandomRing(const RandomRing &) = default;
+
+    /// assignment operator
+    /// The random numbers are shared with the other ring
+    RandomRing &operator=(const RandomRing &) = default;
+
     /// next random value from the ring buffer
     /// This function return a value from the ring buffer
     /// and increases the buffer position
     /// @return next random value
     float getNextValue()
     {
-      const float value = mRandomNumbers[mRingPosition];
-      ++mRingPosition %= mRandomNumbers.size();
+      const Buffer &numbers = *mRandomNumbers;
+      const float value = numbers[mRingPosition];
+      if (++mRingPosition >= mStreamEnd) mRingPosition = mStreamBegin;
       return value;
     }
 
@@ -91,42 +110,75 @@ class RandomRing
     /// @return vector with random values
     float_v getNextValueVc()
     {
-      const float_v value = float_v(&mRandomNumbers[mRingPosition]);
+      const Buffer &numbers = *mRandomNumbers;
+      const float_v value = float_v(&numbers[mRingPosition]);
       mRingPosition += float_v::size();
-      mRingPosition %= mRandomNumbers.size();
+      if (mRingPosition >= mStreamEnd) mRingPosition = mStreamBegin;
       return value;
     }
 
+    /// fill a buffer with the next random values from the ring buffer
+    /// This function copies the values in contiguous chunks, taking care
+    /// of the wrap around, and increases the buffer position by n
+    /// @param [out] values buffer to be filled, must hold at least n values
+    /// @param [in] n number of random values
+    void getNextValues(float *values, size_t n)
+    {
+      const Buffer &numbers = *mRandomNumbers;
+      while (n > 0) {
+        const size_t chunk = std::min<size_t>(n, mStreamEnd - mRingPosition);
+        std::copy_n(&numbers[mRingPosition], chunk, values);
+        values += chunk;
+        n -= chunk;
+        mRingPosition += chunk;
+        if (mRingPosition >= mStreamEnd) mRingPosition = mStreamBegin;
+      }
+    }
+
     /// position in the ring buffer
     /// @return position in the ring buffer
     unsigned int getRingPosition() const { return  mRingPosition; }
 
+    /// restrict the ring to one of several equal, disjoint parts
+    /// This allows several copies of a ring to read independent random numbers:
+    /// each copy starts at the beginning of its part and wraps around within it.
+    /// The size of the parts is a multiple of the Vc vector size, as for getNextValueVc.
+    /// If the ring is too small to be split, the full ring is used
+    /// @param [in] stream index of the part
+    /// @param [in] nStreams number of parts
+    void setStream(int stream, int nStreams)
+    {
+      const size_t part = mRandomNumbers->size() / nStreams / float_v::size() * float_v::size();
+      if (part == 0) {
+        mStreamBegin = 0;
+        mStreamEnd = mRandomNumbers->size();
+      }
+      else {
+        mStreamBegin = stream * part;
+        mStreamEnd = mStreamBegin + part;
+      }
+      mRingPosition = mStreamBegin;
+    }
+
   private:
     // =========================================================================
     // ===| members |===========================================================
     //
 
     RandomType mRandomType;                                   ///< Type of random numbers used
-    std::vector<float, Vc::Allocator<float>> mRandomNumbers;  ///< Ring with random gaus numbers
+    std::shared_ptr<const Buffer> mRandomNumbers;             ///< Ring with random gaus numbers, shared by the copies
     unsigned int mRingPosition;                               ///< presently accessed position in the ring
-
-    // =========================================================================
-    // ===| functions |=========================================================
-    //
-
-    /// disallow copy constructor
-    RandomRing(const RandomRing &);
-
-    /// disallow assignment operator
-    void operator=(const RandomRing &) {}
-
+    unsigned int mStreamBegin;                                ///< first position of the part of the ring in use
+    unsigned int mStreamEnd;                                  ///< one past the last position of the part of the ring in use
 }; // end class RandomRing
 
 //______________________________________________________________________________
 inline RandomRing::RandomRing()
   : mRandomType(RandomType::None),
     mRandomNumbers(),
-    mRingPosition(float_v::size())
+    mRingPosition(float_v::size()),
+    mStreamBegin(0),
+    mStreamEnd(0)
 {
   initialize(RandomType::None, float_v::size());
 }
@@ -134,8 +186,10 @@ inline RandomRing::RandomRing()
 //______________________________________________________________________________
 inline RandomRing::RandomRing(const RandomType randomType, const size_t size)
   : mRandomType(randomType),
-    mRandomNumbers(size),
-    mRingPosition(0)
+    mRandomNumbers(),
+    mRingPosition(0),
+    mStreamBegin(0),
+    mStreamEnd(0)
 
 {
   initialize(randomType, size);
@@ -144,8 +198,10 @@ inline RandomRing::RandomRing(const RandomType randomType, const size_t size)
 //______________________________________________________________________________
 inline RandomRing::RandomRing(TF1 &function, const size_t size)
   : mRandomType(RandomType::CustomTF1),
-    mRandomNumbers(size),
-    mRingPosition(0)
+    mRandomNumbers(),
+    mRingPosition(0),
+    mStreamBegin(0),
+    mStreamEnd(0)
 {
   initialize(function, size);
 }
@@ -153,9 +209,9 @@ inline RandomRing::RandomRing(TF1 &function, const size_t size)
 //______________________________________________________________________________
 inline void RandomRing::initialize(const RandomType randomType, const size_t size)
 {
-  mRandomNumbers.resize(size);
+  auto numbers = std::make_shared<Buffer>(size);
 
-  for (auto &v : mRandomNumbers) {
+  for (auto &v : *numbers) {
     // TODO: configurable mean and sigma
     switch (randomType) {
       case RandomType::Gaus: {
@@ -172,16 +228,22 @@ inline void RandomRing::initialize(const RandomType randomType, const size_t siz
       }
     }
   }
+  mRandomNumbers = numbers;
+  mStreamBegin = 0;
+  mStreamEnd = size;
 }
 
 //______________________________________________________________________________
 inline void RandomRing::initialize(TF1 &function, const size_t size)
 {
-  mRandomNumbers.resize(size);
+  auto numbers = std::make_shared<Buffer>(size);
 
-  for (auto &v : mRandomNumbers) {
+  for (auto &v : *numbers) {
     v = function.GetRandom();
   }
+  mRandomNumbers = numbers;
+  mStreamBegin = 0;
+  mStreamEnd = size;
 }
 
 
@@ -17,6 +17,7 @@
 #include "TPCReconstruction/GBTFrame.h"
 #include "TPCReconstruction/AdcClockMonitor.h"
 #include "TPCReconstruction/SyncPatternMonitor.h"
+#include "TPCReconstruction/GBTFrameDecoder.h"
 #include "TPCReconstruction/HalfSAMPAData.h"
 #include "TPCBase/Digit.h"
 #include "TPCBase/Mapper.h" 
@@ -24,7 +25,6 @@
 
 #include <iterator>
 #include <vector>
-#include <queue>
 #include <array>
 #include <mutex>
 
@@ -60,7 +60,7 @@ class GBTFrameContainer {
     GBTFrameContainer(int size, int cru, int link);
 
     /// Destructor
-    ~GBTFrameContainer();
+    ~GBTFrameContainer() = default;
 
     /// Reset function to clear container
     void reset();
@@ -118,6 +118,11 @@ class GBTFrameContainer {
 
 //    template<typename... Args> void addGBTFrame(Args&&... args);
 
+    /// Add a block of frames to the container, they are processed at once
+    /// @param words Raw GBT frames, 4 words per frame with the bits [127:96] in the first word
+    /// @param nFrames Number of frames
+    void addGBTFrames(const uint32_t* words, int nFrames);
+
     /// Add all frames from file to conatiner
     /// @param fileName Path to file
     void addGBTFramesFromFile(std::string fileName);
@@ -202,17 +207,22 @@ class GBTFrameContainer {
     /// @param iFrame GBT Frame to be processed (ordering is important!!)
     void processFrame(std::vector<GBTFrame>::iterator iFrame);
 
+    /// Processes a block of frames, monitors ADC clock, searches for sync pattern,...
+    /// @param words Raw GBT frames, 4 words per frame (ordering is important!!)
+    /// @param nFrames Number of frames
+    void processFrames(const uint32_t* words, int nFrames);
+
     /// Checks the ADC clock;
-    /// @param iFrame GBT Frame to be processed (ordering is important!!)
-    void checkAdcClock(std::vector<GBTFrame>::iterator iFrame);
+    /// @param words Raw GBT frames, 4 words per frame (ordering is important!!)
+    /// @param nFrames Number of frames
+    void checkAdcClock(const uint32_t* words, int nFrames);
 
-    /// Searches for the synchronization pattern
-    /// @param iFrame GBT Frame to be processed (ordering is important!!)
-    void searchSyncPattern(std::vector<GBTFrame>::iterator iFrame);
+    /// Checks that the sync pattern positions of all half SAMPAs agree
+    void checkSyncPattern();
 
-    // Compiles the ADC values
-    /// @param iFrame GBT Frame to be processed (ordering is important!!)
-    void compileAdcValues(std::vector<GBTFrame>::iterator iFrame);
+    /// Takes the ADC values of one time bin (16 channels) of every half SAMPA
+    /// @return True if data of at least one half SAMPA was available
+    bool fillTmpData();
 
     void resetAdcClock();
     void resetSyncPattern();
@@ -222,9 +232,9 @@ class GBTFrameContainer {
 
     std::vector<GBTFrame> mGBTFrames;                ///< GBT Frames container
     std::array<AdcClockMonitor,3> mAdcClock;        ///< ADC clock monitor for the 3 SAMPAs
-    std::array<SyncPatternMonitor,5> mSyncPattern;  ///< Synchronization pattern monitor for the 5 half SAMPAs
-    std::array<short,10> mPositionForHalfSampa;      ///< Start position of data for all 5 half SAMPAs
-    std::array<std::queue<short>*,5> mAdcValues;    ///< Vector to buffer the decoded ADC values, one deque per half SAMPA 
+    GBTFrameDecoder mDecoder;                       ///< Sync pattern search and ADC value decoding for the 5 half SAMPAs
+    std::array<std::vector<short>,5> mAdcValues;    ///< Buffer of the decoded ADC values, one per half SAMPA
+    std::array<size_t,5> mAdcReadPosition;          ///< Position of the first not yet extracted value in mAdcValues
 
     bool mEnableAdcClockWarning;                    ///< enables the ADC clock warnings
     bool mEnableSyncPatternWarning;                 ///< enables the Sync Pattern warnings
@@ -0,0 +1,82 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GBTFrameDecoder.h
+/// \brief Bulk decoder of GBT frames into ADC values
+#ifndef ALICEO2_TPC_GBTFRAMEDECODER_H_
+#define ALICEO2_TPC_GBTFRAMEDECODER_H_
+
+#include "TPCReconstruction/SyncPatternMonitor.h"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace o2 {
+namespace TPC {
+
+/// \class GBTFrameDecoder
+/// \brief Decodes blocks of raw GBT frames into the ADC values of the 5 half SAMPAs
+///
+/// The half-words of all frames of a block are first extracted into one contiguous
+/// stream per half SAMPA. The synchronization pattern is searched in these streams
+/// and the ADC values are assembled from pairs of consecutive half-words, starting
+/// at the position given by the pattern. The state (sync pattern monitors, found
+/// positions and the last frame) is kept between blocks, such that a data stream
+/// can be split into blocks of arbitrary size.
+class GBTFrameDecoder {
+  public:
+
+    /// Default constructor
+    GBTFrameDecoder();
+
+    /// Destructor
+    ~GBTFrameDecoder() = default;
+
+    /// Reset the sync pattern monitors and the decoding state
+    void reset();
+
+    /// Decode a block of GBT frames
+    /// @param words Raw GBT frames, frameStride words per frame with the bits [127:96] in the first word
+    /// @param nFrames Number of frames in the block
+    /// @param adcValues Output array for each half SAMPA with space for 2*nFrames values,
+    ///                  if nullptr, the sync pattern is searched but no values are written
+    /// @param frameStride Distance of two consecutive frames in words
+    /// @return Number of ADC values written for each half SAMPA
+    std::array<int,5> decode(const uint32_t* words, int nFrames, const std::array<short*,5>& adcValues, int frameStride = 4);
+
+    /// Get the position of the sync pattern
+    /// @param halfSampa Half SAMPA
+    /// @return Position of the first half-word of an ADC value in a frame, -1 if the pattern was not found yet
+    short getPosition(int halfSampa) const { return mPosition[halfSampa]; };
+
+  private:
+
+    /// Extract the 4 half-words of each half SAMPA of all frames of a block
+    void extractHalfWords(const uint32_t* words, int nFrames, int frameStride);
+
+    /// Assemble the ADC values from pairs of consecutive half-words
+    /// @param hw Half-word stream of a half SAMPA
+    /// @param firstFrame First frame to decode
+    /// @param lastFrame One past the last frame to decode
+    /// @param position Position of the sync pattern
+    /// @param adcValues Output array
+    /// @return Number of written ADC values
+    static int assembleAdcValues(const short* hw, int firstFrame, int lastFrame, short position, short* adcValues);
+
+    std::array<SyncPatternMonitor,5> mSyncPattern;  ///< Synchronization pattern monitor for the 5 half SAMPAs
+    std::array<short,5> mPosition;                  ///< Position of the sync pattern for the 5 half SAMPAs
+    std::array<std::vector<short>,5> mHalfWords;    ///< Half-words of the last frame of the previous block, followed by the ones of the current block
+};
+
+}
+}
+
+#endif
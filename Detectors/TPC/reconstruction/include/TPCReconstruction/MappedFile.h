@@ -0,0 +1,71 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_TPC_MAPPEDFILE_H_
+#define O2_TPC_MAPPEDFILE_H_
+
+/// \file MappedFile.h
+/// \brief Read only memory mapping of a file
+
+#include <string>
+#include <cstddef>
+
+namespace o2 {
+namespace TPC {
+
+/// \class MappedFile
+/// \brief Read only memory mapping of a complete file
+///
+/// The pages are only read from disk when they are accessed, they can be
+/// requested in advance with prefetch().
+class MappedFile {
+  public:
+
+    /// Constructor, maps the file
+    /// @param path Path to the file
+    MappedFile(const std::string& path);
+
+    /// Destructor, unmaps the file
+    ~MappedFile();
+
+    /// Check if the file was mapped
+    /// @return True if the file could be opened and mapped
+    bool isOpen() const { return mIsOpen; };
+
+    /// Get the path
+    /// @return Path to the file
+    const std::string& getPath() const { return mPath; };
+
+    /// Get the mapped data
+    /// @return Pointer to the first byte of the file
+    const char* data() const { return mData; };
+
+    /// Get the size
+    /// @return Size of the file in bytes
+    size_t size() const { return mSize; };
+
+    /// Read the pages of a range of the file into memory
+    /// @param offset Position of the range in the file
+    /// @param length Length of the range in bytes
+    void prefetch(size_t offset, size_t length) const;
+
+  private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    std::string mPath;          ///< Path to the file
+    const char* mData;          ///< Mapped data
+    size_t mSize;               ///< Size of the file
+    bool mIsOpen;               ///< File is mapped
+};
+
+}
+}
+#endif
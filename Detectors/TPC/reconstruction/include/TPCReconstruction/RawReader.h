@@ -15,20 +15,27 @@
 /// \author Sebastian Klewin (Sebastian.Klewin@cern.ch)
 
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <memory>
 #include <utility>
 #include <tuple>
+#include <future>
 
 #include "TPCBase/PadPos.h"
 #include "TPCBase/CalDet.h"
+#include "TPCReconstruction/MappedFile.h"
 
 namespace o2 {
 namespace TPC {
 
 /// \class RawReader
 /// \brief Reader for RAW TPC data
+///
+/// The input files are memory mapped, the headers are indexed in a single scan
+/// when a file is added and the payload is decoded directly from the mapped pages.
 /// \author Sebastian Klewin (Sebastian.Klewin@cern.ch)
 class RawReader {
   public:
@@ -45,15 +52,15 @@ class RawReader {
 
       /// Get the timestamp
       /// @return corrected header time stamp
-      uint64_t timeStamp() { return (timeStamp_w << 32) | (timeStamp_w >> 32);}
+      uint64_t timeStamp() const { return (timeStamp_w << 32) | (timeStamp_w >> 32);}
 
       /// Get event counter
       /// @return corrected event counter
-      uint64_t eventCount() { return (eventCount_w << 32) | (eventCount_w >> 32);}
+      uint64_t eventCount() const { return (eventCount_w << 32) | (eventCount_w >> 32);}
 
       /// Get reserved data field
       /// @return corrected data field
-      uint64_t reserved_2() { return (reserved_2_w << 32) | (reserved_2_w >> 32);}
+      uint64_t reserved_2() const { return (reserved_2_w << 32) | (reserved_2_w >> 32);}
 
       /// Default constructor
       Header() {};
@@ -67,7 +74,7 @@ class RawReader {
     /// Data struct
     struct EventInfo {
       std::string path;     ///< Path to data file
-      int posInFile;        ///< Position in data file
+      int64_t posInFile;    ///< Position in data file
       Header header;        ///< Header of this evend
 
       /// Default constructor
@@ -132,15 +139,15 @@ class RawReader {
 
     /// Get the first event
     /// @return Event number of first event in data
-    uint64_t getFirstEvent() const { return mEvents.begin()->first; };
+    uint64_t getFirstEvent() const { return mEvents.empty() ? 0 : mEvents.front().event; };
 
     /// Get the last event
     /// @return Event number of last event in data
-    uint64_t getLastEvent() const {  return (mEvents.size() == 0) ? mEvents.begin()->first : mEvents.rbegin()->first; };
+    uint64_t getLastEvent() const { return mEvents.empty() ? 0 : mEvents.back().event; };
 
     /// Get number of events
     /// @return If events are continous, it's the number of stored events
-    int getNumberOfEvents() const { return  mEvents.size(); };
+    int getNumberOfEvents() const { return mNumberOfEvents; };
 
     /// Get time stamp of first data
     /// @param hf half SAMPA
@@ -168,6 +175,10 @@ class RawReader {
     void setPrintRawData(bool val) { mPrintRawData = val; };
     void setCheckAdcClock(bool val) { mCheckAdcClock = val; };
 
+    /// Read the pages of the next event into memory on a background thread after an event was loaded
+    /// @param val Enables the prefetching
+    void setPrefetchNextEvent(bool val) { mPrefetchNextEvent = val; };
+
     /// Returns some innformation about the event, e.g. the header
     /// @param event Event number
     /// @return shared pointer to vector with event informations
@@ -177,8 +188,38 @@ class RawReader {
 
   private:
 
-    bool decodeRawGBTFrames(EventInfo eventInfo);
-    bool decodePreprocessedData(EventInfo eventInfo);
+    /// Entry of the event index
+    struct IndexEntry {
+      uint64_t event;       ///< Event number
+      uint64_t posInFile;   ///< Position of the payload in the file
+      uint32_t file;        ///< Index of the file in mFiles
+    };
+
+    /// Get the index entries of an event
+    /// @param event Event number
+    /// @return Range of index entries, in the order the files were added
+    std::pair<std::vector<IndexEntry>::const_iterator, std::vector<IndexEntry>::const_iterator> getEventRange(uint64_t event) const;
+
+    /// Get the header of an index entry
+    /// @param entry Index entry
+    /// @return Copy of the header in the mapped file
+    Header getHeader(const IndexEntry& entry) const;
+
+    /// Read the pages of an event into memory on a background thread
+    /// @param event Event number
+    void prefetchEvent(uint64_t event);
+
+    /// Decode the GBT frames of an event
+    /// @param header Header of the event
+    /// @param words Payload of the event
+    /// @param nWords Number of 32 bit words in the payload
+    bool decodeRawGBTFrames(Header header, const uint32_t* words, int nWords);
+
+    /// Decode the preprocessed data of an event
+    /// @param header Header of the event
+    /// @param words Payload of the event
+    /// @param nWords Number of 32 bit words in the payload
+    bool decodePreprocessedData(Header header, const uint32_t* words, int nWords);
 
     int mRegion;                        ///< Region of the data
     int mLink;                          ///< FEC of the data
@@ -187,9 +228,13 @@ class RawReader {
     bool mApplyChannelMask;             ///< apply channel mask
     bool mCheckAdcClock;                ///< check the ADC clock
     bool mPrintRawData;                 ///< print the RAW data while decoding
+    bool mPrefetchNextEvent;            ///< read the next event into memory after loading one
     int64_t mLastEvent;                 ///< Number of last loaded event
     std::array<uint64_t,5> mTimestampOfFirstData;   ///< Time stamp of first decoded ADC value, individually for each half sampa
-    std::map<uint64_t, std::shared_ptr<std::vector<EventInfo>>> mEvents;                ///< all "event data" - headers, file path, etc. NOT actual data
+    std::vector<std::shared_ptr<const MappedFile>> mFiles;                             ///< memory mapped input files, shared between copies
+    std::vector<IndexEntry> mEvents;                                                    ///< index of all events, sorted by event number
+    int mNumberOfEvents;                                                                ///< number of different event numbers in the index
+    std::shared_future<void> mPrefetch;                                                 ///< prefetching of the next event
     std::map<PadPos,std::shared_ptr<std::vector<uint16_t>>> mData;                      ///< ADC values of last loaded Event
     std::map<PadPos,std::shared_ptr<std::vector<uint16_t>>>::iterator mDataIterator;    ///< Iterator to last requested data
     std::array<short,5> mSyncPos;       ///< positions of the sync pattern (for readout mode 3)
@@ -198,14 +243,35 @@ class RawReader {
     std::vector<std::tuple<short,short,short>> mAdcError;
 };
 
+inline
+std::pair<std::vector<RawReader::IndexEntry>::const_iterator, std::vector<RawReader::IndexEntry>::const_iterator>
+RawReader::getEventRange(uint64_t event) const {
+  auto first = std::lower_bound(mEvents.begin(), mEvents.end(), event,
+      [](const IndexEntry& entry, uint64_t ev) { return entry.event < ev; });
+  auto last = std::upper_bound(first, mEvents.end(), event,
+      [](uint64_t ev, const IndexEntry& entry) { return ev < entry.event; });
+  return std::make_pair(first, last);
+};
+
+inline
+RawReader::Header RawReader::getHeader(const IndexEntry& entry) const {
+  Header header;
+  std::memcpy(&header, mFiles[entry.file]->data() + entry.posInFile - sizeof(Header), sizeof(Header));
+  return header;
+};
+
 inline
 std::shared_ptr<std::vector<RawReader::EventInfo>> RawReader::getEventInfo(uint64_t event) const {
-  auto evIterator = mEvents.find(event);
-  if (evIterator == mEvents.end()) {
-    std::shared_ptr<std::vector<EventInfo>> emptyVecPtr(new std::vector<EventInfo>);
-    return emptyVecPtr;
+  auto eventInfos = std::make_shared<std::vector<EventInfo>>();
+  const auto range = getEventRange(event);
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    EventInfo eD;
+    eD.path = mFiles[entry->file]->getPath();
+    eD.posInFile = entry->posInFile;
+    eD.header = getHeader(*entry);
+    eventInfos->push_back(eD);
   }
-  return evIterator->second;
+  return eventInfos;
 };
 
 inline
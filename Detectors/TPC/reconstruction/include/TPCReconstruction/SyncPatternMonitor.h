@@ -18,6 +18,8 @@
 #include <iostream>
 #include <iomanip>
 #include <array>
+#include <vector>
+#include <cstdint>
 
 namespace o2 {
 namespace TPC {
@@ -51,6 +53,14 @@ class SyncPatternMonitor {
     /// @return Position of first part of the synchronization pattern, -1 if no pattern was found
     short addSequence(const short hw0, const short hw1, const short hw2, const short hw3);
 
+    /// Adds the half-words of several GBT frames and looks for sync pattern, stops after the
+    /// frame in which the pattern was found. Equivalent to calling addSequence for each frame,
+    /// but half-words which can't complete the pattern are skipped after a vectorised scan.
+    /// @param hw Half-words of the frames, 4 consecutive (timewise) half-words per frame
+    /// @param nFrames Number of frames
+    /// @return Number of processed frames, the last one contained the end of the pattern if it is less than nFrames
+    int addSequences(const short* hw, int nFrames);
+
     /// Get position
     /// @return Position of first part of the synchronization pattern, -1 if no patter was found
     short getPosition() { return mPatternFound ? mHwWithPattern : -1; };
@@ -81,7 +91,8 @@ class SyncPatternMonitor {
 
     void patternFound(const short hw); 
 
-    void checkWord(const short hw, const short pos);
+    /// @return True if the pattern was completed with this half-word
+    bool checkWord(const short hw, const short pos);
 
     bool mPatternFound;     ///< store whether pattern was already found
     short mPosition;        ///< position of last part of the pattern
@@ -89,6 +100,7 @@ class SyncPatternMonitor {
     int mSampa;             ///< SAMPA number
     int mLowHigh;           ///< Low or high bits
     unsigned mCheckedWords; ///< Counter for half words got checked
+    std::vector<uint64_t> mPatternWords; ///< Bit mask of the half words which are A or B, scratch space for addSequences
 
 };
 
@@ -100,7 +112,7 @@ short SyncPatternMonitor::addSequence(const short hw0, const short hw1, const sh
 };
 
 inline
-void SyncPatternMonitor::checkWord(const short hw, const short pos) {
+bool SyncPatternMonitor::checkWord(const short hw, const short pos) {
   ++mCheckedWords;
   if (hw == SYNC_PATTERN[mPosition]) ++mPosition;
   else if (! (mPosition == SYNC_START+2 && hw == SYNC_PATTERN[mPosition-1])) mPosition = SYNC_START;
@@ -114,7 +126,11 @@ void SyncPatternMonitor::checkWord(const short hw, const short pos) {
   //              |
   //             real start
   
-  if (mPosition == 32) patternFound(pos); 
+  if (mPosition == 32) {
+    patternFound(pos);
+    return true;
+  }
+  return false;
 };
 
 inline
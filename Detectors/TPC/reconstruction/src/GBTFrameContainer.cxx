@@ -13,6 +13,7 @@
 
 #include "TPCReconstruction/GBTFrameContainer.h"
 #include <bitset>
+#include <algorithm>
 
 using namespace o2::TPC;
 
@@ -34,13 +35,9 @@ GBTFrameContainer::GBTFrameContainer(int size, int cru, int link)
       AdcClockMonitor(0),
       AdcClockMonitor(1),
       AdcClockMonitor(2)})
-  , mSyncPattern({
-      SyncPatternMonitor(0,0),
-      SyncPatternMonitor(0,1),
-      SyncPatternMonitor(1,0),
-      SyncPatternMonitor(1,1),
-      SyncPatternMonitor(2,0)})
-  , mPositionForHalfSampa({-1,-1,-1,-1,-1,-1,-1,-1,-1,-1})
+  , mDecoder()
+  , mAdcValues()
+  , mAdcReadPosition()
   , mGBTFrames()
   , mGBTFramesAnalyzed(0)
   , mCRU(cru)
@@ -48,17 +45,28 @@ GBTFrameContainer::GBTFrameContainer(int size, int cru, int link)
   , mTimebin(0)
 {
   mGBTFrames.reserve(size);
-
-  for (auto &aAdcValues : mAdcValues) {
-    aAdcValues = new std::queue<short>;
-  }
+  mAdcReadPosition.fill(0);
 }
 
-GBTFrameContainer::~GBTFrameContainer()
+void GBTFrameContainer::addGBTFrames(const uint32_t* words, int nFrames)
 {
-  for (auto &aAdcValues : mAdcValues) {
-    delete aAdcValues;
+  if (mEnableStoreGBTFrames) {
+    mGBTFrames.reserve(mGBTFrames.size() + nFrames);
+    for (int iFrame = 0; iFrame < nFrames; ++iFrame) {
+      mGBTFrames.emplace_back(words[4*iFrame], words[4*iFrame+1], words[4*iFrame+2], words[4*iFrame+3]);
+    }
+  } else {
+    // only the last two frames are kept
+    for (int iFrame = std::max(0, nFrames-2); iFrame < nFrames; ++iFrame) {
+      if (mGBTFrames.size() > 1) {
+        mGBTFrames[0] = mGBTFrames[1];
+        mGBTFrames[1].setData(words[4*iFrame], words[4*iFrame+1], words[4*iFrame+2], words[4*iFrame+3]);
+      } else {
+        mGBTFrames.emplace_back(words[4*iFrame], words[4*iFrame+1], words[4*iFrame+2], words[4*iFrame+3]);
+      }
+    }
   }
+  processFrames(words, nFrames);
 }
 
 void GBTFrameContainer::addGBTFramesFromFile(std::string fileName)
@@ -122,9 +130,15 @@ void GBTFrameContainer::addGBTFramesFromBinaryFile(std::string fileName, std::st
       }
     }
   } else if (type == "trorc") {
-    while (!file.eof() && ((frames == -1) || (mGBTFramesAnalyzed < frames))) {
-      file.read((char*)&words,4*sizeof(words[0]));
-      addGBTFrame(words[0],words[1],words[2],words[3]); 
+    // the frames are read and processed in blocks
+    const int blockSize = 4096;
+    std::vector<uint32_t> block(4*blockSize);
+    while ((frames == -1) || (mGBTFramesAnalyzed < frames)) {
+      const int nRequested = (frames == -1) ? blockSize : std::min(blockSize, frames - mGBTFramesAnalyzed);
+      file.read((char*)block.data(), 4*nRequested*sizeof(block[0]));
+      const int nFrames = file.gcount() / (4*sizeof(block[0]));
+      if (nFrames == 0) break;
+      addGBTFrames(block.data(), nFrames);
     }
   } else if (type == "trorc2") {
     //
@@ -153,10 +167,9 @@ void GBTFrameContainer::addGBTFramesFromBinaryFile(std::string fileName, std::st
 
       switch (readoutMode) {
         case 1: {// raw GBT frames
-          for (int i=0; i<(n_words-8); i= i+4) {
-            file.read((char*)&words,4*sizeof(words[0]));
-            addGBTFrame(words[0],words[1],words[2],words[3]); 
-          }
+          std::vector<uint32_t> block(n_words-8);
+          file.read((char*)block.data(), block.size()*sizeof(block[0]));
+          addGBTFrames(block.data(), file.gcount() / (4*sizeof(block[0])));
           break;
           }
 
@@ -187,24 +200,15 @@ void GBTFrameContainer::addGBTFramesFromBinaryFile(std::string fileName, std::st
 	    adcValues[0][((ids[0] & 0x7)*2)+1] = (((ids[0]>>3)&0x1) == 0) ? 0 : (words[1] >> 16) & 0x3FF;
             adcValues[0][((ids[0] & 0x7)*2)  ] = (((ids[0]>>3)&0x1) == 0) ? 0 : ((words[0] & 0xF) << 6) | ((words[1] >> 26) & 0x3F);
 
-            for (int j=0; j<5; ++j) {
-              std::cout << std::bitset<4>(ids[j]) << " " <<  adcValues[0][((ids[0] & 0x7)*2)  ] << " " << adcValues[0][((ids[0] & 0x7)*2)+1] << std::endl;
-            }
-            std::cout << std::endl;
-                                                                                                                      
+
             for (int j=0; j<5; ++j) {
               if (ids[j] == 0x8) writeValue[j] = true;
             }
             for (int j=0; j<5; ++j) {
               if ((writeValue[j] & ids[j]) == 0xF) {
-                for (int k=0; k<16; ++k) {
-                  mAdcValues[j]->push(adcValues[j][k]);
-                  std::cout << adcValues[j][k] << " ";
-                }
-                std::cout << std::endl;
+                mAdcValues[j].insert(mAdcValues[j].end(), adcValues[j].begin(), adcValues[j].end());
               }
             }
-            std::cout << std::endl;
           }
 
           mAdcMutex.unlock();
@@ -243,9 +247,7 @@ void GBTFrameContainer::addGBTFramesFromBinaryFile(std::string fileName, std::st
             }
             for (int j=0; j<5; ++j) {
               if ((writeValue[j] & ids[j]) == 0xF) {
-                for (int k=0; k<16; ++k) {
-                  mAdcValues[j]->push(adcValues[j][k]);
-                }
+                mAdcValues[j].insert(mAdcValues[j].end(), adcValues[j].begin(), adcValues[j].end());
               }
             }
           }
@@ -295,10 +297,10 @@ void GBTFrameContainer::processAllFrames()
 {
 
   mAdcMutex.lock();
-  for (std::array<std::queue<short>*,5>::iterator it = mAdcValues.begin(); it != mAdcValues.end(); ++it) {
-    if ((*it)->size() > 0) {
+  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+    if (mAdcValues[iHalfSampa].size() > mAdcReadPosition[iHalfSampa]) {
       LOG(WARNING) << "There are already some ADC values for half SAMPA " 
-        << std::distance(mAdcValues.begin(),it) 
+        << iHalfSampa
         << " , maybe the frames were already processed." << FairLogger::endl;
     }
   }
@@ -311,147 +313,103 @@ void GBTFrameContainer::processAllFrames()
 
 void GBTFrameContainer::processFrame(std::vector<GBTFrame>::iterator iFrame)
 {
-  ++mGBTFramesAnalyzed;
-
-  if (mEnableAdcClockWarning) checkAdcClock(iFrame);
-
-  searchSyncPattern(iFrame);
-
-  if (mEnableCompileAdcValues) compileAdcValues(iFrame);
+  uint32_t words[4];
+  iFrame->getGBTFrame(words[0], words[1], words[2], words[3]);
+  processFrames(words, 1);
 }
 
-void GBTFrameContainer::compileAdcValues(std::vector<GBTFrame>::iterator iFrame)
+void GBTFrameContainer::processFrames(const uint32_t* words, int nFrames)
 {
-  short value1;
-  short value2;
-  mAdcMutex.lock();
-  for (short iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
-    if (mPositionForHalfSampa[iHalfSampa] == -1) continue;
-    if (mPositionForHalfSampa[iHalfSampa+5] == -1) continue;
-
-    switch(mPositionForHalfSampa[iHalfSampa]) {
-      case 0:
-        value1 = 
-            (iFrame->getHalfWord(iHalfSampa/2,1,iHalfSampa%2) << 5) |
-             iFrame->getHalfWord(iHalfSampa/2,0,iHalfSampa%2);
-        value2 = 
-            (iFrame->getHalfWord(iHalfSampa/2,3,iHalfSampa%2) << 5) | 
-             iFrame->getHalfWord(iHalfSampa/2,2,iHalfSampa%2);
-        break;
-  
-      case 1:
-        value1 = 
-            ((iFrame-1)->getHalfWord(iHalfSampa/2,2,iHalfSampa%2) << 5) |
-             (iFrame-1)->getHalfWord(iHalfSampa/2,1,iHalfSampa%2);
-        value2 = 
-            (iFrame   ->getHalfWord(iHalfSampa/2,0,iHalfSampa%2) << 5) |
-            (iFrame-1)->getHalfWord(iHalfSampa/2,3,iHalfSampa%2);
-        break;
-  
-      case 2:
-        value1 = 
-            ((iFrame-1)->getHalfWord(iHalfSampa/2,3,iHalfSampa%2) << 5) |
-             (iFrame-1)->getHalfWord(iHalfSampa/2,2,iHalfSampa%2);
-        value2 = 
-            (iFrame->getHalfWord(iHalfSampa/2,1,iHalfSampa%2) << 5) | 
-             iFrame->getHalfWord(iHalfSampa/2,0,iHalfSampa%2);
-        break;
-  
-      case 3:
-        value1 = 
-            (iFrame   ->getHalfWord(iHalfSampa/2,0,iHalfSampa%2) << 5) |
-            (iFrame-1)->getHalfWord(iHalfSampa/2,3,iHalfSampa%2);
-        value2 = 
-            (iFrame->getHalfWord(iHalfSampa/2,2,iHalfSampa%2) << 5) | 
-             iFrame->getHalfWord(iHalfSampa/2,1,iHalfSampa%2);
-        break;
-  
-      default:
-        LOG(ERROR) << "Position " << mPositionForHalfSampa[iHalfSampa] << " not known." << FairLogger::endl;
-        return;
+  if (mEnableAdcClockWarning) checkAdcClock(words, nFrames);
+
+  if (mEnableCompileAdcValues) {
+    // the values are decoded directly into the buffers
+    std::array<short*,5> adcValues;
+    std::array<size_t,5> nOldValues;
+    mAdcMutex.lock();
+    for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+      nOldValues[iHalfSampa] = mAdcValues[iHalfSampa].size();
+      mAdcValues[iHalfSampa].resize(nOldValues[iHalfSampa] + 2*nFrames);
+      adcValues[iHalfSampa] = mAdcValues[iHalfSampa].data() + nOldValues[iHalfSampa];
     }
-
-    mAdcValues[iHalfSampa]->emplace(value1 ^ (1 << 9));
-    mAdcValues[iHalfSampa]->emplace(value2 ^ (1 << 9));
-//  std::cout << iHalfSampa << " " << std::hex
-//     << "0x" << std::setfill('0') << std::setw(3) << *(mAdcValues[iHalfSampa]->rbegin()+1) << " "
-//     << "0x" << std::setfill('0') << std::setw(3) << *(mAdcValues[iHalfSampa]->rbegin()) << std::dec << std::endl;
+    const std::array<int,5> nNewValues = mDecoder.decode(words, nFrames, adcValues);
+    for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+      mAdcValues[iHalfSampa].resize(nOldValues[iHalfSampa] + nNewValues[iHalfSampa]);
+    }
+    mAdcMutex.unlock();
+  } else {
+    mDecoder.decode(words, nFrames, {{nullptr, nullptr, nullptr, nullptr, nullptr}});
   }
-  mAdcMutex.unlock();
-}
 
-void GBTFrameContainer::checkAdcClock(std::vector<GBTFrame>::iterator iFrame)
-{
-  if (mAdcClock[0].addSequence(iFrame->getAdcClock(0))) 
-    LOG(WARNING) << "ADC clock error of SAMPA 0 in GBT Frame " << std::distance(mGBTFrames.begin(),iFrame) << FairLogger::endl;
-  if (mAdcClock[1].addSequence(iFrame->getAdcClock(1))) 
-    LOG(WARNING) << "ADC clock error of SAMPA 1 in GBT Frame " << std::distance(mGBTFrames.begin(),iFrame) << FairLogger::endl;
-  if (mAdcClock[2].addSequence(iFrame->getAdcClock(2))) 
-    LOG(WARNING) << "ADC clock error of SAMPA 2 in GBT Frame " << std::distance(mGBTFrames.begin(),iFrame) << FairLogger::endl;
+  if (mEnableSyncPatternWarning) checkSyncPattern();
+
+  mGBTFramesAnalyzed += nFrames;
 }
 
-void GBTFrameContainer::searchSyncPattern(std::vector<GBTFrame>::iterator iFrame)
+void GBTFrameContainer::checkAdcClock(const uint32_t* words, int nFrames)
 {
-  for (short iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
-    mPositionForHalfSampa[iHalfSampa+5] =  mPositionForHalfSampa[iHalfSampa];
-  }
-
-  if (mSyncPattern[0].addSequence(
-      iFrame->getHalfWord(0,0,0),
-      iFrame->getHalfWord(0,1,0),
-      iFrame->getHalfWord(0,2,0),
-      iFrame->getHalfWord(0,3,0))){
-    mPositionForHalfSampa[0] = mSyncPattern[0].getPosition();
-  }
-
-  if (mSyncPattern[1].addSequence(
-      iFrame->getHalfWord(0,0,1),
-      iFrame->getHalfWord(0,1,1),
-      iFrame->getHalfWord(0,2,1),
-      iFrame->getHalfWord(0,3,1))) {
-    mPositionForHalfSampa[1] = mSyncPattern[1].getPosition();
+  for (int iFrame = 0; iFrame < nFrames; ++iFrame) {
+    const uint32_t* frame = words + 4*iFrame;
+    if (mAdcClock[0].addSequence((frame[2] >> 8) & 0xF))
+      LOG(WARNING) << "ADC clock error of SAMPA 0 in GBT Frame " << mGBTFramesAnalyzed + iFrame << FairLogger::endl;
+    if (mAdcClock[1].addSequence((frame[1] >> 20) & 0xF))
+      LOG(WARNING) << "ADC clock error of SAMPA 1 in GBT Frame " << mGBTFramesAnalyzed + iFrame << FairLogger::endl;
+    if (mAdcClock[2].addSequence((frame[0] >> 12) & 0xF))
+      LOG(WARNING) << "ADC clock error of SAMPA 2 in GBT Frame " << mGBTFramesAnalyzed + iFrame << FairLogger::endl;
   }
+}
 
-  if (mSyncPattern[2].addSequence(
-      iFrame->getHalfWord(1,0,0),
-      iFrame->getHalfWord(1,1,0),
-      iFrame->getHalfWord(1,2,0),
-      iFrame->getHalfWord(1,3,0))) {
-    mPositionForHalfSampa[2] = mSyncPattern[2].getPosition();
+void GBTFrameContainer::checkSyncPattern()
+{
+  const short pos0 = mDecoder.getPosition(0);
+  const short pos1 = mDecoder.getPosition(1);
+  const short pos2 = mDecoder.getPosition(2);
+  const short pos3 = mDecoder.getPosition(3);
+  const short pos4 = mDecoder.getPosition(4);
+
+  if (pos0 != pos1) {
+    LOG(WARNING) << "The two half words from SAMPA 0 don't start at the same position, lower bits start at "
+      << pos0 << ", higher bits at " << pos1 << FairLogger::endl;
   }
-
-  if (mSyncPattern[3].addSequence(
-      iFrame->getHalfWord(1,0,1),
-      iFrame->getHalfWord(1,1,1),
-      iFrame->getHalfWord(1,2,1),
-      iFrame->getHalfWord(1,3,1))) {
-    mPositionForHalfSampa[3] = mSyncPattern[3].getPosition();
+  if (pos2 != pos3) {
+    LOG(WARNING) << "The two half words from SAMPA 1 don't start at the same position, lower bits start at "
+      << pos2 << ", higher bits at " << pos3 << FairLogger::endl;
   }
-
-  if (mSyncPattern[4].addSequence(
-      iFrame->getHalfWord(2,0),
-      iFrame->getHalfWord(2,1),
-      iFrame->getHalfWord(2,2),
-      iFrame->getHalfWord(2,3))) {
-    mPositionForHalfSampa[4] = mSyncPattern[4].getPosition();
+  if (pos0 != pos2 || pos0 != pos4) {
+    LOG(WARNING) << "The three SAMPAs don't have the same position, SAMPA0 = " << pos0
+      << ", SAMPA1 = " << pos2 << ", SAMPA2 = " << pos4 << FairLogger::endl;
   }
+}
 
-//  std::cout << mPositionForHalfSampa[0] << " " << mPositionForHalfSampa[1] << " " << mPositionForHalfSampa[2] << " " << mPositionForHalfSampa[3] << " " << mPositionForHalfSampa[4] << std::endl;
+bool GBTFrameContainer::fillTmpData()
+{
+  bool dataAvailable = false;
 
-  if (mEnableSyncPatternWarning) { 
-    if (mPositionForHalfSampa[0] != mPositionForHalfSampa[1]) {
-      LOG(WARNING) << "The two half words from SAMPA 0 don't start at the same position, lower bits start at "
-        << mPositionForHalfSampa[0] << ", higher bits at " << mPositionForHalfSampa[1] << FairLogger::endl;
-    }
-    if (mPositionForHalfSampa[2] != mPositionForHalfSampa[3]) {
-      LOG(WARNING) << "The two half words from SAMPA 1 don't start at the same position, lower bits start at "
-        << mPositionForHalfSampa[2] << ", higher bits at " << mPositionForHalfSampa[3] << FairLogger::endl;
+  mAdcMutex.lock();
+  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa)
+  {
+    std::vector<short>& values = mAdcValues[iHalfSampa];
+    size_t& readPosition = mAdcReadPosition[iHalfSampa];
+    if (values.size() - readPosition < 16) {
+      mTmpData[iHalfSampa].fill(0);
+      continue;
     }
-    if (mPositionForHalfSampa[0] != mPositionForHalfSampa[2] || mPositionForHalfSampa[0] != mPositionForHalfSampa[4]) {
-      LOG(WARNING) << "The three SAMPAs don't have the same position, SAMPA0 = " << mPositionForHalfSampa[0] 
-        << ", SAMPA1 = " << mPositionForHalfSampa[2] << ", SAMPA2 = " << mPositionForHalfSampa[4] << FairLogger::endl;
+    dataAvailable = true;
+    std::copy(values.begin()+readPosition, values.begin()+readPosition+16, mTmpData[iHalfSampa].begin());
+    readPosition += 16;
+
+    // drop the extracted values once they make up most of the buffer
+    if (readPosition == values.size()) {
+      values.clear();
+      readPosition = 0;
+    } else if (readPosition >= 4096 && 2*readPosition >= values.size()) {
+      values.erase(values.begin(), values.begin()+readPosition);
+      readPosition = 0;
     }
   }
+  mAdcMutex.unlock();
+
+  return dataAvailable;
 }
 
 bool GBTFrameContainer::getData(std::vector<Digit>& container)
@@ -468,23 +426,7 @@ bool GBTFrameContainer::getData(std::vector<Digit>& container)
 //    }
 //  }
 //  mAdcMutex.unlock();
-  bool dataAvailable = false;
-
-  mAdcMutex.lock();
-  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa)
-  {
-    if (mAdcValues[iHalfSampa]->size() < 16){ 
-      mTmpData[iHalfSampa].fill(0);
-      continue;
-    }
-    dataAvailable = true;
-    for (int iChannel = 0; iChannel < 16; ++iChannel)
-    {
-      mTmpData[iHalfSampa][iChannel] = mAdcValues[iHalfSampa]->front();
-      mAdcValues[iHalfSampa]->pop();
-    }
-  }
-  mAdcMutex.unlock();
+  const bool dataAvailable = fillTmpData();
 
   if (!dataAvailable) return dataAvailable;
 
@@ -526,23 +468,7 @@ bool GBTFrameContainer::getData(std::vector<Digit>& container)
 
 bool GBTFrameContainer::getData(std::vector<HalfSAMPAData>& container)
 {
-  bool dataAvailable = false;
-
-  mAdcMutex.lock();
-  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa)
-  {
-    if (mAdcValues[iHalfSampa]->size() < 16)  {
-      mTmpData[iHalfSampa].fill(0);
-      continue;
-    }
-    dataAvailable = true;
-    for (int iChannel = 0; iChannel < 16; ++iChannel)
-    {
-      mTmpData[iHalfSampa][iChannel] = mAdcValues[iHalfSampa]->front();
-      mAdcValues[iHalfSampa]->pop();
-    }
-  }
-  mAdcMutex.unlock();
+  const bool dataAvailable = fillTmpData();
 
   if (!dataAvailable) return dataAvailable;
 
@@ -600,22 +526,16 @@ void GBTFrameContainer::resetAdcClock()
 
 void GBTFrameContainer::resetSyncPattern()
 {
-  for (auto &aSyncPattern : mSyncPattern) {
-    aSyncPattern.reset();
-  }
-  for (auto &aPositionForHalfSampa : mPositionForHalfSampa) {
-    aPositionForHalfSampa = -1;
-  }
-//  mPositionForHalfSampa.clear();
+  mDecoder.reset();
 }
 
 void GBTFrameContainer::resetAdcValues()
 {
   mAdcMutex.lock();
-  for (std::array<std::queue<short>*,5>::iterator it = mAdcValues.begin(); it != mAdcValues.end(); ++it) {
-    delete (*it);
-    (*it) = new std::queue<short>;
+  for (auto &aAdcValues : mAdcValues) {
+    aAdcValues.clear();
   }
+  mAdcReadPosition.fill(0);
   mAdcMutex.unlock();
 }
 
@@ -623,8 +543,8 @@ int GBTFrameContainer::getNentries()
 {
   int counter = 0;
   mAdcMutex.lock();
-  for (auto &aAdcValues : mAdcValues) {
-    counter += aAdcValues->size();
+  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+    counter += mAdcValues[iHalfSampa].size() - mAdcReadPosition[iHalfSampa];
   }
   mAdcMutex.unlock();
   return counter;
@@ -0,0 +1,136 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GBTFrameDecoder.cxx
+/// \brief Bulk decoder of GBT frames into ADC values
+
+#include "TPCReconstruction/GBTFrameDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace o2::TPC;
+
+GBTFrameDecoder::GBTFrameDecoder()
+  : mSyncPattern({
+      SyncPatternMonitor(0,0),
+      SyncPatternMonitor(0,1),
+      SyncPatternMonitor(1,0),
+      SyncPatternMonitor(1,1),
+      SyncPatternMonitor(2,0)})
+  , mPosition()
+  , mHalfWords()
+{
+  reset();
+}
+
+void GBTFrameDecoder::reset()
+{
+  for (auto &aSyncPattern : mSyncPattern) {
+    aSyncPattern.reset();
+  }
+  mPosition.fill(-1);
+  for (auto &aHalfWords : mHalfWords) {
+    aHalfWords.assign(4, 0);
+  }
+}
+
+std::array<int,5> GBTFrameDecoder::decode(const uint32_t* words, int nFrames, const std::array<short*,5>& adcValues, int frameStride)
+{
+  std::array<int,5> nAdcValues{0,0,0,0,0};
+  if (nFrames <= 0) return nAdcValues;
+
+  extractHalfWords(words, nFrames, frameStride);
+
+  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+    const short* hw = mHalfWords[iHalfSampa].data();
+    short* out = adcValues[iHalfSampa];
+
+    // The stream is decoded in segments which end with a frame in which the sync pattern was found,
+    // within a segment the position is constant and the values are contiguous pairs of half-words.
+    int frame = 0;
+    while (frame < nFrames) {
+      const int nProcessed = mSyncPattern[iHalfSampa].addSequences(hw + 4 + 4*frame, nFrames - frame);
+      const int lastFrame = frame + nProcessed - 1;
+      const short newPosition = mSyncPattern[iHalfSampa].getPosition();
+
+      if (out != nullptr && mPosition[iHalfSampa] != -1) {
+        nAdcValues[iHalfSampa] += assembleAdcValues(hw, frame, lastFrame, mPosition[iHalfSampa], out + nAdcValues[iHalfSampa]);
+        // the frame with the pattern already uses the new position, the previous one has to be known as well
+        if (newPosition != -1) {
+          nAdcValues[iHalfSampa] += assembleAdcValues(hw, lastFrame, lastFrame+1, newPosition, out + nAdcValues[iHalfSampa]);
+        }
+      }
+      mPosition[iHalfSampa] = newPosition;
+      frame += nProcessed;
+    }
+
+    // keep the last frame, the values of the next block might start in it
+    std::copy(mHalfWords[iHalfSampa].end()-4, mHalfWords[iHalfSampa].end(), mHalfWords[iHalfSampa].begin());
+  }
+
+  return nAdcValues;
+}
+
+void GBTFrameDecoder::extractHalfWords(const uint32_t* words, int nFrames, int frameStride)
+{
+  // Each half SAMPA occupies 20 consecutive bits of the frame, bit k of half-word j is bit 3-j of the k-th nibble.
+  // The table transposes one nibble into bit 0 of the 4 half-words, which are packed as 16 bit lanes of an
+  // uint64_t in the order of the half-word stream (little endian).
+  static const std::array<uint64_t,16> transposeNibble = []() {
+    std::array<uint64_t,16> table;
+    for (uint64_t nibble = 0; nibble < 16; ++nibble) {
+      table[nibble] = 0;
+      for (int j = 0; j < 4; ++j) table[nibble] |= ((nibble >> (3-j)) & 0x1) << (16*j);
+    }
+    return table;
+  }();
+
+  std::array<short*,5> hw;
+  for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+    mHalfWords[iHalfSampa].resize(4 + 4*nFrames);
+    hw[iHalfSampa] = mHalfWords[iHalfSampa].data() + 4;
+  }
+
+  for (int iFrame = 0; iFrame < nFrames; ++iFrame) {
+    const uint32_t* frame = words + iFrame*frameStride;
+    const uint64_t low  = (uint64_t(frame[2]) << 32) | frame[3];   // bits [ 63: 0]
+    const uint64_t high = (uint64_t(frame[0]) << 32) | frame[1];   // bits [127:64]
+
+    const std::array<uint32_t,5> fields{{
+      uint32_t(low),
+      uint32_t(low >> 20),
+      uint32_t(low >> 44),
+      uint32_t(high),
+      uint32_t(high >> 24)}};
+
+    for (int iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
+      const uint32_t field = fields[iHalfSampa];
+      const uint64_t packed =
+         transposeNibble[ field        & 0xF]       |
+        (transposeNibble[(field >>  4) & 0xF] << 1) |
+        (transposeNibble[(field >>  8) & 0xF] << 2) |
+        (transposeNibble[(field >> 12) & 0xF] << 3) |
+        (transposeNibble[(field >> 16) & 0xF] << 4);
+      std::memcpy(hw[iHalfSampa] + 4*iFrame, &packed, sizeof(packed));
+    }
+  }
+}
+
+int GBTFrameDecoder::assembleAdcValues(const short* hw, int firstFrame, int lastFrame, short position, short* adcValues)
+{
+  // an ADC value consists of two consecutive half-words, the first one starts at the position in the frame
+  const short* first = hw + 4 + 4*firstFrame + ((position == 0) ? 0 : position - 4);
+  const int nValues = 2*(lastFrame - firstFrame);
+  for (int i = 0; i < nValues; ++i) {
+    adcValues[i] = ((first[2*i+1] << 5) | first[2*i]) ^ (1 << 9);
+  }
+  return nValues;
+}
@@ -0,0 +1,71 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MappedFile.cxx
+/// \brief Read only memory mapping of a file
+
+#include "TPCReconstruction/MappedFile.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace o2::TPC;
+
+MappedFile::MappedFile(const std::string& path)
+  : mPath(path)
+  , mData(nullptr)
+  , mSize(0)
+  , mIsOpen(false)
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0) {
+    mSize = fileStat.st_size;
+    if (mSize == 0) {
+      mIsOpen = true;
+    } else {
+      void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        // the data is mostly read front to back, which enables a larger read ahead
+        madvise(data, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const char*>(data);
+        mIsOpen = true;
+      }
+    }
+  }
+  // the mapping stays valid after closing the file
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (mData != nullptr) munmap(const_cast<char*>(mData), mSize);
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const
+{
+  if (mData == nullptr || offset >= mSize) return;
+  const size_t end = offset + std::min(length, mSize - offset);
+  const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const size_t begin = offset / pageSize * pageSize;
+  madvise(const_cast<char*>(mData) + begin, end - begin, MADV_WILLNEED);
+
+  // touch every page, such that it is in memory when this function returns
+  volatile char touch;
+  for (size_t pos = begin; pos < end; pos += pageSize) {
+    touch = mData[pos];
+  }
+  (void)touch;
+}
@@ -17,6 +17,7 @@
 #include <iomanip>
 #include <bitset>
 #include <queue>
+#include <cstring>
 
 #include "TPCReconstruction/RawReader.h"
 #include "TPCReconstruction/GBTFrame.h"
@@ -37,8 +38,12 @@ RawReader::RawReader(int region, int link, int run)
   , mApplyChannelMask(false)
   , mCheckAdcClock(false)
   , mPrintRawData(false)
+  , mPrefetchNextEvent(false)
   , mTimestampOfFirstData({0,0,0,0,0})
+  , mFiles()
   , mEvents()
+  , mNumberOfEvents(0)
+  , mPrefetch()
   , mData()
   , mDataIterator(mData.end())
   , mSyncPos()
@@ -112,42 +117,59 @@ bool RawReader::addInputFile(int region, int link, std::string path, int run){
     return false;
   }
 
-  std::ifstream file(path);
-  if (!file.is_open()) {
+  auto file = std::make_shared<const MappedFile>(path);
+  if (!file->isOpen()) {
     LOG(ERROR) << "Can't read file " << path << FairLogger::endl;
     return false;
   }
 
+  const uint32_t fileIndex = mFiles.size();
+  mFiles.push_back(file);
+  const size_t firstNewEntry = mEvents.size();
+
+  // single scan over the headers, the payload pages are not touched
+  bool ret = true;
   Header h;
-  int pos = 0;
-  file.seekg(0,file.end);
-  int length = file.tellg();
-  file.seekg(0,file.beg);
+  size_t pos = 0;
+  const size_t length = file->size();
 
   while (pos < length) {
-    file.read((char*)&h, sizeof(h));
+    if (pos + sizeof(h) > length) {
+      LOG(ERROR) << "Truncated header at position " << pos << " in file " << path << FairLogger::endl;
+      ret = false;
+      break;
+    }
+    std::memcpy(&h, file->data() + pos, sizeof(h));
     if (h.reserved_01 != 0x0F || h.reserved_2() != 0x3fec2fec1fec0fec) {
       LOG(ERROR) << "Header does not look consistent" << FairLogger::endl;
     }
-    EventInfo eD;
-    eD.path = path;
-    eD.posInFile =  file.tellg();
-    eD.header = h;
-    if (h.headerVersion == 1) {
-
-//      auto ins = mEvents.insert(std::make_pair(h.eventCount(),std::shared_ptr<std::vector<EventInfo>>(new std::vector<EventInfo>)));
-      auto ins = mEvents.insert(std::make_pair(h.eventCount(),std::make_shared<std::vector<EventInfo>>()));
-      ins.first->second->push_back(eD);
-
-      file.seekg(pos+(h.nWords*4));
-      pos = file.tellg();
-    } else {
+    if (h.headerVersion != 1) {
       LOG(ERROR) << "Header version " << (int)h.headerVersion << " not implemented." << FairLogger::endl;
-      return false;
+      ret = false;
+      break;
+    }
+    const size_t eventLength = size_t(h.nWords)*4;
+    if (eventLength < sizeof(h) || pos + eventLength > length) {
+      LOG(ERROR) << "Event at position " << pos << " with " << h.nWords << " words does not fit into file " << path << FairLogger::endl;
+      ret = false;
+      break;
     }
+
+    mEvents.push_back({h.eventCount(), pos+sizeof(h), fileIndex});
+    pos += eventLength;
   }
 
-  return true;
+  // the events of one file are mostly ordered already, entries of the same event keep the order of the files
+  auto byEvent = [](const IndexEntry& a, const IndexEntry& b) { return a.event < b.event; };
+  std::stable_sort(mEvents.begin()+firstNewEntry, mEvents.end(), byEvent);
+  std::inplace_merge(mEvents.begin(), mEvents.begin()+firstNewEntry, mEvents.end(), byEvent);
+
+  mNumberOfEvents = 0;
+  for (size_t i = 0; i < mEvents.size(); ++i) {
+    if (i == 0 || mEvents[i].event != mEvents[i-1].event) ++mNumberOfEvents;
+  }
+
+  return ret;
 }
 
 bool RawReader::loadEvent(int64_t event) {
@@ -162,52 +184,55 @@ bool RawReader::loadEvent(int64_t event) {
   }
   mData.clear();
 
-  auto ev = mEvents.find(event);
+  const auto range = getEventRange(event);
 
-  if (ev == mEvents.end()) return false;
+  if (range.first == range.second) return false;
   mLastEvent = event;
   
-  const Mapper& mapper = Mapper::instance();
-  for (auto &eventInfo : *(ev->second)) {
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    const Header header = getHeader(*entry);
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(mFiles[entry->file]->data() + entry->posInFile);
+    const int nWords = header.nWords-8;
+    LOG(DEBUG) << "decoding " << nWords << " words from position " << entry->posInFile << " in file " << mFiles[entry->file]->getPath() << FairLogger::endl;
     if (mPrintRawData) {
       LOG(INFO) << "Header:" << FairLogger::endl;
       LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Version" 
-        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(2) << (unsigned) eventInfo.header.headerVersion << FairLogger::endl;
+        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(2) << (unsigned) header.headerVersion << FairLogger::endl;
 //      LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Reserved"
-//        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(2) << (unsigned) eventInfo.header.reserved_01 << FairLogger::endl;
+//        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(2) << (unsigned) header.reserved_01 << FairLogger::endl;
       LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Datatype"
-        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(4) << eventInfo.header.dataType << FairLogger::endl;
+        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(4) << header.dataType << FairLogger::endl;
       LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Number of Words"
-        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(8) << eventInfo.header.nWords << FairLogger::endl;
+        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(8) << header.nWords << FairLogger::endl;
       LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Timestamp"
-        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << eventInfo.header.timeStamp() << FairLogger::endl;
+        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << header.timeStamp() << FairLogger::endl;
       LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Event counter"
-        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << eventInfo.header.eventCount() << FairLogger::endl;
+        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << header.eventCount() << FairLogger::endl;
 //      LOG(INFO) << std::setfill(' ') << std::left << std::setw(16) << "Reserved2"
-//        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << eventInfo.header.reserved_2() << FairLogger::endl;
+//        << "0x" << std::hex << std::setfill('0') << std::right << std::setw(16) << header.reserved_2() << FairLogger::endl;
       LOG(INFO) << std::dec << FairLogger::endl;
     }
-    switch (eventInfo.header.dataType) {
+    switch (header.dataType) {
       case 1: // RAW GBT frames
         { 
           LOG(DEBUG) << "Data of readout mode 1 (RAW GBT frames)" << FairLogger::endl;
-          if (!decodeRawGBTFrames(eventInfo)) return false;
+          if (!decodeRawGBTFrames(header, words, nWords)) return false;
           break;
         }
       case 2: // Decoded data
         {
           LOG(DEBUG) << "Data of readout mode 2 (decoded data)" << FairLogger::endl;
-          if (!decodePreprocessedData(eventInfo)) return false;
+          if (!decodePreprocessedData(header, words, nWords)) return false;
           break;
         }
       case 3: // both, RAW GBT frames and decoded data
         {
           if (mUseRawInMode3) {
             LOG(DEBUG) << "Data of readout mode 3 (decoding RAW GBT frames)" << FairLogger::endl;
-            if (!decodeRawGBTFrames(eventInfo)) return false;
+            if (!decodeRawGBTFrames(header, words, nWords)) return false;
           } else {
             LOG(DEBUG) << "Data of readout mode 3 (using decoded data)" << FairLogger::endl;
-            if (!decodePreprocessedData(eventInfo)) return false;
+            if (!decodePreprocessedData(header, words, nWords)) return false;
           }
           break;
         }
@@ -220,22 +245,31 @@ bool RawReader::loadEvent(int64_t event) {
   }
 
   mDataIterator = mData.begin();
+
+  if (mPrefetchNextEvent && range.second != mEvents.end()) prefetchEvent(range.second->event);
   return true;
 }
 
-bool RawReader::decodePreprocessedData(EventInfo eventInfo) {
-  std::ifstream file(eventInfo.path);
-  if (!file.is_open()) {
-    LOG(ERROR) << "Can't read file " << eventInfo.path << FairLogger::endl;
-    return false;
+void RawReader::prefetchEvent(uint64_t event) {
+  struct Chunk {
+    std::shared_ptr<const MappedFile> file;
+    size_t offset;
+    size_t length;
+  };
+  std::vector<Chunk> chunks;
+  const auto range = getEventRange(event);
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    chunks.push_back({mFiles[entry->file], entry->posInFile, (getHeader(*entry).nWords-8)*sizeof(uint32_t)});
   }
 
-  int nWords = eventInfo.header.nWords-8;
-  uint32_t words[nWords];
-  LOG(DEBUG) << "reading " << nWords << " words from position " << eventInfo.posInFile << " in file " << eventInfo.path << FairLogger::endl;
-  file.seekg(eventInfo.posInFile);
-  file.read((char*)&words, nWords*sizeof(words[0]));
+  // the file mappings are shared with the task, such that they stay valid also if the reader is destroyed;
+  // replacing mPrefetch waits for the previous prefetching to finish
+  mPrefetch = std::async(std::launch::async, [chunks]() {
+    for (const auto& chunk : chunks) chunk.file->prefetch(chunk.offset, chunk.length);
+  }).share();
+}
 
+bool RawReader::decodePreprocessedData(Header header, const uint32_t* words, int nWords) {
   const Mapper& mapper = Mapper::instance();
 
   std::array<char,5> sampas;
@@ -254,8 +288,8 @@ bool RawReader::decodePreprocessedData(EventInfo eventInfo) {
   std::array<std::array<uint16_t,16>,5> adcValues;
 
 
-  int indexStep = (eventInfo.header.dataType == 3) ? 8 : 4;
-  int offset = (eventInfo.header.dataType == 3) ? 4: 0;
+  int indexStep = (header.dataType == 3) ? 8 : 4;
+  int offset = (header.dataType == 3) ? 4: 0;
 
   for (int i=0; i<nWords; i=i+indexStep) {
     ids[4] = (words[i+offset] >> 4) & 0xF;
@@ -309,7 +343,7 @@ bool RawReader::decodePreprocessedData(EventInfo eventInfo) {
       if (ids[j] == 0x8) {
         writeValue[j] = true;
         // header TS is one before first word -> +1
-        if (mTimestampOfFirstData[j] == 0) mTimestampOfFirstData[j] = eventInfo.header.timeStamp() + 1 + i/8;
+        if (mTimestampOfFirstData[j] == 0) mTimestampOfFirstData[j] = header.timeStamp() + 1 + i/8;
       }
     }
 
@@ -336,19 +370,7 @@ bool RawReader::decodePreprocessedData(EventInfo eventInfo) {
   return true;
 }
 
-bool RawReader::decodeRawGBTFrames(EventInfo eventInfo) {
-  std::ifstream file(eventInfo.path);
-  if (!file.is_open()) {
-    LOG(ERROR) << "Can't read file " << eventInfo.path << FairLogger::endl;
-    return false;
-  }
-
-  int nWords = eventInfo.header.nWords-8;
-  uint32_t words[nWords];
-  LOG(DEBUG) << "reading " << nWords << " words from position " << eventInfo.posInFile << " in file " << eventInfo.path << FairLogger::endl;
-  file.seekg(eventInfo.posInFile);
-  file.read((char*)&words, nWords*sizeof(words[0]));
-
+bool RawReader::decodeRawGBTFrames(Header header, const uint32_t* words, int nWords) {
   const Mapper& mapper = Mapper::instance();
 
   std::array<char,5> sampas;
@@ -380,12 +402,12 @@ bool RawReader::decodeRawGBTFrames(EventInfo eventInfo) {
   mAdcError.clear();
   uint64_t timebin = 0;
 
-  int indexStep = (eventInfo.header.dataType == 3) ? 8 : 4;
+  int indexStep = (header.dataType == 3) ? 8 : 4;
   for (int i=0; i<nWords; i=i+indexStep) {
 
     for (char j=0; j<5; ++j) {
       if ((mTimestampOfFirstData[j] != 0) && 
-          ((mTimestampOfFirstData[j] & 0x7) == ((eventInfo.header.timeStamp() + 1 + i/indexStep) & 0x7))) {
+          ((mTimestampOfFirstData[j] & 0x7) == ((header.timeStamp() + 1 + i/indexStep) & 0x7))) {
         if (adcValues[j].size() < 16) {
           std::queue<uint16_t> empty;
           std::swap(adcValues[j], empty);
@@ -544,7 +566,7 @@ bool RawReader::decodeRawGBTFrames(EventInfo eventInfo) {
     for (short iHalfSampa = 0; iHalfSampa < 5; ++iHalfSampa) {
       if (mSyncPos[iHalfSampa] < 0 ) continue;
       if (lastSyncPos[iHalfSampa] < 0 ) continue;
-      if (mTimestampOfFirstData[iHalfSampa] == 0) mTimestampOfFirstData[iHalfSampa] = eventInfo.header.timeStamp() + 1 + i/indexStep;
+      if (mTimestampOfFirstData[iHalfSampa] == 0) mTimestampOfFirstData[iHalfSampa] = header.timeStamp() + 1 + i/indexStep;
 
       switch(mSyncPos[iHalfSampa]) {
         case 0:
@@ -13,6 +13,8 @@
 
 #include "TPCReconstruction/SyncPatternMonitor.h"
 
+#include <Vc/Vc>
+
 using namespace o2::TPC;
 constexpr std::array<short,32> SyncPatternMonitor::SYNC_PATTERN;
 
@@ -27,6 +29,7 @@ SyncPatternMonitor::SyncPatternMonitor(int sampa, int lowHigh)
   , mSampa(sampa)
   , mLowHigh(lowHigh)
   , mCheckedWords(0)
+  , mPatternWords()
 {}
 
 SyncPatternMonitor::SyncPatternMonitor(const SyncPatternMonitor& other)
@@ -42,4 +45,68 @@ void SyncPatternMonitor::reset()
     << "was resetted" << FairLogger::endl;
 }
 
+namespace {
+  /// Find the next bit with the given value
+  /// @param bits Bit mask
+  /// @param start First bit to look at
+  /// @param end One past the last bit to look at
+  /// @param value Value of the bit
+  /// @return Position of the bit, end if there is none
+  int findBit(const std::vector<uint64_t>& bits, int start, int end, bool value)
+  {
+    int pos = start;
+    while (pos < end) {
+      uint64_t word = value ? bits[pos/64] : ~bits[pos/64];
+      word &= ~uint64_t(0) << (pos%64);
+      if (word != 0) return std::min(end, (pos/64)*64 + __builtin_ctzll(word));
+      pos = (pos/64 + 1)*64;
+    }
+    return end;
+  }
+}
+
+int SyncPatternMonitor::addSequences(const short* hw, int nFrames)
+{
+  const int nHw = 4*nFrames;
 
+  // all parts of the pattern are either A or B, all other half-words reset the monitor
+  mPatternWords.assign((nHw+63)/64, 0);
+  const Vc::short_v patternA(PATTERN_A);
+  const Vc::short_v patternB(PATTERN_B);
+  int i = 0;
+  for (; i + static_cast<int>(Vc::short_v::Size) <= nHw; i += Vc::short_v::Size) {
+    const Vc::short_v words(hw+i, Vc::Unaligned);
+    const uint64_t bits = ((words == patternA) | (words == patternB)).toInt();
+    mPatternWords[i/64] |= bits << (i%64);
+  }
+  for (; i < nHw; ++i) {
+    if (hw[i] == PATTERN_A || hw[i] == PATTERN_B) mPatternWords[i/64] |= uint64_t(1) << (i%64);
+  }
+
+  const int minLength = SYNC_PATTERN.size() - SYNC_START;
+  i = 0;
+  while (i < nHw) {
+    if (mPosition == SYNC_START) {
+      // Without a started pattern, only a run of at least minLength A/B half-words can complete it.
+      // Shorter runs are skipped, unless they reach the end of the block and the state has to be kept.
+      const int runStart = findBit(mPatternWords, i, nHw, true);
+      const int runEnd = findBit(mPatternWords, runStart, nHw, false);
+      if (runEnd < nHw && runEnd - runStart < minLength) {
+        mCheckedWords += runEnd - i;
+        i = runEnd;
+        continue;
+      }
+      mCheckedWords += runStart - i;
+      i = runStart;
+      if (i == nHw) break;
+    }
+
+    if (checkWord(hw[i], (i+1)%4)) {
+      // finish the frame, the pattern can't be completed a second time in it
+      for (++i; i%4 != 0; ++i) checkWord(hw[i], (i+1)%4);
+      return i/4;
+    }
+    ++i;
+  }
+  return nFrames;
+}
@@ -0,0 +1,71 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GBTFrameTestUtils.h
+/// \brief GBT frame generation shared by the tests and benchmarks of the GBT frame decoding
+
+#ifndef ALICEO2_TPC_GBTFRAMETESTUTILS_H_
+#define ALICEO2_TPC_GBTFRAMETESTUTILS_H_
+
+#include "TPCReconstruction/GBTFrame.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+namespace test {
+
+  /// Sync pattern of the half SAMPAs, in half-words
+  const std::array<short,32> syncPattern{{
+    0x15, 0x15, 0x0A, 0x0A, 0x15, 0x15, 0x0A, 0x0A, 0x15, 0x15, 0x0A, 0x0A, 0x15, 0x15, 0x0A, 0x0A,
+    0x15, 0x15, 0x15, 0x15, 0x0A, 0x0A, 0x0A, 0x0A, 0x15, 0x15, 0x15, 0x15, 0x0A, 0x0A, 0x0A, 0x0A}};
+
+  /// Pack the half-word streams of the 5 half SAMPAs into GBT frames, 4 words per frame
+  inline std::vector<uint32_t> packFrames(const std::array<std::vector<short>,5>& hw)
+  {
+    std::vector<uint32_t> words;
+    for (size_t i = 0; i + 4 <= hw[0].size(); i += 4) {
+      const GBTFrame frame(
+          hw[0][i], hw[0][i+1], hw[0][i+2], hw[0][i+3], hw[1][i], hw[1][i+1], hw[1][i+2], hw[1][i+3],
+          hw[2][i], hw[2][i+1], hw[2][i+2], hw[2][i+3], hw[3][i], hw[3][i+1], hw[3][i+2], hw[3][i+3],
+          hw[4][i], hw[4][i+1], hw[4][i+2], hw[4][i+3], 0, 0, 0);
+      unsigned word3, word2, word1, word0;
+      frame.getGBTFrame(word3, word2, word1, word0);
+      words.insert(words.end(), {word3, word2, word1, word0});
+    }
+    return words;
+  }
+
+  /// Half-word streams with random data and a sync pattern after offset[h] half-words, followed by the ADC values
+  inline std::array<std::vector<short>,5> makeStreams(const std::array<int,5>& offset, const std::array<std::vector<short>,5>& adcValues,
+                                                      int nHalfWords, std::mt19937& gen)
+  {
+    std::uniform_int_distribution<short> random(0, 31);
+    std::array<std::vector<short>,5> hw;
+    for (int h = 0; h < 5; ++h) {
+      for (int i = 0; i < offset[h]; ++i) hw[h].push_back(random(gen));
+      hw[h].insert(hw[h].end(), syncPattern.begin(), syncPattern.end());
+      for (short value : adcValues[h]) {
+        hw[h].push_back((value ^ (1 << 9)) & 0x1F);
+        hw[h].push_back((value ^ (1 << 9)) >> 5);
+      }
+      while (static_cast<int>(hw[h].size()) < nHalfWords) hw[h].push_back(random(gen));
+      hw[h].resize(nHalfWords);
+    }
+    return hw;
+  }
+}
+}
+}
+
+#endif
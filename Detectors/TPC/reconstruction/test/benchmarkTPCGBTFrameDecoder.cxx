@@ -0,0 +1,70 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkTPCGBTFrameDecoder.cxx
+/// \brief Decoding speed of the bulk GBT frame decoder and of the frame by frame decoding
+
+#include "TPCReconstruction/GBTFrameDecoder.h"
+#include "TPCReconstruction/GBTFrameContainer.h"
+#include "GBTFrameTestUtils.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace o2::TPC;
+
+int main()
+{
+  std::mt19937 gen(4);
+  std::uniform_int_distribution<short> adc(0, 1023);
+  const int nFrames = 1 << 18;
+  const int blockSize = 4096;
+  const std::array<int,5> offset{{1, 1, 1, 1, 1}};
+  std::array<std::vector<short>,5> adcValues;
+  for (int h = 0; h < 5; ++h) {
+    for (int i = 0; i < 2*nFrames - 40; ++i) adcValues[h].push_back(adc(gen));
+  }
+  const auto words = test::packFrames(test::makeStreams(offset, adcValues, 4*nFrames, gen));
+  const double gigaBytes = words.size()*sizeof(uint32_t)/1e9;
+
+  GBTFrameDecoder decoder;
+  std::array<std::vector<short>,5> output;
+  std::array<short*,5> out;
+  for (int h = 0; h < 5; ++h) {
+    output[h].resize(2*blockSize);
+    out[h] = output[h].data();
+  }
+  size_t nValues = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int first = 0; first < nFrames; first += blockSize) {
+    const auto n = decoder.decode(words.data() + 4*first, blockSize, out);
+    nValues += n[0];
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  const double timeBulk = std::chrono::duration<double>(end - start).count();
+
+  GBTFrameContainer container(0, 0);
+  container.setEnableAdcClockWarning(false);
+  container.setEnableSyncPatternWarning(false);
+  container.setEnableStoreGBTFrames(false);
+  start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < words.size(); i += 4) {
+    container.addGBTFrame(words[i], words[i+1], words[i+2], words[i+3]);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  const double timeFrameByFrame = std::chrono::duration<double>(end - start).count();
+
+  std::cout << "GBT frame decoding of " << nFrames << " frames, " << nValues << " ADC values per half SAMPA: bulk "
+            << gigaBytes/timeBulk << " GB/s, frame by frame " << gigaBytes/timeFrameByFrame << " GB/s" << std::endl;
+  return 0;
+}
@@ -0,0 +1,189 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCGBTFrameDecoder.cxx
+/// \brief This task tests the bulk GBT frame decoder against the frame by frame decoding
+
+#define BOOST_TEST_MODULE Test TPC GBTFrameDecoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TPCReconstruction/GBTFrameDecoder.h"
+#include "TPCReconstruction/GBTFrameContainer.h"
+#include "TPCReconstruction/GBTFrame.h"
+#include "TPCReconstruction/SyncPatternMonitor.h"
+#include "GBTFrameTestUtils.h"
+
+#include <vector>
+#include <array>
+#include <random>
+
+namespace o2 {
+namespace TPC {
+
+  using test::packFrames;
+  using test::makeStreams;
+
+  /// Frame by frame decoding with GBTFrame and SyncPatternMonitor::addSequence
+  std::array<std::vector<short>,5> decodeReference(const std::vector<uint32_t>& words)
+  {
+    std::array<SyncPatternMonitor,5> syncMon{{
+      SyncPatternMonitor(0,0), SyncPatternMonitor(0,1), SyncPatternMonitor(1,0), SyncPatternMonitor(1,1), SyncPatternMonitor(2,0)}};
+    std::array<short,5> position{{-1,-1,-1,-1,-1}};
+    std::array<std::vector<short>,5> adcValues;
+    GBTFrame frame;
+    GBTFrame lastFrame;
+
+    for (size_t i = 0; i < words.size(); i += 4) {
+      lastFrame = frame;
+      frame.setData(words[i], words[i+1], words[i+2], words[i+3]);
+      const std::array<short,5> lastPosition = position;
+
+      for (short h = 0; h < 5; ++h) {
+        if (syncMon[h].addSequence(frame.getHalfWord(h/2,0,h%2), frame.getHalfWord(h/2,1,h%2),
+                                   frame.getHalfWord(h/2,2,h%2), frame.getHalfWord(h/2,3,h%2))) {
+          position[h] = syncMon[h].getPosition();
+        }
+        if (position[h] == -1 || lastPosition[h] == -1) continue;
+
+        std::array<short,8> hw;
+        for (short j = 0; j < 4; ++j) {
+          hw[j] = lastFrame.getHalfWord(h/2,j,h%2);
+          hw[j+4] = frame.getHalfWord(h/2,j,h%2);
+        }
+        const short first = (position[h] == 0) ? 4 : position[h];
+        adcValues[h].push_back(((hw[first+1] << 5) | hw[first]) ^ (1 << 9));
+        adcValues[h].push_back(((hw[first+3] << 5) | hw[first+2]) ^ (1 << 9));
+      }
+    }
+    return adcValues;
+  }
+
+  /// Decode with the bulk decoder, split into blocks
+  std::array<std::vector<short>,5> decodeBlocks(const std::vector<uint32_t>& words, int blockSize, GBTFrameDecoder& decoder)
+  {
+    std::array<std::vector<short>,5> adcValues;
+    const int nFrames = words.size()/4;
+    for (int first = 0; first < nFrames; first += blockSize) {
+      const int n = std::min(blockSize, nFrames - first);
+      std::array<short*,5> out;
+      std::array<size_t,5> nOld;
+      for (int h = 0; h < 5; ++h) {
+        nOld[h] = adcValues[h].size();
+        adcValues[h].resize(nOld[h] + 2*n);
+        out[h] = adcValues[h].data() + nOld[h];
+      }
+      const auto nNew = decoder.decode(words.data() + 4*first, n, out);
+      for (int h = 0; h < 5; ++h) adcValues[h].resize(nOld[h] + nNew[h]);
+    }
+    return adcValues;
+  }
+
+  /// @brief Test the decoding of ADC values after sync patterns at all 4 positions
+  BOOST_AUTO_TEST_CASE(GBTFrameDecoder_positions)
+  {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<short> adc(0, 1023);
+    const std::array<int,5> offset{{0, 5, 10, 15, 7}};
+    std::array<std::vector<short>,5> adcValues;
+    for (int h = 0; h < 5; ++h) {
+      for (int i = 0; i < 320; ++i) adcValues[h].push_back(adc(gen));
+    }
+    const auto words = packFrames(makeStreams(offset, adcValues, 4*200, gen));
+
+    for (int blockSize : {1, 3, 64, 200}) {
+      GBTFrameDecoder decoder;
+      const auto decoded = decodeBlocks(words, blockSize, decoder);
+      for (int h = 0; h < 5; ++h) {
+        BOOST_CHECK_EQUAL(decoder.getPosition(h), offset[h]%4);
+        BOOST_REQUIRE_GE(decoded[h].size(), adcValues[h].size());
+        BOOST_CHECK_EQUAL_COLLECTIONS(decoded[h].begin(), decoded[h].begin() + adcValues[h].size(),
+                                      adcValues[h].begin(), adcValues[h].end());
+      }
+    }
+  }
+
+  /// @brief Test the bulk decoding against the frame by frame decoding on random frames with repeated sync patterns
+  BOOST_AUTO_TEST_CASE(GBTFrameDecoder_reference)
+  {
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<uint32_t> random;
+    std::uniform_int_distribution<int> randomOffset(0, 200);
+
+    std::vector<uint32_t> words;
+    for (int iSync = 0; iSync < 4; ++iSync) {
+      std::array<int,5> offset;
+      std::array<std::vector<short>,5> noAdcValues;
+      for (auto& o : offset) o = randomOffset(gen);
+      const auto block = packFrames(makeStreams(offset, noAdcValues, 4*300, gen));
+      words.insert(words.end(), block.begin(), block.end());
+    }
+    for (int i = 0; i < 4*1000; ++i) words.push_back(random(gen));
+
+    const auto reference = decodeReference(words);
+    for (int blockSize : {1, 2, 17, 1000, 2200}) {
+      GBTFrameDecoder decoder;
+      const auto decoded = decodeBlocks(words, blockSize, decoder);
+      for (int h = 0; h < 5; ++h) {
+        BOOST_CHECK(!reference[h].empty());
+        BOOST_CHECK_EQUAL_COLLECTIONS(decoded[h].begin(), decoded[h].end(), reference[h].begin(), reference[h].end());
+      }
+    }
+  }
+
+  /// @brief Test that adding frames in blocks to the GBTFrameContainer gives the same data as adding them one by one
+  BOOST_AUTO_TEST_CASE(GBTFrameContainer_blocks)
+  {
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<short> adc(0, 1023);
+    const std::array<int,5> offset{{3, 3, 3, 3, 3}};
+    std::array<std::vector<short>,5> adcValues;
+    for (int h = 0; h < 5; ++h) {
+      for (int i = 0; i < 16*20; ++i) adcValues[h].push_back(adc(gen));
+    }
+    const auto words = packFrames(makeStreams(offset, adcValues, 4*300, gen));
+
+    GBTFrameContainer frameByFrame(0, 0);
+    GBTFrameContainer blocks(0, 0);
+    for (auto container : {&frameByFrame, &blocks}) {
+      container->setEnableAdcClockWarning(false);
+      container->setEnableSyncPatternWarning(false);
+      container->setEnableStoreGBTFrames(false);
+    }
+    for (size_t i = 0; i < words.size(); i += 4) {
+      frameByFrame.addGBTFrame(words[i], words[i+1], words[i+2], words[i+3]);
+    }
+    blocks.addGBTFrames(words.data(), 100);
+    blocks.addGBTFrames(words.data() + 4*100, words.size()/4 - 100);
+
+    BOOST_CHECK_EQUAL(frameByFrame.getNFramesAnalyzed(), blocks.getNFramesAnalyzed());
+    BOOST_CHECK_EQUAL(frameByFrame.getNentries(), blocks.getNentries());
+
+    std::vector<HalfSAMPAData> dataFrameByFrame;
+    std::vector<HalfSAMPAData> dataBlocks;
+    int nTimeBins = 0;
+    while (frameByFrame.getData(dataFrameByFrame)) {
+      BOOST_CHECK(blocks.getData(dataBlocks));
+      ++nTimeBins;
+    }
+    BOOST_CHECK(!blocks.getData(dataBlocks));
+    BOOST_CHECK_EQUAL(nTimeBins, 2*(300-9)/16);
+    BOOST_REQUIRE_EQUAL(dataFrameByFrame.size(), dataBlocks.size());
+    for (size_t i = 0; i < dataBlocks.size(); ++i) {
+      BOOST_CHECK(dataFrameByFrame[i] == dataBlocks[i]);
+    }
+    for (int channel = 0; channel < 16; ++channel) {
+      BOOST_CHECK_EQUAL(dataBlocks[0].getChannel(channel), adcValues[0][channel]);
+      BOOST_CHECK_EQUAL(dataBlocks[4].getChannel(channel), adcValues[4][channel]);
+    }
+  }
+
+}
+}
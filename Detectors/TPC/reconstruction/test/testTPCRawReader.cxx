@@ -0,0 +1,161 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCRawReader.cxx
+/// \brief This task tests the event index and the decoding of the RawReader on synthetic data in readout mode 2
+
+#define BOOST_TEST_MODULE Test TPC RawReader
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TPCReconstruction/RawReader.h"
+#include "TPCBase/Mapper.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+
+namespace o2 {
+namespace TPC {
+
+  const int nTimeBins = 10;
+
+  /// ADC value of a channel of half SAMPA 0
+  uint16_t adcValue(uint64_t event, int file, int timeBin, int channel)
+  {
+    return (event*131 + file*37 + timeBin*16 + channel) & 0x3FF;
+  }
+
+  /// Write events of decoded data of half SAMPA 0, one time bin are 8 blocks of 4 words with IDs 0x8 - 0xF
+  void writeFile(const std::string& path, const std::vector<uint64_t>& events, int file, bool truncateLast = false)
+  {
+    std::ofstream out(path, std::ios::binary);
+    for (size_t iEvent = 0; iEvent < events.size(); ++iEvent) {
+      std::vector<uint32_t> payload;
+      for (int timeBin = 0; timeBin < nTimeBins; ++timeBin) {
+        for (uint32_t id = 0x8; id <= 0xF; ++id) {
+          const uint32_t v0 = adcValue(events[iEvent], file, timeBin, (id & 0x7)*2);
+          const uint32_t v1 = adcValue(events[iEvent], file, timeBin, (id & 0x7)*2+1);
+          payload.push_back((id << 20) | (v0 >> 6));
+          payload.push_back(((v0 & 0x3F) << 26) | (v1 << 16));
+          payload.push_back(0);
+          payload.push_back(0);
+        }
+      }
+
+      auto swap = [](uint64_t w) { return (w << 32) | (w >> 32); };
+      RawReader::Header h;
+      h.dataType = 2;
+      h.reserved_01 = 0x0F;
+      h.headerVersion = 1;
+      h.nWords = 8 + payload.size();
+      h.timeStamp_w = swap(1000*events[iEvent]);
+      h.eventCount_w = swap(events[iEvent]);
+      h.reserved_2_w = swap(0x3fec2fec1fec0fec);
+
+      out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+      const size_t nWrite = (truncateLast && iEvent == events.size()-1) ? payload.size()/2 : payload.size();
+      out.write(reinterpret_cast<const char*>(payload.data()), nWrite*sizeof(uint32_t));
+    }
+  }
+
+  /// Check the data of half SAMPA 0 of the loaded event
+  void checkData(RawReader& reader, uint64_t event, const std::vector<int>& files)
+  {
+    const Mapper& mapper = Mapper::instance();
+    for (int channel = 0; channel < 16; ++channel) {
+      const PadPos padPos = mapper.padPosRegion(0, 0, 0, channel);
+      auto data = reader.getData(padPos);
+      BOOST_REQUIRE_EQUAL(data->size(), nTimeBins*files.size());
+      for (size_t iFile = 0; iFile < files.size(); ++iFile) {
+        for (int timeBin = 0; timeBin < nTimeBins; ++timeBin) {
+          BOOST_CHECK_EQUAL((*data)[iFile*nTimeBins + timeBin], adcValue(event, files[iFile], timeBin, channel));
+        }
+      }
+    }
+  }
+
+  /// @brief Test the event index of several files
+  BOOST_AUTO_TEST_CASE(RawReader_index)
+  {
+    const std::string pathA = "testTPCRawReader_A.raw";
+    const std::string pathB = "testTPCRawReader_B.raw";
+    writeFile(pathA, {2, 0}, 0);
+    writeFile(pathB, {1, 2}, 1);
+
+    RawReader reader;
+    BOOST_CHECK(reader.addInputFile(0, 0, pathA, 0));
+    BOOST_CHECK(reader.addInputFile(0, 0, pathB, 0));
+    BOOST_CHECK(!reader.addInputFile(0, 0, "testTPCRawReader_missing.raw", 0));
+
+    BOOST_CHECK_EQUAL(reader.getNumberOfEvents(), 3);
+    BOOST_CHECK_EQUAL(reader.getFirstEvent(), 0);
+    BOOST_CHECK_EQUAL(reader.getLastEvent(), 2);
+
+    auto eventInfo = reader.getEventInfo(2);
+    BOOST_REQUIRE_EQUAL(eventInfo->size(), 2);
+    BOOST_CHECK_EQUAL(eventInfo->at(0).path, pathA);
+    BOOST_CHECK_EQUAL(eventInfo->at(1).path, pathB);
+    BOOST_CHECK_EQUAL(eventInfo->at(0).posInFile, sizeof(RawReader::Header));
+    BOOST_CHECK_EQUAL(eventInfo->at(1).header.eventCount(), 2);
+    BOOST_CHECK_EQUAL(eventInfo->at(1).header.timeStamp(), 2000);
+    BOOST_CHECK(reader.getEventInfo(5)->empty());
+
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+  }
+
+  /// @brief Test the decoding from the mapped files, with and without prefetching
+  BOOST_AUTO_TEST_CASE(RawReader_decoding)
+  {
+    const std::string pathA = "testTPCRawReader_A.raw";
+    const std::string pathB = "testTPCRawReader_B.raw";
+    writeFile(pathA, {2, 0}, 0);
+    writeFile(pathB, {1, 2}, 1);
+
+    for (bool prefetch : {false, true}) {
+      RawReader reader;
+      reader.setPrefetchNextEvent(prefetch);
+      reader.addInputFile(0, 0, pathA, 0);
+      reader.addInputFile(0, 0, pathB, 0);
+
+      BOOST_CHECK_EQUAL(reader.loadNextEventNoWrap(), 0);
+      checkData(reader, 0, {0});
+      BOOST_CHECK_EQUAL(reader.loadNextEventNoWrap(), 1);
+      checkData(reader, 1, {1});
+      BOOST_CHECK_EQUAL(reader.loadNextEventNoWrap(), 2);
+      checkData(reader, 2, {0, 1});
+      BOOST_CHECK_EQUAL(reader.loadNextEventNoWrap(), -1);
+      BOOST_CHECK(!reader.loadEvent(5));
+    }
+
+    std::remove(pathA.c_str());
+    std::remove(pathB.c_str());
+  }
+
+  /// @brief Test that a truncated event is rejected while the complete ones are kept
+  BOOST_AUTO_TEST_CASE(RawReader_truncated)
+  {
+    const std::string path = "testTPCRawReader_truncated.raw";
+    writeFile(path, {0, 1, 2}, 0, true);
+
+    RawReader reader;
+    BOOST_CHECK(!reader.addInputFile(0, 0, path, 0));
+    BOOST_CHECK_EQUAL(reader.getNumberOfEvents(), 2);
+    BOOST_CHECK_EQUAL(reader.getLastEvent(), 1);
+    BOOST_CHECK(reader.loadEvent(1));
+    checkData(reader, 1, {0});
+
+    std::remove(path.c_str());
+  }
+
+}
+}
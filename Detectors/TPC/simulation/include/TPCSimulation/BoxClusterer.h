@@ -53,6 +53,7 @@ namespace o2{
       /* BoxClusterer &operator=(const BoxClusterer &); */
       
       void FindLocalMaxima(const Int_t iCRU);
+      void FindLocalMaximaPeakFinder(const Int_t iCRU);
       void CleanArrays();
       void GetPadAndTimeBin(Int_t bin, Short_t& iPad, Short_t& iTimeBin);
       Int_t Update(const Int_t iCRU, const Int_t iRow, const Int_t iPad, 
@@ -74,6 +75,11 @@ namespace o2{
       Int_t*    mAllNSigBins;  //!<! Array with number of signals in each row
       CalPad*   mPedestals;    //!<! Pedestal data
 
+      std::vector<Int_t>                    mPadTimeMin; //!<! First time bin with signal for each pad
+      std::vector<Int_t>                    mPadTimeMax; //!<! Last time bin with signal for each pad
+      std::vector<int>                      mPeaks;      //!<! Bins of the peaks found by the PeakFinder
+      std::vector<PeakFinder::Moments>      mMoments;    //!<! Moments of the clusters found by the PeakFinder
+
       std::vector<o2::TPC::BoxCluster>* mClusterArray; ///< Internal cluster storage
       
       ClassDefNV(BoxClusterer, 1);
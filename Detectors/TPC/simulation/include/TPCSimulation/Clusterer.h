@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "TPCSimulation/ClusterContainer.h"
+#include "TPCSimulation/PeakFinder.h"
 
 namespace o2{
 namespace TPC {
@@ -61,12 +62,20 @@ class Clusterer {
     void setRequirePositiveCharge(bool val)     { mRequirePositiveCharge = val; };
     void setRequireNeighbouringPad(bool val)    { mRequireNeighbouringPad = val; };
 
+    /// Use the PeakFinder kernel on the contiguous charge matrix instead of the cell by cell search
+    /// \param usePeakFinder Switch for the PeakFinder
+    /// \param kernel Implementation of the kernel, by default the fastest one supported by the CPU
+    void setUsePeakFinder(bool usePeakFinder, PeakFinder::Kernel kernel = PeakFinder::getDefaultKernel())
+    { mUsePeakFinder = usePeakFinder; mPeakFinderKernel = kernel; };
+
     int     getRowsMax()                  const { return mRowsMax; };
     int     getPadsMax()                  const { return mPadsMax; };
     int     getTimeBinsMax()              const { return mTimeBinsMax; };
     float   getMinQMax()                  const { return mMinQMax; };
     bool    hasRequirePositiveCharge()    const { return mRequirePositiveCharge; };
     bool    hasRequireNeighbouringPad()   const { return mRequireNeighbouringPad; };
+    bool    hasUsePeakFinder()            const { return mUsePeakFinder; };
+    PeakFinder::Kernel getPeakFinderKernel() const { return mPeakFinderKernel; };
     
   protected:
     
@@ -77,6 +86,8 @@ class Clusterer {
     float   mMinQMax;                       ///< Minimun Qmax for cluster
     bool    mRequirePositiveCharge;         ///< If true, require charge > 0
     bool    mRequireNeighbouringPad;        ///< If true, require 2+ pads minimum
+    bool    mUsePeakFinder;                 //!< If true, use the PeakFinder kernel
+    PeakFinder::Kernel mPeakFinderKernel;   //!< Implementation of the PeakFinder kernel
     
   };
 }
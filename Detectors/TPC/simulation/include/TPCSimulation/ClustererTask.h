@@ -67,10 +67,15 @@ class ClustererTask : public FairTask{
   /// \param isContinuous - false for triggered readout, true for continuous readout
   void setContinuousReadout(bool isContinuous);
 
+  /// Switch for the PeakFinder kernel in the clusterers, off by default
+  /// \param usePeakFinder - true to search the peaks with the PeakFinder instead of the cell by cell search
+  void setUsePeakFinder(bool usePeakFinder) { mUsePeakFinder = usePeakFinder; }
+
   private:
     bool          mBoxClustererEnable;
     bool          mHwClustererEnable;
     bool          mIsContinuousReadout; ///< Switch for continuous readout
+    bool          mUsePeakFinder;       ///< Switch for the PeakFinder kernel in the clusterers
 
     BoxClusterer        *mBoxClusterer;
     HwClusterer         *mHwClusterer;
@@ -80,7 +85,7 @@ class ClustererTask : public FairTask{
     std::vector<o2::TPC::BoxCluster>  *mClustersArray;
     std::vector<o2::TPC::HwCluster>  *mHwClustersArray;
     
-    ClassDefOverride(ClustererTask, 1)
+    ClassDefOverride(ClustererTask, 2)
 };
 
 inline
@@ -0,0 +1,179 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DigitCRUBuffer.h
+/// \brief Definition of the flat CRU container
+
+#ifndef ALICEO2_TPC_DigitCRUBuffer_H_
+#define ALICEO2_TPC_DigitCRUBuffer_H_
+
+#include "TPCSimulation/CommonModeContainer.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+
+#include "FairLogger.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+
+class Digit;
+class DigitMCMetaData;
+
+/// \class DigitCRUBuffer
+/// This is the intermediate Digit container of one CRU, in which all incoming electrons from the hits are sorted into after amplification.
+/// It replaces the former hierarchy of CRU / time bin / row / pad containers by a single dense circular buffer of charges,
+/// indexed by (time bin modulo the window size, pad index within the CRU), and a compact side table of MC labels per time bin.
+/// Time bins are flushed incrementally once they are outside of the drift window, and their buffers are reused for the following time bins.
+/// The window only has to span the time bins holding digits, it starts anew at the first digit filled into an empty buffer.
+/// The window is enlarged if a digit beyond it arrives, no data is dropped.
+
+class DigitCRUBuffer {
+  public:
+
+    /// Constructor
+    /// \param cru CRU ID
+    /// \param commonModeCont Common mode container
+    /// \param nTimeBins Initial size of the time bin window, slightly more than one full drift time by default
+    DigitCRUBuffer(int cru, CommonModeContainer &commonModeCont, int nTimeBins = 512);
+
+    /// Destructor
+    ~DigitCRUBuffer() = default;
+
+    /// Resets the container
+    void reset();
+
+    /// Get the CRU ID
+    /// \return CRU ID
+    int getCRUID() const { return mCRU; }
+
+    /// Get the first time bin which is not yet written out
+    /// \return First time bin
+    int getFirstTimeBin() const { return mFirstTimeBin; }
+
+    /// Get the size of the time bin window
+    /// \return Number of time bins in the circular buffer
+    int getWindowSize() const { return static_cast<int>(mLabels.size()); }
+
+    /// Get the number of pads in the CRU
+    /// \return Number of pads
+    size_t getNumberOfPads() const { return mPadRow.size(); }
+
+    /// Get the allocated memory
+    /// \return Allocated memory in bytes
+    size_t getMemorySize() const;
+
+    /// Add digit to the container, the MC label is built from the current entry of the FairRootManager
+    /// \param hitID MC Hit ID
+    /// \param timeBin Time bin of the digit
+    /// \param row Pad row of digit
+    /// \param pad Pad of digit
+    /// \param charge Charge of the digit
+    void setDigit(size_t hitID, int timeBin, int row, int pad, float charge);
+
+    /// Add digit to the container
+    /// \param label MC label of the digit
+    /// \param timeBin Time bin of the digit
+    /// \param row Pad row of digit
+    /// \param pad Pad of digit
+    /// \param charge Charge of the digit
+    void setDigit(const MCCompLabel &label, int timeBin, int row, int pad, float charge);
+
+    /// Move the charges and MC labels of another buffer of the same CRU into this one, together with their common mode
+    /// The other buffer is left empty
+    /// \param other Buffer of the same CRU, filled e.g. by another Digitizer
+    void merge(DigitCRUBuffer &other);
+
+    /// Fill output vector with all time bins before the event time, sorted in time bin, row and pad
+    /// \param output Output container
+    /// \param mcTruth MC Truth container
+    /// \param debug Optional debug output container
+    /// \param eventTime time stamp of the event
+    /// \param isContinuous Switch for continuous readout
+    void fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                             std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime=0, bool isContinuous=true);
+
+  private:
+    /// MC label of a pad in one time bin together with its number of occurrences
+    struct LabelEntry {
+      unsigned int pad;                ///< Pad index within the CRU
+      MCCompLabel  label;              ///< MC label
+      int          count;              ///< Number of occurrences
+    };
+
+    /// Write out one time bin and clear its slot in the buffer
+    void flushTimeBin(int timeBin, std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                      std::vector<o2::TPC::DigitMCMetaData> *debug);
+
+    /// Enlarge the time bin window
+    /// \param nTimeBins Minimal number of time bins in the window
+    void growWindow(int nTimeBins);
+
+    /// Get the slot of a time bin in the buffer, the window is enlarged if the time bin does not fit into it
+    /// \param timeBin Time bin, not before the first time bin
+    /// \return Slot of the time bin
+    size_t getSlot(int timeBin);
+
+    unsigned short                        mCRU;                 ///< CRU of the ADC value
+    int                                   mFirstTimeBin;        ///< First time bin not yet written out
+    int                                   mBeginTimeBin;        ///< First time bin with a digit, equal to mEndTimeBin if empty
+    int                                   mEndTimeBin;          ///< One past the last time bin with a digit
+    std::vector<unsigned int>             mRowOffset;           ///< Pad index of the first pad in each row
+    std::vector<unsigned char>            mPadRow;              ///< Row of each pad index
+    std::vector<float>                    mCharge;              ///< Accumulated charge per (time bin slot, pad)
+    std::vector<std::vector<LabelEntry>>  mLabels;              ///< MC labels per time bin slot
+    CommonModeContainer                   &mCommonModeContainer; ///< Reference to the common mode container
+};
+
+inline
+void DigitCRUBuffer::setDigit(const MCCompLabel &label, int timeBin, int row, int pad, float charge)
+{
+  if(timeBin < mFirstTimeBin) {
+    LOG(FATAL) << "TPC DigitCRUBuffer buffer misaligned for CRU " << mCRU << " TimeBin " << timeBin << " First TimeBin " << mFirstTimeBin << FairLogger::endl;
+    return;
+  }
+  const size_t slot = getSlot(timeBin);
+  const unsigned int padIndex = mRowOffset[row] + pad;
+  mCharge[slot * getNumberOfPads() + padIndex] += charge;
+
+  /// Consecutive charges on a pad mostly stem from the same particle, such that comparing to the last entry
+  /// keeps the side table compact, duplicates are merged when the time bin is written out
+  auto &labels = mLabels[slot];
+  if(!labels.empty() && labels.back().pad == padIndex && ULong64_t(labels.back().label) == ULong64_t(label)) {
+    ++labels.back().count;
+  }
+  else {
+    labels.push_back({padIndex, label, 1});
+  }
+}
+
+inline
+size_t DigitCRUBuffer::getSlot(int timeBin)
+{
+  if(mBeginTimeBin == mEndTimeBin) {
+    mBeginTimeBin = timeBin;
+    mEndTimeBin = timeBin;
+  }
+  const int beginTimeBin = std::min(mBeginTimeBin, timeBin);
+  const int endTimeBin = std::max(mEndTimeBin, timeBin + 1);
+  if(endTimeBin - beginTimeBin > getWindowSize()) {
+    growWindow(endTimeBin - beginTimeBin);
+  }
+  mBeginTimeBin = beginTimeBin;
+  mEndTimeBin = endTimeBin;
+  return timeBin % getWindowSize();
+}
+
+}
+}
+
+#endif // ALICEO2_TPC_DigitCRUBuffer_H_
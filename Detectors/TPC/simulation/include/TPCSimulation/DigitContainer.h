@@ -16,7 +16,7 @@
 #define ALICEO2_TPC_DigitContainer_H_
 
 #include "TPCBase/CRU.h"
-#include "TPCSimulation/DigitCRU.h"
+#include "TPCSimulation/DigitCRUBuffer.h"
 #include "TPCSimulation/CommonModeContainer.h"
 
 namespace o2 {
@@ -28,7 +28,7 @@ class DigitMCMetaData;
 /// \class DigitContainer
 /// This is the base class of the intermediate Digit Containers, in which all incoming electrons from the hits are sorted into after amplification
 /// The structure assures proper sorting of the Digits when later on written out for further processing.
-/// This class holds the CRU containers.
+/// This class holds the CRU containers, which are flat circular buffers of the time bins in the drift window.
 
 class DigitContainer{
   public:
@@ -58,6 +58,20 @@ class DigitContainer{
     /// \param charge Charge of the digit
     void addDigit(size_t hitID, int cru, int timeBin, int row, int pad, float charge);
 
+    /// Add digit to the container
+    /// \param label MC label of the digit
+    /// \param cru CRU of the digit
+    /// \param row Pad row of digit
+    /// \param pad Pad of digit
+    /// \param timeBin Time bin of the digit
+    /// \param charge Charge of the digit
+    void addDigit(const MCCompLabel &label, int cru, int timeBin, int row, int pad, float charge);
+
+    /// Move the digits of the CRUs of one sector from another container into this one, together with their common mode
+    /// \param other Container filled e.g. by another Digitizer, whose CRUs of the sector are left empty
+    /// \param sector Sector whose CRUs are moved
+    void merge(DigitContainer &other, const Sector &sector);
+
     /// Fill output vector
     /// \param output Output container
     /// \param mcTruth MC Truth container
@@ -67,8 +81,24 @@ class DigitContainer{
     void fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
 			     std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime=0, bool isContinuous=true);
 
+    /// Fill output vector with the digits of one sector
+    /// The common mode container is not cleaned up, which has to be done by cleanUp() once all sectors are written out
+    /// \param output Output container
+    /// \param mcTruth MC Truth container
+    /// \param debug Optional debug output container
+    /// \param sector Sector to be written out
+    /// \param eventTime time stamp of the event
+    /// \param isContinuous Switch for continuous readout
+    void fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                             std::vector<o2::TPC::DigitMCMetaData> *debug, const Sector &sector, int eventTime=0, bool isContinuous=true);
+
+    /// Clean up the common mode container after the write out
+    /// \param eventTime time stamp of the event
+    /// \param isContinuous Switch for continuous readout
+    void cleanUp(int eventTime=0, bool isContinuous=true) { mCommonModeContainer.cleanUp(eventTime, isContinuous); }
+
   private:
-    std::array<std::unique_ptr<DigitCRU> , CRU::MaxCRU> mCRU;   ///< CRU Container for the ADC value
+    std::array<std::unique_ptr<DigitCRUBuffer> , CRU::MaxCRU> mCRU;   ///< CRU Container for the ADC value
     CommonModeContainer                                 mCommonModeContainer; ///< Container for the common mode values
 };
 
@@ -16,6 +16,8 @@
 #define ALICEO2_TPC_Digitizer_H_
 
 #include "TPCSimulation/DigitContainer.h"
+#include "TPCSimulation/ElectronTransport.h"
+#include "TPCSimulation/GEMAmplification.h"
 #include "TPCSimulation/PadResponse.h"
 #include "TPCSimulation/Point.h"
 #include "TPCBase/ParameterDetector.h"
@@ -25,6 +27,7 @@
 #include "TPCBase/Mapper.h"
 
 #include <cmath>
+#include <memory>
 
 using std::vector;
 
@@ -43,7 +46,6 @@ typedef struct {
     float pad;
     float nElectrons;
 } GEMRESPONSE;
-static GEMRESPONSE GEMresponse;
 
 /// \class Digitizer
 /// This is the digitizer for the ALICE GEM TPC.
@@ -55,6 +57,7 @@ static GEMRESPONSE GEMresponse;
 /// -# Shaping and further signal processing in the Front-End Cards (SampaProcessing)
 /// The such created Digits and then sorted in an intermediate Container (DigitContainer) and after processing of the full event/drift time summed up
 /// and sorted as Digits into a vector which is then passed further on
+/// All state, including the random number streams, is held per instance, such that several Digitizers can run in parallel threads
 
 class Digitizer {
   public:
@@ -62,6 +65,13 @@ class Digitizer {
     /// Default constructor
     Digitizer();
 
+    /// Constructor sharing the read-only random number rings and the pad response of another Digitizer
+    /// The rings are read starting at the position of the given random stream, see setRandomStream()
+    /// \param other Digitizer whose random number rings and pad response are shared
+    /// \param stream Index of the random stream
+    /// \param nStreams Number of random streams
+    Digitizer(const Digitizer &other, int stream, int nStreams);
+
     /// Destructor
     ~Digitizer();
 
@@ -69,19 +79,37 @@ class Digitizer {
     void init();
 
     /// Steer conversion of points to digits
-    /// \param points Container with TPC points
+    /// \param hits Container with TPC hit groups
+    /// \param eventID MC event ID used for the MC labels
+    /// \param eventTime Time of the event in us, only used for continuous readout
     /// \return digits container
-    DigitContainer* Process(const std::vector<o2::TPC::HitGroup>& hits);
+    DigitContainer* Process(const std::vector<o2::TPC::HitGroup>& hits, int eventID, float eventTime);
 
     DigitContainer *getDigitContainer() const { return mDigitContainer; }
 
+    /// Read the random number rings starting at the beginning of one of several equal parts
+    /// Digitizers sharing the same rings read different random numbers when they use different streams
+    /// \param stream Index of the random stream
+    /// \param nStreams Number of random streams
+    void setRandomStream(int stream, int nStreams);
+
+    /// \return Number of hits processed so far
+    size_t getNumberOfProcessedHits() const { return mHitCounter; }
+
     /// Enable the debug output after application of the PRF
     /// Can be set via DigitizerTask::setDebugOutput("PRFdebug")
-    static void setPRFDebug() { mDebugFlagPRF = true; }
+    void setPRFDebug() { mDebugFlagPRF = true; }
 
     /// Switch for triggered / continuous readout
     /// \param isContinuous - false for triggered readout, true for continuous readout
-    static void setContinuousReadout(bool isContinuous) { mIsContinuous = isContinuous ; }
+    void setContinuousReadout(bool isContinuous) { mIsContinuous = isContinuous ; }
+
+    /// Switch for the batched processing of the electrons
+    /// In batched mode all primary electrons of a HitGroup are processed in structure-of-arrays layout,
+    /// one processing step at a time. Each random number stream is consumed in the same order as in the
+    /// per-electron processing, such that both give identical digits
+    /// \param isBatched - true for batched processing, false for per-electron processing
+    void setBatchedProcessing(bool isBatched) { mIsBatched = isBatched; }
 
     /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     /// Conversion functions that at some point should go someplace else
@@ -121,13 +149,42 @@ class Digitizer {
     Digitizer(const Digitizer &);
     Digitizer &operator=(const Digitizer &);
 
+    /// Primary electrons of one HitGroup in structure-of-arrays layout
+    struct ElectronBatch {
+      std::vector<float> x;              ///< x position of the electrons
+      std::vector<float> y;              ///< y position of the electrons
+      std::vector<float> z;              ///< z position of the electrons
+      std::vector<float> time;           ///< Time of the hit, later absolute time of the electrons
+      std::vector<float> driftTime;      ///< Drift time of the electrons
+      std::vector<char>  selected;       ///< Attachment flag, reused as selection flag of the electrons
+      std::vector<int>   cru;            ///< CRU of the electrons
+      std::vector<int>   row;            ///< Pad row of the electrons
+      std::vector<int>   pad;            ///< Pad of the electrons
+      std::vector<float> ADC;            ///< ADC value after the amplification
+      std::vector<float> signal;         ///< Shaped signals, see SAMPAProcessing::getShapedSignal
+    };
+
+    /// Batched conversion of all primary electrons of one HitGroup to digits
+    /// \param inputgroup HitGroup to be processed
+    /// \param eventID MC event ID
+    /// \param eventTime Time of the event in us
+    void processHitGroupBatched(const HitGroup &inputgroup, int eventID, float eventTime);
+
     DigitContainer          *mDigitContainer;   ///< Container for the Digits
+    GEMAmplification        mGEMAmplification;  //!< Amplification in the GEM stack
+    ElectronTransport       mElectronTransport; //!< Drift, diffusion and attachment of the electrons
+    std::shared_ptr<const PadResponse> mPadResponse; //!< Pad response function, shared with the copies
+    std::vector<float>      mSignalArray;       //!< Shaped signal of one electron
+    GEMRESPONSE             mGEMresponse;       //!< Debug output after the PRF
+    bool                    mIsBatched;         ///< Switch for the batched processing
+    ElectronBatch           mElectronBatch;     //!< Buffers of the batched processing, kept to avoid reallocations
 
     std::unique_ptr<TTree>  mDebugTreePRF;      ///< Output tree for the output after the PRF
-    static bool             mDebugFlagPRF;      ///< Flag for debug output after the PRF
-    static bool             mIsContinuous;      ///< Switch for continuous readout
+    bool                    mDebugFlagPRF;      ///< Flag for debug output after the PRF
+    bool                    mIsContinuous;      ///< Switch for continuous readout
+    size_t                  mHitCounter;        //!< Number of processed hits
 
-  ClassDefNV(Digitizer, 1);
+  ClassDefNV(Digitizer, 2);
 };
 
 // inline implementations
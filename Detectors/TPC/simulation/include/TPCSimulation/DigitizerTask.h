@@ -16,12 +16,15 @@
 #define ALICEO2_TPC_DigitizerTask_H_
 
 #include <cstdio>
+#include <memory>
 #include <string>
+#include <vector>
 #include "FairTask.h"
 #include "FairLogger.h"
 #include "TPCSimulation/Digitizer.h"
 #include "TPCBase/Sector.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
+#include "CommonUtils/ThreadPool.h"
 
 namespace o2 {
 namespace TPC { 
@@ -31,6 +34,9 @@ class Digitizer;
 /// \class DigitizerTask
 /// This task steers the digitization process and takes care of the input and output
 /// Furthermore, it allows for switching debug output on/off
+/// When all sectors are treated, each sector has its own Digitizer, all of them sharing the read-only random number rings
+/// and reading them from a different position. The sectors can be digitized in parallel by a thread pool,
+/// and the results do not depend on the number of threads
     
 class DigitizerTask : public FairTask{
   public:
@@ -54,6 +60,14 @@ class DigitizerTask : public FairTask{
     /// \param isContinuous - false for triggered readout, true for continuous readout
     void setContinuousReadout(bool isContinuous);
 
+    /// Switch for the batched processing of the electrons in the digitizer
+    /// \param isBatched - true for batched processing, false for per-electron processing
+    void setBatchedProcessing(bool isBatched) { mIsBatchedProcessing = isBatched; }
+
+    /// Set the number of threads for the digitization of all sectors
+    /// \param nThreads Number of threads, 0 to use all available cores
+    void setNumberOfThreads(int nThreads) { mNThreads = nThreads; }
+
     /// Set the maximal number of written out time bins
     /// \param nTimeBinsMax Maximal number of time bins to be written out
     void setMaximalTimeBinWriteOut(int i) { mTimeBinMax = i; }
@@ -64,9 +78,26 @@ class DigitizerTask : public FairTask{
       
     void FinishTask() override;
 
+    /// Create the Digitizers and the thread pool, called by Init()
+    void initDigitizers();
+
+    /// Digitize the hits of the treated sectors
+    /// \param sectorHits Hits of each sector, only the treated sectors are accessed
+    /// \param eventID MC event ID used for the MC labels
+    /// \param eventTime Time of the event in us
+    void digitize(const std::vector<o2::TPC::HitGroup> *const sectorHits[], int eventID, float eventTime);
+
+    /// Write out the digits of all Digitizers in sector order
+    /// \param digits Output container of the digits
+    /// \param mcTruth Output container of the MC labels
+    /// \param debug Optional debug output container
+    /// \param eventTime time stamp of the event
+    void fillOutputContainer(std::vector<o2::TPC::Digit> *digits, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                             std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime);
+
   private:
-    Digitizer           *mDigitizer;    ///< Digitization process
-    DigitContainer      *mDigitContainer;
+    std::vector<std::unique_ptr<Digitizer>> mDigitizers;  //!< Digitization processes, one per treated sector
+    std::unique_ptr<o2::utils::ThreadPool>  mThreadPool;  //!< Pool of the digitization threads
       
     std::vector<o2::TPC::Digit> *mDigitsArray = nullptr;  ///< Array of the Digits, passed from the digitization
     o2::dataformats::MCTruthContainer<o2::MCCompLabel> mMCTruthArray; ///< Array for MCTruth information associated to digits in mDigitsArrray. Passed from the digitization
@@ -75,6 +106,9 @@ class DigitizerTask : public FairTask{
     int                 mTimeBinMax;   ///< Maximum time bin to be written out
     bool                mIsContinuousReadout; ///< Switch for continuous readout
     bool                mDigitDebugOutput;    ///< Switch for the debug output of the DigitMC
+    bool                mPRFDebugOutput;      ///< Switch for the debug output after the PRF
+    bool                mIsBatchedProcessing; ///< Switch for the batched processing of the electrons
+    int                 mNThreads;     ///< Number of threads for the digitization of all sectors
     int                 mHitSector=-1; ///< which sector to treat
 
     const std::vector<o2::TPC::HitGroup> *mSectorHitsArray[Sector::MAXSECTOR];
@@ -88,7 +122,7 @@ void DigitizerTask::setDebugOutput(TString debugString)
   LOG(INFO) << "TPC - Debug output enabled for: ";
   if (debugString.Contains("PRFdebug")) {
     LOG(INFO) << "Pad response function, ";
-    o2::TPC::Digitizer::setPRFDebug();
+    mPRFDebugOutput = true;
   }
   if (debugString.Contains("DigitMCDebug")) {
     LOG(INFO) << "DigitMC, ";
@@ -101,7 +135,6 @@ inline
 void DigitizerTask::setContinuousReadout(bool isContinuous)
 {
   mIsContinuousReadout = isContinuous;
-  o2::TPC::Digitizer::setContinuousReadout(isContinuous);
 }
 
 }
@@ -20,6 +20,8 @@
 #include "TPCBase/RandomRing.h"
 #include "TPCBase/Mapper.h"
 
+#include <vector>
+
 namespace o2 {
 namespace TPC {
 
@@ -34,9 +36,18 @@ class ElectronTransport
     /// Default constructor
     ElectronTransport();
 
+    /// Copy constructor
+    /// The copy shares the read-only random number rings with the original
+    ElectronTransport(const ElectronTransport &) = default;
+
     /// Destructor
     ~ElectronTransport();
 
+    /// Read the random number rings starting at the beginning of one of several equal parts
+    /// \param stream Index of the part
+    /// \param nStreams Number of parts
+    void setRandomStream(int stream, int nStreams);
+
     /// Drift of electrons in electric field taking into account diffusion
     /// \param posEle GlobalPosition3D with start position of the electrons
     /// \return GlobalPosition3D with position of the electrons after the drift taking into account diffusion
@@ -47,12 +58,25 @@ class ElectronTransport
     /// \return Boolean whether the electron is attached (and lost) or not
     bool isElectronAttachment(float driftTime);
 
+    /// Drift of a batch of electrons in structure-of-arrays layout
+    /// The positions are smeared in place, with the same diffusion as in getElectronDrift(GlobalPosition3D)
+    /// \param x x positions of the electrons
+    /// \param y y positions of the electrons
+    /// \param z z positions of the electrons
+    void getElectronDrift(std::vector<float> &x, std::vector<float> &y, std::vector<float> &z);
+
+    /// Attachment for a batch of electrons
+    /// \param driftTime Drift times of the electrons
+    /// \param isAttached Flag per electron whether it is attached (and lost) or not
+    void getElectronAttachment(const std::vector<float> &driftTime, std::vector<char> &isAttached);
 
   private:
     /// Circular random buffer containing random values of the Gauss distribution to take into account diffusion of the electrons
     RandomRing     mRandomGaus;
     /// Circular random buffer containing flat random values to take into account electron attachement during drift
     RandomRing     mRandomFlat;
+    /// Scratch buffer for the random values of the batched functions
+    std::vector<float> mRandomBuffer;
 };
 
 inline
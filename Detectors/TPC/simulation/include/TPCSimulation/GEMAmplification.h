@@ -31,9 +31,18 @@ class GEMAmplification
     /// Default constructor
     GEMAmplification();
 
+    /// Copy constructor
+    /// The copy shares the read-only random number rings with the original
+    GEMAmplification(const GEMAmplification &) = default;
+
     /// Destructor
     ~GEMAmplification();
 
+    /// Read the random number rings starting at the beginning of one of several equal parts
+    /// \param stream Index of the part
+    /// \param nStreams Number of parts
+    void setRandomStream(int stream, int nStreams);
+
     /// Compute the number of electrons after amplification in a full stack of four GEM foils
     /// \param nElectrons Number of electrons arriving at the first amplification stage (GEM1)
     /// \return Number of electrons after amplification in a full stack of four GEM foils
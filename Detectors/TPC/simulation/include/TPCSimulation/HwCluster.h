@@ -53,6 +53,14 @@ class HwCluster : public Cluster {
     /// \param other HwCluster to be copied
     HwCluster(const HwCluster& other);
 
+    /// Move Constructor
+    /// \param other HwCluster to be moved
+    HwCluster(HwCluster&& other) = default;
+
+    /// Assignment operators
+    HwCluster& operator=(const HwCluster& other) = default;
+    HwCluster& operator=(HwCluster&& other) = default;
+
     short getPad() const { return mPad; }
     short getTime() const { return mTime; }
     short getSizeP() const { return mSizeP; }
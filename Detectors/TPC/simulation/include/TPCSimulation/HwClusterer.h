@@ -16,8 +16,10 @@
 
 #include "TPCSimulation/Clusterer.h"
 #include "TPCSimulation/HwCluster.h"
+#include "CommonUtils/ThreadPool.h"
 #include "TPCBase/CalDet.h" 
 
+#include <memory>
 #include <vector>
 
 namespace o2{
@@ -76,6 +78,10 @@ class HwClusterer : public Clusterer {
 
     void setProcessingType(Processing processing)    { mProcessingType = processing; };   
 
+    /// Set the number of threads for the parallel processing, has to be called before Init()
+    /// \param nThreads Number of threads, 0 to use all available cores
+    void setNumberOfThreads(int nThreads) { mNThreads = nThreads; };
+
     void setNoiseObject(CalDet<float>* noiseObject) { mNoiseObject = noiseObject; };
     void setPedestalObject(CalDet<float>* pedestalObject) { mPedestalObject = pedestalObject; };
 
@@ -103,12 +109,45 @@ class HwClusterer : public Clusterer {
       CalDet<float>* iNoiseObject;
       CalDet<float>* iPedestalObject;
     };
+
+    /// Scratch buffers of the PeakFinder, kept between the calls to avoid reallocations
+    struct PeakFinderBuffers {
+      std::vector<float> allBins;                  ///< Charge matrix of one row
+      std::vector<int> peaks;                      ///< Found peaks of one row
+      std::vector<PeakFinder::Moments> moments;    ///< Cluster moments of the peaks
+    };
     
     static void processDigits(
         const std::vector<std::vector<Digit const*>>& digits, 
         const std::vector<std::vector<HwClusterFinder*>>& clusterFinder, 
               std::vector<HwCluster>& cluster, 
               CfConfig config);
+
+    /// Find the clusters with the PeakFinder kernel on the contiguous charge matrix of each row
+    /// \param digits Digits of the CRU, sorted by row
+    /// \param history Last time bins of each row of the previous call, updated for the next one
+    /// \param cluster Output container
+    /// \param peakFinder PeakFinder kernel
+    /// \param buffers Scratch buffers, which must not be used by another thread at the same time
+    /// \param config Configuration
+    static void processDigitsPeakFinder(
+        const std::vector<std::vector<Digit const*>>& digits,
+              std::vector<float>& history,
+              std::vector<HwCluster>& cluster,
+        const PeakFinder& peakFinder,
+              PeakFinderBuffers& buffers,
+              CfConfig config);
+
+    /// Fill the charges of one row into the time bins, including noise and pedestal subtraction
+    /// \param timebins Time bins of the row, each one with config.iMaxPads pads
+    /// \param digits Digits of the row
+    /// \param iRow Row
+    /// \param timeDiff Number of time bins
+    /// \param config Configuration
+    static void fillTimebins(float* timebins, const std::vector<Digit const*>& digits, int iRow, int timeDiff, const CfConfig& config);
+
+    /// Number of time bins of each row kept between the calls for the PeakFinder
+    static constexpr int PeakFinderHistory = 4;
 //              int iCRU,
 //              int maxRows,
 //              int maxPads, 
@@ -120,9 +159,15 @@ class HwClusterer : public Clusterer {
     std::vector<std::vector<std::vector<HwClusterFinder*>>> mClusterFinder;
     std::vector<std::vector<std::vector<Digit const*>>> mDigitContainer;
 
-    std::vector<std::vector<HwCluster>> mClusterStorage;
-    
+    std::vector<std::vector<HwCluster>> mClusterStorage;   ///< Found clusters, one buffer per CRU, written only by the task of that CRU
+    std::vector<int>                    mCRUOrder;         ///< CRUs in the order of their scheduling
+
     Processing    mProcessingType; 
+    int           mNThreads;                        ///< Number of threads for the parallel processing
+    std::unique_ptr<o2::utils::ThreadPool> mThreadPool; //!< Persistent pool for the parallel processing
+    std::unique_ptr<PeakFinder> mPeakFinder;        //!< PeakFinder kernel, if it is used instead of the cluster finders
+    std::vector<std::vector<float>> mTimebinHistory; ///< Last time bins of each row per CRU, kept for the PeakFinder
+    std::vector<PeakFinderBuffers> mPeakFinderBuffers; //!< Scratch buffers of the PeakFinder, one per worker thread
 
     int     mGlobalTime;
     int     mCRUMin;
@@ -0,0 +1,173 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PeakFinder.h
+/// \brief Definition of the vectorised peak finding and cluster moment kernel
+
+#ifndef ALICEO2_TPC_PeakFinder_H_
+#define ALICEO2_TPC_PeakFinder_H_
+
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+
+/// \class PeakFinder
+/// Peak finding and 5x5 cluster moment computation on a padded, contiguous charge matrix.
+/// The matrix is addressed as data[time * timeStride + pad * padStride], such that the same kernel
+/// works on time major (HwClusterer) and pad major (BoxClusterer) layouts. Around every scanned cell
+/// two cells of padding have to be accessible in both directions.
+///
+/// A cell is a peak if its charge is above threshold and it is a local maximum of the 3x3 neighbourhood.
+/// The neighbours before the cell in (time, pad) order have to be smaller, the ones after it not larger,
+/// such that of two equal neighbouring maxima only one is taken.
+/// The cluster consists of the inner 3x3 cells and of those outer cells of the 5x5 matrix, whose
+/// neighbouring inner cell towards the peak is above the outer threshold:
+///    --->  pad direction
+///    o o o o o    |
+///    o i i i o    |
+///    o i C i o    V Time direction
+///    o i i i o
+///    o o o o o
+///
+/// The peak search is vectorised with Vc along the contiguous direction, the moments across the peaks.
+/// The instruction set is fixed at build time for the whole library, such that the scalar kernel is no
+/// fallback for CPUs without it. It is the reference implementation, and the default if Vc has no SIMD
+/// implementation for the target.
+class PeakFinder {
+  public:
+    /// Implementation of the kernel
+    enum class Kernel : int { Scalar, Vectorised };
+
+    /// Charge moments of a cluster, the positions are relative to the peak
+    struct Moments {
+      double qTot;       ///< Total charge
+      double qMax;       ///< Charge of the peak
+      double padMean;    ///< Mean position in pad direction
+      double padSigma;   ///< Sigma in pad direction
+      double timeMean;   ///< Mean position in time direction
+      double timeSigma;  ///< Sigma in time direction
+      short  padMin;     ///< First pad with charge
+      short  padMax;     ///< Last pad with charge
+      short  timeMin;    ///< First time bin with charge
+      short  timeMax;    ///< Last time bin with charge
+    };
+
+    /// Constructor
+    /// \param chargeThreshold Minimum charge of the peak
+    /// \param outerThreshold Minimum charge of an inner cell for its outer neighbours to be added to the cluster
+    /// \param requirePositiveCharge Only cells with charge > 0 are added to the cluster
+    /// \param requireNeighbouringTimeBin Requires signal in one of the neighbouring time bins of the peak
+    /// \param requireNeighbouringPad Requires signal in one of the neighbouring pads of the peak
+    /// \param kernel Implementation of the kernel
+    PeakFinder(float chargeThreshold = 5, float outerThreshold = 0, bool requirePositiveCharge = true,
+               bool requireNeighbouringTimeBin = true, bool requireNeighbouringPad = false,
+               Kernel kernel = getDefaultKernel());
+
+    /// Get the fastest kernel of the build
+    /// \return Vectorised kernel if Vc was built with a SIMD implementation, scalar kernel otherwise
+    static Kernel getDefaultKernel();
+
+    /// Find the peaks in a contiguous range of cells
+    /// \param data Charge matrix
+    /// \param begin Index of the first cell to check
+    /// \param end Index one past the last cell to check
+    /// \param timeStride Distance between neighbouring time bins
+    /// \param padStride Distance between neighbouring pads
+    /// \param peaks Indices of the found peaks, which are appended in increasing order
+    void findPeaks(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const;
+
+    /// Compute the cluster moments of the peaks
+    /// \param data Charge matrix
+    /// \param peaks Indices of the peaks
+    /// \param timeStride Distance between neighbouring time bins
+    /// \param padStride Distance between neighbouring pads
+    /// \param moments Moments of the clusters, one per peak
+    void computeMoments(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                        std::vector<Moments> &moments) const;
+
+    void  setChargeThreshold(float val)                 { mChargeThreshold = val; }
+    void  setOuterThreshold(float val)                  { mOuterThreshold = val; }
+    void  setRequirePositiveCharge(bool val)            { mRequirePositiveCharge = val; }
+    void  setRequireNeighbouringTimeBin(bool val)       { mRequireNeighbouringTimeBin = val; }
+    void  setRequireNeighbouringPad(bool val)           { mRequireNeighbouringPad = val; }
+    void  setKernel(Kernel val)                         { mKernel = val; }
+
+    float  getChargeThreshold() const                   { return mChargeThreshold; }
+    float  getOuterThreshold() const                    { return mOuterThreshold; }
+    bool   getRequirePositiveCharge() const             { return mRequirePositiveCharge; }
+    bool   getRequireNeighbouringTimeBin() const        { return mRequireNeighbouringTimeBin; }
+    bool   getRequireNeighbouringPad() const            { return mRequireNeighbouringPad; }
+    Kernel getKernel() const                            { return mKernel; }
+
+  private:
+    /// Check if a cell is a peak
+    /// \param q Pointer to the cell
+    bool isPeak(const float *q, int timeStride, int padStride) const;
+
+    /// Get the charge of a cell which is added to the cluster
+    /// \param q Pointer to the peak
+    /// \param deltaTime Time bin relative to the peak
+    /// \param deltaPad Pad relative to the peak
+    float getClusterCharge(const float *q, int deltaTime, int deltaPad, int timeStride, int padStride) const;
+
+    void findPeaksScalar(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const;
+    void findPeaksVectorised(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const;
+    void computeMomentsScalar(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                              std::vector<Moments> &moments) const;
+    void computeMomentsVectorised(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                                  std::vector<Moments> &moments) const;
+
+    float  mChargeThreshold;            ///< Minimum charge of the peak
+    float  mOuterThreshold;             ///< Minimum charge of an inner cell to add its outer neighbours
+    bool   mRequirePositiveCharge;      ///< If true, only cells with charge > 0 are added
+    bool   mRequireNeighbouringTimeBin; ///< If true, require signal in a neighbouring time bin
+    bool   mRequireNeighbouringPad;     ///< If true, require signal in a neighbouring pad
+    Kernel mKernel;                     ///< Implementation of the kernel
+};
+
+inline
+bool PeakFinder::isPeak(const float *q, int timeStride, int padStride) const
+{
+  const float qMax = q[0];
+  if (qMax < mChargeThreshold) return false;
+  if (mRequireNeighbouringTimeBin && (q[-timeStride] + q[timeStride] <= 0)) return false;
+  if (mRequireNeighbouringPad && (q[-padStride] + q[padStride] <= 0)) return false;
+
+  if (q[-timeStride - padStride] >= qMax) return false;
+  if (q[-timeStride]             >= qMax) return false;
+  if (q[-timeStride + padStride] >= qMax) return false;
+  if (q[-padStride]              >= qMax) return false;
+  if (q[padStride]               >  qMax) return false;
+  if (q[timeStride - padStride]  >  qMax) return false;
+  if (q[timeStride]              >  qMax) return false;
+  if (q[timeStride + padStride]  >  qMax) return false;
+  return true;
+}
+
+inline
+float PeakFinder::getClusterCharge(const float *q, int deltaTime, int deltaPad, int timeStride, int padStride) const
+{
+  const float charge = q[deltaTime * timeStride + deltaPad * padStride];
+  if (deltaTime == 0 && deltaPad == 0) return charge;
+  if (mRequirePositiveCharge && charge <= 0) return 0.f;
+  if (deltaTime == 2 || deltaTime == -2 || deltaPad == 2 || deltaPad == -2) {
+    /// outer cell, the neighbouring inner cell is the one towards the peak
+    const int innerTime = deltaTime / 2 + deltaTime % 2;
+    const int innerPad = deltaPad / 2 + deltaPad % 2;
+    if (!(q[innerTime * timeStride + innerPad * padStride] > mOuterThreshold)) return 0.f;
+  }
+  return charge;
+}
+
+}
+}
+
+#endif // ALICEO2_TPC_PeakFinder_H_
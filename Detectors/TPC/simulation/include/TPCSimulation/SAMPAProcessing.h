@@ -65,6 +65,19 @@ class SAMPAProcessing
     /// \todo the size of the array should be retrieved from ParameterElectronics::getNShapedPoints()
     static void getShapedSignal(float ADCsignal, float driftTime, std::vector<float> &signalArray);
 
+    /// Shaping of a batch of delta signals, vectorized over the signals
+    /// The shaped value of the time bin i of signal j is stored at signalArray[i * stride + j],
+    /// with the stride given by getShapedSignalStride()
+    /// \param ADCsignal Signals of the incoming charges
+    /// \param driftTime t0 of the incoming charges
+    /// \param signalArray Array with the shaped signals
+    static void getShapedSignal(const std::vector<float> &ADCsignal, const std::vector<float> &driftTime, std::vector<float> &signalArray);
+
+    /// Stride of the array filled by the batched getShapedSignal
+    /// \param nSignals Number of signals in the batch
+    /// \return Number of signals rounded up to a multiple of the Vc vector size
+    static size_t getShapedSignalStride(size_t nSignals) { return (nSignals + Vc::float_v::Size - 1) / Vc::float_v::Size * Vc::float_v::Size; }
+
     /// Value of the Gamma4 shaping function at a given time (vectorized)
     /// \param time Time of the ADC value with respect to the first bin in the pulse
     /// \param startTime First bin in the pulse
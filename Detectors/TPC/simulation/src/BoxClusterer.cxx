@@ -99,6 +99,9 @@
 #include "TMath.h"
 #include "TError.h"   // for R__ASSERT()
 
+#include <algorithm>
+#include <limits>
+
 ClassImp(o2::TPC::BoxClusterer)
 
 using namespace o2::TPC;
@@ -228,6 +231,11 @@ void BoxClusterer::FindLocalMaxima(const Int_t iCRU)
   /// Loop over the signals and identify local maxima and fill the
   /// calibration objects with the information
 
+  if (mUsePeakFinder) {
+    FindLocalMaximaPeakFinder(iCRU);
+    return;
+  }
+
   R__ASSERT(mAllBins);
 
   Int_t nLocalMaxima = 0;
@@ -375,6 +383,65 @@ void BoxClusterer::FindLocalMaxima(const Int_t iCRU)
   } // end loop over rows
 }
 
+//_____________________________________________________________________
+void BoxClusterer::FindLocalMaximaPeakFinder(const Int_t iCRU)
+{
+  /// Same as FindLocalMaxima, but the local maxima and the cluster
+  /// parameters are computed by the PeakFinder kernel, which scans the
+  /// contiguous time bins of each pad between its first and last signal
+
+  R__ASSERT(mAllBins);
+
+  const Int_t maxTimeBin = mTimeBinsMax+4; // Used to step between neighboring pads
+  // the outer bins are only added if the inner bin has a signal
+  const Float_t outerThreshold = mRequirePositiveCharge ? 0.f : -std::numeric_limits<Float_t>::infinity();
+  const PeakFinder peakFinder(mMinQMax, outerThreshold, mRequirePositiveCharge,
+                              true, mRequireNeighbouringPad, mPeakFinderKernel);
+  mPadTimeMin.resize(mPadsMax+4);
+  mPadTimeMax.resize(mPadsMax+4);
+
+  // loop over rows
+  for (Int_t iRow = 0; iRow < mRowsMax; iRow++) {
+
+    const Float_t* allBins = mAllBins[iRow];
+    const Int_t* sigBins   = mAllSigBins[iRow];
+    const Int_t nSigBins   = mAllNSigBins[iRow];
+    if (nSigBins == 0) continue;
+
+    // time range of the signals on each pad
+    std::fill(mPadTimeMin.begin(), mPadTimeMin.end(), maxTimeBin);
+    std::fill(mPadTimeMax.begin(), mPadTimeMax.end(), -1);
+    for (Int_t iSig = 0; iSig < nSigBins; iSig++) {
+      const Int_t pad  = sigBins[iSig] / maxTimeBin;
+      const Int_t time = sigBins[iSig] % maxTimeBin;
+      mPadTimeMin[pad] = std::min(mPadTimeMin[pad], time);
+      mPadTimeMax[pad] = std::max(mPadTimeMax[pad], time);
+    }
+
+    // only bins with 2 pads and time bins around them are checked
+    mPeaks.clear();
+    for (Int_t pad = 2; pad < mPadsMax+2; pad++) {
+      const Int_t begin = std::max(mPadTimeMin[pad], 2);
+      const Int_t end   = std::min(mPadTimeMax[pad]+1, mTimeBinsMax+2);
+      if (begin >= end) continue;
+      peakFinder.findPeaks(allBins, pad*maxTimeBin + begin, pad*maxTimeBin + end, 1, maxTimeBin, mPeaks);
+    }
+    peakFinder.computeMoments(allBins, mPeaks, 1, maxTimeBin, mMoments);
+
+    for (size_t iPeak = 0; iPeak < mPeaks.size(); iPeak++) {
+      const PeakFinder::Moments& moments = mMoments[iPeak];
+      if (moments.qTot <= 0) continue;
+      Short_t pad, timebin;
+      GetPadAndTimeBin(mPeaks[iPeak], pad, timebin);
+      Short_t size = 10*(moments.padMax-moments.padMin+1) + (moments.timeMax-moments.timeMin+1);
+      BoxCluster* cluster = ClusterContainer::AddCluster<BoxCluster>(mClusterArray, iCRU, iRow, moments.qTot, moments.qMax,
+                                                                     moments.padMean + pad, moments.timeMean + timebin,
+                                                                     moments.padSigma, moments.timeSigma);
+      cluster->setBoxParameters(pad, timebin, size);
+    }
+  }
+}
+
 //_____________________________________________________________________
 void BoxClusterer::CleanArrays()
 {
@@ -31,6 +31,8 @@ Clusterer::Clusterer(int rowsMax, int padsMax, int timeBinsMax, int minQMax,
   , mMinQMax(minQMax)
   , mRequirePositiveCharge(requirePositiveCharge)
   , mRequireNeighbouringPad(requireNeighbouringPad)
+  , mUsePeakFinder(false)
+  , mPeakFinderKernel(PeakFinder::getDefaultKernel())
 {
 }
 
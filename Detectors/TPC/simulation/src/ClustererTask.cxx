@@ -32,6 +32,7 @@ ClustererTask::ClustererTask()
   , mBoxClustererEnable(false)
   , mHwClustererEnable(false)
   , mIsContinuousReadout(true)
+  , mUsePeakFinder(false)
   , mBoxClusterer(nullptr)
   , mHwClusterer(nullptr)
   , mDigitsArray(nullptr)
@@ -82,6 +83,7 @@ InitStatus ClustererTask::Init()
 
     // create clusterer and pass output pointer
     mBoxClusterer = new BoxClusterer(mClustersArray);
+    mBoxClusterer->setUsePeakFinder(mUsePeakFinder);
     mBoxClusterer->Init();
   }
 
@@ -93,6 +95,7 @@ InitStatus ClustererTask::Init()
      // create clusterer and pass output pointer
     mHwClusterer = new HwClusterer(mHwClustersArray);
     mHwClusterer->setContinuousReadout(mIsContinuousReadout);
+    mHwClusterer->setUsePeakFinder(mUsePeakFinder);
     mHwClusterer->Init();
 // TODO: implement noise/pedestal objecta
 //    mHwClusterer->setNoiseObject();
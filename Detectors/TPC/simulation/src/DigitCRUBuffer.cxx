@@ -0,0 +1,198 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DigitCRUBuffer.cxx
+/// \brief Implementation of the flat CRU container
+
+#include "TPCSimulation/DigitCRUBuffer.h"
+#include "TPCSimulation/DigitMCMetaData.h"
+#include "TPCSimulation/SAMPAProcessing.h"
+#include "TPCBase/CRU.h"
+#include "TPCBase/Digit.h"
+#include "TPCBase/Mapper.h"
+#include "TPCBase/PadPos.h"
+#include "TPCBase/PadSecPos.h"
+
+#include "FairRootManager.h"
+
+#include <algorithm>
+
+using namespace o2::TPC;
+
+DigitCRUBuffer::DigitCRUBuffer(int cru, CommonModeContainer &commonModeCont, int nTimeBins)
+  : mCRU(cru),
+    mFirstTimeBin(0),
+    mBeginTimeBin(0),
+    mEndTimeBin(0),
+    mRowOffset(),
+    mPadRow(),
+    mCharge(),
+    mLabels(nTimeBins),
+    mCommonModeContainer(commonModeCont)
+{
+  const Mapper& mapper = Mapper::instance();
+  const PadRegionInfo& regionInfo = mapper.getPadRegionInfo(CRU(cru).region());
+  const int nRows = regionInfo.getNumberOfPadRows();
+  mRowOffset.resize(nRows);
+  for(int row = 0; row < nRows; ++row) {
+    mRowOffset[row] = mPadRow.size();
+    mPadRow.insert(mPadRow.end(), regionInfo.getPadsInRowRegion(row), row);
+  }
+  mCharge.resize(nTimeBins * getNumberOfPads());
+}
+
+void DigitCRUBuffer::reset()
+{
+  std::fill(mCharge.begin(), mCharge.end(), 0.f);
+  for(auto &labels : mLabels) {
+    labels.clear();
+  }
+  mFirstTimeBin = 0;
+  mBeginTimeBin = 0;
+  mEndTimeBin = 0;
+}
+
+size_t DigitCRUBuffer::getMemorySize() const
+{
+  size_t memory = sizeof(*this) + mCharge.capacity() * sizeof(float) + mRowOffset.capacity() * sizeof(unsigned int) + mPadRow.capacity();
+  for(const auto &labels : mLabels) {
+    memory += sizeof(labels) + labels.capacity() * sizeof(LabelEntry);
+  }
+  return memory;
+}
+
+void DigitCRUBuffer::setDigit(size_t hitID, int timeBin, int row, int pad, float charge)
+{
+  static FairRootManager *mgr = FairRootManager::Instance();
+  setDigit(MCCompLabel(hitID, mgr->GetEntryNr()), timeBin, row, pad, charge);
+}
+
+void DigitCRUBuffer::merge(DigitCRUBuffer &other)
+{
+  for(int timeBin = other.mBeginTimeBin; timeBin < other.mEndTimeBin; ++timeBin) {
+    const size_t otherSlot = timeBin % other.getWindowSize();
+    auto &otherLabels = other.mLabels[otherSlot];
+    if(otherLabels.empty()) continue;
+    if(timeBin < mFirstTimeBin) {
+      LOG(FATAL) << "TPC DigitCRUBuffer buffer misaligned for CRU " << mCRU << " TimeBin " << timeBin << " First TimeBin " << mFirstTimeBin << FairLogger::endl;
+      return;
+    }
+    const size_t slot = getSlot(timeBin);
+    float *charge = &mCharge[slot * getNumberOfPads()];
+    float *otherCharge = &other.mCharge[otherSlot * getNumberOfPads()];
+
+    /// Each pad with charge has at least one entry in the side table, the charge is moved with the first one
+    float movedCharge = 0.f;
+    for(const auto &entry : otherLabels) {
+      charge[entry.pad] += otherCharge[entry.pad];
+      movedCharge += otherCharge[entry.pad];
+      otherCharge[entry.pad] = 0.f;
+    }
+    auto &labels = mLabels[slot];
+    labels.insert(labels.end(), otherLabels.begin(), otherLabels.end());
+    otherLabels.clear();
+    mCommonModeContainer.addDigit(mCRU, timeBin, movedCharge);
+    other.mCommonModeContainer.addDigit(mCRU, timeBin, -movedCharge);
+  }
+  other.mBeginTimeBin = other.mEndTimeBin;
+}
+
+void DigitCRUBuffer::fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                                         std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime, bool isContinuous)
+{
+  /// the time bins between the last event and the timing of this event are uncorrelated and can be written out
+  /// OR the readout is triggered (i.e. not continuous) and we can dump everything in any case
+  const int lastTimeBin = isContinuous ? std::min(eventTime, mEndTimeBin) : mEndTimeBin;
+  for(int timeBin = mBeginTimeBin; timeBin < lastTimeBin; ++timeBin) {
+    flushTimeBin(timeBin, output, mcTruth, debug);
+  }
+  if(!isContinuous) {
+    mFirstTimeBin = 0;
+    mBeginTimeBin = 0;
+    mEndTimeBin = 0;
+    return;
+  }
+  /// nothing before the event time is kept, the window spans the time bins of the remaining digits only
+  mFirstTimeBin = std::max(mFirstTimeBin, eventTime);
+  mBeginTimeBin = std::max(mBeginTimeBin, lastTimeBin);
+}
+
+void DigitCRUBuffer::flushTimeBin(int timeBin, std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                                  std::vector<o2::TPC::DigitMCMetaData> *debug)
+{
+  const size_t slot = timeBin % getWindowSize();
+  auto &labels = mLabels[slot];
+  if(labels.empty()) return;
+  float *charge = &mCharge[slot * getNumberOfPads()];
+
+  /// Sort the side table by pad and label and merge the duplicates
+  std::sort(labels.begin(), labels.end(), [](const LabelEntry &a, const LabelEntry &b) {
+    return (a.pad != b.pad) ? a.pad < b.pad : ULong64_t(a.label) < ULong64_t(b.label);
+  });
+  size_t nLabels = 0;
+  for(const auto &entry : labels) {
+    if(nLabels > 0 && labels[nLabels-1].pad == entry.pad && ULong64_t(labels[nLabels-1].label) == ULong64_t(entry.label)) {
+      labels[nLabels-1].count += entry.count;
+    }
+    else {
+      labels[nLabels++] = entry;
+    }
+  }
+  labels.resize(nLabels);
+
+  const float commonMode = mCommonModeContainer.getCommonMode(mCRU, timeBin);
+  const Sector sector = CRU(mCRU).sector();
+  for(auto first = labels.begin(); first != labels.end();) {
+    const unsigned int padIndex = first->pad;
+    const auto last = std::find_if(first, labels.end(), [padIndex](const LabelEntry &entry) { return entry.pad != padIndex; });
+    const int row = mPadRow[padIndex];
+    const int pad = padIndex - mRowOffset[row];
+
+    /// The charge accumulated on that pad is converted into ADC counts, saturation of the SAMPA is applied and a Digit is created in written out
+    const float totalADC = charge[padIndex] - commonMode; // common mode is subtracted here in order to properly apply noise, pedestals and saturation of the SAMPA
+    float noise = 0.f;
+    float pedestal = 0.f;
+    const float ADC = SAMPAProcessing::makeSignal(totalADC, PadSecPos(sector, PadPos(row, pad)), pedestal, noise);
+    if(ADC > 0) {
+      /// Sort the MC labels according to their occurrence
+      std::stable_sort(first, last, [](const LabelEntry &a, const LabelEntry &b) { return a.count > b.count; });
+
+      const auto digiPos = output->size();
+      output->emplace_back(mCRU, ADC, row, pad, timeBin); /// create Digit and append to container
+      for(auto entry = first; entry != last; ++entry) {
+        mcTruth.addElement(digiPos, entry->label); /// add MCTruth output
+      }
+      if(debug!=nullptr) {
+        debug->emplace_back(charge[padIndex], commonMode, pedestal, noise); /// create DigitMCMetaData
+      }
+    }
+    charge[padIndex] = 0.f;
+    first = last;
+  }
+  labels.clear();
+}
+
+void DigitCRUBuffer::growWindow(int nTimeBins)
+{
+  const int oldWindow = getWindowSize();
+  int newWindow = oldWindow;
+  while(newWindow < nTimeBins) newWindow *= 2;
+
+  std::vector<float> charge(newWindow * getNumberOfPads());
+  std::vector<std::vector<LabelEntry>> labels(newWindow);
+  for(int timeBin = mBeginTimeBin; timeBin < mEndTimeBin; ++timeBin) {
+    const size_t oldSlot = timeBin % oldWindow;
+    const size_t newSlot = timeBin % newWindow;
+    std::copy_n(&mCharge[oldSlot * getNumberOfPads()], getNumberOfPads(), &charge[newSlot * getNumberOfPads()]);
+    labels[newSlot].swap(mLabels[oldSlot]);
+  }
+  mCharge.swap(charge);
+  mLabels.swap(labels);
+}
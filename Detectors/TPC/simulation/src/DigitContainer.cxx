@@ -13,37 +13,61 @@
 /// \author Andi Mathis, TU München, andreas.mathis@ph.tum.de
 
 #include "TPCSimulation/DigitContainer.h"
-#include "TPCBase/Mapper.h"
-#include <iostream>
+
+#include "FairRootManager.h"
 
 using namespace o2::TPC;
 
 void DigitContainer::addDigit(size_t hitID, int cru, int timeBin, int row, int pad, float charge)
+{
+  static FairRootManager *mgr = FairRootManager::Instance();
+  addDigit(MCCompLabel(hitID, mgr->GetEntryNr()), cru, timeBin, row, pad, charge);
+}
+
+void DigitContainer::addDigit(const MCCompLabel &label, int cru, int timeBin, int row, int pad, float charge)
 {
   /// Check whether the container at this spot already contains an entry
-  DigitCRU *result = mCRU[cru].get();
-  if(result != nullptr){
-    mCRU[cru]->setDigit(hitID, timeBin, row, pad, charge);
-  }
-  else{
-    const Mapper& mapper = Mapper::instance();
-    mCRU[cru] = std::make_unique<DigitCRU>(cru, mCommonModeContainer);
-    mCRU[cru]->setDigit(hitID, timeBin, row, pad, charge);
+  if(mCRU[cru] == nullptr) {
+    mCRU[cru] = std::make_unique<DigitCRUBuffer>(cru, mCommonModeContainer);
   }
+  mCRU[cru]->setDigit(label, timeBin, row, pad, charge);
   /// Take care of the common mode
   mCommonModeContainer.addDigit(cru, timeBin, charge);
 }
 
 
+void DigitContainer::merge(DigitContainer &other, const Sector &sector)
+{
+  const int firstCRU = sector.getSector() * CRU::CRUperSector;
+  for(int cru = firstCRU; cru < firstCRU + CRU::CRUperSector; ++cru) {
+    auto &otherCRU = other.mCRU[cru];
+    if(otherCRU == nullptr) continue;
+    if(mCRU[cru] == nullptr) {
+      mCRU[cru] = std::make_unique<DigitCRUBuffer>(cru, mCommonModeContainer);
+    }
+    mCRU[cru]->merge(*otherCRU);
+  }
+}
+
 void DigitContainer::fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
 					 std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime, bool isContinuous)
 {
-  for(auto &aCRU : mCRU) {
+  for(int sector = 0; sector < Sector::MAXSECTOR; ++sector) {
+    fillOutputContainer(output, mcTruth, debug, Sector(sector), eventTime, isContinuous);
+  }
+  cleanUp(eventTime, isContinuous);
+}
+
+void DigitContainer::fillOutputContainer(std::vector<o2::TPC::Digit> *output, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                                         std::vector<o2::TPC::DigitMCMetaData> *debug, const Sector &sector, int eventTime, bool isContinuous)
+{
+  const int firstCRU = sector.getSector() * CRU::CRUperSector;
+  for(int cru = firstCRU; cru < firstCRU + CRU::CRUperSector; ++cru) {
+    auto &aCRU = mCRU[cru];
     if(aCRU == nullptr) continue;
-    aCRU->fillOutputContainer(output, mcTruth, debug, aCRU->getCRUID(), eventTime, isContinuous);
+    aCRU->fillOutputContainer(output, mcTruth, debug, eventTime, isContinuous);
     if(!isContinuous) {
       aCRU->reset();
     }
   }
-  mCommonModeContainer.cleanUp(eventTime, isContinuous);
 }
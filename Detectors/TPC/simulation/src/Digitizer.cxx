@@ -27,14 +27,53 @@ ClassImp(o2::TPC::Digitizer)
 
 using namespace o2::TPC;
 
-bool o2::TPC::Digitizer::mDebugFlagPRF = false;
-bool o2::TPC::Digitizer::mIsContinuous = true;
+namespace {
+/// Stable in-place removal of all entries not flagged in keep
+template <typename T>
+void compact(std::vector<T> &values, const std::vector<char> &keep)
+{
+  size_t nKept = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (keep[i]) {
+      values[nKept++] = values[i];
+    }
+  }
+  values.resize(nKept);
+}
+}
 
 Digitizer::Digitizer()
   : mDigitContainer(nullptr),
-    mDebugTreePRF(nullptr)
+    mGEMAmplification(),
+    mElectronTransport(),
+    mPadResponse(std::make_shared<PadResponse>()),
+    mSignalArray(),
+    mGEMresponse(),
+    mIsBatched(false),
+    mElectronBatch(),
+    mDebugTreePRF(nullptr),
+    mDebugFlagPRF(false),
+    mIsContinuous(true),
+    mHitCounter(0)
 {}
 
+Digitizer::Digitizer(const Digitizer &other, int stream, int nStreams)
+  : mDigitContainer(nullptr),
+    mGEMAmplification(other.mGEMAmplification),
+    mElectronTransport(other.mElectronTransport),
+    mPadResponse(other.mPadResponse),
+    mSignalArray(),
+    mGEMresponse(),
+    mIsBatched(other.mIsBatched),
+    mElectronBatch(),
+    mDebugTreePRF(nullptr),
+    mDebugFlagPRF(other.mDebugFlagPRF),
+    mIsContinuous(other.mIsContinuous),
+    mHitCounter(0)
+{
+  setRandomStream(stream, nStreams);
+}
+
 Digitizer::~Digitizer()
 {
   delete mDigitContainer;
@@ -50,29 +89,31 @@ void Digitizer::init()
 //  mDebugTreePRF->Branch("GEMresponse", &GEMresponse, "CRU:timeBin:row:pad:nElectrons");
 }
 
-DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
+void Digitizer::setRandomStream(int stream, int nStreams)
+{
+  mGEMAmplification.setRandomStream(stream, nStreams);
+  mElectronTransport.setRandomStream(stream, nStreams);
+}
+
+DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits, int eventID, float eventTimeContinuous)
 {
 //  mDigitContainer->reset();
   const static Mapper& mapper = Mapper::instance();
   const static ParameterDetector &detParam = ParameterDetector::defaultInstance();
   const static ParameterElectronics &eleParam = ParameterElectronics::defaultInstance();
-  FairRootManager *mgr = FairRootManager::Instance();
 
-  const float eventTime = ( mIsContinuous) ? mgr->GetEventTime() * 0.001 : 0.f; /// transform in us
-
-  /// \todo static_thread for thread savety?
-  static GEMAmplification gemAmplification;
-  static ElectronTransport electronTransport;
-  static PadResponse padResponse;
+  const float eventTime = ( mIsContinuous) ? eventTimeContinuous : 0.f;
 
   const int nShapedPoints = eleParam.getNShapedPoints();
-  static std::vector<float> signalArray;
-  signalArray.resize(nShapedPoints);
+  mSignalArray.resize(nShapedPoints);
 
-  static size_t hitCounter=0;
   for(auto& inputgroup : hits) {
     //    auto *inputgroup = static_cast<HitGroup*>(pointObject);
-    const int MCTrackID = inputgroup.GetTrackID();
+    if (mIsBatched) {
+      processHitGroupBatched(inputgroup, eventID, eventTime);
+      continue;
+    }
+    const MCCompLabel label(inputgroup.GetTrackID(), eventID);
     for(size_t hitindex = 0; hitindex < inputgroup.getSize(); ++hitindex){
       const auto& eh = inputgroup.getHit(hitindex);
 
@@ -87,14 +128,14 @@ DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
       for(int iEle=0; iEle < nPrimaryElectrons; ++iEle) {
 
         /// Drift and Diffusion
-        const GlobalPosition3D posEleDiff = electronTransport.getElectronDrift(posEle);
+        const GlobalPosition3D posEleDiff = mElectronTransport.getElectronDrift(posEle);
 
         /// \todo Time management in continuous mode (adding the time of the event?)
         const float driftTime = getTime(posEleDiff.Z()) + eh.GetTime() * 0.001; /// in us
         const float absoluteTime = driftTime + eventTime;
 
         /// Attachment
-        if(electronTransport.isElectronAttachment(driftTime)) continue;
+        if(mElectronTransport.isElectronAttachment(driftTime)) continue;
 
         /// Remove electrons that end up outside the active volume
         /// \todo should go to mapper?
@@ -103,7 +144,7 @@ DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
         const DigitPos digiPadPos = mapper.findDigitPosFromGlobalPosition(posEleDiff);
         if(!digiPadPos.isValid()) continue;
 
-        const int nElectronsGEM = gemAmplification.getStackAmplification();
+        const int nElectronsGEM = mGEMAmplification.getStackAmplification();
         if ( nElectronsGEM ==0 ) continue;
 
         /// Loop over all individual pads with signal due to pad response function
@@ -118,7 +159,7 @@ DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
 
         DigitPos digiPos = digiPadPos;
         if (!digiPos.isValid()) continue;
-        // const float normalizedPadResponse = padResponse.getPadResponse(posEleDiff, digiPos);
+        // const float normalizedPadResponse = mPadResponse->getPadResponse(posEleDiff, digiPos);
 
         const float normalizedPadResponse = 1.f;
         if (normalizedPadResponse <= 0) continue;
@@ -127,19 +168,19 @@ DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
 
         if(mDebugFlagPRF) {
           /// \todo Write out the debug output
-          GEMresponse.CRU = digiPos.getCRU().number();
-          GEMresponse.time = absoluteTime;
-          GEMresponse.row = row;
-          GEMresponse.pad = pad;
-          GEMresponse.nElectrons = nElectronsGEM * normalizedPadResponse;
+          mGEMresponse.CRU = digiPos.getCRU().number();
+          mGEMresponse.time = absoluteTime;
+          mGEMresponse.row = row;
+          mGEMresponse.pad = pad;
+          mGEMresponse.nElectrons = nElectronsGEM * normalizedPadResponse;
           //mDebugTreePRF->Fill();
         }
 
         const float ADCsignal = SAMPAProcessing::getADCvalue(nElectronsGEM * normalizedPadResponse);
-        SAMPAProcessing::getShapedSignal(ADCsignal, absoluteTime, signalArray);
+        SAMPAProcessing::getShapedSignal(ADCsignal, absoluteTime, mSignalArray);
         for(float i=0; i<nShapedPoints; ++i) {
           const float time = absoluteTime + i * eleParam.getZBinWidth();
-          mDigitContainer->addDigit(MCTrackID, digiPos.getCRU().number(), getTimeBinFromTime(time), row, pad, signalArray[i]);
+          mDigitContainer->addDigit(label, digiPos.getCRU().number(), getTimeBinFromTime(time), row, pad, mSignalArray[i]);
         }
 
       // }
@@ -147,10 +188,107 @@ DigitContainer* Digitizer::Process(const std::vector<o2::TPC::HitGroup>& hits)
       /// end of loop over prf
       }
     /// end of loop over electrons
-    ++hitCounter;
+    ++mHitCounter;
     }
   }
   /// end of loop over points
 
   return mDigitContainer;
 }
+
+void Digitizer::processHitGroupBatched(const HitGroup &inputgroup, int eventID, float eventTime)
+{
+  const static Mapper& mapper = Mapper::instance();
+  const static ParameterDetector &detParam = ParameterDetector::defaultInstance();
+  const static ParameterElectronics &eleParam = ParameterElectronics::defaultInstance();
+  const MCCompLabel label(inputgroup.GetTrackID(), eventID);
+  ElectronBatch &batch = mElectronBatch;
+
+  /// Expand the hits to the individual primary electrons
+  batch.x.clear();
+  batch.y.clear();
+  batch.z.clear();
+  batch.time.clear();
+  for(size_t hitindex = 0; hitindex < inputgroup.getSize(); ++hitindex) {
+    const auto& eh = inputgroup.getHit(hitindex);
+    // The energy loss stored is really nElectrons
+    const int nPrimaryElectrons = static_cast<int>(eh.GetEnergyLoss());
+    if (nPrimaryElectrons <= 0) continue;
+    batch.x.insert(batch.x.end(), nPrimaryElectrons, eh.GetX());
+    batch.y.insert(batch.y.end(), nPrimaryElectrons, eh.GetY());
+    batch.z.insert(batch.z.end(), nPrimaryElectrons, eh.GetZ());
+    batch.time.insert(batch.time.end(), nPrimaryElectrons, eh.GetTime());
+    ++mHitCounter;
+  }
+  if (batch.z.empty()) return;
+
+  /// Drift and Diffusion
+  mElectronTransport.getElectronDrift(batch.x, batch.y, batch.z);
+
+  /// Drift time and absolute time, in us, computed as in the per-electron processing
+  const size_t nElectrons = batch.z.size();
+  batch.driftTime.resize(nElectrons);
+  for(size_t i = 0; i < nElectrons; ++i) {
+    batch.driftTime[i] = getTime(batch.z[i]) + batch.time[i] * 0.001;
+    batch.time[i] = batch.driftTime[i] + eventTime;
+  }
+
+  /// Attachment, and removal of electrons that end up outside the active volume
+  mElectronTransport.getElectronAttachment(batch.driftTime, batch.selected);
+  const float tpcLength = detParam.getTPClength();
+  for(size_t i = 0; i < nElectrons; ++i) {
+    batch.selected[i] = !batch.selected[i] && std::fabs(batch.z[i]) <= tpcLength;
+  }
+  compact(batch.x, batch.selected);
+  compact(batch.y, batch.selected);
+  compact(batch.z, batch.selected);
+  compact(batch.time, batch.selected);
+
+  /// Pad lookup and amplification, which both do not vectorize and stay per electron
+  const size_t nSurvivors = batch.z.size();
+  batch.cru.resize(nSurvivors);
+  batch.row.resize(nSurvivors);
+  batch.pad.resize(nSurvivors);
+  batch.ADC.resize(nSurvivors);
+  batch.selected.resize(nSurvivors);
+  for(size_t i = 0; i < nSurvivors; ++i) {
+    const DigitPos digiPos = mapper.findDigitPosFromGlobalPosition(GlobalPosition3D(batch.x[i], batch.y[i], batch.z[i]));
+    batch.selected[i] = digiPos.isValid();
+    if (!digiPos.isValid()) continue;
+    batch.cru[i] = digiPos.getCRU().number();
+    batch.row[i] = digiPos.getPadPos().getRow();
+    batch.pad[i] = digiPos.getPadPos().getPad();
+  }
+  for(size_t i = 0; i < nSurvivors; ++i) {
+    if (!batch.selected[i]) continue;
+    const int nElectronsGEM = mGEMAmplification.getStackAmplification();
+    batch.selected[i] = (nElectronsGEM != 0);
+    if (nElectronsGEM == 0) continue;
+    if(mDebugFlagPRF) {
+      /// \todo Write out the debug output
+      mGEMresponse.CRU = batch.cru[i];
+      mGEMresponse.time = batch.time[i];
+      mGEMresponse.row = batch.row[i];
+      mGEMresponse.pad = batch.pad[i];
+      mGEMresponse.nElectrons = nElectronsGEM;
+      //mDebugTreePRF->Fill();
+    }
+    batch.ADC[i] = SAMPAProcessing::getADCvalue(static_cast<float>(nElectronsGEM));
+  }
+  compact(batch.time, batch.selected);
+  compact(batch.cru, batch.selected);
+  compact(batch.row, batch.selected);
+  compact(batch.pad, batch.selected);
+  compact(batch.ADC, batch.selected);
+
+  /// Shaping, vectorized over the electrons
+  SAMPAProcessing::getShapedSignal(batch.ADC, batch.time, batch.signal);
+  const int nShapedPoints = eleParam.getNShapedPoints();
+  const size_t stride = SAMPAProcessing::getShapedSignalStride(batch.ADC.size());
+  for(size_t i = 0; i < batch.ADC.size(); ++i) {
+    for(int bin = 0; bin < nShapedPoints; ++bin) {
+      const float time = batch.time[i] + bin * eleParam.getZBinWidth();
+      mDigitContainer->addDigit(label, batch.cru[i], getTimeBinFromTime(time), batch.row[i], batch.pad[i], batch.signal[bin * stride + i]);
+    }
+  }
+}
@@ -26,6 +26,7 @@
 #include "FairLogger.h"
 #include "FairRootManager.h"
 
+#include <algorithm>
 #include <sstream>
 //#include "valgrind/callgrind.h"
 
@@ -36,24 +37,24 @@ using namespace o2::TPC;
 
 DigitizerTask::DigitizerTask(int sectorid)
   : FairTask("TPCDigitizerTask"),
-    mDigitizer(nullptr),
-    mDigitContainer(nullptr),
+    mDigitizers(),
+    mThreadPool(),
     mDigitsArray(nullptr),
     mMCTruthArray(),
     mDigitsDebugArray(nullptr),
     mTimeBinMax(1000000),
     mIsContinuousReadout(true),
     mDigitDebugOutput(false),
+    mPRFDebugOutput(false),
+    mIsBatchedProcessing(false),
+    mNThreads(1),
     mHitSector(sectorid)
 {
-  /// \todo get rid of new
-  mDigitizer = new Digitizer;
   //CALLGRIND_START_INSTRUMENTATION;
 }
 
 DigitizerTask::~DigitizerTask()
 {
-  delete mDigitizer;
   delete mDigitsArray;
   delete mDigitsDebugArray;
 
@@ -101,8 +102,7 @@ InitStatus DigitizerTask::Init()
     mgr->RegisterAny("TPCDigitMCMetaData", mDigitsDebugArray, kTRUE);
   }
   
-  mDigitizer->init();
-  mDigitContainer = mDigitizer->getDigitContainer();
+  initDigitizers();
   return kSUCCESS;
 }
 
@@ -110,7 +110,9 @@ void DigitizerTask::Exec(Option_t *option)
 {
   FairRootManager *mgr = FairRootManager::Instance();
 
-  const int eventTime = Digitizer::getTimeBinFromTime(mgr->GetEventTime() * 0.001);
+  const float eventTimeContinuous = mgr->GetEventTime() * 0.001; /// transform in us
+  const int eventTime = Digitizer::getTimeBinFromTime(eventTimeContinuous);
+  const int eventID = mgr->GetEntryNr();
 
   LOG(DEBUG) << "Running digitization on new event at time bin " << eventTime << FairLogger::endl;
   mDigitsArray->clear();
@@ -119,18 +121,16 @@ void DigitizerTask::Exec(Option_t *option)
     mDigitsDebugArray->clear();
   }
 
-  if (mHitSector == -1){
-    // treat all sectors
-    for (int s=0; s<Sector::MAXSECTOR; ++s){
-      LOG(DEBUG) << "Processing sector " << s << "\n";
-      mDigitContainer = mDigitizer->Process(*mSectorHitsArray[s]);
-    }
+  if(mIsContinuousReadout) {
+    /// the time bins before this event are complete and written out first, such that the CRU buffers only hold
+    /// the time bins from this event on, whatever the time since the last event
+    fillOutputContainer(mDigitsArray, mMCTruthArray, mDigitsDebugArray, eventTime);
+    digitize(mSectorHitsArray, eventID, eventTimeContinuous);
   }
   else {
-    // treat only chosen sector
-    mDigitContainer = mDigitizer->Process(*mSectorHitsArray[mHitSector]);
+    digitize(mSectorHitsArray, eventID, eventTimeContinuous);
+    fillOutputContainer(mDigitsArray, mMCTruthArray, mDigitsDebugArray, eventTime);
   }
-  mDigitContainer->fillOutputContainer(mDigitsArray, mMCTruthArray, mDigitsDebugArray, eventTime, mIsContinuousReadout);
 }
 
 void DigitizerTask::FinishTask()
@@ -143,5 +143,80 @@ void DigitizerTask::FinishTask()
   if(mDigitDebugOutput) {
     mDigitsDebugArray->clear();
   }
-  mDigitContainer->fillOutputContainer(mDigitsArray, mMCTruthArray, mDigitsDebugArray, mTimeBinMax, mIsContinuousReadout);
+  fillOutputContainer(mDigitsArray, mMCTruthArray, mDigitsDebugArray, mTimeBinMax);
+}
+
+void DigitizerTask::initDigitizers()
+{
+  /// The random number rings are filled once by the first Digitizer and shared by all others,
+  /// each sector reading its own disjoint part of them
+  const int nDigitizers = (mHitSector == -1) ? Sector::MAXSECTOR : 1;
+  mDigitizers.clear();
+  mDigitizers.emplace_back(new Digitizer);
+  for (int s = 1; s < nDigitizers; ++s) {
+    mDigitizers.emplace_back(new Digitizer(*mDigitizers.front(), s, Sector::MAXSECTOR));
+  }
+  mDigitizers.front()->setRandomStream((mHitSector == -1) ? 0 : mHitSector, Sector::MAXSECTOR);
+  for (auto &digitizer : mDigitizers) {
+    digitizer->init();
+    digitizer->setContinuousReadout(mIsContinuousReadout);
+    digitizer->setBatchedProcessing(mIsBatchedProcessing);
+    if (mPRFDebugOutput) {
+      digitizer->setPRFDebug();
+    }
+  }
+
+  mThreadPool.reset();
+  if (nDigitizers > 1 && mNThreads != 1) {
+    mThreadPool = std::make_unique<o2::utils::ThreadPool>(std::min(mNThreads, nDigitizers));
+  }
+  LOG(INFO) << "TPC digitization with " << (mThreadPool ? mThreadPool->getNumberOfWorkers() : 1) << " thread(s)" << FairLogger::endl;
+}
+
+void DigitizerTask::digitize(const std::vector<o2::TPC::HitGroup> *const sectorHits[], int eventID, float eventTime)
+{
+  if (mHitSector != -1) {
+    // treat only chosen sector
+    mDigitizers.front()->Process(*sectorHits[mHitSector], eventID, eventTime);
+    return;
+  }
+  // treat all sectors, each one with its own Digitizer
+  auto digitizeSector = [this, sectorHits, eventID, eventTime](size_t sector, int) {
+    mDigitizers[sector]->Process(*sectorHits[sector], eventID, eventTime);
+  };
+  if (mThreadPool) {
+    mThreadPool->run(Sector::MAXSECTOR, digitizeSector);
+  }
+  else {
+    for (int s = 0; s < Sector::MAXSECTOR; ++s) {
+      digitizeSector(s, 0);
+    }
+  }
+}
+
+void DigitizerTask::fillOutputContainer(std::vector<o2::TPC::Digit> *digits, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &mcTruth,
+                                        std::vector<o2::TPC::DigitMCMetaData> *debug, int eventTime)
+{
+  /// The electrons of a sector may diffuse into the pads of a neighbouring one. The charges of the CRUs of each sector
+  /// are first moved from all Digitizers to the one of the sector, such that the common mode, the noise and the saturation
+  /// are applied once to the full charge of each pad and time bin
+  if (mDigitizers.size() > 1) {
+    for (int s=0; s<Sector::MAXSECTOR; ++s) {
+      DigitContainer *container = mDigitizers[s]->getDigitContainer();
+      for (auto &digitizer : mDigitizers) {
+        if (digitizer != mDigitizers[s]) {
+          container->merge(*digitizer->getDigitContainer(), Sector(s));
+        }
+      }
+    }
+  }
+  /// Writing out sector by sector keeps the digits sorted by CRU, all Digitizers are written out to keep their time bins aligned
+  for (int s=0; s<Sector::MAXSECTOR; ++s) {
+    for (auto &digitizer : mDigitizers) {
+      digitizer->getDigitContainer()->fillOutputContainer(digits, mcTruth, debug, Sector(s), eventTime, mIsContinuousReadout);
+    }
+  }
+  for (auto &digitizer : mDigitizers) {
+    digitizer->getDigitContainer()->cleanUp(eventTime, mIsContinuousReadout);
+  }
 }
@@ -14,13 +14,15 @@
 
 #include "TPCSimulation/ElectronTransport.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace o2::TPC;
 
 ElectronTransport::ElectronTransport()
   : mRandomGaus(),
-    mRandomFlat()
+    mRandomFlat(),
+    mRandomBuffer()
 {
   mRandomGaus.initialize(RandomRing::RandomType::Gaus);
   mRandomFlat.initialize(RandomRing::RandomType::Flat);
@@ -29,6 +31,12 @@ ElectronTransport::ElectronTransport()
 ElectronTransport::~ElectronTransport()
 = default;
 
+void ElectronTransport::setRandomStream(int stream, int nStreams)
+{
+  mRandomGaus.setStream(stream, nStreams);
+  mRandomFlat.setStream(stream, nStreams);
+}
+
 GlobalPosition3D ElectronTransport::getElectronDrift(GlobalPosition3D posEle)
 {
   const static ParameterGas &gasParam = ParameterGas::defaultInstance();
@@ -47,3 +55,40 @@ GlobalPosition3D ElectronTransport::getElectronDrift(GlobalPosition3D posEle)
                                    (mRandomGaus.getNextValue() * sigL) + posEle.Z());
   return posEleDiffusion;
 }
+
+void ElectronTransport::getElectronDrift(std::vector<float> &x, std::vector<float> &y, std::vector<float> &z)
+{
+  const static ParameterGas &gasParam = ParameterGas::defaultInstance();
+  const size_t nElectrons = z.size();
+  mRandomBuffer.resize(3 * nElectrons);
+  mRandomGaus.getNextValues(mRandomBuffer.data(), mRandomBuffer.size());
+  const float *gaus = mRandomBuffer.data();
+  const float diffT = gasParam.getDiffT();
+  const float diffL = gasParam.getDiffL();
+
+  /// Branch-free loop over contiguous arrays, which the compiler can vectorize
+  /// The random numbers are used in the same order and the arithmetic is the same as in the per-electron
+  /// getElectronDrift, such that both give identical results
+  /// For drift lengths shorter than 1 mm, the drift length is set to that value
+  for (size_t i = 0; i < nElectrons; ++i) {
+    const float driftl = std::sqrt(std::max(z[i], 0.01f));
+    const float sigT = driftl * diffT;
+    const float sigL = driftl * diffL;
+    x[i] += gaus[3 * i] * sigT;
+    y[i] += gaus[3 * i + 1] * sigT;
+    z[i] += gaus[3 * i + 2] * sigL;
+  }
+}
+
+void ElectronTransport::getElectronAttachment(const std::vector<float> &driftTime, std::vector<char> &isAttached)
+{
+  const static ParameterGas &gasParam = ParameterGas::defaultInstance();
+  const size_t nElectrons = driftTime.size();
+  mRandomBuffer.resize(nElectrons);
+  mRandomFlat.getNextValues(mRandomBuffer.data(), nElectrons);
+  isAttached.resize(nElectrons);
+  const float attachment = gasParam.getAttachmentCoefficient() * gasParam.getOxygenContent();
+  for (size_t i = 0; i < nElectrons; ++i) {
+    isAttached[i] = mRandomBuffer[i] < attachment * driftTime[i];
+  }
+}
@@ -78,6 +78,15 @@ GEMAmplification::GEMAmplification()
 GEMAmplification::~GEMAmplification()
 = default;
 
+void GEMAmplification::setRandomStream(int stream, int nStreams)
+{
+  mRandomGaus.setStream(stream, nStreams);
+  mRandomFlat.setStream(stream, nStreams);
+  for (auto &gain : mGain) {
+    gain.setStream(stream, nStreams);
+  }
+}
+
 int GEMAmplification::getStackAmplification(int nElectrons)
 {
   /// We start with an arbitrary number of electrons given to the first amplification stage
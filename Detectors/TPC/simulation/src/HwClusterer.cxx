@@ -23,6 +23,8 @@
 
 #include "FairLogger.h"
 #include "TMath.h"
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <thread>
 #include <mutex>
@@ -32,12 +34,19 @@ std::mutex g_display_mutex;
 
 using namespace o2::TPC;
 
+constexpr int HwClusterer::PeakFinderHistory;
+
 //________________________________________________________________________
 HwClusterer::HwClusterer(std::vector<o2::TPC::HwCluster> *output, Processing processingType, int globalTime, int cruMin, int cruMax, float minQDiff,
     bool assignChargeUnique, bool enableNoiseSim, bool enablePedestalSubtraction, int padsPerCF, int timebinsPerCF, int cfPerRow)
   : Clusterer()
   , mClusterArray(output)
   , mProcessingType(processingType)
+  , mNThreads(0)
+  , mThreadPool()
+  , mPeakFinder()
+  , mTimebinHistory()
+  , mPeakFinderBuffers()
   , mGlobalTime(globalTime)
   , mCRUMin(cruMin)
   , mCRUMax(cruMax)
@@ -119,6 +128,31 @@ void HwClusterer::Init()
   for (int iCRU = mCRUMin; iCRU < mCRUMax; iCRU++)
     mDigitContainer[iCRU].resize(mapper.getNumberOfRowsPartition(iCRU));
 
+  /*
+   * the PeakFinder replaces the cluster finders, it keeps the last time bins
+   * of each row between the calls
+   */
+  if (mUsePeakFinder) {
+    if (mAssignChargeUnique) {
+      LOG(WARNING) << "The PeakFinder does not support the unique assignment of charges, the cluster finders are used" << FairLogger::endl;
+    } else {
+      mPeakFinder = std::make_unique<PeakFinder>(mMinQMax, mMinQDiff, mRequirePositiveCharge, true, false, mPeakFinderKernel);
+      mTimebinHistory.resize(mCRUMax);
+      for (int iCRU = mCRUMin; iCRU < mCRUMax; iCRU++)
+        mTimebinHistory[iCRU].resize(mapper.getNumberOfRowsPartition(iCRU)*PeakFinderHistory*(mPadsMax+2+2), 0.f);
+    }
+  }
+
+  /*
+   * the worker threads are started once and reused for every call
+   */
+  if (mProcessingType == Processing::Parallel) {
+    mThreadPool = std::make_unique<o2::utils::ThreadPool>(mNThreads);
+    LOG(DEBUG) << "HwClusterer uses " << mThreadPool->getNumberOfWorkers() << " threads" << FairLogger::endl;
+  }
+  if (mPeakFinder) {
+    mPeakFinderBuffers.resize(mThreadPool ? mThreadPool->getNumberOfWorkers() : 1);
+  }
 }
 
 //________________________________________________________________________
@@ -152,36 +186,9 @@ void HwClusterer::processDigits(
   for (int iRow = 0; iRow < config.iMaxRows; iRow++){
 
     /*
-     * prepare local storage
-     */
-    short t,p;
-    float noise;
-    if (config.iEnableNoiseSim && config.iNoiseObject != nullptr) {
-      for (t=timeDiff; t--;) {
-        for (p=config.iMaxPads; p--;) {
-          iAllBins[t][p] = config.iNoiseObject->getValue(CRU(config.iCRU),iRow,p);
-        }
-      }
-    } else {
-      std::fill(&iAllBins[0][0], &iAllBins[0][0]+timeDiff*config.iMaxPads, 0.f);
-    }
-
-    /*
-     * fill in digits
+     * prepare local storage and fill in digits
      */
-    for (auto& digit : digits[iRow]){
-      const Int_t iTime         = digit->getTimeStamp();
-      const Int_t iPad          = digit->getPad() + 2;  // offset to have 2 empty pads on the "left side"
-      const Float_t charge      = digit->getChargeFloat();
-  
-//      std::cout << iCRU << " " << iRow << " " << iPad << " " << iTime << " (" << iTime-minTime << "," << timeDiff << ") " << charge << std::endl;
-      iAllBins[iTime-config.iMinTimeBin][iPad] += charge;
-      if (config.iEnablePedestalSubtraction && config.iPedestalObject != nullptr) {
-        const float pedestal = config.iPedestalObject->getValue(CRU(config.iCRU),iRow,iPad-2);
-        //printf("digit: %.2f, pedestal: %.2f\n", iAllBins[iTime-config.iMinTimeBin][iPad], pedestal);
-        iAllBins[iTime-config.iMinTimeBin][iPad] -= pedestal;
-      }
-    }
+    fillTimebins(&iAllBins[0][0], digits[iRow], iRow, timeDiff, config);
   
     /*
      * copy data to cluster finders
@@ -246,7 +253,8 @@ void HwClusterer::processDigits(
     for (std::vector<HwClusterFinder*>::const_reverse_iterator &cf_it : cfWithCluster) {
       std::vector<HwCluster>* cc = (*cf_it)->getClusterContainer();
       for (HwCluster& c : *cc){
-        cluster.push_back(c);
+        ClusterContainer::AddCluster<HwCluster>(&cluster, c.getCRU(),c.getRow(),c.getQ(),c.getQmax(),
+            c.getPadMean(),c.getTimeMean(),c.getPadSigma(),c.getTimeSigma());
       }
       (*cf_it)->clearClusterContainer();
     }
@@ -267,6 +275,97 @@ void HwClusterer::processDigits(
 //  g_display_mutex.unlock();
 }
 
+//________________________________________________________________________
+void HwClusterer::processDigitsPeakFinder(
+    const std::vector<std::vector<Digit const*>>& digits,
+          std::vector<float>& history,
+          std::vector<HwCluster>& cluster,
+    const PeakFinder& peakFinder,
+          PeakFinderBuffers& buffers,
+    const CfConfig config)
+{
+  int timeDiff = (config.iMaxTimeBin+1) - config.iMinTimeBin;
+  if (timeDiff < 0) return;
+
+  /*
+   * The time bins of a row are stored in one contiguous matrix. They are
+   * preceded by the last time bins of the previous call, which are needed as
+   * neighbours or were not yet checked, and for triggered readout followed by
+   * empty time bins to find the last clusters.
+   */
+  const int nPads = config.iMaxPads;
+  const int nHistory = PeakFinderHistory;
+  const int nEmpty = config.iIsContinuousReadout ? 0 : 2;
+  const int nTimebins = nHistory + timeDiff + nEmpty;
+  std::vector<float>& allBins = buffers.allBins;
+  std::vector<int>& peaks = buffers.peaks;
+  std::vector<PeakFinder::Moments>& moments = buffers.moments;
+  allBins.resize(nTimebins*nPads);
+
+  for (int iRow = 0; iRow < config.iMaxRows; iRow++){
+    float* rowHistory = &history[iRow*nHistory*nPads];
+    std::copy_n(rowHistory, nHistory*nPads, allBins.begin());
+    fillTimebins(allBins.data()+nHistory*nPads, digits[iRow], iRow, timeDiff, config);
+    std::fill(allBins.end()-nEmpty*nPads, allBins.end(), 0.f);
+
+    /*
+     * every time bin with 2 time bins on both sides is checked, the real pads
+     * of the row have 2 empty pads on both sides
+     */
+    peaks.clear();
+    for (int t = 2; t < nTimebins-2; ++t) {
+      peakFinder.findPeaks(allBins.data(), t*nPads+2, (t+1)*nPads-2, nPads, 1, peaks);
+    }
+    peakFinder.computeMoments(allBins.data(), peaks, nPads, 1, moments);
+
+    for (size_t i = 0; i < peaks.size(); ++i) {
+      const PeakFinder::Moments& m = moments[i];
+      const int time = peaks[i] / nPads - nHistory + config.iMinTimeBin;
+      const int pad = peaks[i] % nPads - 2;
+      ClusterContainer::AddCluster<HwCluster>(&cluster, config.iCRU, iRow, m.qTot, m.qMax,
+          m.padMean+pad, m.timeMean+time, m.padSigma, m.timeSigma);
+    }
+
+    /*
+     * keep the last time bins for the next call, for triggered readout
+     * everything was processed
+     */
+    if (config.iIsContinuousReadout) {
+      std::copy_n(allBins.end()-nHistory*nPads, nHistory*nPads, rowHistory);
+    } else {
+      std::fill(rowHistory, rowHistory+nHistory*nPads, 0.f);
+    }
+  }
+}
+
+//________________________________________________________________________
+void HwClusterer::fillTimebins(float* timebins, const std::vector<Digit const*>& digits, int iRow, int timeDiff, const CfConfig& config)
+{
+  short t,p;
+  if (config.iEnableNoiseSim && config.iNoiseObject != nullptr) {
+    for (t=timeDiff; t--;) {
+      for (p=config.iMaxPads; p--;) {
+        timebins[t*config.iMaxPads+p] = config.iNoiseObject->getValue(CRU(config.iCRU),iRow,p);
+      }
+    }
+  } else {
+    std::fill(timebins, timebins+timeDiff*config.iMaxPads, 0.f);
+  }
+
+  for (auto& digit : digits){
+    const Int_t iTime         = digit->getTimeStamp();
+    const Int_t iPad          = digit->getPad() + 2;  // offset to have 2 empty pads on the "left side"
+    const Float_t charge      = digit->getChargeFloat();
+
+    float& bin = timebins[(iTime-config.iMinTimeBin)*config.iMaxPads+iPad];
+    bin += charge;
+    if (config.iEnablePedestalSubtraction && config.iPedestalObject != nullptr) {
+      const float pedestal = config.iPedestalObject->getValue(CRU(config.iCRU),iRow,iPad-2);
+      bin -= pedestal;
+    }
+  }
+}
+
 //________________________________________________________________________
 void HwClusterer::Process(std::vector<o2::TPC::Digit> const &digits)
 {
@@ -349,23 +448,8 @@ void HwClusterer::Process(std::vector<std::unique_ptr<Digit>>& digits)
 
 void HwClusterer::ProcessTimeBins(int iTimeBinMin, int iTimeBinMax)
 {
-
-   /*
-   * vector to store all threads for parallel processing
-   * one thread per CRU (360 in total)
-   */
-  std::vector<std::thread> thread_vector;
-  if (mProcessingType == Processing::Parallel)
-    LOG(DEBUG) << std::thread::hardware_concurrency() << " concurrent threads are supported." << FairLogger::endl;
-
-  /*
-   * if CRU number of current digit changes, start processing (either
-   * sequential or parallel) of all CRUs in between the last processed
-   * one and the current one.
-   */
-
   const Mapper& mapper = Mapper::instance();
-  for (int iCRU = mCRUMin; iCRU < mCRUMax; ++iCRU) {
+  auto processCRU = [this, &mapper, iTimeBinMin, iTimeBinMax](int iCRU, int worker) {
     struct CfConfig cfConfig = {
       iCRU,
       mapper.getNumberOfRowsPartition(iCRU),
@@ -378,64 +462,43 @@ void HwClusterer::ProcessTimeBins(int iTimeBinMin, int iTimeBinMax)
       mNoiseObject,
       mPedestalObject
     };
-//        std::cout << "starting CRU " << iCRU << std::endl;
-    if (mProcessingType == Processing::Parallel)
-      thread_vector.emplace_back(
-            processDigits,                      // function name
-            std::ref(mDigitContainer[iCRU]),    // digit container for individual CRUs
-            std::ref(mClusterFinder[iCRU]),     // cluster finder for individual CRUs
-            std::ref(mClusterStorage[iCRU]),    // container to store found clusters
-            cfConfig
-//            iCRU,                               // current CRU for deb. purposes
-//            mRowsMax,                           // max. numbers of rows per CRU
-//            mPadsMax+2+2,                       // max. numbers of pads in each row (+2 empty ones on each side)
-//            iTimeBinMin,                        // Min timebin of digit
-//            iTimeBinMax                         // Max timebin of digits
-          
-        );
-    else {
-      processDigits(
-          std::ref(mDigitContainer[iCRU]),
-          std::ref(mClusterFinder[iCRU]),
-          std::ref(mClusterStorage[iCRU]),
-          cfConfig);
-//          iCRU,
-//          mRowsMax,
-//          mPadsMax+2+2,
-//          iTimeBinMin,
-//          iTimeBinMax);
+    if (mPeakFinder) {
+      processDigitsPeakFinder(mDigitContainer[iCRU], mTimebinHistory[iCRU], mClusterStorage[iCRU], *mPeakFinder,
+                              mPeakFinderBuffers[worker], cfConfig);
+    } else {
+      processDigits(mDigitContainer[iCRU], mClusterFinder[iCRU], mClusterStorage[iCRU], cfConfig);
     }
-  }
-
+  };
 
-  /*
-   * wait for threads to join
-   */
-  for (std::thread& t: thread_vector) {
-    t.join();
+  if (mProcessingType == Processing::Parallel && mThreadPool) {
+    /*
+     * schedule the CRUs with the most digits first, the work stealing of the
+     * pool then balances the remaining small ones
+     */
+    std::vector<size_t> nDigits(mCRUMax, 0);
+    mCRUOrder.clear();
+    for (int iCRU = mCRUMin; iCRU < mCRUMax; ++iCRU) {
+      for (const auto& row : mDigitContainer[iCRU]) nDigits[iCRU] += row.size();
+      mCRUOrder.push_back(iCRU);
+    }
+    std::stable_sort(mCRUOrder.begin(), mCRUOrder.end(), [&nDigits](int a, int b) { return nDigits[a] > nDigits[b]; });
+    mThreadPool->run(mCRUOrder.size(), [this, &processCRU](size_t task, int worker) { processCRU(mCRUOrder[task], worker); });
+  }
+  else {
+    for (int iCRU = mCRUMin; iCRU < mCRUMax; ++iCRU) {
+      processCRU(iCRU, 0);
+    }
   }
 
   /*
-   * collect clusters from individual cluster finder
+   * collect clusters from the per CRU buffers, in CRU order
    */
+  size_t nClusters = mClusterArray->size();
+  for (const auto& cc : mClusterStorage) nClusters += cc.size();
+  mClusterArray->reserve(nClusters);
   for (auto& cc : mClusterStorage) {
-    if (cc.size() != 0) {  
-      for (auto& c : cc){
-	ClusterContainer::AddCluster<HwCluster>(mClusterArray, c.getCRU(),c.getRow(),c.getQ(),c.getQmax(),
-            c.getPadMean(),c.getTimeMean(),c.getPadSigma(),c.getTimeSigma());
-////          if (c.getPadSigma() > 0.45 && c.getPadSigma() < 0.5) {
-//          if ((c.getCRU() == 179)){// && c.getRow() == 5)){// && (int)c.getPadMean() == 103 && (int)c.getTimeMean() == 170) || 
-////              (iCRU == 256 && iRow == 10 && (int)c.getPadMean() == 27 && (int)c.getTimeMean() == 181) ) { 
-//           std::cout << "HwCluster - ";
-////           c.Print(std::cout);
-//           c.PrintDetails(std::cout);
-//           std::cout << std::endl;
-//          }
-//          c.Print();
-      }
-    }
+    mClusterArray->insert(mClusterArray->end(), std::make_move_iterator(cc.begin()), std::make_move_iterator(cc.end()));
   }
 
   mLastTimebin = iTimeBinMax;
 }
-      
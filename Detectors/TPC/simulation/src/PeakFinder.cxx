@@ -0,0 +1,204 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PeakFinder.cxx
+/// \brief Implementation of the vectorised peak finding and cluster moment kernel
+
+#include "TPCSimulation/PeakFinder.h"
+
+#include <Vc/Vc>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace o2::TPC;
+
+namespace {
+  /// Normalise the accumulated moments of a cluster
+  void normaliseMoments(PeakFinder::Moments &moments)
+  {
+    if (moments.qTot > 0) {
+      moments.padMean  /= moments.qTot;
+      moments.timeMean /= moments.qTot;
+      moments.padSigma  = std::sqrt(moments.padSigma / moments.qTot - moments.padMean * moments.padMean);
+      moments.timeSigma = std::sqrt(moments.timeSigma / moments.qTot - moments.timeMean * moments.timeMean);
+    }
+    else {
+      moments.padMean = moments.timeMean = moments.padSigma = moments.timeSigma = 0;
+    }
+  }
+}
+
+PeakFinder::PeakFinder(float chargeThreshold, float outerThreshold, bool requirePositiveCharge,
+                       bool requireNeighbouringTimeBin, bool requireNeighbouringPad, Kernel kernel)
+  : mChargeThreshold(chargeThreshold),
+    mOuterThreshold(outerThreshold),
+    mRequirePositiveCharge(requirePositiveCharge),
+    mRequireNeighbouringTimeBin(requireNeighbouringTimeBin),
+    mRequireNeighbouringPad(requireNeighbouringPad),
+    mKernel(kernel)
+{
+}
+
+PeakFinder::Kernel PeakFinder::getDefaultKernel()
+{
+  return (Vc::float_v::Size > 1) ? Kernel::Vectorised : Kernel::Scalar;
+}
+
+void PeakFinder::findPeaks(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const
+{
+  if (mKernel == Kernel::Vectorised) {
+    findPeaksVectorised(data, begin, end, timeStride, padStride, peaks);
+  }
+  else {
+    findPeaksScalar(data, begin, end, timeStride, padStride, peaks);
+  }
+}
+
+void PeakFinder::computeMoments(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                                std::vector<Moments> &moments) const
+{
+  moments.resize(peaks.size());
+  if (mKernel == Kernel::Vectorised) {
+    computeMomentsVectorised(data, peaks, timeStride, padStride, moments);
+  }
+  else {
+    computeMomentsScalar(data, peaks, timeStride, padStride, moments);
+  }
+}
+
+void PeakFinder::findPeaksScalar(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const
+{
+  for (int i = begin; i < end; ++i) {
+    if (isPeak(data + i, timeStride, padStride)) peaks.push_back(i);
+  }
+}
+
+void PeakFinder::findPeaksVectorised(const float *data, int begin, int end, int timeStride, int padStride, std::vector<int> &peaks) const
+{
+  const Vc::float_v threshold(mChargeThreshold);
+  const Vc::float_v zero(Vc::Zero);
+
+  int i = begin;
+  for (; i + static_cast<int>(Vc::float_v::Size) <= end; i += Vc::float_v::Size) {
+    const float *q = data + i;
+    const Vc::float_v qMax(q, Vc::Unaligned);
+    auto peak = qMax >= threshold;
+    /// most of the cells are empty, such that the remaining checks are mostly skipped
+    if (Vc::none_of(peak)) continue;
+
+    if (mRequireNeighbouringTimeBin) {
+      peak &= (Vc::float_v(q - timeStride, Vc::Unaligned) + Vc::float_v(q + timeStride, Vc::Unaligned)) > zero;
+    }
+    if (mRequireNeighbouringPad) {
+      peak &= (Vc::float_v(q - padStride, Vc::Unaligned) + Vc::float_v(q + padStride, Vc::Unaligned)) > zero;
+    }
+    peak &= Vc::float_v(q - timeStride - padStride, Vc::Unaligned) <  qMax;
+    peak &= Vc::float_v(q - timeStride,             Vc::Unaligned) <  qMax;
+    peak &= Vc::float_v(q - timeStride + padStride, Vc::Unaligned) <  qMax;
+    peak &= Vc::float_v(q - padStride,              Vc::Unaligned) <  qMax;
+    peak &= Vc::float_v(q + padStride,              Vc::Unaligned) <= qMax;
+    peak &= Vc::float_v(q + timeStride - padStride, Vc::Unaligned) <= qMax;
+    peak &= Vc::float_v(q + timeStride,             Vc::Unaligned) <= qMax;
+    peak &= Vc::float_v(q + timeStride + padStride, Vc::Unaligned) <= qMax;
+    if (Vc::none_of(peak)) continue;
+
+    for (size_t lane = 0; lane < Vc::float_v::Size; ++lane) {
+      if (peak[lane]) peaks.push_back(i + static_cast<int>(lane));
+    }
+  }
+  findPeaksScalar(data, i, end, timeStride, padStride, peaks);
+}
+
+void PeakFinder::computeMomentsScalar(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                                      std::vector<Moments> &moments) const
+{
+  for (size_t iPeak = 0; iPeak < peaks.size(); ++iPeak) {
+    const float *q = data + peaks[iPeak];
+    Moments &m = moments[iPeak];
+    m = Moments{0, q[0], 0, 0, 0, 0, 0, 0, 0, 0};
+    for (short deltaTime = -2; deltaTime <= 2; ++deltaTime) {
+      for (short deltaPad = -2; deltaPad <= 2; ++deltaPad) {
+        const double charge = getClusterCharge(q, deltaTime, deltaPad, timeStride, padStride);
+        m.qTot      += charge;
+        m.padMean   += charge * deltaPad;
+        m.timeMean  += charge * deltaTime;
+        m.padSigma  += charge * deltaPad * deltaPad;
+        m.timeSigma += charge * deltaTime * deltaTime;
+        if (charge > 0) {
+          m.padMin = std::min(m.padMin, deltaPad);   m.padMax = std::max(m.padMax, deltaPad);
+          m.timeMin = std::min(m.timeMin, deltaTime); m.timeMax = std::max(m.timeMax, deltaTime);
+        }
+      }
+    }
+    normaliseMoments(m);
+  }
+}
+
+void PeakFinder::computeMomentsVectorised(const float *data, const std::vector<int> &peaks, int timeStride, int padStride,
+                                          std::vector<Moments> &moments) const
+{
+  const Vc::double_v zero(Vc::Zero);
+  const Vc::double_v outerThreshold(mOuterThreshold);
+
+  /// Vc::double_v::Size clusters are processed at once, the lanes beyond the last peak repeat it
+  for (size_t first = 0; first < peaks.size(); first += Vc::double_v::Size) {
+    const size_t nLanes = std::min(peaks.size() - first, static_cast<size_t>(Vc::double_v::Size));
+    const float *q[Vc::double_v::Size];
+    for (size_t lane = 0; lane < Vc::double_v::Size; ++lane) {
+      q[lane] = data + peaks[first + std::min(lane, nLanes - 1)];
+    }
+
+    Vc::double_v qTot(Vc::Zero), padMean(Vc::Zero), timeMean(Vc::Zero), padSigma(Vc::Zero), timeSigma(Vc::Zero);
+    Vc::double_v padMin(Vc::Zero), padMax(Vc::Zero), timeMin(Vc::Zero), timeMax(Vc::Zero);
+    for (int deltaTime = -2; deltaTime <= 2; ++deltaTime) {
+      for (int deltaPad = -2; deltaPad <= 2; ++deltaPad) {
+        const int offset = deltaTime * timeStride + deltaPad * padStride;
+        Vc::double_v charge;
+        for (size_t lane = 0; lane < Vc::double_v::Size; ++lane) {
+          charge[lane] = q[lane][offset];
+        }
+        if (deltaTime != 0 || deltaPad != 0) {
+          if (mRequirePositiveCharge) {
+            charge = Vc::iif(charge > zero, charge, zero);
+          }
+          if (deltaTime == 2 || deltaTime == -2 || deltaPad == 2 || deltaPad == -2) {
+            const int innerOffset = (deltaTime / 2 + deltaTime % 2) * timeStride + (deltaPad / 2 + deltaPad % 2) * padStride;
+            Vc::double_v inner;
+            for (size_t lane = 0; lane < Vc::double_v::Size; ++lane) {
+              inner[lane] = q[lane][innerOffset];
+            }
+            charge = Vc::iif(inner > outerThreshold, charge, zero);
+          }
+        }
+        const Vc::double_v dPad(deltaPad);
+        const Vc::double_v dTime(deltaTime);
+        qTot      += charge;
+        padMean   += charge * dPad;
+        timeMean  += charge * dTime;
+        padSigma  += charge * dPad * dPad;
+        timeSigma += charge * dTime * dTime;
+        const auto hasCharge = charge > zero;
+        padMin  = Vc::iif(hasCharge, Vc::min(padMin, dPad), padMin);
+        padMax  = Vc::iif(hasCharge, Vc::max(padMax, dPad), padMax);
+        timeMin = Vc::iif(hasCharge, Vc::min(timeMin, dTime), timeMin);
+        timeMax = Vc::iif(hasCharge, Vc::max(timeMax, dTime), timeMax);
+      }
+    }
+
+    for (size_t lane = 0; lane < nLanes; ++lane) {
+      Moments &m = moments[first + lane];
+      m = Moments{qTot[lane], q[lane][0], padMean[lane], padSigma[lane], timeMean[lane], timeSigma[lane],
+                  static_cast<short>(padMin[lane]), static_cast<short>(padMax[lane]),
+                  static_cast<short>(timeMin[lane]), static_cast<short>(timeMax[lane])};
+      normaliseMoments(m);
+    }
+  }
+}
@@ -82,3 +82,30 @@ void SAMPAProcessing::getShapedSignal(float ADCsignal, float driftTime, std::vec
     }
   }
 }
+
+void SAMPAProcessing::getShapedSignal(const std::vector<float> &ADCsignal, const std::vector<float> &driftTime, std::vector<float> &signalArray)
+{
+  const static ParameterElectronics &eleParam = ParameterElectronics::defaultInstance();
+  const int nShapedPoints = eleParam.getNShapedPoints();
+  const float binWidth = eleParam.getZBinWidth();
+  const size_t nSignals = ADCsignal.size();
+  const size_t stride = getShapedSignalStride(nSignals);
+  signalArray.resize(nShapedPoints * stride);
+
+  for (size_t iSignal = 0; iSignal < nSignals; iSignal += Vc::float_v::Size) {
+    /// Padding lanes carry a zero signal
+    /// The start of the time bins is computed as in the single signal getShapedSignal, such that both
+    /// give identical results
+    Vc::float_v ADC(Vc::Zero), startTime(Vc::Zero), timeBinTime(Vc::Zero);
+    for (size_t i = 0; i < Vc::float_v::Size && iSignal + i < nSignals; ++i) {
+      const float signalTimeBinTime = Digitizer::getTimeBinTime(driftTime[iSignal + i]);
+      ADC[i] = ADCsignal[iSignal + i];
+      timeBinTime[i] = signalTimeBinTime;
+      startTime[i] = signalTimeBinTime + (driftTime[iSignal + i] - signalTimeBinTime);
+    }
+    for (int bin = 0; bin < nShapedPoints; ++bin) {
+      const Vc::float_v signal = getGamma4(timeBinTime + float(bin) * binWidth, startTime, ADC);
+      signal.store(&signalArray[bin * stride + iSignal], Vc::Unaligned);
+    }
+  }
+}
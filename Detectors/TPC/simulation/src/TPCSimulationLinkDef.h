@@ -26,12 +26,9 @@
 #pragma link C++ class o2::TPC::Detector+;
 #pragma link C++ class o2::TPC::DigitMCMetaData+;
 #pragma link C++ class o2::TPC::DigitContainer+;
-#pragma link C++ class o2::TPC::DigitCRU+;
+#pragma link C++ class o2::TPC::DigitCRUBuffer+;
 #pragma link C++ class o2::TPC::Digitizer+;
 #pragma link C++ class o2::TPC::DigitizerTask+;
-#pragma link C++ class o2::TPC::DigitPad+;
-#pragma link C++ class o2::TPC::DigitRow+;
-#pragma link C++ class o2::TPC::DigitTime+;
 #pragma link C++ class o2::TPC::ElectronTransport+;
 #pragma link C++ class o2::TPC::GEMAmplification+;
 #pragma link C++ class o2::TPC::HwCluster+;
@@ -0,0 +1,123 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ClustererTestUtils.h
+/// \brief Digit generation and clusterer runs shared by the tests and benchmarks of the TPC clusterers
+
+#ifndef ALICEO2_TPC_CLUSTERERTESTUTILS_H_
+#define ALICEO2_TPC_CLUSTERERTESTUTILS_H_
+
+#include "TPCSimulation/BoxClusterer.h"
+#include "TPCSimulation/HwClusterer.h"
+#include "TPCSimulation/PeakFinder.h"
+#include "TPCBase/Digit.h"
+#include "TPCBase/Mapper.h"
+
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+namespace test {
+
+  /// Create digits of nClusters 3x3 charge blobs, randomly distributed over all CRUs
+  /// \param nClusters Number of charge blobs
+  /// \param nTimeBins Number of time bins the blobs are distributed over
+  /// \param seed Seed of the random number generator
+  /// \param maxPad Largest pad of the centre of a blob
+  /// \param merge If true, the charges of overlapping blobs are summed up to one digit per pad and time bin,
+  ///              and the digits are sorted by CRU, otherwise each blob gives its own 9 digits
+  inline std::vector<Digit> createDigits(int nClusters, int nTimeBins, unsigned int seed, int maxPad, bool merge)
+  {
+    const Mapper& mapper = Mapper::instance();
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> cruDist(0, CRU::MaxCRU - 1);
+    std::uniform_int_distribution<int> timeDist(1, nTimeBins - 2);
+    std::uniform_int_distribution<int> padDist(1, maxPad);
+    std::uniform_real_distribution<float> chargeDist(20.f, 200.f);
+    std::vector<Digit> digits;
+    std::map<std::tuple<int, int, int, int>, float> charges;
+    for (int i = 0; i < nClusters; ++i) {
+      const int cru = cruDist(generator);
+      std::uniform_int_distribution<int> rowDist(0, mapper.getNumberOfRowsPartition(cru) - 1);
+      const int row = rowDist(generator);
+      const int time = timeDist(generator);
+      const int pad = padDist(generator);
+      const float charge = chargeDist(generator);
+      for (int t = -1; t <= 1; ++t) {
+        for (int p = -1; p <= 1; ++p) {
+          const float padCharge = charge / (1 + 2 * std::abs(t) + 2 * std::abs(p));
+          if (merge) {
+            charges[std::make_tuple(cru, row, pad + p, time + t)] += padCharge;
+          }
+          else {
+            digits.emplace_back(cru, padCharge, row, pad + p, time + t);
+          }
+        }
+      }
+    }
+    for (const auto& charge : charges) {
+      digits.emplace_back(std::get<0>(charge.first), charge.second, std::get<1>(charge.first), std::get<2>(charge.first), std::get<3>(charge.first));
+    }
+    return digits;
+  }
+
+  /// Run a new BoxClusterer on the digits
+  /// \param digits Digits to be clustered
+  /// \param usePeakFinder Switch for the PeakFinder instead of the cell by cell search
+  /// \param kernel Implementation of the PeakFinder kernel
+  /// \param time Processing time in ms
+  /// \return Found clusters
+  inline std::vector<BoxCluster> runBoxClusterer(const std::vector<Digit>& digits, bool usePeakFinder, PeakFinder::Kernel kernel,
+                                                 double& time)
+  {
+    std::vector<BoxCluster> clusters;
+    BoxClusterer clusterer(&clusters);
+    clusterer.setUsePeakFinder(usePeakFinder, kernel);
+    clusterer.Init();
+    const auto start = std::chrono::high_resolution_clock::now();
+    clusterer.Process(digits);
+    const auto end = std::chrono::high_resolution_clock::now();
+    time = std::chrono::duration<double, std::milli>(end - start).count();
+    return clusters;
+  }
+
+  /// Run a new HwClusterer on the digits
+  /// \param digits Digits to be clustered
+  /// \param processing Sequential or parallel processing
+  /// \param nThreads Number of threads of the parallel processing
+  /// \param usePeakFinder Switch for the PeakFinder instead of the cluster finders
+  /// \param kernel Implementation of the PeakFinder kernel
+  /// \param time Processing time in ms
+  /// \return Found clusters
+  inline std::vector<HwCluster> runHwClusterer(const std::vector<Digit>& digits, HwClusterer::Processing processing, int nThreads,
+                                               bool usePeakFinder, PeakFinder::Kernel kernel, double& time)
+  {
+    std::vector<HwCluster> clusters;
+    HwClusterer clusterer(&clusters, processing);
+    clusterer.setNumberOfThreads(nThreads);
+    clusterer.setContinuousReadout(false);
+    clusterer.setUsePeakFinder(usePeakFinder, kernel);
+    clusterer.Init();
+    const auto start = std::chrono::high_resolution_clock::now();
+    clusterer.Process(digits);
+    const auto end = std::chrono::high_resolution_clock::now();
+    time = std::chrono::duration<double, std::milli>(end - start).count();
+    return clusters;
+  }
+}
+}
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkTPCDigitContainer.cxx
+/// \brief Benchmark of the flat DigitCRUBuffer
+/// Shaped electron signals are filled into one CRU, and the time to fill and write out the digits, as well as the memory, are measured
+
+#include "TPCSimulation/DigitCRUBuffer.h"
+#include "TPCSimulation/CommonModeContainer.h"
+#include "TPCBase/Digit.h"
+#include "TPCBase/Mapper.h"
+#include "FairRootManager.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace o2::TPC;
+
+int main()
+{
+  const Mapper& mapper = Mapper::instance();
+  static FairRootManager *mgr = FairRootManager::Instance();
+  mgr->SetEntryNr(1);
+  const int cruID = 0;
+  const PadRegionInfo& regionInfo = mapper.getPadRegionInfo(CRU(cruID).region());
+
+  /// electrons, each of them shaped into 8 consecutive time bins
+  const int nElectrons = 200000;
+  const int nShapedPoints = 8;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> timeDist(0, 400);
+  std::uniform_int_distribution<int> rowDist(0, regionInfo.getNumberOfPadRows() - 1);
+  std::uniform_int_distribution<int> trackDist(0, 100);
+  struct Electron { int track, time, row, pad; };
+  std::vector<Electron> electrons;
+  for(int i=0; i<nElectrons; ++i) {
+    const int row = rowDist(generator);
+    std::uniform_int_distribution<int> padDist(0, regionInfo.getPadsInRowRegion(row) - 1);
+    electrons.push_back({trackDist(generator), timeDist(generator), row, padDist(generator)});
+  }
+
+  CommonModeContainer commonMode;
+  DigitCRUBuffer buffer(cruID, commonMode);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for(const auto &electron : electrons) {
+    for(int bin=0; bin<nShapedPoints; ++bin) {
+      buffer.setDigit(electron.track, electron.time + bin, electron.row, electron.pad, 1.f);
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  const std::chrono::duration<double, std::milli> fillBuffer = end - start;
+
+  std::vector<o2::TPC::Digit> digits;
+  o2::dataformats::MCTruthContainer<o2::MCCompLabel> mcTruth;
+  const size_t memory = buffer.getMemorySize();
+  start = std::chrono::high_resolution_clock::now();
+  buffer.fillOutputContainer(&digits, mcTruth, nullptr, 1000);
+  end = std::chrono::high_resolution_clock::now();
+  const std::chrono::duration<double, std::milli> outputBuffer = end - start;
+
+  std::cout << "DigitContainer benchmark, " << nElectrons * nShapedPoints << " signals in " << digits.size() << " digits" << std::endl;
+  std::cout << "  DigitCRUBuffer: fill " << fillBuffer.count() << " ms, output " << outputBuffer.count() << " ms, memory " << memory / 1024 << " kB" << std::endl;
+  return 0;
+}
@@ -0,0 +1,42 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkTPCHwClusterer.cxx
+/// \brief Benchmark of the HwClusterer
+/// Low (pp like) and high (Pb-Pb like) occupancies are processed sequentially and with an increasing number of threads
+
+#include "ClustererTestUtils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+using namespace o2::TPC;
+
+int main()
+{
+  const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  for (const auto& occupancy : {std::make_pair("pp", 2000), std::make_pair("Pb-Pb", 100000)}) {
+    const std::vector<Digit> digits = test::createDigits(occupancy.second, 500, 2, 100, false);
+    double timeSequential;
+    const auto clusters = test::runHwClusterer(digits, HwClusterer::Processing::Sequential, 1, false, PeakFinder::Kernel::Scalar, timeSequential);
+    std::cout << "HwClusterer benchmark, " << occupancy.first << " occupancy: " << digits.size() << " digits, "
+              << clusters.size() << " clusters" << std::endl;
+    std::cout << "  sequential: " << timeSequential << " ms" << std::endl;
+    for (int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+      double timeParallel;
+      test::runHwClusterer(digits, HwClusterer::Processing::Parallel, nThreads, false, PeakFinder::Kernel::Scalar,
+                           timeParallel);
+      std::cout << "  " << nThreads << " thread(s): " << timeParallel << " ms, speed up " << timeSequential / timeParallel << std::endl;
+    }
+  }
+  return 0;
+}
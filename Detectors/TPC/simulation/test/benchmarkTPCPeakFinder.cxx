@@ -0,0 +1,42 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmarkTPCPeakFinder.cxx
+/// \brief Benchmark of the PeakFinder
+/// The clusters per second of both clusterers are measured with their own search and with the PeakFinder kernels,
+/// for low (pp like) and high (Pb-Pb like) occupancies
+
+#include "ClustererTestUtils.h"
+
+#include <iostream>
+#include <utility>
+
+using namespace o2::TPC;
+
+int main()
+{
+  std::cout << "PeakFinder benchmark, default kernel: "
+            << ((PeakFinder::getDefaultKernel() == PeakFinder::Kernel::Vectorised) ? "vectorised" : "scalar") << std::endl;
+  for (const auto& occupancy : {std::make_pair("pp", 2000), std::make_pair("Pb-Pb", 100000)}) {
+    const std::vector<Digit> digits = test::createDigits(occupancy.second, 1000, 2, 60, true);
+    std::cout << occupancy.first << " occupancy: " << digits.size() << " digits" << std::endl;
+    for (int algorithm = 0; algorithm < 3; ++algorithm) {
+      const bool usePeakFinder = algorithm > 0;
+      const auto kernel = (algorithm == 2) ? PeakFinder::Kernel::Vectorised : PeakFinder::Kernel::Scalar;
+      const char* name = usePeakFinder ? ((algorithm == 2) ? "vectorised PeakFinder" : "scalar PeakFinder") : "cell by cell search";
+      double timeBox, timeHw;
+      const size_t nBox = test::runBoxClusterer(digits, usePeakFinder, kernel, timeBox).size();
+      const size_t nHw = test::runHwClusterer(digits, HwClusterer::Processing::Sequential, 1, usePeakFinder, kernel, timeHw).size();
+      std::cout << "  " << name << ": BoxClusterer " << 1E3 * nBox / timeBox << " clusters/s, HwClusterer "
+                << 1E3 * nHw / timeHw << " clusters/s" << std::endl;
+    }
+  }
+  return 0;
+}
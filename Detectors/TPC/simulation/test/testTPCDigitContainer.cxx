@@ -20,7 +20,12 @@
 #include "TPCBase/Digit.h"
 #include "TPCSimulation/DigitMCMetaData.h"
 #include "TPCSimulation/SAMPAProcessing.h"
+#include "TPCSimulation/DigitCRUBuffer.h"
+#include "FairRootManager.h"
 #include <memory>
+#include <random>
+#include <set>
+#include <tuple>
 #include <vector>
 
 namespace o2 {
@@ -133,5 +138,132 @@ namespace TPC {
     delete mDigitsArray;
   }
 
+  /// \brief Test of the DigitContainer in continuous readout
+  /// Digits are filled beyond the initial time bin window of the CRU buffer and we check that the time bins are written out incrementally
+  BOOST_AUTO_TEST_CASE(DigitContainer_test3)
+  {
+    static FairRootManager *mgr = FairRootManager::Instance();
+    mgr->SetEntryNr(1);
+    DigitContainer digitContainer;
+    o2::dataformats::MCTruthContainer<MCCompLabel> mMCTruthArray;
+
+    const std::vector<int> Time = {10, 600, 2000};
+    for(auto timeBin : Time) {
+      digitContainer.addDigit(5, 23, timeBin, 12, 15, 100);
+    }
+
+    std::vector<o2::TPC::Digit> digits;
+    digitContainer.fillOutputContainer(&digits, mMCTruthArray, nullptr, 100);
+    BOOST_REQUIRE(digits.size() == 1);
+    BOOST_CHECK(digits[0].getTimeStamp() == Time[0]);
+
+    digitContainer.fillOutputContainer(&digits, mMCTruthArray, nullptr, 100);
+    BOOST_CHECK(digits.size() == 1);
+
+    digitContainer.fillOutputContainer(&digits, mMCTruthArray, nullptr, 5000);
+    BOOST_REQUIRE(digits.size() == 3);
+    BOOST_CHECK(digits[1].getTimeStamp() == Time[1]);
+    BOOST_CHECK(digits[2].getTimeStamp() == Time[2]);
+    for(size_t i=0; i<digits.size(); ++i) {
+      BOOST_CHECK(mMCTruthArray.getLabels(i).size() == 1);
+      BOOST_CHECK(mMCTruthArray.getLabels(i)[0].getTrackID() == 5);
+    }
+  }
+
+  /// \brief Test of the DigitCRUBuffer in continuous readout with events far apart in time
+  /// As in the DigitizerTask, the time bins before each event are written out before the event is filled, and we check that
+  /// the time bin window and the memory do not grow with the gaps between the events, nor for a buffer created late in time
+  BOOST_AUTO_TEST_CASE(DigitContainer_test4)
+  {
+    static FairRootManager *mgr = FairRootManager::Instance();
+    mgr->SetEntryNr(1);
+    const int cruID = 23;
+    CommonModeContainer commonMode;
+    DigitCRUBuffer buffer(cruID, commonMode);
+    std::unique_ptr<DigitCRUBuffer> lateBuffer;
+    const int windowSize = buffer.getWindowSize();
+
+    const int nEvents = 20;
+    const int eventSpacing = 5000;
+    const int nTimeBins = 400;
+    std::vector<o2::TPC::Digit> digits;
+    o2::dataformats::MCTruthContainer<MCCompLabel> mcTruth;
+    size_t memoryFirstEvent = 0;
+    for(int event=0; event<nEvents; ++event) {
+      const int eventTime = event * eventSpacing;
+      buffer.fillOutputContainer(&digits, mcTruth, nullptr, eventTime);
+      commonMode.cleanUp(eventTime);
+      for(int timeBin=eventTime; timeBin<eventTime+nTimeBins; ++timeBin) {
+        buffer.setDigit(event, timeBin, 12, 15, 100);
+        commonMode.addDigit(cruID, timeBin, 100);
+      }
+      if(event == nEvents - 1) {
+        lateBuffer = std::make_unique<DigitCRUBuffer>(cruID + 1, commonMode);
+        for(int timeBin=eventTime+nTimeBins-1; timeBin>=eventTime; --timeBin) {
+          lateBuffer->setDigit(event, timeBin, 12, 15, 100);
+          commonMode.addDigit(cruID + 1, timeBin, 100);
+        }
+      }
+      if(event == 0) memoryFirstEvent = buffer.getMemorySize();
+    }
+    buffer.fillOutputContainer(&digits, mcTruth, nullptr, nEvents * eventSpacing);
+    lateBuffer->fillOutputContainer(&digits, mcTruth, nullptr, nEvents * eventSpacing);
+
+    BOOST_CHECK(digits.size() == (nEvents + 1) * nTimeBins);
+    BOOST_CHECK(buffer.getWindowSize() == windowSize);
+    BOOST_CHECK(lateBuffer->getWindowSize() == windowSize);
+    BOOST_CHECK(buffer.getMemorySize() < 2 * memoryFirstEvent);
+  }
+
+  /// \brief Test of the sorting in the DigitCRUBuffer
+  /// Shaped electron signals are filled into one CRU in random order
+  /// The digits have to come out sorted by time bin, row and pad, at most one per fired voxel
+  BOOST_AUTO_TEST_CASE(DigitContainer_test5)
+  {
+    const Mapper& mapper = Mapper::instance();
+    static FairRootManager *mgr = FairRootManager::Instance();
+    mgr->SetEntryNr(1);
+    const int cruID = 0;
+    const PadRegionInfo& regionInfo = mapper.getPadRegionInfo(CRU(cruID).region());
+
+    /// electrons, each of them shaped into 8 consecutive time bins
+    const int nElectrons = 20000;
+    const int nShapedPoints = 8;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> timeDist(0, 400);
+    std::uniform_int_distribution<int> rowDist(0, regionInfo.getNumberOfPadRows() - 1);
+    std::uniform_int_distribution<int> trackDist(0, 100);
+    CommonModeContainer commonMode;
+    DigitCRUBuffer buffer(cruID, commonMode);
+    std::set<std::tuple<int, int, int>> voxels;
+    for(int i=0; i<nElectrons; ++i) {
+      const int track = trackDist(generator);
+      const int time = timeDist(generator);
+      const int row = rowDist(generator);
+      std::uniform_int_distribution<int> padDist(0, regionInfo.getPadsInRowRegion(row) - 1);
+      const int pad = padDist(generator);
+      for(int bin=0; bin<nShapedPoints; ++bin) {
+        buffer.setDigit(track, time + bin, row, pad, 1.f);
+        voxels.emplace(time + bin, row, pad);
+      }
+    }
+
+    std::vector<o2::TPC::Digit> digits;
+    o2::dataformats::MCTruthContainer<MCCompLabel> mcTruth;
+    buffer.fillOutputContainer(&digits, mcTruth, nullptr, 1000);
+
+    /// Voxels whose charge does not survive the common mode subtraction give no digit
+    BOOST_CHECK(digits.size() > 0);
+    BOOST_CHECK(digits.size() <= voxels.size());
+    for(size_t i=0; i<digits.size(); ++i) {
+      const auto voxel = std::make_tuple(digits[i].getTimeStamp(), digits[i].getRow(), digits[i].getPad());
+      BOOST_CHECK(voxels.count(voxel) == 1);
+      if(i > 0) {
+        BOOST_CHECK(std::make_tuple(digits[i-1].getTimeStamp(), digits[i-1].getRow(), digits[i-1].getPad()) < voxel);
+      }
+      BOOST_CHECK(mcTruth.getLabels(i).size() > 0);
+    }
+  }
+
 }
 }
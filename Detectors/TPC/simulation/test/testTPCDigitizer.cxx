@@ -0,0 +1,229 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCDigitizer.cxx
+/// \brief This task tests the Digitizer of the TPC digitization
+
+#define BOOST_TEST_MODULE Test TPC Digitizer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "TPCSimulation/Digitizer.h"
+#include "TPCSimulation/DigitizerTask.h"
+#include "TPCSimulation/DigitContainer.h"
+#include "TPCSimulation/Point.h"
+#include "TPCBase/Digit.h"
+#include "TPCBase/Sector.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "TRandom.h"
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+
+  /// Hit groups of tracks crossing the TPC at random positions
+  std::vector<HitGroup> generateHits(int nTracks, int nHitsPerTrack)
+  {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> phi(0.f, 2.f * M_PI), radius(90.f, 240.f), z(-240.f, 240.f), time(0.f, 1000.f);
+    std::uniform_int_distribution<int> nElectrons(1, 100);
+    std::vector<HitGroup> hits;
+    for (int track = 0; track < nTracks; ++track) {
+      hits.emplace_back(track);
+      for (int hit = 0; hit < nHitsPerTrack; ++hit) {
+        const float r = radius(gen), p = phi(gen);
+        hits.back().addHit(r * std::cos(p), r * std::sin(p), z(gen), time(gen), nElectrons(gen));
+      }
+    }
+    return hits;
+  }
+
+  /// Hit groups of tracks crossing the TPC at random positions, sorted into the sectors of the hits
+  std::array<std::vector<HitGroup>, Sector::MAXSECTOR> generateSectorHits(int nTracks, int nHitsPerTrack)
+  {
+    std::array<std::vector<HitGroup>, Sector::MAXSECTOR> sectorHits;
+    for (const auto &group : generateHits(nTracks, nHitsPerTrack)) {
+      for (size_t i = 0; i < group.getSize(); ++i) {
+        const auto &hit = group.getHit(i);
+        auto &hits = sectorHits[Sector::ToSector(hit.GetX(), hit.GetY(), hit.GetZ())];
+        if (hits.empty() || hits.back().GetTrackID() != group.GetTrackID()) {
+          hits.emplace_back(group.GetTrackID());
+        }
+        hits.back().addHit(hit.GetX(), hit.GetY(), hit.GetZ(), hit.GetTime(), hit.GetEnergyLoss());
+      }
+    }
+    return sectorHits;
+  }
+
+  /// Digitize the hits of all sectors with a new DigitizerTask, whose random number rings are filled from the same seed
+  void digitizeSectors(const std::array<std::vector<HitGroup>, Sector::MAXSECTOR> &sectorHits, int nThreads, int nEvents,
+                       std::vector<Digit> &digits, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &labels)
+  {
+    const std::vector<HitGroup> *hits[Sector::MAXSECTOR];
+    for (int s = 0; s < Sector::MAXSECTOR; ++s) {
+      hits[s] = &sectorHits[s];
+    }
+    gRandom->SetSeed(42);
+    DigitizerTask task;
+    task.setContinuousReadout(false);
+    task.setNumberOfThreads(nThreads);
+    task.initDigitizers();
+    for (int event = 0; event < nEvents; ++event) {
+      task.digitize(hits, event, 0.f);
+      task.fillOutputContainer(&digits, labels, nullptr, 0);
+    }
+  }
+
+  /// Digitize the hits of all sectors into one DigitContainer with a single new Digitizer, which reads for each sector
+  /// the same part of the random number rings as the Digitizer of the sector in the DigitizerTask
+  void digitizeSectorsSingle(const std::array<std::vector<HitGroup>, Sector::MAXSECTOR> &sectorHits,
+                             std::vector<Digit> &digits, o2::dataformats::MCTruthContainer<o2::MCCompLabel> &labels)
+  {
+    gRandom->SetSeed(42);
+    Digitizer digitizer;
+    digitizer.init();
+    digitizer.setContinuousReadout(false);
+    for (int s = 0; s < Sector::MAXSECTOR; ++s) {
+      digitizer.setRandomStream(s, Sector::MAXSECTOR);
+      digitizer.Process(sectorHits[s], 0, 0.f);
+    }
+    digitizer.getDigitContainer()->fillOutputContainer(&digits, labels, nullptr, 0, false);
+  }
+
+  /// Check that two sets of digits and their labels are identical, the charges up to the given relative tolerance in percent
+  void compareDigits(const std::vector<Digit> &digits1, const o2::dataformats::MCTruthContainer<o2::MCCompLabel> &labels1,
+                     const std::vector<Digit> &digits2, const o2::dataformats::MCTruthContainer<o2::MCCompLabel> &labels2,
+                     float tolerance)
+  {
+    BOOST_REQUIRE(digits2.size() == digits1.size());
+    BOOST_REQUIRE(labels2.getIndexedSize() == labels1.getIndexedSize());
+    for (size_t i = 0; i < digits1.size(); ++i) {
+      BOOST_CHECK(digits2[i].getCRU() == digits1[i].getCRU());
+      BOOST_CHECK(digits2[i].getRow() == digits1[i].getRow());
+      BOOST_CHECK(digits2[i].getPad() == digits1[i].getPad());
+      BOOST_CHECK(digits2[i].getTimeStamp() == digits1[i].getTimeStamp());
+      if (tolerance > 0.f) {
+        BOOST_CHECK_CLOSE(digits2[i].getChargeFloat(), digits1[i].getChargeFloat(), tolerance);
+      }
+      else {
+        BOOST_CHECK(digits2[i].getChargeFloat() == digits1[i].getChargeFloat());
+      }
+
+      const auto labelsDigit1 = labels1.getLabels(i);
+      const auto labelsDigit2 = labels2.getLabels(i);
+      BOOST_REQUIRE(labelsDigit2.size() == labelsDigit1.size());
+      for (int j = 0; j < static_cast<int>(labelsDigit1.size()); ++j) {
+        BOOST_CHECK(labelsDigit2[j].getTrackID() == labelsDigit1[j].getTrackID());
+        BOOST_CHECK(labelsDigit2[j].getEventID() == labelsDigit1[j].getEventID());
+      }
+    }
+  }
+
+  /// Digitize the hits with a new Digitizer, whose random number rings are filled from the same seed
+  void digitize(const std::vector<HitGroup> &hits, bool isBatched, std::vector<Digit> &digits,
+                o2::dataformats::MCTruthContainer<o2::MCCompLabel> &labels, size_t &nProcessedHits)
+  {
+    gRandom->SetSeed(42);
+    Digitizer digitizer;
+    digitizer.init();
+    digitizer.setContinuousReadout(false);
+    digitizer.setBatchedProcessing(isBatched);
+    DigitContainer *container = digitizer.Process(hits, 3, 0.f);
+    container->fillOutputContainer(&digits, labels, nullptr, 0, false);
+    nProcessedHits = digitizer.getNumberOfProcessedHits();
+  }
+
+  /// \brief Test of the batched processing of the electrons
+  /// The same hits are digitized per electron and in batches, which have to give identical digits and labels
+  BOOST_AUTO_TEST_CASE(Digitizer_batched_test)
+  {
+    const int nTracks = 20, nHitsPerTrack = 50;
+    const std::vector<HitGroup> hits = generateHits(nTracks, nHitsPerTrack);
+
+    std::vector<Digit> digitsScalar, digitsBatched;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> labelsScalar, labelsBatched;
+    size_t nHitsScalar = 0, nHitsBatched = 0;
+    digitize(hits, false, digitsScalar, labelsScalar, nHitsScalar);
+    digitize(hits, true, digitsBatched, labelsBatched, nHitsBatched);
+
+    BOOST_CHECK(nHitsScalar == nTracks * nHitsPerTrack);
+    BOOST_CHECK(nHitsBatched == nHitsScalar);
+
+    BOOST_CHECK(digitsScalar.size() > 0);
+    BOOST_REQUIRE(digitsBatched.size() == digitsScalar.size());
+    BOOST_REQUIRE(labelsBatched.getIndexedSize() == labelsScalar.getIndexedSize());
+    for (size_t i = 0; i < digitsScalar.size(); ++i) {
+      const Digit &scalar = digitsScalar[i];
+      const Digit &batched = digitsBatched[i];
+      BOOST_CHECK(batched.getCRU() == scalar.getCRU());
+      BOOST_CHECK(batched.getRow() == scalar.getRow());
+      BOOST_CHECK(batched.getPad() == scalar.getPad());
+      BOOST_CHECK(batched.getTimeStamp() == scalar.getTimeStamp());
+      BOOST_CHECK(batched.getChargeFloat() == scalar.getChargeFloat());
+
+      const auto scalarLabels = labelsScalar.getLabels(i);
+      const auto batchedLabels = labelsBatched.getLabels(i);
+      BOOST_REQUIRE(batchedLabels.size() == scalarLabels.size());
+      for (int j = 0; j < static_cast<int>(scalarLabels.size()); ++j) {
+        BOOST_CHECK(batchedLabels[j].getTrackID() == scalarLabels[j].getTrackID());
+        BOOST_CHECK(batchedLabels[j].getEventID() == scalarLabels[j].getEventID());
+      }
+    }
+  }
+  /// \brief Test of the parallel digitization of all sectors
+  /// The digits and labels have to be identical, and in the same order, for any number of threads
+  BOOST_AUTO_TEST_CASE(DigitizerTask_threads_test)
+  {
+    const auto sectorHits = generateSectorHits(200, 50);
+
+    std::vector<Digit> digitsSingle;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> labelsSingle;
+    digitizeSectors(sectorHits, 1, 2, digitsSingle, labelsSingle);
+    BOOST_CHECK(digitsSingle.size() > 0);
+
+    for (int nThreads : {2, 4, 0}) {
+      std::vector<Digit> digits;
+      o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+      digitizeSectors(sectorHits, nThreads, 2, digits, labels);
+      compareDigits(digitsSingle, labelsSingle, digits, labels, 0.f);
+    }
+  }
+
+  /// \brief Test of the digitization of all sectors with one Digitizer per sector
+  /// The charge diffusing into a neighbouring sector has to be merged with the charge of that sector, such that each pad and
+  /// time bin gives at most one digit, and the digits have to be the same as with a single Digitizer filling one DigitContainer.
+  /// The charges are summed up in a different order, hence they are compared with a tolerance
+  BOOST_AUTO_TEST_CASE(DigitizerTask_sectors_test)
+  {
+    const auto sectorHits = generateSectorHits(200, 50);
+
+    std::vector<Digit> digits;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> labels;
+    digitizeSectors(sectorHits, 4, 1, digits, labels);
+    BOOST_CHECK(digits.size() > 0);
+
+    std::set<std::tuple<int, int, int, int>> voxels;
+    for (const auto &digit : digits) {
+      BOOST_CHECK(voxels.emplace(digit.getCRU(), digit.getRow(), digit.getPad(), digit.getTimeStamp()).second);
+    }
+
+    std::vector<Digit> digitsSingle;
+    o2::dataformats::MCTruthContainer<o2::MCCompLabel> labelsSingle;
+    digitizeSectorsSingle(sectorHits, digitsSingle, labelsSingle);
+    compareDigits(digitsSingle, labelsSingle, digits, labels, 1e-3f);
+  }
+}
+}
@@ -133,5 +133,78 @@ namespace TPC {
 
     BOOST_CHECK_CLOSE(lostElectrons/nEvents, gasParam.getAttachmentCoefficient() * gasParam.getOxygenContent() * driftTime, 0.1);
   }
+
+  /// \brief Test of the batched getElectronDrift function
+  /// Same as test 1 of the getElectronDrift function,
+  /// but with all electrons drifted in one batch
+  ///
+  /// Precision: 0.5 %.
+  BOOST_AUTO_TEST_CASE(ElectronDiffusion_batch_test)
+  {
+    const static ParameterGas &gasParam = ParameterGas::defaultInstance();
+    const GlobalPosition3D posEle(10.f, 10.f, 250.f);
+    TH1D hTestDiffX("hTestDiffX", "", 500, posEle.X()-10., posEle.X()+10.);
+    TH1D hTestDiffY("hTestDiffY", "", 500, posEle.Y()-10., posEle.Y()+10.);
+    TH1D hTestDiffZ("hTestDiffZ", "", 500, posEle.Z()-10., posEle.Z()+10.);
+
+    TF1 gausX("gausX", "gaus");
+    TF1 gausY("gausY", "gaus");
+    TF1 gausZ("gausZ", "gaus");
+
+    static ElectronTransport electronTransport;
+
+    const size_t nElectrons = 500000;
+    std::vector<float> x(nElectrons, posEle.X()), y(nElectrons, posEle.Y()), z(nElectrons, posEle.Z());
+    electronTransport.getElectronDrift(x, y, z);
+    for(size_t i=0; i<nElectrons; ++i) {
+      hTestDiffX.Fill(x[i]);
+      hTestDiffY.Fill(y[i]);
+      hTestDiffZ.Fill(z[i]);
+    }
+
+    hTestDiffX.Fit("gausX", "Q0");
+    hTestDiffY.Fit("gausY", "Q0");
+    hTestDiffZ.Fit("gausZ", "Q0");
+
+    // check whether the mean of the gaussian fit matches the starting point
+    BOOST_CHECK_CLOSE(gausX.GetParameter(1), posEle.X(), 0.5);
+    BOOST_CHECK_CLOSE(gausY.GetParameter(1), posEle.Y(), 0.5);
+    BOOST_CHECK_CLOSE(gausZ.GetParameter(1), posEle.Z(), 0.5);
+
+    // check whether the width of the distribution matches the expected one
+    const float sigT = std::sqrt(posEle.Z()) * gasParam.getDiffT();
+    const float sigL = std::sqrt(posEle.Z()) * gasParam.getDiffL();
+
+    BOOST_CHECK_CLOSE(gausX.GetParameter(2), sigT, 0.5);
+    BOOST_CHECK_CLOSE(gausY.GetParameter(2), sigT, 0.5);
+    BOOST_CHECK_CLOSE(gausZ.GetParameter(2), sigL, 0.5);
+  }
+
+  /// \brief Test of the batched getElectronAttachment function
+  /// Same as the test of the isElectronAttachment function,
+  /// but with all electrons processed in one batch
+  ///
+  /// Precision: 0.1 %.
+  BOOST_AUTO_TEST_CASE(ElectronAttatchment_batch_test)
+  {
+    const static ParameterGas &gasParam = ParameterGas::defaultInstance();
+    static ElectronTransport electronTransport;
+
+    const float driftTime = 100.f;
+    const size_t nEvents = 500000;
+    std::vector<float> driftTimes(nEvents, driftTime);
+    std::vector<char> isAttached;
+    electronTransport.getElectronAttachment(driftTimes, isAttached);
+    BOOST_REQUIRE(isAttached.size() == nEvents);
+
+    float lostElectrons = 0;
+    for(const auto attached : isAttached) {
+      if(attached) {
+        ++ lostElectrons;
+      }
+    }
+
+    BOOST_CHECK_CLOSE(lostElectrons/nEvents, gasParam.getAttachmentCoefficient() * gasParam.getOxygenContent() * driftTime, 0.1);
+  }
 }
 }
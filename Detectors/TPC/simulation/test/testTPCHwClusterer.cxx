@@ -0,0 +1,46 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCHwClusterer.cxx
+/// \brief This task tests the parallel processing of the HwClusterer
+
+#define BOOST_TEST_MODULE Test TPC HwClusterer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ClustererTestUtils.h"
+
+namespace o2 {
+namespace TPC {
+
+  using test::createDigits;
+  using test::runHwClusterer;
+
+  /// \brief Test of the parallel HwClusterer
+  /// The clusters found with the thread pool have to be the same, and in the same order, as the sequentially found ones
+  BOOST_AUTO_TEST_CASE(HwClusterer_parallel_test)
+  {
+    const std::vector<Digit> digits = createDigits(2000, 200, 1, 100, false);
+    double time;
+    const auto sequential = runHwClusterer(digits, HwClusterer::Processing::Sequential, 1, false, PeakFinder::Kernel::Scalar, time);
+    const auto parallel = runHwClusterer(digits, HwClusterer::Processing::Parallel, 4, false, PeakFinder::Kernel::Scalar, time);
+
+    BOOST_CHECK(sequential.size() > 0);
+    BOOST_REQUIRE(sequential.size() == parallel.size());
+    for (size_t i = 0; i < sequential.size(); ++i) {
+      BOOST_CHECK(sequential[i].getCRU() == parallel[i].getCRU());
+      BOOST_CHECK(sequential[i].getRow() == parallel[i].getRow());
+      BOOST_CHECK(sequential[i].getQ() == parallel[i].getQ());
+      BOOST_CHECK(sequential[i].getPadMean() == parallel[i].getPadMean());
+      BOOST_CHECK(sequential[i].getTimeMean() == parallel[i].getTimeMean());
+    }
+  }
+}
+}
@@ -0,0 +1,153 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCPeakFinder.cxx
+/// \brief This task tests the PeakFinder kernel and its use in the BoxClusterer and HwClusterer
+
+#define BOOST_TEST_MODULE Test TPC PeakFinder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ClustererTestUtils.h"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace o2 {
+namespace TPC {
+
+  using test::createDigits;
+  using test::runBoxClusterer;
+
+  /// Sort the clusters to compare the output of different algorithms
+  template <typename ClusterType>
+  void sortClusters(std::vector<ClusterType>& clusters)
+  {
+    std::sort(clusters.begin(), clusters.end(), [](const ClusterType& a, const ClusterType& b) {
+      return std::make_tuple(a.getCRU(), a.getRow(), a.getQmax(), a.getPadMean()) < std::make_tuple(b.getCRU(), b.getRow(), b.getQmax(), b.getPadMean());
+    });
+  }
+
+  /// Compare two sets of clusters
+  template <typename ClusterType>
+  void compareClusters(std::vector<ClusterType> clusters, std::vector<ClusterType> reference)
+  {
+    sortClusters(clusters);
+    sortClusters(reference);
+    BOOST_REQUIRE(clusters.size() == reference.size());
+    for (size_t i = 0; i < clusters.size(); ++i) {
+      BOOST_CHECK(clusters[i].getCRU() == reference[i].getCRU());
+      BOOST_CHECK(clusters[i].getRow() == reference[i].getRow());
+      BOOST_CHECK(clusters[i].getQmax() == reference[i].getQmax());
+      BOOST_CHECK_CLOSE(clusters[i].getQ(), reference[i].getQ(), 1E-3);
+      BOOST_CHECK_CLOSE(clusters[i].getPadMean(), reference[i].getPadMean(), 1E-3);
+      BOOST_CHECK_CLOSE(clusters[i].getTimeMean(), reference[i].getTimeMean(), 1E-3);
+      BOOST_CHECK_SMALL(clusters[i].getPadSigma() - reference[i].getPadSigma(), 1E-3f);
+      BOOST_CHECK_SMALL(clusters[i].getTimeSigma() - reference[i].getTimeSigma(), 1E-3f);
+    }
+  }
+
+  /// Run the HwClusterer sequentially on the digits
+  std::vector<HwCluster> runHwClusterer(const std::vector<Digit>& digits, bool usePeakFinder, PeakFinder::Kernel kernel, double& time)
+  {
+    return test::runHwClusterer(digits, HwClusterer::Processing::Sequential, 1, usePeakFinder, kernel, time);
+  }
+
+  /// \brief Test of the PeakFinder kernel
+  /// The peaks and moments of a single cluster are checked, and the vectorised kernel has to give the same result
+  /// as the scalar one on random data in time and pad major layout
+  BOOST_AUTO_TEST_CASE(PeakFinder_test)
+  {
+    const int nTimeBins = 50;
+    const int nPads = 40;
+
+    /// Single cluster in a time major matrix, symmetric in pad direction
+    std::vector<float> matrix((nTimeBins + 4) * (nPads + 4), 0.f);
+    const int peak = 20 * (nPads + 4) + 10;
+    const float charges[3][3] = {{10, 20, 10}, {20, 80, 20}, {5, 10, 5}};
+    for (int t = 0; t < 3; ++t) {
+      for (int p = 0; p < 3; ++p) {
+        matrix[peak + (t - 1) * (nPads + 4) + (p - 1)] = charges[t][p];
+      }
+    }
+    for (auto kernel : {PeakFinder::Kernel::Scalar, PeakFinder::Kernel::Vectorised}) {
+      const PeakFinder peakFinder(5, 0, true, true, false, kernel);
+      std::vector<int> peaks;
+      for (int t = 2; t < nTimeBins + 2; ++t) {
+        peakFinder.findPeaks(matrix.data(), t * (nPads + 4) + 2, (t + 1) * (nPads + 4) - 2, nPads + 4, 1, peaks);
+      }
+      BOOST_REQUIRE(peaks.size() == 1);
+      BOOST_CHECK(peaks[0] == peak);
+      std::vector<PeakFinder::Moments> moments;
+      peakFinder.computeMoments(matrix.data(), peaks, nPads + 4, 1, moments);
+      BOOST_CHECK_CLOSE(moments[0].qTot, 180., 1E-6);
+      BOOST_CHECK_CLOSE(moments[0].qMax, 80., 1E-6);
+      BOOST_CHECK_SMALL(moments[0].padMean, 1E-9);
+      BOOST_CHECK_CLOSE(moments[0].timeMean, -20. / 180., 1E-6);
+      BOOST_CHECK(moments[0].padMin == -1 && moments[0].padMax == 1);
+      BOOST_CHECK(moments[0].timeMin == -1 && moments[0].timeMax == 1);
+    }
+
+    /// Random data
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> flat(0.f, 1.f);
+    for (auto& charge : matrix) {
+      charge = (flat(generator) < 0.3f) ? 50.f * flat(generator) : 0.f;
+    }
+    for (bool timeMajor : {true, false}) {
+      const int timeStride = timeMajor ? nPads + 4 : 1;
+      const int padStride = timeMajor ? 1 : nTimeBins + 4;
+      const int nLines = timeMajor ? nTimeBins : nPads;
+      const int lineLength = timeMajor ? nPads : nTimeBins;
+      const int lineStride = timeMajor ? timeStride : padStride;
+
+      std::vector<int> peaks[2];
+      std::vector<PeakFinder::Moments> moments[2];
+      for (auto kernel : {PeakFinder::Kernel::Scalar, PeakFinder::Kernel::Vectorised}) {
+        const int k = static_cast<int>(kernel);
+        const PeakFinder peakFinder(5, 0, true, true, !timeMajor, kernel);
+        for (int line = 2; line < nLines + 2; ++line) {
+          peakFinder.findPeaks(matrix.data(), line * lineStride + 2, line * lineStride + lineLength + 2, timeStride, padStride, peaks[k]);
+        }
+        peakFinder.computeMoments(matrix.data(), peaks[k], timeStride, padStride, moments[k]);
+      }
+      BOOST_CHECK(peaks[0].size() > 0);
+      BOOST_REQUIRE(peaks[0] == peaks[1]);
+      for (size_t i = 0; i < peaks[0].size(); ++i) {
+        BOOST_CHECK_CLOSE(moments[0][i].qTot, moments[1][i].qTot, 1E-9);
+        BOOST_CHECK_SMALL(moments[0][i].padMean - moments[1][i].padMean, 1E-9);
+        BOOST_CHECK_SMALL(moments[0][i].timeMean - moments[1][i].timeMean, 1E-9);
+        BOOST_CHECK_SMALL(moments[0][i].padSigma - moments[1][i].padSigma, 1E-9);
+        BOOST_CHECK_SMALL(moments[0][i].timeSigma - moments[1][i].timeSigma, 1E-9);
+        BOOST_CHECK(moments[0][i].padMin == moments[1][i].padMin && moments[0][i].padMax == moments[1][i].padMax);
+        BOOST_CHECK(moments[0][i].timeMin == moments[1][i].timeMin && moments[0][i].timeMax == moments[1][i].timeMax);
+      }
+    }
+  }
+
+  /// \brief Test of the clusterers with the PeakFinder
+  /// Both clusterers have to find the same clusters with the PeakFinder kernels as with their own search
+  BOOST_AUTO_TEST_CASE(PeakFinder_clusterer_test)
+  {
+    const std::vector<Digit> digits = createDigits(2000, 500, 1, 60, true);
+    double time;
+    const auto boxReference = runBoxClusterer(digits, false, PeakFinder::Kernel::Scalar, time);
+    const auto hwReference = runHwClusterer(digits, false, PeakFinder::Kernel::Scalar, time);
+    BOOST_CHECK(boxReference.size() > 0);
+    BOOST_CHECK(hwReference.size() > 0);
+    for (auto kernel : {PeakFinder::Kernel::Scalar, PeakFinder::Kernel::Vectorised}) {
+      compareClusters(runBoxClusterer(digits, true, kernel, time), boxReference);
+      compareClusters(runHwClusterer(digits, true, kernel, time), hwReference);
+    }
+  }
+}
+}
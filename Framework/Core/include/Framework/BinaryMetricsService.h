@@ -0,0 +1,52 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_BINARYMETRICSSERVICE_H
+#define FRAMEWORK_BINARYMETRICSSERVICE_H
+
+#include "Framework/MetricsRing.h"
+#include "Framework/MetricsService.h"
+#include "Framework/SimpleMetricsService.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace o2 {
+namespace framework {
+
+/// A metrics service which pushes int and float metrics as binary samples
+/// in a MetricsRing shared with the driver. String metrics, and whatever
+/// does not fit in the ring, go through the SimpleMetricsService text path.
+class BinaryMetricsService : public MetricsService {
+public:
+  BinaryMetricsService(std::unique_ptr<MetricsRing> ring);
+  void post(const char *label, float value) final;
+  void post(const char *label, int value) final;
+  void post(const char *label, const char *value) final;
+private:
+  int getId(const char *label);
+  bool push(const char *label, MetricSample &sample);
+
+  std::unique_ptr<MetricsRing> mRing;
+  // Labels are usually string literals, so we look them up by address
+  // first and by content only the first time we see a given address.
+  std::unordered_map<const char *, int> mIdsByAddress;
+  std::map<std::string, int> mIdsByLabel;
+  // The ring has a single producer, but metrics can be posted from the
+  // worker threads as well.
+  std::atomic_flag mLock = ATOMIC_FLAG_INIT;
+  SimpleMetricsService mFallback;
+};
+
+} // framework
+} // o2
+#endif // FRAMEWORK_BINARYMETRICSSERVICE_H
@@ -104,7 +104,8 @@ public:
   : mData{reinterpret_cast<T*>(data)},
     mSize{size}
   {
-    static_assert(std::is_pod<T>::value == true, "Collection only works with PoD");
+    static_assert(std::is_trivially_copyable<T>::value == true,
+                  "Collection only works with trivially copyable types");
   }
 
   // Collection is non-owning, since the data is assumed to be created
@@ -15,15 +15,23 @@
 #include "Framework/OutputSpec.h"
 #include "Framework/DataChunk.h"
 #include "Framework/Collection.h"
+#include "Framework/DataSpecKey.h"
 
+#include <cstring>
 #include <map>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class TClonesArray;
 
 namespace o2 {
 namespace framework {
 
+class HeaderPool;
 class MessageContext;
 class RootObjectContext;
 
@@ -47,18 +55,65 @@ public:
 
   template <class T>
   Collection<T> newCollectionChunk(const OutputSpec &spec, size_t nElements) {
-    static_assert(std::is_pod<T>::value == true, "Type must be a PoD");
+    static_assert(std::is_trivially_copyable<T>::value == true,
+                  "Type must be trivially copyable");
     auto size = nElements*sizeof(T);
     DataChunk chunk = newChunk(spec, size);
     return Collection<T>(chunk.data, nElements);
   }
 
+  /// Create a message holding @a nElements objects of type T, constructed
+  /// in place in the transport buffer from @a args. Unlike newTClonesArray
+  /// no serialization happens: the receiving end can access them directly
+  /// via DataRefUtils::as<T>. Classes with virtual functions, e.g. anything
+  /// using ClassDef / ClassDefOverride such as o2::ITSMFT::Cluster, are not
+  /// trivially copyable and still need newTClonesArray.
+  template <typename T, typename... Args>
+  Collection<T> make(const OutputSpec &spec, size_t nElements, Args&&... args) {
+    static_assert(std::is_trivially_copyable<T>::value == true,
+                  "Type must be trivially copyable");
+    DataChunk chunk = newChunk(spec, nElements*sizeof(T));
+    T *elements = reinterpret_cast<T*>(chunk.data);
+    for (size_t i = 0; i < nElements; ++i) {
+      new (elements + i) T(args...);
+    }
+    return Collection<T>(chunk.data, nElements);
+  }
+
+  /// Create a message holding a copy of the contents of @a elements.
+  template <typename T>
+  Collection<T> makeVector(const OutputSpec &spec, const std::vector<T> &elements) {
+    static_assert(std::is_trivially_copyable<T>::value == true,
+                  "Type must be trivially copyable");
+    DataChunk chunk = newChunk(spec, elements.size()*sizeof(T));
+    if (!elements.empty()) {
+      memcpy(chunk.data, elements.data(), chunk.size);
+    }
+    return Collection<T>(chunk.data, elements.size());
+  }
+
+  /// Set the timeframe the messages created from now on belong to. This is
+  /// propagated downstream in the DataProcessingHeader of each message.
+  void setTimeframeId(uint64_t timeframeId) {
+    mTimeframeId = timeframeId;
+  }
+
 private:
-  std::string matchDataHeader(const OutputSpec &spec);
+  const std::string &matchDataHeader(const OutputSpec &spec);
+  FairMQMessagePtr headerMessageFromSpec(const OutputSpec &spec,
+                                         const std::string &channel,
+                                         size_t payloadSize);
+
   FairMQDevice *mDevice;
   AllowedOutputsMap mAllowedOutputs;
+  // The channel of each allowed output, resolved at construction.
+  std::unordered_map<DataSpecKey, std::string, DataSpecKeyHash> mChannelForOutput;
+  // The channels whose transport copies adopted buffers.
+  std::unordered_set<std::string> mCopyingChannels;
+  HeaderPool &mHeaderPool;
   MessageContext *mContext;
   RootObjectContext *mRootContext;
+  uint64_t mTimeframeId;
 };
 
 }
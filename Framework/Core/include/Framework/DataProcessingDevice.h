@@ -17,24 +17,67 @@
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/DataAllocator.h"
 #include "Framework/DataRelayer.h"
+#include "Framework/DataSpecKey.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/ServiceRegistry.h"
 #include "Framework/MessageContext.h"
 #include "Framework/RootObjectContext.h"
+#include "Framework/OrderedWorkerPool.h"
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace o2 {
 namespace framework {
 
+/// When @a DeviceSpec::workerThreads is non zero, the algorithm is invoked on
+/// a pool of threads, each with its own MessageContext and DataAllocator, rather
+/// than on the FairMQ callback thread. Outputs are sent in the same order in
+/// which the complete sets of inputs were dispatched. Only stateless algorithms
+/// are run on the pool, which must therefore be reentrant and use only thread
+/// safe services. A stateful algorithm, i.e. one created by an init callback,
+/// is always invoked on the FairMQ callback thread.
+///
+/// Whatever the thread, every Send on the channels goes through the ordered
+/// output stage of the pool, so that the channels are never used concurrently.
 class DataProcessingDevice : public FairMQDevice {
 public:
   DataProcessingDevice(const DeviceSpec &spec, ServiceRegistry &);
+  ~DataProcessingDevice();
   void Init() final;
+  void Reset() final;
 protected:
   bool HandleData(FairMQParts &parts, int index);
   void error(const char *msg);
 private:
+  using InputSet = std::vector<DataRelayer::PartRef>;
+
+  /// The state owned by each thread of the worker pool.
+  struct Worker {
+    Worker(FairMQDevice *device, const DataAllocator::AllowedOutputsMap &outputs)
+    : allocator{device, &context, &rootContext, outputs}
+    {
+    }
+    MessageContext context;
+    RootObjectContext rootContext;
+    DataAllocator allocator;
+  };
+
+  /// The outcome of a set of inputs processed by a worker, waiting for its
+  /// turn to be sent.
+  struct PendingOutput {
+    MessageContext context;
+    RootObjectContext rootContext;
+  };
+
+  void processInputs(InputSet &inputs, MessageContext &context,
+                     RootObjectContext &rootContext, DataAllocator &allocator);
+  void forwardInputs(std::vector<DataRelayer::PartRef> &inputs);
+
   AlgorithmSpec::InitCallback mInit;
   AlgorithmSpec::ProcessCallback mStatefulProcess;
   AlgorithmSpec::ProcessCallback mStatelessProcess;
@@ -49,8 +92,18 @@ private:
   std::vector<ChannelSpec> mChannels;
   std::map<std::string, InputSpec> mInputs;
   std::map<std::string, InputSpec> mForwards;
-  int mErrorCount;
-  int mProcessingCount;
+  // Which of the mForwardChannels each kind of data has to be sent to.
+  std::unordered_map<DataSpecKey, std::vector<size_t>, DataSpecKeyHash> mForwardRoutes;
+  std::vector<std::string> mForwardChannels;
+  std::atomic<int> mErrorCount;
+  std::atomic<int> mProcessingCount;
+
+  // Worker pool, only used when workerThreads is non zero and the
+  // algorithm is stateless. The pool is declared last, so that it is
+  // stopped before the workers it uses are destroyed.
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+  std::mutex mErrorMutex; // serializes the error callback
+  OrderedWorkerPool mPool;
 };
 
 }
@@ -0,0 +1,66 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_DATAPROCESSINGHEADER_H
+#define FRAMEWORK_DATAPROCESSINGHEADER_H
+
+#include "Headers/DataHeader.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace o2 {
+namespace framework {
+
+/// Header which the framework appends to the DataHeader of every message
+/// it sends. It carries the timeframe the data belongs to, so that a
+/// receiving device can correlate parts coming from different senders
+/// regardless of the order in which they arrive.
+struct DataProcessingHeader : public Header::BaseHeader
+{
+  // static data for this header type/version
+  static const uint32_t sVersion;
+  static const o2::Header::HeaderType sHeaderType;
+  static const o2::Header::SerializationMethod sSerializationMethod;
+
+  /// The timeframe (or orbit) the associated payload belongs to.
+  uint64_t startTime;
+  /// How many units of startTime the associated payload covers.
+  uint64_t duration;
+
+  DataProcessingHeader()
+  : DataProcessingHeader(0, 0)
+  {
+  }
+
+  DataProcessingHeader(uint64_t s, uint64_t d = 1)
+  : BaseHeader(sizeof(DataProcessingHeader), sHeaderType, sSerializationMethod, sVersion),
+    startTime{s},
+    duration{d}
+  {
+  }
+
+  static const DataProcessingHeader* Get(const BaseHeader* baseHeader) {
+    return (baseHeader->description == DataProcessingHeader::sHeaderType) ?
+      static_cast<const DataProcessingHeader*>(baseHeader) : nullptr;
+  }
+};
+
+static_assert(sizeof(DataProcessingHeader) == 48,
+              "DataProcessingHeader struct must be of size 48");
+
+/// Check that the @a size bytes at @a buffer are a well formed header stack:
+/// a DataHeader followed by any number of headers, whose sizes add up to
+/// exactly @a size.
+bool isValidHeaderStack(const void *buffer, size_t size);
+
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_DATAPROCESSINGHEADER_H
@@ -39,6 +39,14 @@ struct DataProcessorSpec {
   Options options;
   // FIXME: not used for now...
   std::vector<std::string> requiredServices;
+  /// Time in milliseconds after which an incomplete set of inputs
+  /// for a given timeframe is dropped. 0 means wait forever.
+  int completionTimeout = 0;
+  /// Number of threads used to invoke the algorithm on different
+  /// timeframes in parallel. 0 means the algorithm is invoked directly
+  /// when the inputs are complete. When non zero the algorithm must be
+  /// reentrant.
+  int workerThreads = 0;
 };
 
 } // namespace framework
@@ -14,6 +14,9 @@
 #include "Framework/Collection.h"
 #include "Headers/DataHeader.h"
 
+#include <cassert>
+#include <type_traits>
+
 namespace o2 {
 namespace framework {
 
@@ -23,6 +26,8 @@ struct DataRefUtils {
   static Collection<T> as(const DataRef &ref) {
     using DataHeader = o2::Header::DataHeader;
     auto header = reinterpret_cast<const DataHeader*const>(ref.header);
+    static_assert(std::is_trivially_copyable<T>::value == true,
+                  "Type must be trivially copyable");
     assert((header->payloadSize % sizeof(T)) == 0);
     //FIXME: provide a const collection
     return Collection<T>(reinterpret_cast<void *>(const_cast<char *>(ref.payload)), header->payloadSize/sizeof(T));
@@ -11,9 +11,12 @@
 #define FRAMEWORK_DATARELAYER_H
 
 #include <fairmq/FairMQMessage.h>
+#include "Framework/DataSpecKey.h"
 #include "Framework/InputSpec.h"
+#include <chrono>
 #include <cstddef>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace o2 {
@@ -25,7 +28,8 @@ class DataRelayer {
 public:
   enum RelayChoice {
     WillRelay,
-    WillNotRelay
+    WillNotRelay,
+    Dropped
   };
 
   using InputsMap = std::map<std::string, InputSpec>;
@@ -53,30 +57,64 @@ public:
     std::vector<PartRef> readyInputs;
   };
 
-  DataRelayer(const InputsMap &, const ForwardsMap&, MetricsService &);
+  /// @a pipelineLength is the maximum number of timeframes which can be in
+  /// flight at the same time. Each of them gets a slot in a ring with one entry
+  /// per input, so that completing a timeframe does not require any search.
+  DataRelayer(const InputsMap &, const ForwardsMap&, MetricsService &,
+              size_t pipelineLength = sDefaultPipelineLength);
 
+  /// Parts are associated to a timeframe using the DataProcessingHeader
+  /// or, if missing, the orbit of the HeartbeatFrameEnvelope in their header
+  /// stack. Parts without any timing information are assumed to arrive in
+  /// order. Parts belonging to a timeframe older than the ones in flight,
+  /// or to a timeframe already completed or dropped, are Dropped, as well
+  /// as parts whose header is not a valid header stack.
   RelayChoice relay(std::unique_ptr<FairMQMessage> &&header,
                     std::unique_ptr<FairMQMessage> &&payload);
 
+  /// Timeframes which are still incomplete after @a timeout are dropped
+  /// the next time getReadyToProcess is invoked. A zero timeout means
+  /// waiting forever.
+  void setCompletionTimeout(std::chrono::milliseconds timeout);
+
   DataReadyInfo getReadyToProcess();
 
   // The messages which need to be forwarded to next stage.
   const std::vector<bool> &forwardingMask();
   size_t getCacheSize() const;
 
+  static constexpr size_t sDefaultPipelineLength = 16;
 private:
   static constexpr TimeframeId sInvalidTimeframeId{(size_t) -1};
-  struct CompletionMask {
+
+  /// One entry of the ring of timeframes being relayed. The parts
+  /// themselves live in mCache, at the position slot * inputs + input.
+  struct TimeframeSlot {
     TimeframeId timeframeId;
-    size_t mask;
+    size_t filled; // number of inputs already present for the timeframe
+    std::chrono::steady_clock::time_point created;
+    // last timeframe completed or dropped in this slot, used to detect
+    // late and duplicate parts once the slot is free again
+    TimeframeId lastDone;
   };
+
+  size_t getInputIndex(const Header::DataHeader &header) const;
+  TimeframeId getTimeframeId(const Header::DataHeader &header, size_t inputIdx);
+  void dropSlot(size_t slotIdx);
+  void releaseSlot(TimeframeSlot &slot);
+  void expireSlots();
+
   InputsMap mInputs;
   ForwardsMap mForwards;
   MetricsService &mMetrics;
+  std::unordered_map<DataSpecKey, size_t, DataSpecKeyHash> mInputIndex;
+  std::vector<TimeframeSlot> mSlots;
   std::vector<PartRef> mCache;
-  std::vector<CompletionMask> mCompletion;
+  std::vector<TimeframeId> mNextTimeframe; // per input
+  std::vector<size_t> mReadySlots;
   std::vector<bool> mForwardingMask;
-  size_t mAllInputsMask;
+  std::chrono::milliseconds mCompletionTimeout;
+  size_t mPendingParts;
 };
 
 }
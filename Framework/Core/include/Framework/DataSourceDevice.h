@@ -43,6 +43,7 @@ private:
   MessageContext mContext;
   RootObjectContext mRootContext;
   DataAllocator mAllocator;
+  uint64_t mTimeframeId;
 };
 
 }
@@ -0,0 +1,56 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_DATASPECKEY_H
+#define FRAMEWORK_DATASPECKEY_H
+
+#include "Headers/DataHeader.h"
+#include <cstddef>
+
+namespace o2 {
+namespace framework {
+
+/// The (origin, description, subSpec) triplet identifying a given kind of
+/// data, to be used as key of hash tables which need to find out quickly
+/// which spec a message matches.
+struct DataSpecKey {
+  Header::DataOrigin origin;
+  Header::DataDescription description;
+  Header::DataHeader::SubSpecificationType subSpec;
+
+  template <typename T>
+  static DataSpecKey fromSpec(const T &spec) {
+    return DataSpecKey{spec.origin, spec.description, spec.subSpec};
+  }
+
+  static DataSpecKey fromHeader(const Header::DataHeader &header) {
+    return DataSpecKey{header.dataOrigin, header.dataDescription, header.subSpecification};
+  }
+
+  bool operator==(const DataSpecKey &rhs) const {
+    return origin == rhs.origin
+           && description == rhs.description
+           && subSpec == rhs.subSpec;
+  }
+};
+
+struct DataSpecKeyHash {
+  size_t operator()(const DataSpecKey &key) const {
+    size_t h = key.origin.itg[0];
+    h = h * 31 + key.description.itg[0];
+    h = h * 31 + key.description.itg[1];
+    h = h * 31 + key.subSpec;
+    return h;
+  }
+};
+
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_DATASPECKEY_H
@@ -45,6 +45,12 @@ struct DeviceMetricsInfo {
 
 bool parseMetric(const std::string &s, std::smatch &match);
 bool processMetric(const std::smatch &match, DeviceMetricsInfo &info);
+size_t findOrCreateMetric(const std::string &name, MetricType type,
+                          DeviceMetricsInfo &info);
+bool addMetricSample(size_t metricIndex, size_t timestamp, int value,
+                     DeviceMetricsInfo &info);
+bool addMetricSample(size_t metricIndex, size_t timestamp, float value,
+                     DeviceMetricsInfo &info);
 size_t metricIdxByName(const std::string &name,
                        const DeviceMetricsInfo &info);
 
@@ -36,6 +36,8 @@ struct DeviceSpec {
   std::map<std::string, InputSpec> inputs;
   std::map<std::string, OutputSpec> outputs;
   std::map<std::string, InputSpec> forwards;
+  int completionTimeout = 0; // in milliseconds, 0 means wait forever
+  int workerThreads = 0; // 0 means processing on the FairMQ callback thread
   std::vector<char *> args; // Calculated list of args for the device.
 };
 
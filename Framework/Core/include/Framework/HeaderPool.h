@@ -0,0 +1,56 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_HEADERPOOL_H
+#define FRAMEWORK_HEADERPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace o2 {
+namespace framework {
+
+/// A pool of fixed size buffers used for the header stacks of the messages
+/// created by the DataAllocator. Buffers are adopted by the FairMQ messages
+/// and handed back to the pool by the transport, via HeaderPool::release,
+/// once the message has been sent, so that they can be recycled for the
+/// next message rather than being allocated every time.
+///
+/// Since the transport can give back a buffer at any point, even after the
+/// device is gone, pools are never destroyed and are obtained via
+/// HeaderPool::get().
+class HeaderPool {
+public:
+  /// The pool of buffers of @a bufferSize bytes for this process.
+  static HeaderPool &get(size_t bufferSize);
+
+  /// A buffer of bufferSize() bytes, to be given back with release.
+  void *acquire();
+  /// Matches the FairMQ free function signature. @a hint is the pool.
+  static void release(void *data, void *hint);
+
+  size_t bufferSize() const {
+    return mBufferSize;
+  }
+
+private:
+  HeaderPool(size_t bufferSize);
+  HeaderPool(const HeaderPool &) = delete;
+  HeaderPool &operator=(const HeaderPool &) = delete;
+
+  size_t mBufferSize;
+  std::mutex mMutex;
+  std::vector<void *> mFree;
+};
+
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_HEADERPOOL_H
@@ -0,0 +1,153 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_METRICSRING_H
+#define FRAMEWORK_METRICSRING_H
+
+#include "Framework/DeviceMetricsInfo.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace o2 {
+namespace framework {
+
+/// A single metric sample, as stored in the MetricsRing.
+struct MetricSample {
+  uint64_t timestamp;
+  uint32_t id; // as returned by MetricsRing::registerLabel
+  MetricType type;
+  union {
+    int intValue;
+    float floatValue;
+  };
+};
+
+/// A single producer / single consumer ring of binary metric samples.
+///
+/// The ring lives in a buffer which can be shared between the device
+/// posting the metrics and the driver collecting them, so that metrics
+/// do not need to be formatted, printed and parsed back. The labels of
+/// the metrics are registered once and samples only refer to them by id.
+/// Samples posted while the ring is full are dropped and counted.
+class MetricsRing {
+public:
+  static constexpr size_t sMaxLabels = 256;
+  static constexpr size_t sMaxLabelSize = 64;
+
+  /// Create a new ring with room for @a capacity samples in the shared
+  /// memory segment @a name. The segment is removed when the ring is
+  /// destroyed. Returns nullptr if the segment could not be created.
+  static std::unique_ptr<MetricsRing> create(const std::string &name, size_t capacity);
+  /// Attach to the ring previously created in the shared memory segment
+  /// @a name. Returns nullptr if the segment does not exist (yet).
+  static std::unique_ptr<MetricsRing> attach(const std::string &name);
+  /// The name of the shared memory segment used by the device @a deviceId.
+  /// A segment left over by a previous run has the same name, so check
+  /// creatorPid() after attaching.
+  static std::string nameForDevice(const std::string &deviceId);
+  /// The size of the buffer needed for a ring of @a capacity samples.
+  static size_t bufferSize(size_t capacity);
+
+  /// Use @a buffer, of at least bufferSize(capacity) bytes, as storage for
+  /// the ring. If @a initialise is false, the buffer is assumed to already
+  /// contain a ring.
+  MetricsRing(void *buffer, size_t capacity, bool initialise);
+  ~MetricsRing();
+
+  // Producer side
+  /// @returns the id to use for samples of the metric @a label, or -1 if
+  ///          no more labels can be registered.
+  int registerLabel(const char *label);
+  bool push(const MetricSample &sample) {
+    uint64_t head = mLayout->head.load(std::memory_order_relaxed);
+    uint64_t tail = mLayout->tail.load(std::memory_order_acquire);
+    if (head - tail >= mCapacity) {
+      mLayout->dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    mSamples[head & mMask] = sample;
+    mLayout->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  /// Copies up to @a maxSamples samples in @a samples, oldest first.
+  /// @returns how many samples were copied
+  size_t pop(MetricSample *samples, size_t maxSamples) {
+    uint64_t tail = mLayout->tail.load(std::memory_order_relaxed);
+    uint64_t head = mLayout->head.load(std::memory_order_acquire);
+    size_t n = head - tail < maxSamples ? head - tail : maxSamples;
+    for (size_t si = 0; si < n; ++si) {
+      samples[si] = mSamples[(tail + si) & mMask];
+    }
+    mLayout->tail.store(tail + n, std::memory_order_release);
+    return n;
+  }
+  size_t labelsCount() const {
+    return mLayout->labelsCount.load(std::memory_order_acquire);
+  }
+  const char *label(size_t id) const {
+    return mLayout->labels[id];
+  }
+  uint64_t dropped() const {
+    return mLayout->dropped.load(std::memory_order_relaxed);
+  }
+  size_t capacity() const {
+    return mCapacity;
+  }
+  /// The pid of the process which created the ring in shared memory, 0 if
+  /// the ring was not created by create().
+  pid_t creatorPid() const {
+    return mLayout->creatorPid.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr uint32_t sMagic = 0x4d4f3230; // "02OM"
+  /// What is actually stored in the buffer, followed by the samples.
+  /// Producer and consumer indices sit on different cache lines.
+  struct Layout {
+    uint32_t magic;
+    uint32_t capacity;
+    std::atomic<int32_t> creatorPid;
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) std::atomic<uint64_t> dropped;
+    std::atomic<uint32_t> labelsCount;
+    char labels[sMaxLabels][sMaxLabelSize];
+  };
+
+  Layout *mLayout;
+  MetricSample *mSamples;
+  size_t mCapacity;
+  size_t mMask;
+  // Only set when the buffer is a shared memory mapping.
+  std::string mShmName;
+  size_t mMappedSize;
+  bool mOwner;
+};
+
+/// Move all the samples currently in @a ring to @a info, in batches.
+/// @a metricIndices caches the position in @a info of each label of the ring
+/// and is updated as new labels get registered.
+/// @returns the number of samples consumed
+size_t consumeMetrics(MetricsRing &ring,
+                      std::vector<size_t> &metricIndices,
+                      DeviceMetricsInfo &info);
+
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_METRICSRING_H
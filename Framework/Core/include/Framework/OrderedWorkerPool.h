@@ -0,0 +1,82 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_ORDEREDWORKERPOOL_H
+#define FRAMEWORK_ORDEREDWORKERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2 {
+namespace framework {
+
+/// A pool of threads running tasks in parallel, whose results are committed
+/// in the order the tasks were submitted. A task is invoked on a worker
+/// thread with the index of the worker, and returns the commit step, which
+/// is invoked once all the previous tasks have been committed. Only one commit
+/// step runs at the time, and never concurrently with the functions passed
+/// to exclusive(), so that they can safely share non thread safe resources,
+/// e.g. the channels of a device.
+class OrderedWorkerPool {
+public:
+  using Commit = std::function<void()>;
+  using Task = std::function<Commit(size_t)>;
+
+  OrderedWorkerPool() = default;
+  ~OrderedWorkerPool();
+  OrderedWorkerPool(const OrderedWorkerPool &) = delete;
+  OrderedWorkerPool &operator=(const OrderedWorkerPool &) = delete;
+
+  /// Start @a workers threads. Does nothing if the pool is already running.
+  void start(size_t workers);
+  /// Process and commit whatever is queued, then join the threads. The
+  /// pool can be started again afterwards.
+  void stop();
+  /// The number of running threads, 0 when the pool is stopped.
+  size_t size() const { return mThreads.size(); }
+
+  /// Queue @a task, waiting if every worker already has a task queued. The
+  /// pool must be running.
+  void submit(Task task);
+
+  /// Invoke @a f, making sure no commit step is running at the same time.
+  template <typename F>
+  void exclusive(F &&f) {
+    std::lock_guard<std::mutex> lock(mCommitMutex);
+    f();
+  }
+
+private:
+  void run(size_t worker);
+  void commit(size_t sequence, Commit &&step);
+
+  std::vector<std::thread> mThreads;
+
+  std::mutex mQueueMutex;
+  std::condition_variable mWorkAvailable;
+  std::condition_variable mWorkConsumed;
+  std::deque<std::pair<size_t, Task>> mQueue;
+  bool mStop = false;
+  size_t mNextSequence = 0;
+
+  std::mutex mCommitMutex;
+  std::map<size_t, Commit> mPendingCommits;
+  size_t mNextToCommit = 0;
+};
+
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_ORDEREDWORKERPOOL_H
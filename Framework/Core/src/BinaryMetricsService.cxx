@@ -0,0 +1,90 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/BinaryMetricsService.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <cassert>
+
+namespace o2 {
+namespace framework {
+
+BinaryMetricsService::BinaryMetricsService(std::unique_ptr<MetricsRing> ring)
+: mRing{std::move(ring)}
+{
+  assert(mRing.get());
+}
+
+// Must be called with mLock held.
+int BinaryMetricsService::getId(const char *label) {
+  // The buffer at a given address might have been reused for a different
+  // label, so we still check it matches the registered one.
+  auto ai = mIdsByAddress.find(label);
+  if (ai != mIdsByAddress.end()
+      && ai->second >= 0
+      && strncmp(mRing->label(ai->second), label, MetricsRing::sMaxLabelSize - 1) == 0) {
+    return ai->second;
+  }
+  int id;
+  auto li = mIdsByLabel.find(label);
+  if (li != mIdsByLabel.end()) {
+    id = li->second;
+  } else {
+    id = mRing->registerLabel(label);
+    mIdsByLabel.insert(std::make_pair(std::string(label), id));
+  }
+  mIdsByAddress[label] = id;
+  return id;
+}
+
+bool BinaryMetricsService::push(const char *label, MetricSample &sample) {
+  auto now = std::chrono::system_clock::now();
+  sample.timestamp = std::chrono::system_clock::to_time_t(now);
+  // The lock is only held for a few instructions, so spinning is fine, but
+  // give way to the holder if it got preempted.
+  while (mLock.test_and_set(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  int id = getId(label);
+  bool pushed = false;
+  if (id >= 0) {
+    sample.id = id;
+    pushed = mRing->push(sample);
+  }
+  mLock.clear(std::memory_order_release);
+  return pushed;
+}
+
+void BinaryMetricsService::post(const char *label, float value) {
+  MetricSample sample;
+  sample.type = MetricType::Float;
+  sample.floatValue = value;
+  if (!push(label, sample)) {
+    mFallback.post(label, value);
+  }
+}
+
+void BinaryMetricsService::post(const char *label, int value) {
+  MetricSample sample;
+  sample.type = MetricType::Int;
+  sample.intValue = value;
+  if (!push(label, sample)) {
+    mFallback.post(label, value);
+  }
+}
+
+void BinaryMetricsService::post(const char *label, const char *value) {
+  mFallback.post(label, value);
+}
+
+} // framework
+} // o2
@@ -11,8 +11,12 @@
 #include "Framework/MessageContext.h"
 #include "Framework/RootObjectContext.h"
 #include "Framework/DataSpecUtils.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/HeaderPool.h"
 #include <TClonesArray.h>
 
+#include <new>
+
 namespace o2 {
 namespace framework {
 
@@ -21,18 +25,24 @@ DataAllocator::DataAllocator(FairMQDevice *device,
                              RootObjectContext *rootContext,
                              const AllowedOutputsMap &outputs)
 : mDevice{device},
+  mAllowedOutputs{outputs},
+  mChannelForOutput{},
+  mCopyingChannels{},
+  mHeaderPool{HeaderPool::get(sizeof(Header::DataHeader) + sizeof(DataProcessingHeader))},
   mContext{context},
   mRootContext{rootContext},
-  mAllowedOutputs{outputs}
+  mTimeframeId{0}
 {
+  for (auto &output : mAllowedOutputs) {
+    mChannelForOutput.emplace(DataSpecKey::fromSpec(output.second), output.first);
+  }
 }
 
-std::string
+const std::string &
 DataAllocator::matchDataHeader(const OutputSpec &spec) {
-  for (auto &output : mAllowedOutputs) {
-    if (DataSpecUtils::match(output.second, spec.origin, spec.description, spec.subSpec)) {
-      return output.first;
-    }
+  auto ci = mChannelForOutput.find(DataSpecKey::fromSpec(spec));
+  if (ci != mChannelForOutput.end()) {
+    return ci->second;
   }
   std::ostringstream str;
   str << "Worker is not authorised to create message with "
@@ -42,16 +52,42 @@ DataAllocator::matchDataHeader(const OutputSpec &spec) {
   throw std::runtime_error(str.str());
 }
 
+// Creates the header stack for a message: a DataHeader describing the
+// payload, followed by the DataProcessingHeader holding the timeframe.
+// The headers are constructed in place in a recycled buffer, which the
+// message adopts and gives back to the pool once sent. Transports which
+// copy adopted buffers anyway, like shmem, gain nothing from the pool, so
+// once a channel is seen doing so its headers are built directly in the
+// message.
+FairMQMessagePtr
+DataAllocator::headerMessageFromSpec(const OutputSpec &spec,
+                                     const std::string &channel,
+                                     size_t payloadSize) {
+  auto fillHeaders = [this, &spec, payloadSize](char *buffer) {
+    auto header = new (buffer) Header::DataHeader(spec.description, spec.origin, spec.subSpec, payloadSize);
+    header->flagsNextHeader = 1;
+    new (buffer + sizeof(Header::DataHeader)) DataProcessingHeader{mTimeframeId};
+  };
+  if (mCopyingChannels.count(channel)) {
+    auto message = mDevice->NewMessageFor(channel, 0, mHeaderPool.bufferSize());
+    fillHeaders(reinterpret_cast<char*>(message->GetData()));
+    return message;
+  }
+  auto buffer = reinterpret_cast<char*>(mHeaderPool.acquire());
+  fillHeaders(buffer);
+  auto message = mDevice->NewMessageFor(channel, 0, buffer, mHeaderPool.bufferSize(),
+                                        &HeaderPool::release, &mHeaderPool);
+  if (message->GetData() != buffer) {
+    mCopyingChannels.insert(channel);
+  }
+  return message;
+}
+
 DataChunk
 DataAllocator::newChunk(const OutputSpec &spec, size_t size) {
-  std::string channel = matchDataHeader(spec);
+  const std::string &channel = matchDataHeader(spec);
   FairMQParts parts;
-  FairMQMessagePtr headerMessage = mDevice->NewMessageFor(channel, 0, sizeof(Header::DataHeader));
-  Header::DataHeader *header = reinterpret_cast<Header::DataHeader*>(headerMessage->GetData());
-  header->magicStringInt = o2::Header::BaseHeader::sMagicString;
-  header->dataOrigin = spec.origin;
-  header->dataDescription = spec.description;
-  header->subSpecification = spec.subSpec;
+  FairMQMessagePtr headerMessage = headerMessageFromSpec(spec, channel, size);
   // FIXME: how do we want to use subchannels? time based parallelism?
   FairMQMessagePtr payloadMessage = mDevice->NewMessageFor(channel, 0, size);
   auto dataPtr = payloadMessage->GetData();
@@ -68,13 +104,9 @@ DataChunk
 DataAllocator::adoptChunk(const OutputSpec &spec, char *buffer, size_t size, fairmq_free_fn *freefn, void *hint = nullptr) {
   // Find a matching channel, create a new message for it and put it in the
   // queue to be sent at the end of the processing
-  std::string channel = matchDataHeader(spec);
+  const std::string &channel = matchDataHeader(spec);
   FairMQParts parts;
-  FairMQMessagePtr headerMessage = mDevice->NewMessageFor(channel, 0, sizeof(Header::DataHeader));
-  Header::DataHeader *header = reinterpret_cast<Header::DataHeader*>(headerMessage->GetData());
-  header->dataOrigin = spec.origin;
-  header->dataDescription = spec.description;
-  header->subSpecification = spec.subSpec;
+  FairMQMessagePtr headerMessage = headerMessageFromSpec(spec, channel, size);
   // FIXME: how do we want to use subchannels? time based parallelism?
   FairMQMessagePtr payloadMessage = mDevice->NewMessageFor(channel, 0, buffer, size, freefn, hint);
   auto dataPtr = payloadMessage->GetData();
@@ -88,13 +120,9 @@ DataAllocator::adoptChunk(const OutputSpec &spec, char *buffer, size_t size, fai
 
 TClonesArray&
 DataAllocator::newTClonesArray(const OutputSpec &spec, const char *className, size_t nElements) {
-  std::string channel = matchDataHeader(spec);
-  FairMQMessagePtr headerMessage = mDevice->NewMessageFor(channel, 0, sizeof(Header::DataHeader));
-  Header::DataHeader *header = reinterpret_cast<Header::DataHeader*>(headerMessage->GetData());
-  header->dataOrigin = spec.origin;
-  header->dataDescription = spec.description;
-  header->subSpecification = spec.subSpec;
-  header->payloadSize = 0; // We will override this at Send time.
+  const std::string &channel = matchDataHeader(spec);
+  // The payload size will be overridden at Send time.
+  FairMQMessagePtr headerMessage = headerMessageFromSpec(spec, channel, 0);
   auto payload = std::make_unique<TClonesArray>(className, nElements);
   payload->SetOwner(kTRUE);
   auto &result = *payload.get();
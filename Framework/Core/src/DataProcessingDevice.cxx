@@ -9,15 +9,16 @@
 // or submit itself to any jurisdiction.
 #include "Framework/DataProcessingDevice.h"
 #include "Framework/ChannelMatching.h"
-#include "Framework/DataSpecUtils.h"
 #include "Framework/MetricsService.h"
 #include "Framework/TMessageSerializer.h"
 #include "Framework/DataProcessor.h"
+#include "Framework/DataProcessingHeader.h"
 #include "Framework/FairOptionsRetriever.h"
 #include <fairmq/FairMQParts.h>
 #include <options/FairMQProgOptions.h>
 #include <TMessage.h>
 #include <TClonesArray.h>
+#include <TROOT.h>
 
 using namespace o2::framework;
 
@@ -42,12 +43,21 @@ DataProcessingDevice::DataProcessingDevice(const DeviceSpec &spec,
   mErrorCount{0},
   mProcessingCount{0}
 {
+  mRelayer.setCompletionTimeout(std::chrono::milliseconds(spec.completionTimeout));
+  for (int wi = 0; wi < spec.workerThreads; ++wi) {
+    mWorkers.emplace_back(std::make_unique<Worker>(this, spec.outputs));
+  }
+}
+
+DataProcessingDevice::~DataProcessingDevice() {
+  mPool.stop();
 }
 
 /// This takes care of initialising the device from its specification.
 /// In particular it needs to:
 /// * Allocate the channels as needed and attach HandleData to each one of them
 /// * Invoke the actual init
+/// * Start the worker pool, if requested and the algorithm is stateless
 void DataProcessingDevice::Init() {
   LOG(DEBUG) << "DataProcessingDevice::InitTask::START";
   auto optionsRetriever(std::make_unique<FairOptionsRetriever>(GetConfig()));
@@ -64,20 +74,47 @@ void DataProcessingDevice::Init() {
     LOG(ERROR) << "DataProcessingDevice should have at least one input channel";
   }
 
+  // Build the routing table for the forwards, so that we do not
+  // need to match every input against every forward later on.
+  mForwardRoutes.clear();
+  mForwardChannels.clear();
+  for (auto &forward : mForwards) {
+    mForwardRoutes[DataSpecKey::fromSpec(forward.second)].push_back(mForwardChannels.size());
+    mForwardChannels.push_back(forward.first);
+  }
+
   if (mInit) {
     mStatefulProcess = mInit(*mConfigRegistry, mServiceRegistry);
   }
+  if (!mWorkers.empty()) {
+    if (mStatefulProcess) {
+      LOG(WARNING) << "Stateful algorithms are not run on the worker pool, "
+                   << "processing on the callback thread";
+    } else {
+      // Workers might create ROOT objects at the same time.
+      ROOT::EnableThreadSafety();
+      mPool.start(mWorkers.size());
+    }
+  }
   LOG(DEBUG) << "DataProcessingDevice::InitTask::END";
 }
 
+/// The workers are stopped, after processing whatever was queued, so that
+/// they can be started again by the next Init.
+void DataProcessingDevice::Reset() {
+  mPool.stop();
+  FairMQDevice::Reset();
+}
+
 // This is the inner loop of our framework
 // This should:
 // - Check what message we got and which argument it is.
-// - FIXME: make up some timeframe id for now.
+// - Find out to which timeframe it belongs.
 // - Insert the header and the payload in the multimap.
 // - Check if any of the timeframes has all the required messages
-// - Invoke the process callback, if this is the case
 // - Forward the parts to the next stage
+// - Invoke the process callback, if this is the case, either directly
+//   or by handing the inputs to the worker pool
 bool
 DataProcessingDevice::HandleData(FairMQParts &parts, int /*index*/) {
   auto &metricsService = mServiceRegistry.get<MetricsService>();
@@ -105,14 +142,12 @@ DataProcessingDevice::HandleData(FairMQParts &parts, int /*index*/) {
       error("Unable to relay part.");
       return true;
     }
+    if (relayed == DataRelayer::Dropped) {
+      continue;
+    }
     LOG(DEBUG) << "Relaying part idx: " << headerIndex;
-    assert(mRelayer.getCacheSize() > 0);
   }
 
-  // Notice that compleated represent ONE set of complete
-  // inputs because an incoming message can complete only
-  // one pending set of inputs.
-  // FIXME: is the above true?!?!?!
   LOG(DEBUG) << "Getting parts to process";
   auto completed = mRelayer.getReadyToProcess();
 
@@ -123,20 +158,73 @@ DataProcessingDevice::HandleData(FairMQParts &parts, int /*index*/) {
   }
 
   assert(!mInputs.empty());
-  if (completed.readyInputs.size() != mInputs.size()) {
+  if (completed.readyInputs.size() % mInputs.size()) {
     std::ostringstream err;
     err << "Number of parts (" << completed.readyInputs.size()
-        << ") should match the declared inputs ("
+        << ") should be a multiple of the declared inputs ("
         << mInputs.size() << "). Dropping.";
     error(err.str().c_str());
     return true;
   }
 
+  // Forwarding happens before processing, so that downstream devices
+  // do not have to wait for us.
+  forwardInputs(completed.readyInputs);
+
+  // The relayer can complete more than one timeframe at the time. They are
+  // sorted by timeframe, each of them with one part per declared input.
+  for (size_t si = 0; si < completed.readyInputs.size(); si += mInputs.size()) {
+    InputSet inputs;
+    inputs.reserve(mInputs.size());
+    for (size_t ii = si; ii < si + mInputs.size(); ++ii) {
+      inputs.push_back(std::move(completed.readyInputs[ii]));
+    }
+
+    if (!mPool.size()) {
+      mContext.clear();
+      mRootContext.clear();
+      processInputs(inputs, mContext, mRootContext, mAllocator);
+      mPool.exclusive([this]() {
+        DataProcessor::doSend(*this, mContext);
+        DataProcessor::doSend(*this, mRootContext);
+      });
+      continue;
+    }
+
+    // Hand the inputs to the pool, waiting if all the workers are
+    // already busy and have something queued. The outputs are sent by
+    // the commit step, in the order the inputs were submitted.
+    auto shared = std::make_shared<InputSet>(std::move(inputs));
+    mPool.submit([this, shared](size_t wi) -> OrderedWorkerPool::Commit {
+      auto &worker = *mWorkers[wi];
+      worker.context.clear();
+      worker.rootContext.clear();
+      processInputs(*shared, worker.context, worker.rootContext, worker.allocator);
+      auto output = std::make_shared<PendingOutput>(PendingOutput{std::move(worker.context),
+                                                                  std::move(worker.rootContext)});
+      return [this, output]() {
+        DataProcessor::doSend(*this, output->context);
+        DataProcessor::doSend(*this, output->rootContext);
+      };
+    });
+  }
+  return true;
+}
+
+// Invokes the algorithm on a complete set of inputs, which will use
+// the provided @a allocator to create its outputs.
+void
+DataProcessingDevice::processInputs(InputSet &parts,
+                                    MessageContext &context,
+                                    RootObjectContext &rootContext,
+                                    DataAllocator &allocator) {
+  auto &metricsService = mServiceRegistry.get<MetricsService>();
   std::vector<DataRef> inputs;
+  inputs.reserve(parts.size());
 
-  for (auto &readyParts : completed.readyInputs) {
+  for (auto &readyParts : parts) {
     assert(readyParts.header->GetData());
-    assert(readyParts.header->GetSize() == 80);
+    assert(isValidHeaderStack(readyParts.header->GetData(), readyParts.header->GetSize()));
     assert(readyParts.payload->GetData());
     inputs.push_back(std::move(DataRef{nullptr,
                                reinterpret_cast<char *>(readyParts.header->GetData()),
@@ -146,76 +234,74 @@ DataProcessingDevice::HandleData(FairMQParts &parts, int /*index*/) {
   // The above check should enforce this, which
   // should never happen.
   assert(inputs.size() == mInputs.size());
-  mContext.clear();
-  mRootContext.clear();
+  // Whatever we produce belongs to the same timeframe as the inputs.
+  allocator.setTimeframeId(parts.front().timeframeId.value);
 
   // If we are here, we have a complete set of inputs,
   // therefore we dispatch the calculation, if available.
-  // After the computation is done, we get the output message
-  // context and we send the messages we find in it.
+  // After the computation is done, the caller gets the output message
+  // context and sends the messages it finds in it.
   try {
     if (mStatefulProcess) {
       LOG(DEBUG) << "PROCESSING:START";
       metricsService.post("dataprocessing/stateful_process", mProcessingCount++);
-      mStatefulProcess(inputs, mServiceRegistry, mAllocator);
+      mStatefulProcess(inputs, mServiceRegistry, allocator);
       LOG(DEBUG) << "PROCESSING:END";
     }
     if (mStatelessProcess) {
       LOG(DEBUG) << "PROCESSING:START";
       metricsService.post("dataprocessing/stateless_process", mProcessingCount++);
-      mStatelessProcess(inputs, mServiceRegistry, mAllocator);
+      mStatelessProcess(inputs, mServiceRegistry, allocator);
       LOG(DEBUG) << "PROCESSING:END";
     }
-    DataProcessor::doSend(*this, mContext);
-    DataProcessor::doSend(*this, mRootContext);
   } catch(std::exception &e) {
     LOG(DEBUG) << "Exception caught" << e.what() << std::endl;
     if (mError) {
       metricsService.post("error", 1);
+      std::lock_guard<std::mutex> lock(mErrorMutex);
       mError(inputs, mServiceRegistry, e);
     }
   }
+}
 
-  // Do the forwarding. We check if any of the inputs
-  // should be forwarded elsewhere.
-  // FIXME: do it in a smarter way than O(N^2)
+// Do the forwarding. All the inputs going to the same channel are sent
+// together as a single multipart message. The messages are shared with the
+// ones used by the algorithm, so nothing is copied.
+void
+DataProcessingDevice::forwardInputs(std::vector<DataRelayer::PartRef> &parts) {
+  if (mForwardRoutes.empty()) {
+    return;
+  }
   LOG(DEBUG) << "FORWARDING:START";
-  for (auto &input : completed.readyInputs) {
+  std::vector<FairMQParts> forwardedParts(mForwardChannels.size());
+  for (auto &input : parts) {
     assert(input.header);
-    assert(input.header->GetSize() == 80);
-    //auto h = o2::Header::get<DataHeader>(input.header->GetData());
-    auto h = reinterpret_cast<DataHeader*>(input.header->GetData());
-    if (!h) {
-      error("Header is not a DataHeader?");
+    assert(isValidHeaderStack(input.header->GetData(), input.header->GetSize()));
+    auto h = reinterpret_cast<const DataHeader*>(input.header->GetData());
+    auto route = mForwardRoutes.find(DataSpecKey::fromHeader(*h));
+    if (route == mForwardRoutes.end()) {
       continue;
     }
-    for (auto forward : mForwards) {
-      // This should check if any of the parts can be forwarded and
-      // where.
-      if (strncmp(h->magicString, "O2O2", 4)) {
-        error("Could not find magic string");
-      }
-      LOG(DEBUG) << "Input part content";
-      LOG(DEBUG) << h->dataOrigin.str;
-      LOG(DEBUG) << h->dataDescription.str;
-      LOG(DEBUG) << h->subSpecification;
-      if (DataSpecUtils::match(forward.second, h->dataOrigin,
-                               h->dataDescription,
-                               h->subSpecification)) {
-        LOG(DEBUG) << "Forwarding data to " << forward.first;
-        FairMQParts forwardedParts;
-        forwardedParts.AddPart(std::move(input.header));
-        forwardedParts.AddPart(std::move(input.payload));
-        // FIXME: this should use a correct subchannel
-        this->Send(forwardedParts, forward.first, 0);
-      }
+    for (auto channelIdx : route->second) {
+      LOG(DEBUG) << "Forwarding data to " << mForwardChannels[channelIdx];
+      FairMQMessagePtr header(NewMessage());
+      FairMQMessagePtr payload(NewMessage());
+      header->Copy(input.header);
+      payload->Copy(input.payload);
+      forwardedParts[channelIdx].AddPart(std::move(header));
+      forwardedParts[channelIdx].AddPart(std::move(payload));
+    }
+  }
+  for (size_t ci = 0; ci < mForwardChannels.size(); ++ci) {
+    if (forwardedParts[ci].Size() == 0) {
+      continue;
     }
+    // FIXME: this should use a correct subchannel
+    mPool.exclusive([this, &forwardedParts, ci]() {
+      this->Send(forwardedParts[ci], mForwardChannels[ci], 0);
+    });
   }
   LOG(DEBUG) << "FORWARDING:END";
-
-  // Once we are done, we can start processing a new set of inputs.
-  inputs.clear();
-  return true;
 }
 
 void
@@ -0,0 +1,51 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/DataProcessingHeader.h"
+
+namespace o2 {
+namespace framework {
+
+// storage for DataProcessingHeader static members
+const uint32_t DataProcessingHeader::sVersion = 1;
+const o2::Header::HeaderType DataProcessingHeader::sHeaderType = Header::String2<uint64_t>("DataFlow");
+const o2::Header::SerializationMethod DataProcessingHeader::sSerializationMethod = o2::Header::gSerializationMethodNone;
+
+bool isValidHeaderStack(const void *buffer, size_t size) {
+  using namespace o2::Header;
+  auto bytes = reinterpret_cast<const byte *>(buffer);
+  if (size < sizeof(DataHeader)) {
+    return false;
+  }
+  auto current = BaseHeader::get(bytes);
+  if (!current
+      || current->description != DataHeader::sHeaderType
+      || current->size() != sizeof(DataHeader)) {
+    return false;
+  }
+  size_t offset = 0;
+  while (true) {
+    offset += current->size();
+    if (!current->flagsNextHeader) {
+      return offset == size;
+    }
+    if (offset + sizeof(BaseHeader) > size) {
+      return false;
+    }
+    current = BaseHeader::get(bytes + offset);
+    if (!current
+        || current->size() < sizeof(BaseHeader)
+        || offset + current->size() > size) {
+      return false;
+    }
+  }
+}
+
+} // namespace framework
+} // namespace o2
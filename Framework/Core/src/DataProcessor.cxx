@@ -10,6 +10,7 @@
 #include "Framework/DataProcessor.h"
 #include "Framework/RootObjectContext.h"
 #include "Framework/MessageContext.h"
+#include "Framework/DataProcessingHeader.h"
 #include "Framework/TMessageSerializer.h"
 #include "Headers/DataHeader.h"
 #include <TClonesArray.h>
@@ -29,7 +30,7 @@ void DataProcessor::doSend(FairMQDevice &device, MessageContext &context) {
     FairMQParts parts = std::move(message.parts);
     assert(message.parts.Size() == 0);
     assert(parts.Size() == 2);
-    assert(parts.At(0)->GetSize() == 80);
+    assert(isValidHeaderStack(parts.At(0)->GetData(), parts.At(0)->GetSize()));
     device.Send(parts, message.channel, message.index);
     assert(parts.Size() == 2);
   }
@@ -8,184 +8,237 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include "Framework/DataRelayer.h"
+#include "Framework/DataProcessingHeader.h"
 #include "Framework/DataSpecUtils.h"
 #include "Framework/MetricsService.h"
+#include "Headers/HeartbeatFrame.h"
 #include "fairmq/FairMQLogger.h"
 
+#include <algorithm>
+#include <cassert>
+
 using DataHeader = o2::Header::DataHeader;
 
 namespace o2 {
 namespace framework {
 
+constexpr DataRelayer::TimeframeId DataRelayer::sInvalidTimeframeId;
+constexpr size_t DataRelayer::sDefaultPipelineLength;
+
 // FIXME: do we really need to pass the forwards?
 DataRelayer::DataRelayer(const InputsMap &inputs,
                          const ForwardsMap &forwards,
-                         MetricsService &metrics)
+                         MetricsService &metrics,
+                         size_t pipelineLength)
 : mInputs{inputs},
   mForwards{forwards},
-  mMetrics{metrics}
+  mMetrics{metrics},
+  mCompletionTimeout{0},
+  mPendingParts{0}
 {
+  assert(pipelineLength > 0);
+  // The position of an input is given by the iteration order of the map,
+  // which is also the order in which the parts are handed to the algorithm.
+  size_t inputIdx = 0;
+  for (auto &input : mInputs) {
+    mInputIndex.emplace(DataSpecKey::fromSpec(input.second), inputIdx++);
+  }
+  mSlots.resize(pipelineLength, TimeframeSlot{sInvalidTimeframeId, 0, {}, sInvalidTimeframeId});
+  mCache.resize(pipelineLength * mInputs.size());
+  mNextTimeframe.resize(mInputs.size(), TimeframeId{0});
+  mReadySlots.reserve(pipelineLength);
 }
 
 size_t
-assignInputSpecId(void *data, DataRelayer::InputsMap &specs) {
-  size_t inputIdx = 0;
-  for (auto &input : specs) {
-    const DataHeader *h = reinterpret_cast<const DataHeader*>(data);
-
-    if (DataSpecUtils::match(input.second,
-                             h->dataOrigin,
-                             h->dataDescription,
-                             h->subSpecification)) {
-      return inputIdx;
-    }
-    inputIdx++;
+DataRelayer::getInputIndex(const DataHeader &header) const {
+  auto ii = mInputIndex.find(DataSpecKey::fromHeader(header));
+  if (ii == mInputIndex.end()) {
+    return mInputs.size();
+  }
+  return ii->second;
+}
+
+void
+DataRelayer::dropSlot(size_t slotIdx) {
+  auto &slot = mSlots[slotIdx];
+  size_t numInputs = mInputs.size();
+  for (size_t ii = 0; ii < numInputs; ++ii) {
+    auto &part = mCache[slotIdx * numInputs + ii];
+    part.header.reset();
+    part.payload.reset();
+  }
+  mPendingParts -= slot.filled;
+  releaseSlot(slot);
+}
+
+void
+DataRelayer::releaseSlot(TimeframeSlot &slot) {
+  slot.lastDone = slot.timeframeId;
+  slot.timeframeId = sInvalidTimeframeId;
+  slot.filled = 0;
+}
+
+void
+DataRelayer::setCompletionTimeout(std::chrono::milliseconds timeout) {
+  mCompletionTimeout = timeout;
+}
+
+// Find out to which timeframe a part belongs by looking at the header stack.
+// If no timing information is present, we assume that we cannot have
+// overlapping timeframes and that the payloads for different timeframes are
+// received in order, i.e. that the n-th part received for a given input
+// belongs to the n-th timeframe.
+DataRelayer::TimeframeId
+DataRelayer::getTimeframeId(const DataHeader &header, size_t inputIdx) {
+  auto dph = o2::Header::get<DataProcessingHeader>(&header);
+  if (dph) {
+    return TimeframeId{dph->startTime};
+  }
+  auto hbf = o2::Header::get<o2::Header::HeartbeatFrameEnvelope>(&header);
+  if (hbf) {
+    return TimeframeId{hbf->header.orbit};
   }
-  return inputIdx;
+  return TimeframeId{mNextTimeframe[inputIdx].value++};
 }
 
 DataRelayer::RelayChoice
 DataRelayer::relay(std::unique_ptr<FairMQMessage> &&header,
                    std::unique_ptr<FairMQMessage> &&payload) {
+  if (!isValidHeaderStack(header->GetData(), header->GetSize())) {
+    LOG(ERROR) << "Dropping part with an invalid header stack of size "
+               << header->GetSize();
+    mMetrics.post("inputs/relayed/invalid", (int)header->GetSize());
+    return Dropped;
+  }
   // Find out which input is this and assign a valid id to it.
-  size_t inputIdx = assignInputSpecId(header->GetData(), mInputs);
+  const DataHeader *h = reinterpret_cast<const DataHeader*>(header->GetData());
+  size_t inputIdx = getInputIndex(*h);
   // If this is true, it means the message we got does
   // not match any of the expected inputs.
   if (inputIdx == mInputs.size()) {
     return WillNotRelay;
   }
 
-  // Calculate the mask for the given index and verify
-  size_t inputMask = 1 << inputIdx;
-
-  // FIXME: for the moment we assume that we cannot have overlapping timeframes and
-  //        that same payload for the two different timeframes will be processed
-  //        in order. This might actually not be the case and we would need some
-  //        way of marking to which timeframe each (header,payload) belongs.
-  if (mCompletion.empty()) {
-    mCompletion.emplace_back(CompletionMask{TimeframeId{0},0});
-  }
-  assert(!mCompletion.empty());
-  // The input is already there for current timeframe. We assume this
-  // means we got an input for the next timeframe, therefore we add a new
-  // entry.
-  if (mCompletion.back().mask & inputMask) {
-    LOG(DEBUG) << "Got an entry for the next timeframe";
-    TimeframeId nextTimeframe = TimeframeId{mCompletion.back().timeframeId.value + 1};
-    mCompletion.push_back(CompletionMask{nextTimeframe, 0});
+  TimeframeId timeframeId = getTimeframeId(*h, inputIdx);
+
+  size_t numInputs = mInputs.size();
+  size_t slotIdx = timeframeId.value % mSlots.size();
+  auto &slot = mSlots[slotIdx];
+  if (slot.timeframeId.value != timeframeId.value) {
+    // The timeframe was already completed or dropped, the part is either
+    // a duplicate or arrived too late.
+    if (slot.lastDone.value != sInvalidTimeframeId.value
+        && timeframeId.value <= slot.lastDone.value) {
+      LOG(ERROR) << "Dropping part for timeframe " << timeframeId.value
+                 << " which was already completed or dropped";
+      mMetrics.post("inputs/relayed/late", (int)timeframeId.value);
+      return Dropped;
+    }
+    if (slot.timeframeId.value != sInvalidTimeframeId.value) {
+      // The slot is taken by a newer timeframe, which means we are already
+      // past the one of this part.
+      if (slot.timeframeId.value > timeframeId.value) {
+        LOG(ERROR) << "Dropping part for timeframe " << timeframeId.value
+                   << " which is older than the ones in flight";
+        mMetrics.post("inputs/relayed/late", (int)timeframeId.value);
+        return Dropped;
+      }
+      // The slot is still taken by an older timeframe which never got
+      // completed. We cannot keep more than mSlots.size() timeframes
+      // in flight, so we drop the old one.
+      LOG(ERROR) << "Dropping incomplete timeframe " << slot.timeframeId.value
+                 << " to make room for timeframe " << timeframeId.value;
+      mMetrics.post("inputs/relayed/dropped", (int)slot.timeframeId.value);
+      dropSlot(slotIdx);
+    }
+    slot.timeframeId = timeframeId;
+    if (mCompletionTimeout.count()) {
+      slot.created = std::chrono::steady_clock::now();
+    }
   }
 
-  TimeframeId inputTimeframeId = sInvalidTimeframeId;
-  // We associate the payload to the first empty spot
-  for (auto &completion : mCompletion) {
-    if ((completion.mask & inputMask) == 0) {
-      completion.mask |= inputMask;
-      inputTimeframeId = completion.timeframeId;
-      LOG(DEBUG) << "Completion mask for timeframe " << completion.timeframeId.value
-                 << " is " << completion.mask;
-      break;
-    }
+  auto &part = mCache[slotIdx * numInputs + inputIdx];
+  if (part.header) {
+    LOG(ERROR) << "Dropping duplicate part for input " << inputIdx
+               << " of timeframe " << timeframeId.value;
+    mMetrics.post("inputs/relayed/duplicate", (int)timeframeId.value);
+    return Dropped;
+  }
+  part.timeframeId = timeframeId;
+  part.partPos = inputIdx;
+  part.header = std::move(header);
+  part.payload = std::move(payload);
+  mPendingParts++;
+
+  if (++slot.filled == numInputs) {
+    LOG(DEBUG) << "Input from timeframe " << timeframeId.value
+               << " is complete.";
+    mReadySlots.push_back(slotIdx);
   }
-  assert(inputTimeframeId.value != sInvalidTimeframeId.value);
-  mCache.push_back(std::move(PartRef{inputTimeframeId,
-                                     inputIdx,
-                                     std::move(header),
-                                     std::move(payload)}));
 
-  LOG(DEBUG) << "Adding one part to the cache. Cache size is " << mCache.size();
+  LOG(DEBUG) << "Adding one part to the cache. Cache size is " << mPendingParts;
   return WillRelay;
 }
 
-DataRelayer::DataReadyInfo
-DataRelayer::getReadyToProcess() {
-  size_t allInputsMask = (1 << mInputs.size()) - 1;
-  std::vector<TimeframeId> readyInputs;
-
-  decltype(mCompletion) newCompletion;
-  newCompletion.reserve(mCompletion.size());
-
-  for (auto &completion : mCompletion) {
-    if (completion.mask == allInputsMask) {
-      LOG(DEBUG) << "Input from timeframe " << completion.timeframeId.value
-                 << " is complete.";
-      readyInputs.push_back(completion.timeframeId);
-    } else {
-      newCompletion.push_back(completion);
+// Drop all the timeframes which did not get completed in time.
+void
+DataRelayer::expireSlots() {
+  auto now = std::chrono::steady_clock::now();
+  size_t numInputs = mInputs.size();
+  for (size_t si = 0; si < mSlots.size(); ++si) {
+    auto &slot = mSlots[si];
+    if (slot.timeframeId.value == sInvalidTimeframeId.value
+        || slot.filled == numInputs
+        || now - slot.created < mCompletionTimeout) {
+      continue;
     }
+    LOG(ERROR) << "Timeframe " << slot.timeframeId.value
+               << " not completed in time. Dropping it.";
+    mMetrics.post("inputs/relayed/expired", (int)slot.timeframeId.value);
+    dropSlot(si);
   }
-  // We remove the completed timeframes from the list of what needs to be
-  // completed.
-  mCompletion.swap(newCompletion);
-
-  // We sort so that outputs are ordered correctly
-  std::sort(mCache.begin(), mCache.end());
+}
 
-  // We create a vector with all the parts which can be processed
+DataRelayer::DataReadyInfo
+DataRelayer::getReadyToProcess() {
   DataReadyInfo result;
+  if (mCompletionTimeout.count()) {
+    expireSlots();
+  }
+  if (mReadySlots.empty()) {
+    return result;
+  }
 
-  size_t rti = 0;
-  size_t ci = 0;
-  decltype(mCache) newCache;
-
-  while (true) {
-    // We do not have any more ready inputs to process
-    if (rti >= readyInputs.size()) {
-      LOG(DEBUG) << "All " << readyInputs.size() << " entries processed";
-      break;
-    }
-
-    // We do not have any more cache items to process
-    // (can this happen????)
-    if (ci >= mCache.size()) {
-      LOG(DEBUG) << "No more entries in cache to process";
-      break;
+  // We sort so that outputs are ordered correctly. Only the completed
+  // slots are sorted, which usually means only one.
+  std::sort(mReadySlots.begin(), mReadySlots.end(),
+            [this](size_t a, size_t b) -> bool {
+              return mSlots[a].timeframeId.value < mSlots[b].timeframeId.value;
+            });
+
+  size_t numInputs = mInputs.size();
+  result.readyInputs.reserve(mReadySlots.size() * numInputs);
+  for (auto slotIdx : mReadySlots) {
+    auto &slot = mSlots[slotIdx];
+    // The slot might have been dropped and reused after it was completed.
+    if (slot.filled != numInputs) {
+      continue;
     }
-
-    assert(rti < readyInputs.size());
-    assert(ci < mCache.size());
-    TimeframeId &ready = readyInputs[rti];
-    PartRef &part = mCache[ci];
-    // There are three possibilities:
-    // - We are now processing parts which are older
-    //   than the current ready timeframe we are processing
-    //   move to the next ready timeframe.
-    // - The part in question belongs to the current timeframe
-    //   id. Will append it to the list of those to be processed.
-    // - If we are here it means that the current timeframe is
-    //   larger than the one of the part we are looking at,
-    //   we therefore need to keep it for later.
-    if (ready.value < part.timeframeId.value) {
-      LOG(DEBUG) << "Timeframe " << part.timeframeId.value
-                 << " is not ready. Skipping";
-      ++rti;
-    } else if (ready.value == part.timeframeId.value) {
-      LOG(DEBUG) << "Timeframe " << part.timeframeId.value
-                 << " is ready. Adding it to results";
-      result.readyInputs.push_back(std::move(part));
-      ++ci;
-    } else {
-      LOG(DEBUG) << "Timeframe " << part.timeframeId.value
-                 << " is not ready. Putting it back in cache";
-      newCache.push_back(std::move(part));
-      ++ci;
+    for (size_t ii = 0; ii < numInputs; ++ii) {
+      result.readyInputs.push_back(std::move(mCache[slotIdx * numInputs + ii]));
     }
+    mPendingParts -= numInputs;
+    releaseSlot(slot);
   }
+  mReadySlots.clear();
 
-  // Add the remaining bits to the new cache
-  while(ci < mCache.size()) {
-    newCache.push_back(std::move(mCache[ci]));
-    ci++;
-  }
-
-  // Cleanup the parts which have been scheduled for processing
-  mCache.swap(newCache);
   assert(result.readyInputs.size() % mInputs.size() == 0);
-  return std::move(result);
+  return result;
 }
 
 size_t
 DataRelayer::getCacheSize() const {
-  return mCache.size();
+  return mPendingParts;
 }
 
 }
@@ -27,7 +27,8 @@ DataSourceDevice::DataSourceDevice(const DeviceSpec &spec, ServiceRegistry &regi
   mError{spec.algorithm.onError},
   mConfigRegistry{nullptr},
   mAllocator{this,&mContext,&mRootContext,spec.outputs},
-  mServiceRegistry{registry}
+  mServiceRegistry{registry},
+  mTimeframeId{0}
 {
 }
 
@@ -53,6 +54,8 @@ bool DataSourceDevice::ConditionalRun() {
   try {
     mContext.clear();
     mRootContext.clear();
+    // Each invocation of a source creates a new timeframe.
+    mAllocator.setTimeframeId(mTimeframeId++);
 
     // Avoid runaway process in case we have nothing to do.
     if ((!mStatefulProcess) && (!mStatelessProcess)) {
@@ -29,6 +29,93 @@ bool parseMetric(const std::string &s, std::smatch &match) {
   return std::regex_match(s, match, metricsRE);
 }
 
+// Find the metric based on the label. Create it if not found.
+//
+// @returns the index of the metric in info.metrics or -1 if the metric
+//          could not be created
+size_t findOrCreateMetric(const std::string &name,
+                          MetricType metricType,
+                          DeviceMetricsInfo &info) {
+  using IndexElement = std::pair<std::string, size_t>;
+  auto cmpFn = [](const IndexElement &a, const IndexElement &b) -> bool {
+    return std::tie(a.first, a.second) < std::tie(b.first, b.second);
+  };
+  IndexElement metricLabelIdx = std::make_pair(name, 0);
+  auto mi = std::lower_bound(info.metricLabelsIdx.begin(),
+                             info.metricLabelsIdx.end(),
+                             metricLabelIdx,
+                             cmpFn);
+
+  // We found the metric.
+  if (mi != info.metricLabelsIdx.end()
+      && mi->first == metricLabelIdx.first) {
+    return mi->second;
+  }
+
+  // We could not find the metric, lets insert a new one.
+  // Create a new metric
+  MetricInfo metricInfo;
+  metricInfo.pos = 0;
+  metricInfo.type = metricType;
+  // Add a new empty buffer for it of the correct kind
+  switch(metricType) {
+    case MetricType::Int:
+      metricInfo.storeIdx = info.intMetrics.size();
+      info.intMetrics.emplace_back(std::array<int, 1024>{0});
+      break;
+    case MetricType::Float:
+      metricInfo.storeIdx = info.floatMetrics.size();
+      info.floatMetrics.emplace_back(std::array<float, 1024>{0});
+      break;
+    default:
+      return -1;
+  };
+  // Add the timestamp buffer for it
+  info.timestamps.emplace_back(std::array<size_t, 1024>{0});
+
+  // Add the index by name in the correct position
+  // this will require moving the tail of the index,
+  // but inserting should happen only once for each metric,
+  // so who cares.
+  metricLabelIdx.second = info.metrics.size();
+  info.metricLabelsIdx.insert(mi, metricLabelIdx);
+  // Add the the actual Metric info to the store
+  size_t metricIndex = info.metrics.size();
+  info.metrics.push_back(metricInfo);
+  return metricIndex;
+}
+
+// Save the timestamp for the metric at @a metricIndex and update the
+// position where to write the next value of the circular buffer.
+static void advanceMetric(size_t metricIndex, size_t timestamp, DeviceMetricsInfo &info) {
+  MetricInfo &metricInfo = info.metrics[metricIndex];
+  auto mod = info.timestamps[metricIndex].size();
+  info.timestamps[metricIndex][metricInfo.pos] = timestamp;
+  metricInfo.pos = (metricInfo.pos + 1) % mod;
+}
+
+bool addMetricSample(size_t metricIndex, size_t timestamp, int value,
+                     DeviceMetricsInfo &info) {
+  MetricInfo &metricInfo = info.metrics[metricIndex];
+  if (metricInfo.type != MetricType::Int) {
+    return false;
+  }
+  info.intMetrics[metricInfo.storeIdx][metricInfo.pos] = value;
+  advanceMetric(metricIndex, timestamp, info);
+  return true;
+}
+
+bool addMetricSample(size_t metricIndex, size_t timestamp, float value,
+                     DeviceMetricsInfo &info) {
+  MetricInfo &metricInfo = info.metrics[metricIndex];
+  if (metricInfo.type != MetricType::Float) {
+    return false;
+  }
+  info.floatMetrics[metricInfo.storeIdx][metricInfo.pos] = value;
+  advanceMetric(metricIndex, timestamp, info);
+  return true;
+}
+
 // and fills the appropriatate DeviceInfo plot accordingly.
 //
 // @matches is the regexp_matches from the metric identifying regex
@@ -38,13 +125,13 @@ bool processMetric(const std::smatch &match,
   auto type = match[1];
   auto name = match[2];
   char *ep = nullptr;
-  auto timestamp = strtol(match[3].str().c_str(), &ep, 10);
+  // Keep the strings alive while ep points into them.
+  auto timestampString = match[3].str();
+  auto timestamp = strtol(timestampString.c_str(), &ep, 10);
   if (ep == nullptr || *ep != '\0') {
     return false;
   }
-  auto stringValue = match[4];
-
-  size_t metricIndex = -1;
+  auto stringValue = match[4].str();
 
   auto metricType = MetricType::Unknown;
   if (type.str() == "int") {
@@ -53,86 +140,33 @@ bool processMetric(const std::smatch &match,
     metricType = MetricType::Float;
   }
 
-  // Find the metric based on the label. Create it if not found.
-  using IndexElement = std::pair<std::string, size_t>;
-  auto cmpFn = [](const IndexElement &a, const IndexElement &b) -> bool {
-    return std::tie(a.first, a.second) < std::tie(b.first, b.second);
-  };
-  IndexElement metricLabelIdx = std::make_pair(name.str(), 0);
-  auto mi = std::lower_bound(info.metricLabelsIdx.begin(),
-                             info.metricLabelsIdx.end(),
-                             metricLabelIdx,
-                             cmpFn);
-
-  // We could not find the metric, lets insert a new one.
-  if (mi == info.metricLabelsIdx.end()
-      || mi->first != metricLabelIdx.first) {
-    // Create a new metric
-    MetricInfo metricInfo;
-    metricInfo.pos = 0;
-    metricInfo.type = metricType;
-    // Add a new empty buffer for it of the correct kind
-    switch(metricType) {
-      case MetricType::Int:
-        metricInfo.storeIdx = info.intMetrics.size();
-        info.intMetrics.emplace_back(std::array<int, 1024>{0});
-        break;
-      case MetricType::Float:
-        metricInfo.storeIdx = info.floatMetrics.size();
-        info.floatMetrics.emplace_back(std::array<float, 1024>{0});
-        break;
-      default:
-        return false;
-    };
-    // Add the timestamp buffer for it
-    info.timestamps.emplace_back(std::array<size_t, 1024>{0});
-
-    // Add the index by name in the correct position
-    // this will require moving the tail of the index,
-    // but inserting should happen only once for each metric,
-    // so who cares.
-    metricLabelIdx.second = info.metrics.size();
-    info.metricLabelsIdx.insert(mi, metricLabelIdx);
-    // Add the the actual Metric info to the store
-    metricIndex = info.metrics.size();
-    info.metrics.push_back(metricInfo);
-  } else {
-    metricIndex = mi->second;
+  size_t metricIndex = findOrCreateMetric(name.str(), metricType, info);
+  if (metricIndex == (size_t) -1) {
+    return false;
   }
-  assert(metricIndex != -1);
   // We are now guaranteed our metric is present at metricIndex.
   MetricInfo &metricInfo = info.metrics[metricIndex];
 
   int intValue = 0;
   float floatValue = 0;
-  auto mod = info.timestamps[metricIndex].size();
 
   switch(metricInfo.type) {
     case MetricType::Int:
-      intValue = strtol(stringValue.str().c_str(), &ep, 10);
+      intValue = strtol(stringValue.c_str(), &ep, 10);
       if (!ep || *ep != '\0') {
         return false;
       }
-      info.intMetrics[metricInfo.storeIdx][metricInfo.pos] = intValue;
-      break;
+      return addMetricSample(metricIndex, timestamp, intValue, info);
     case MetricType::Float:
-      floatValue = strtof(stringValue.str().c_str(), &ep);
+      floatValue = strtof(stringValue.c_str(), &ep);
       if (!ep || *ep != '\0') {
         return false;
       }
-      info.floatMetrics[metricInfo.storeIdx][metricInfo.pos] = floatValue;
-      break;
+      return addMetricSample(metricIndex, timestamp, floatValue, info);
     default:
       return false;
       break;
   };
-
-  // Save the timestamp for the current metric we do it here
-  // so that we do not update timestamps for broken metrics
-  info.timestamps[metricIndex][metricInfo.pos] = timestamp;
-  // Update the position where to write the next metric
-  metricInfo.pos = (metricInfo.pos + 1) % mod;
-  return true;
 }
 
 size_t
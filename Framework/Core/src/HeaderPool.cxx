@@ -0,0 +1,58 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/HeaderPool.h"
+
+#include <map>
+#include <memory>
+#include <new>
+
+namespace o2 {
+namespace framework {
+
+HeaderPool::HeaderPool(size_t bufferSize)
+: mBufferSize{bufferSize}
+{
+}
+
+HeaderPool &
+HeaderPool::get(size_t bufferSize) {
+  static std::mutex poolsMutex;
+  // Pools are leaked on purpose, see the class documentation.
+  static auto pools = new std::map<size_t, HeaderPool *>;
+  std::lock_guard<std::mutex> lock(poolsMutex);
+  auto &pool = (*pools)[bufferSize];
+  if (!pool) {
+    pool = new HeaderPool(bufferSize);
+  }
+  return *pool;
+}
+
+void *
+HeaderPool::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFree.empty()) {
+      void *buffer = mFree.back();
+      mFree.pop_back();
+      return buffer;
+    }
+  }
+  return ::operator new(mBufferSize);
+}
+
+void
+HeaderPool::release(void *data, void *hint) {
+  auto pool = reinterpret_cast<HeaderPool *>(hint);
+  std::lock_guard<std::mutex> lock(pool->mMutex);
+  pool->mFree.push_back(data);
+}
+
+} // namespace framework
+} // namespace o2
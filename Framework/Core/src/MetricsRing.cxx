@@ -0,0 +1,184 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/MetricsRing.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o2 {
+namespace framework {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "MetricsRing requires lock free 64 bit atomics to be shared between processes");
+
+constexpr size_t MetricsRing::sMaxLabels;
+constexpr size_t MetricsRing::sMaxLabelSize;
+constexpr uint32_t MetricsRing::sMagic;
+
+size_t
+MetricsRing::bufferSize(size_t capacity) {
+  return sizeof(Layout) + capacity * sizeof(MetricSample);
+}
+
+std::string
+MetricsRing::nameForDevice(const std::string &deviceId) {
+  return "/o2-metrics-" + deviceId;
+}
+
+MetricsRing::MetricsRing(void *buffer, size_t capacity, bool initialise)
+: mLayout{reinterpret_cast<Layout*>(buffer)},
+  mSamples{reinterpret_cast<MetricSample*>(reinterpret_cast<char*>(buffer) + sizeof(Layout))},
+  mCapacity{capacity},
+  mMask{capacity - 1},
+  mShmName{},
+  mMappedSize{0},
+  mOwner{false}
+{
+  // The capacity must be a power of two so that the position in the
+  // ring is a simple mask of the ever increasing indices.
+  assert(capacity && (capacity & (capacity - 1)) == 0);
+  if (initialise) {
+    new (mLayout) Layout;
+    mLayout->magic = sMagic;
+    mLayout->capacity = capacity;
+    mLayout->creatorPid.store(0);
+    mLayout->head.store(0);
+    mLayout->tail.store(0);
+    mLayout->dropped.store(0);
+    mLayout->labelsCount.store(0);
+  }
+}
+
+MetricsRing::~MetricsRing() {
+  if (mMappedSize) {
+    munmap(mLayout, mMappedSize);
+  }
+  if (mOwner) {
+    shm_unlink(mShmName.c_str());
+  }
+}
+
+std::unique_ptr<MetricsRing>
+MetricsRing::create(const std::string &name, size_t capacity) {
+  // Get rid of leftovers of a previous run.
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  size_t size = bufferSize(capacity);
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void *buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  auto ring = std::make_unique<MetricsRing>(buffer, capacity, true);
+  ring->mShmName = name;
+  ring->mMappedSize = size;
+  ring->mOwner = true;
+  ring->mLayout->creatorPid.store(getpid(), std::memory_order_release);
+  return ring;
+}
+
+std::unique_ptr<MetricsRing>
+MetricsRing::attach(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(Layout)) {
+    close(fd);
+    return nullptr;
+  }
+  void *buffer = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    return nullptr;
+  }
+  auto layout = reinterpret_cast<Layout*>(buffer);
+  if (layout->magic != sMagic
+      || bufferSize(layout->capacity) > (size_t) st.st_size) {
+    munmap(buffer, st.st_size);
+    return nullptr;
+  }
+  auto ring = std::make_unique<MetricsRing>(buffer, layout->capacity, false);
+  ring->mShmName = name;
+  ring->mMappedSize = st.st_size;
+  return ring;
+}
+
+int
+MetricsRing::registerLabel(const char *label) {
+  uint32_t id = mLayout->labelsCount.load(std::memory_order_relaxed);
+  if (id >= sMaxLabels) {
+    return -1;
+  }
+  strncpy(mLayout->labels[id], label, sMaxLabelSize - 1);
+  mLayout->labels[id][sMaxLabelSize - 1] = '\0';
+  // Publish the label before any sample can refer to it.
+  mLayout->labelsCount.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+size_t
+consumeMetrics(MetricsRing &ring,
+               std::vector<size_t> &metricIndices,
+               DeviceMetricsInfo &info) {
+  constexpr size_t batchSize = 256;
+  MetricSample samples[batchSize];
+  size_t total = 0;
+  size_t n = 0;
+  while ((n = ring.pop(samples, batchSize))) {
+    for (size_t si = 0; si < n; ++si) {
+      auto &sample = samples[si];
+      // A label is always registered before the first sample using it
+      // is pushed.
+      if (sample.id >= metricIndices.size()) {
+        metricIndices.resize(ring.labelsCount(), -1);
+      }
+      assert(sample.id < metricIndices.size());
+      auto &metricIndex = metricIndices[sample.id];
+      if (metricIndex == (size_t) -1) {
+        metricIndex = findOrCreateMetric(ring.label(sample.id), sample.type, info);
+      }
+      if (metricIndex == (size_t) -1) {
+        continue;
+      }
+      switch (sample.type) {
+        case MetricType::Int:
+          addMetricSample(metricIndex, sample.timestamp, sample.intValue, info);
+          break;
+        case MetricType::Float:
+          addMetricSample(metricIndex, sample.timestamp, sample.floatValue, info);
+          break;
+        default:
+          break;
+      }
+    }
+    total += n;
+  }
+  return total;
+}
+
+} // namespace framework
+} // namespace o2
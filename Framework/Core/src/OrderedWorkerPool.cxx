@@ -0,0 +1,112 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/OrderedWorkerPool.h"
+#include "fairmq/FairMQLogger.h"
+
+#include <cassert>
+#include <exception>
+
+namespace o2 {
+namespace framework {
+
+OrderedWorkerPool::~OrderedWorkerPool() {
+  stop();
+}
+
+void
+OrderedWorkerPool::start(size_t workers) {
+  if (!mThreads.empty()) {
+    return;
+  }
+  // Nothing is queued or pending once the pool has been stopped, so the
+  // sequence can start from scratch.
+  mStop = false;
+  mNextSequence = 0;
+  mNextToCommit = 0;
+  for (size_t wi = 0; wi < workers; ++wi) {
+    mThreads.emplace_back([this, wi]() { run(wi); });
+  }
+}
+
+void
+OrderedWorkerPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mQueueMutex);
+    mStop = true;
+  }
+  mWorkAvailable.notify_all();
+  for (auto &thread : mThreads) {
+    thread.join();
+  }
+  mThreads.clear();
+}
+
+void
+OrderedWorkerPool::submit(Task task) {
+  assert(!mThreads.empty());
+  std::unique_lock<std::mutex> lock(mQueueMutex);
+  mWorkConsumed.wait(lock, [this]() {
+    return mQueue.size() < mThreads.size();
+  });
+  mQueue.emplace_back(mNextSequence++, std::move(task));
+  lock.unlock();
+  mWorkAvailable.notify_one();
+}
+
+// Main loop of each worker thread: pick up the next task, run it and hand
+// its commit step to the ordered stage. The queue is drained before exiting.
+void
+OrderedWorkerPool::run(size_t worker) {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mQueueMutex);
+    mWorkAvailable.wait(lock, [this]() {
+      return mStop || !mQueue.empty();
+    });
+    if (mQueue.empty()) {
+      return;
+    }
+    auto item = std::move(mQueue.front());
+    mQueue.pop_front();
+    lock.unlock();
+    mWorkConsumed.notify_one();
+
+    Commit step;
+    try {
+      step = item.second(worker);
+    } catch (std::exception &e) {
+      // The following tasks must still be committed.
+      LOG(ERROR) << "Task " << item.first << " failed: " << e.what();
+    }
+    commit(item.first, std::move(step));
+  }
+}
+
+// Whoever completes the next expected task commits it, together with all the
+// following ones which are already done.
+void
+OrderedWorkerPool::commit(size_t sequence, Commit &&step) {
+  std::lock_guard<std::mutex> lock(mCommitMutex);
+  mPendingCommits.emplace(sequence, std::move(step));
+  auto next = mPendingCommits.begin();
+  while (next != mPendingCommits.end() && next->first == mNextToCommit) {
+    try {
+      if (next->second) {
+        next->second();
+      }
+    } catch (std::exception &e) {
+      LOG(ERROR) << "Commit of task " << next->first << " failed: " << e.what();
+    }
+    next = mPendingCommits.erase(next);
+    ++mNextToCommit;
+  }
+}
+
+} // namespace framework
+} // namespace o2
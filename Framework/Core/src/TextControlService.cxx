@@ -17,14 +17,10 @@ namespace o2 {
 namespace framework {
 
 // All we do is to printout
+// A single write, so that the line is not interleaved with other output
+// when invoked from several threads.
 void TextControlService::readyToQuit(bool all) {
-  std::cout << "CONTROL_ACTION: READY_TO_QUIT";
-  if (all) {
-    std::cout << "_ALL";
-  } else {
-    std::cout << "_ME";
-  }
-  std::cout << std::endl;
+  std::cout << (all ? "CONTROL_ACTION: READY_TO_QUIT_ALL\n" : "CONTROL_ACTION: READY_TO_QUIT_ME\n") << std::flush;
 }
 
 bool parseControl(const std::string &s, std::smatch &match) {
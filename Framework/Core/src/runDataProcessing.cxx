@@ -8,6 +8,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include "FairMQDevice.h"
+#include "Framework/BinaryMetricsService.h"
 #include "Framework/ChannelMatching.h"
 #include "Framework/DataProcessingDevice.h"
 #include "Framework/DataProcessorSpec.h"
@@ -19,6 +20,7 @@
 #include "Framework/DeviceSpec.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/FrameworkGUIDebugger.h"
+#include "Framework/MetricsRing.h"
 #include "Framework/SimpleMetricsService.h"
 #include "Framework/WorkflowSpec.h"
 #include "Framework/LocalRootFileService.h"
@@ -91,6 +93,11 @@ int doGUI(std::vector<DeviceInfo>& infos,
   // FIXME: I should really have some way of exiting the
   // parent..
   auto debugGUICallback = getGUIDebugger(infos, specs, metricsInfos, controls, ios, ddsEnv, ddsCustomCmd);
+  // The binary metrics rings of the devices, attached as soon as they
+  // get created, together with the position of each ring label in
+  // the associated DeviceMetricsInfo.
+  std::vector<std::unique_ptr<MetricsRing>> metricsRings(infos.size());
+  std::vector<std::vector<size_t>> metricsRingIndices(infos.size());
 
   while (pollGUI(window, debugGUICallback)) {
     // Exit this loop if all the children say they want to quit.
@@ -109,6 +116,26 @@ int doGUI(std::vector<DeviceInfo>& infos,
     // TODO: have multiple display modes
     // TODO: graphical view of the processing?
     assert(infos.size() == controls.size());
+    for (size_t di = 0, de = infos.size(); di < de; ++di) {
+      // The segment might be a leftover of a previous run, or of a
+      // device which got restarted since, so only the ring created by the
+      // current process of the device is used. Devices are started by DDS,
+      // so their pid is only known once they sent their first heartbeat.
+      auto pid = infos[di].pid();
+      if (metricsRings[di] && metricsRings[di]->creatorPid() != pid) {
+        metricsRings[di].reset();
+        metricsRingIndices[di].clear();
+      }
+      if (!metricsRings[di] && pid) {
+        metricsRings[di] = MetricsRing::attach(MetricsRing::nameForDevice(specs[di].id));
+        if (metricsRings[di] && metricsRings[di]->creatorPid() != pid) {
+          metricsRings[di].reset();
+        }
+      }
+      if (metricsRings[di]) {
+        consumeMetrics(*metricsRings[di], metricsRingIndices[di], metricsInfos[di]);
+      }
+    }
     std::smatch match;
     std::string token;
     const std::string delimiter("\n");
@@ -183,7 +210,14 @@ int runDevice(int argc, char **argv, const o2::framework::DeviceSpec &spec) {
     // We initialise this in the driver, because different drivers might have
     // different versions of the service
     ServiceRegistry serviceRegistry;
-    serviceRegistry.registerService<MetricsService>(new SimpleMetricsService());
+    // Metrics go through a binary ring in shared memory, if we can create
+    // one, otherwise they are printed out and parsed back by the driver.
+    auto metricsRing = MetricsRing::create(MetricsRing::nameForDevice(spec.id), 1 << 16);
+    if (metricsRing) {
+      serviceRegistry.registerService<MetricsService>(new BinaryMetricsService(std::move(metricsRing)));
+    } else {
+      serviceRegistry.registerService<MetricsService>(new SimpleMetricsService());
+    }
     serviceRegistry.registerService<RootFileService>(new LocalRootFileService());
     serviceRegistry.registerService<ControlService>(new TextControlService());
 
@@ -0,0 +1,46 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef FRAMEWORK_METRICSRINGTESTUTILS_H
+#define FRAMEWORK_METRICSRINGTESTUTILS_H
+
+#include "Framework/MetricsRing.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2 {
+namespace framework {
+namespace test {
+
+/// Heap storage for a process local ring, aligned like the shared memory one.
+struct AlignedBuffer {
+  AlignedBuffer(size_t capacity)
+  : storage(MetricsRing::bufferSize(capacity) / 64 + 1)
+  {
+  }
+  void *data() { return storage.data(); }
+  struct alignas(64) Line { char bytes[64]; };
+  std::vector<Line> storage;
+};
+
+inline MetricSample makeSample(uint32_t id, uint64_t timestamp, int value) {
+  MetricSample sample;
+  sample.id = id;
+  sample.timestamp = timestamp;
+  sample.type = MetricType::Int;
+  sample.intValue = value;
+  return sample;
+}
+
+} // namespace test
+} // namespace framework
+} // namespace o2
+
+#endif // FRAMEWORK_METRICSRINGTESTUTILS_H
@@ -0,0 +1,62 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/DeviceMetricsInfo.h"
+#include "Framework/MetricsRing.h"
+#include "MetricsRingTestUtils.h"
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace o2::framework;
+using test::AlignedBuffer;
+using test::makeSample;
+
+// Compares how many samples per second go from the device to the
+// DeviceMetricsInfo of the driver for the binary ring and the text path.
+int main() {
+  using namespace std::chrono;
+  const int nSamples = 1000000;
+  const int batch = 1024;
+
+  AlignedBuffer buffer(batch);
+  MetricsRing ring(buffer.data(), batch, true);
+  DeviceMetricsInfo binaryInfo;
+  std::vector<size_t> indices;
+  auto refTime = steady_clock::now();
+  int id = ring.registerLabel("inputs/relayed/pending");
+  for (int i = 0; i < nSamples; ++i) {
+    ring.push(makeSample(id, 1789372894, i));
+    if ((i + 1) % batch == 0) {
+      consumeMetrics(ring, indices, binaryInfo);
+    }
+  }
+  consumeMetrics(ring, indices, binaryInfo);
+  auto binaryTime = duration_cast<duration<double>>(steady_clock::now() - refTime).count();
+
+  DeviceMetricsInfo textInfo;
+  std::smatch match;
+  refTime = steady_clock::now();
+  for (int i = 0; i < nSamples / 10; ++i) {
+    std::ostringstream line;
+    line << "[INFO] METRIC:int:inputs/relayed/pending:1789372894:" << i;
+    std::string s = line.str();
+    if (parseMetric(s, match)) {
+      processMetric(match, textInfo);
+    }
+  }
+  auto textTime = duration_cast<duration<double>>(steady_clock::now() - refTime).count();
+
+  std::cout << "binary ring: " << nSamples / binaryTime << " samples/s" << std::endl;
+  std::cout << "text path: " << (nSamples / 10) / textTime << " samples/s" << std::endl;
+  return 0;
+}
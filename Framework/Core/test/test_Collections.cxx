@@ -15,6 +15,7 @@
 #include "Framework/Collection.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <new>
 
 
 BOOST_AUTO_TEST_CASE(TestCollection) {
@@ -47,3 +48,27 @@ BOOST_AUTO_TEST_CASE(TestCollection) {
   }
 
 }
+
+BOOST_AUTO_TEST_CASE(TestTriviallyCopyableCollection) {
+  using namespace o2::framework;
+  // Not a PoD, because of the user provided constructor, but it can still
+  // be stored as is in a message.
+  class Bar {
+  public:
+    Bar(int v) : mValue{v} {}
+    int value() const { return mValue; }
+  private:
+    int mValue = 0;
+  };
+  alignas(Bar) char buffer[10*sizeof(Bar)];
+  Bar *bars = reinterpret_cast<Bar*>(buffer);
+  for (size_t i = 0; i < 10; ++i) {
+    new (bars + i) Bar(i);
+  }
+  Collection<Bar> cb(buffer, 10);
+  BOOST_CHECK(cb.size() == 10);
+  int i = 0;
+  for (auto &b : cb) {
+    BOOST_CHECK(b.value() == i++);
+  }
+}
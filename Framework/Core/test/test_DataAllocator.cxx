@@ -0,0 +1,91 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DataAllocator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/DataAllocator.h"
+#include "Framework/DataRef.h"
+#include "Framework/DataRefUtils.h"
+#include "Framework/MessageContext.h"
+#include "Framework/RootObjectContext.h"
+#include "Headers/DataHeader.h"
+#include <fairmq/FairMQDevice.h>
+#include <fairmq/FairMQTransportFactory.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using namespace o2::framework;
+
+namespace {
+// Not a PoD, because of the user provided constructor, but trivially
+// copyable, as e.g. o2::TPC::Digit.
+class Point {
+public:
+  Point(int x, float y) : mX{x}, mY{y} {}
+  int x() const { return mX; }
+  float y() const { return mY; }
+private:
+  int mX;
+  float mY;
+};
+
+// What the receiving side sees for the message number @a i in @a context.
+DataRef refFor(MessageContext &context, size_t i) {
+  auto &parts = (context.begin() + i)->parts;
+  return DataRef{nullptr,
+                 reinterpret_cast<const char*>(parts.At(0)->GetData()),
+                 reinterpret_cast<const char*>(parts.At(1)->GetData())};
+}
+}
+
+BOOST_AUTO_TEST_CASE(TestMakeRoundTrip) {
+  auto zmq = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  FairMQDevice device;
+  device.fChannels["out"].push_back(FairMQChannel{"out", "pair", zmq});
+  MessageContext context;
+  RootObjectContext rootContext;
+  OutputSpec spec{"TST", "POINTS", 0};
+  DataAllocator allocator(&device, &context, &rootContext, {{"out", spec}});
+
+  // Constructed in place.
+  auto made = allocator.make<Point>(spec, 10, 3, 0.5f);
+  BOOST_CHECK(made.size() == 10);
+
+  // Copied from a vector, including the empty one.
+  std::vector<Point> points;
+  for (int i = 0; i < 5; ++i) {
+    points.emplace_back(i, i * 0.25f);
+  }
+  allocator.makeVector(spec, points);
+  allocator.makeVector(spec, std::vector<Point>{});
+  BOOST_REQUIRE(context.size() == 3);
+
+  auto ref = refFor(context, 0);
+  auto header = reinterpret_cast<const o2::Header::DataHeader*>(ref.header);
+  BOOST_CHECK(header->payloadSize == 10 * sizeof(Point));
+  auto received = DataRefUtils::as<Point>(ref);
+  BOOST_REQUIRE(received.size() == 10);
+  for (auto &point : received) {
+    BOOST_CHECK(point.x() == 3);
+    BOOST_CHECK(point.y() == 0.5f);
+  }
+
+  auto copied = DataRefUtils::as<Point>(refFor(context, 1));
+  BOOST_REQUIRE(copied.size() == points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    BOOST_CHECK(copied.at(i).x() == points[i].x());
+    BOOST_CHECK(copied.at(i).y() == points[i].y());
+  }
+  BOOST_CHECK(DataRefUtils::as<Point>(refFor(context, 2)).size() == 0);
+
+  // Only the declared outputs can be created.
+  BOOST_CHECK_THROW(allocator.make<Point>(OutputSpec{"TST", "OTHER", 0}, 1, 0, 0.f), std::runtime_error);
+}
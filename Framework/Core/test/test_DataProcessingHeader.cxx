@@ -0,0 +1,69 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DataProcessingHeader
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/DataProcessingHeader.h"
+#include "Headers/DataHeader.h"
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(TestDataProcessingHeaderInStack) {
+  using namespace o2::framework;
+  using namespace o2::Header;
+
+  DataHeader dh;
+  dh.dataDescription = DataDescription("CLUSTERS");
+  dh.dataOrigin = DataOrigin("TPC");
+  DataProcessingHeader dph{42};
+  BOOST_CHECK(dph.startTime == 42);
+  BOOST_CHECK(dph.duration == 1);
+  BOOST_CHECK(dph.size() == sizeof(DataProcessingHeader));
+
+  Stack stack{dh, dph};
+  BOOST_CHECK(stack.size() == sizeof(DataHeader) + sizeof(DataProcessingHeader));
+
+  auto readDh = get<DataHeader>(stack.data());
+  BOOST_REQUIRE(readDh != nullptr);
+  BOOST_CHECK(readDh->dataDescription == DataDescription("CLUSTERS"));
+
+  auto readDph = get<DataProcessingHeader>(stack.data());
+  BOOST_REQUIRE(readDph != nullptr);
+  BOOST_CHECK(readDph->startTime == 42);
+
+  // A stack without a DataProcessingHeader should not return any.
+  Stack plain{dh};
+  BOOST_CHECK(get<DataProcessingHeader>(plain.data()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TestHeaderStackValidation) {
+  using namespace o2::framework;
+  using namespace o2::Header;
+
+  DataHeader dh;
+  DataProcessingHeader dph{1};
+  Stack plain{dh};
+  BOOST_CHECK(isValidHeaderStack(plain.data(), plain.size()));
+  Stack stack{dh, dph};
+  BOOST_CHECK(isValidHeaderStack(stack.data(), stack.size()));
+
+  // Truncated or padded buffers are rejected.
+  BOOST_CHECK(!isValidHeaderStack(stack.data(), sizeof(DataHeader)));
+  BOOST_CHECK(!isValidHeaderStack(stack.data(), stack.size() - 1));
+  BOOST_CHECK(!isValidHeaderStack(plain.data(), sizeof(BaseHeader)));
+  std::vector<byte> padded(stack.data(), stack.data() + stack.size());
+  padded.resize(stack.size() + 16);
+  BOOST_CHECK(!isValidHeaderStack(padded.data(), padded.size()));
+
+  // The first header must be a DataHeader.
+  Stack wrongFirst{dph, dh};
+  BOOST_CHECK(!isValidHeaderStack(wrongFirst.data(), wrongFirst.size()));
+}
@@ -0,0 +1,94 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DataRelayer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/DataRelayer.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/MetricsService.h"
+#include "Headers/DataHeader.h"
+#include <fairmq/FairMQTransportFactory.h>
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <memory>
+
+using namespace o2::framework;
+using namespace o2::Header;
+
+namespace {
+class DummyMetricsService : public MetricsService {
+public:
+  void post(const char *, float) override {}
+  void post(const char *, int) override {}
+  void post(const char *, const char *) override {}
+};
+
+std::unique_ptr<FairMQMessage> makeHeader(FairMQTransportFactory &factory,
+                                          DataOrigin origin,
+                                          size_t timeframe) {
+  DataHeader dh;
+  dh.dataOrigin = origin;
+  dh.dataDescription = DataDescription("CLUSTERS");
+  dh.subSpecification = 0;
+  Stack stack{dh, DataProcessingHeader{timeframe}};
+  auto message = factory.CreateMessage(stack.size());
+  memcpy(message->GetData(), stack.data(), stack.size());
+  return message;
+}
+}
+
+BOOST_AUTO_TEST_CASE(TestLateAndDuplicateParts) {
+  std::shared_ptr<FairMQTransportFactory> zmq(FairMQTransportFactory::CreateTransportFactory("zeromq"));
+  DummyMetricsService metrics;
+  DataRelayer::InputsMap inputs{
+    {"a", InputSpec{"ITS", "CLUSTERS", 0, InputSpec::Timeframe}},
+    {"b", InputSpec{"TPC", "CLUSTERS", 0, InputSpec::Timeframe}}
+  };
+  DataRelayer relayer(inputs, {}, metrics, 4);
+
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "ITS", 0), zmq->CreateMessage(1)) == DataRelayer::WillRelay);
+  // A duplicate part while the timeframe is in flight.
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "ITS", 0), zmq->CreateMessage(1)) == DataRelayer::Dropped);
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "TPC", 0), zmq->CreateMessage(1)) == DataRelayer::WillRelay);
+  BOOST_CHECK(relayer.getReadyToProcess().readyInputs.size() == 2);
+  BOOST_CHECK(relayer.getCacheSize() == 0);
+
+  // Once the timeframe is completed, its parts are late and must not
+  // open a new entry in the free slot.
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "TPC", 0), zmq->CreateMessage(1)) == DataRelayer::Dropped);
+  BOOST_CHECK(relayer.getCacheSize() == 0);
+
+  // A newer timeframe can reuse the slot.
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "TPC", 4), zmq->CreateMessage(1)) == DataRelayer::WillRelay);
+  BOOST_CHECK(relayer.getCacheSize() == 1);
+  // Timeframe 8 takes the slot of the incomplete timeframe 4, which is
+  // dropped, so that later parts for 4 are rejected.
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "ITS", 8), zmq->CreateMessage(1)) == DataRelayer::WillRelay);
+  BOOST_CHECK(relayer.relay(makeHeader(*zmq, "ITS", 4), zmq->CreateMessage(1)) == DataRelayer::Dropped);
+  BOOST_CHECK(relayer.getCacheSize() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestInvalidHeaderStack) {
+  std::shared_ptr<FairMQTransportFactory> zmq(FairMQTransportFactory::CreateTransportFactory("zeromq"));
+  DummyMetricsService metrics;
+  DataRelayer::InputsMap inputs{
+    {"a", InputSpec{"ITS", "CLUSTERS", 0, InputSpec::Timeframe}}
+  };
+  DataRelayer relayer(inputs, {}, metrics);
+
+  auto valid = makeHeader(*zmq, "ITS", 0);
+  auto truncated = zmq->CreateMessage(sizeof(DataHeader) + 8);
+  memcpy(truncated->GetData(), valid->GetData(), truncated->GetSize());
+  BOOST_CHECK(relayer.relay(std::move(truncated), zmq->CreateMessage(1)) == DataRelayer::Dropped);
+  BOOST_CHECK(relayer.getCacheSize() == 0);
+  BOOST_CHECK(relayer.relay(std::move(valid), zmq->CreateMessage(1)) == DataRelayer::WillRelay);
+  BOOST_CHECK(relayer.getReadyToProcess().readyInputs.size() == 1);
+}
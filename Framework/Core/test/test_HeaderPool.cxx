@@ -0,0 +1,64 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework HeaderPool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/HeaderPool.h"
+#include <fairmq/FairMQTransportFactory.h>
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+BOOST_AUTO_TEST_CASE(TestHeaderPoolRecycling) {
+  using namespace o2::framework;
+
+  auto &pool = HeaderPool::get(128);
+  BOOST_CHECK(&pool == &HeaderPool::get(128));
+  BOOST_CHECK(&pool != &HeaderPool::get(64));
+  BOOST_CHECK(pool.bufferSize() == 128);
+
+  void *first = pool.acquire();
+  void *second = pool.acquire();
+  BOOST_CHECK(first != second);
+  HeaderPool::release(first, &pool);
+  // A released buffer is handed out again.
+  BOOST_CHECK(pool.acquire() == first);
+  HeaderPool::release(second, &pool);
+  HeaderPool::release(first, &pool);
+}
+
+BOOST_AUTO_TEST_CASE(TestHeaderPoolWithMessages) {
+  using namespace o2::framework;
+
+  auto &pool = HeaderPool::get(96);
+  auto zmq = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  BOOST_REQUIRE(zmq);
+
+  void *buffer = pool.acquire();
+  auto message = zmq->CreateMessage(buffer, pool.bufferSize(), &HeaderPool::release, &pool);
+  // The buffer is adopted, not copied, so the DataAllocator keeps using
+  // the pool for this transport.
+  BOOST_CHECK(message->GetData() == buffer);
+  BOOST_CHECK(message->GetSize() == pool.bufferSize());
+  // As long as the message is alive the buffer is not handed out again.
+  void *other = pool.acquire();
+  BOOST_CHECK(other != buffer);
+  HeaderPool::release(other, &pool);
+
+  // Once the transport is done with the message the buffer goes back to
+  // the pool and the next message reuses it.
+  message.reset();
+  BOOST_CHECK(pool.acquire() == buffer);
+  message = zmq->CreateMessage(buffer, pool.bufferSize(), &HeaderPool::release, &pool);
+  BOOST_CHECK(message->GetData() == buffer);
+  message.reset();
+  BOOST_CHECK(pool.acquire() == buffer);
+  HeaderPool::release(buffer, &pool);
+}
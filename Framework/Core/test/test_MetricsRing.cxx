@@ -0,0 +1,124 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework MetricsRing
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/DeviceMetricsInfo.h"
+#include "Framework/MetricsRing.h"
+#include "MetricsRingTestUtils.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace o2::framework;
+using test::AlignedBuffer;
+using test::makeSample;
+
+BOOST_AUTO_TEST_CASE(TestMetricsRing) {
+  AlignedBuffer buffer(4);
+  MetricsRing ring(buffer.data(), 4, true);
+  BOOST_CHECK(ring.capacity() == 4);
+  BOOST_CHECK(ring.labelsCount() == 0);
+  int id = ring.registerLabel("bkey");
+  BOOST_CHECK(id == 0);
+  BOOST_CHECK(ring.labelsCount() == 1);
+  BOOST_CHECK(std::string(ring.label(0)) == "bkey");
+
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(ring.push(makeSample(id, 1789372894, 12 + i)));
+  }
+  // The ring is full, the sample is dropped.
+  BOOST_CHECK(ring.push(makeSample(id, 1789372894, 16)) == false);
+  BOOST_CHECK(ring.dropped() == 1);
+
+  MetricSample samples[3];
+  BOOST_CHECK(ring.pop(samples, 3) == 3);
+  BOOST_CHECK(samples[0].intValue == 12);
+  BOOST_CHECK(samples[2].intValue == 14);
+  // We made room for new samples, wrapping around.
+  BOOST_CHECK(ring.push(makeSample(id, 1789372895, 17)));
+  BOOST_CHECK(ring.pop(samples, 3) == 2);
+  BOOST_CHECK(samples[0].intValue == 15);
+  BOOST_CHECK(samples[1].intValue == 17);
+  BOOST_CHECK(ring.pop(samples, 3) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestConsumeMetrics) {
+  AlignedBuffer buffer(16);
+  MetricsRing ring(buffer.data(), 16, true);
+  DeviceMetricsInfo info;
+  std::vector<size_t> indices;
+
+  int bkey = ring.registerLabel("bkey");
+  ring.push(makeSample(bkey, 1789372894, 12));
+  ring.push(makeSample(bkey, 1789372894, 13));
+  int key3 = ring.registerLabel("key3");
+  MetricSample sample;
+  sample.id = key3;
+  sample.timestamp = 1789372895;
+  sample.type = MetricType::Float;
+  sample.floatValue = 16.0;
+  ring.push(sample);
+
+  BOOST_CHECK(consumeMetrics(ring, indices, info) == 3);
+  BOOST_CHECK(indices.size() == 2);
+  BOOST_CHECK(info.metrics.size() == 2);
+  BOOST_CHECK(info.intMetrics.size() == 1);
+  BOOST_CHECK(info.floatMetrics.size() == 1);
+  BOOST_CHECK(info.intMetrics[0][0] == 12);
+  BOOST_CHECK(info.intMetrics[0][1] == 13);
+  BOOST_CHECK(info.floatMetrics[0][0] == 16.0);
+  BOOST_CHECK(info.metrics[0].pos == 2);
+  BOOST_CHECK(info.timestamps[1][0] == 1789372895);
+  BOOST_CHECK(metricIdxByName("bkey", info) == 0);
+  BOOST_CHECK(metricIdxByName("key3", info) == 1);
+  BOOST_CHECK(consumeMetrics(ring, indices, info) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestMetricsRingSharedMemory) {
+  auto name = MetricsRing::nameForDevice("test_MetricsRing");
+  auto producer = MetricsRing::create(name, 8);
+  BOOST_REQUIRE(producer.get());
+  auto consumer = MetricsRing::attach(name);
+  BOOST_REQUIRE(consumer.get());
+  BOOST_CHECK(consumer->capacity() == 8);
+  BOOST_CHECK(consumer->creatorPid() == getpid());
+
+  int id = producer->registerLabel("akey");
+  producer->push(makeSample(id, 1789372894, 14));
+  BOOST_CHECK(consumer->labelsCount() == 1);
+  BOOST_CHECK(std::string(consumer->label(id)) == "akey");
+  MetricSample samples[8];
+  BOOST_CHECK(consumer->pop(samples, 8) == 1);
+  BOOST_CHECK(samples[0].intValue == 14);
+}
+
+// Samples consumed in batches end up in the history of the metric, which
+// wraps around after 1024 entries.
+BOOST_AUTO_TEST_CASE(TestMetricsRingBatches) {
+  const int nSamples = 5000;
+  const int batch = 1024;
+
+  AlignedBuffer buffer(batch);
+  MetricsRing ring(buffer.data(), batch, true);
+  DeviceMetricsInfo info;
+  std::vector<size_t> indices;
+  int id = ring.registerLabel("inputs/relayed/pending");
+  for (int i = 0; i < nSamples; ++i) {
+    BOOST_REQUIRE(ring.push(makeSample(id, 1789372894, i)));
+    if ((i + 1) % batch == 0) {
+      consumeMetrics(ring, indices, info);
+    }
+  }
+  consumeMetrics(ring, indices, info);
+  BOOST_CHECK(info.intMetrics[0][(nSamples - 1) % 1024] == nSamples - 1);
+}
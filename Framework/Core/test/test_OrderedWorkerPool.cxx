@@ -0,0 +1,124 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework OrderedWorkerPool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/OrderedWorkerPool.h"
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace o2::framework;
+
+namespace {
+// What the tasks and their commit steps observe. Boost checks are not thread
+// safe, so the worker threads only count the violations.
+struct Recorder {
+  std::vector<size_t> committed;
+  std::atomic<int> inCommit{0};
+  std::atomic<int> overlaps{0};
+  std::atomic<int> badWorkers{0};
+};
+
+// Submit @a n tasks taking a random time, whose commit steps record their
+// sequence number and check they never overlap.
+void submitTasks(OrderedWorkerPool &pool, size_t workers, size_t n, Recorder &rec, size_t first = 0) {
+  std::mt19937 gen(n);
+  std::uniform_int_distribution<int> delay(0, 200);
+  for (size_t i = first; i < first + n; ++i) {
+    auto us = delay(gen);
+    pool.submit([i, us, workers, &rec](size_t worker) -> OrderedWorkerPool::Commit {
+      if (worker >= workers) {
+        rec.badWorkers++;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(us));
+      return [i, &rec]() {
+        if (rec.inCommit++ != 0) {
+          rec.overlaps++;
+        }
+        rec.committed.push_back(i);
+        rec.inCommit--;
+      };
+    });
+  }
+}
+
+void checkOrder(Recorder &rec, size_t n, size_t first = 0) {
+  BOOST_CHECK(rec.overlaps == 0);
+  BOOST_CHECK(rec.badWorkers == 0);
+  BOOST_REQUIRE(rec.committed.size() == n);
+  for (size_t i = 0; i < n; ++i) {
+    BOOST_CHECK(rec.committed[i] == first + i);
+  }
+  rec.committed.clear();
+}
+}
+
+BOOST_AUTO_TEST_CASE(TestCommitOrder) {
+  for (size_t workers : {1, 2, 4, 8}) {
+    OrderedWorkerPool pool;
+    pool.start(workers);
+    BOOST_CHECK(pool.size() == workers);
+    Recorder rec;
+    submitTasks(pool, workers, 500, rec);
+    // Exclusive sections never overlap with a commit.
+    for (int i = 0; i < 100; ++i) {
+      pool.exclusive([&rec]() {
+        if (rec.inCommit++ != 0) {
+          rec.overlaps++;
+        }
+        rec.inCommit--;
+      });
+    }
+    pool.stop();
+    BOOST_CHECK(pool.size() == 0);
+    checkOrder(rec, 500);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestShutdownAndRestart) {
+  OrderedWorkerPool pool;
+  Recorder rec;
+
+  // Stopping drains what is queued.
+  pool.start(4);
+  submitTasks(pool, 4, 100, rec);
+  pool.stop();
+  checkOrder(rec, 100);
+  // Stopping twice is harmless.
+  pool.stop();
+
+  // A restarted pool starts a new sequence.
+  pool.start(3);
+  BOOST_CHECK(pool.size() == 3);
+  submitTasks(pool, 3, 100, rec);
+  pool.stop();
+  checkOrder(rec, 100);
+
+  // A failing task does not block the commit of the following ones.
+  pool.start(2);
+  pool.submit([](size_t) -> OrderedWorkerPool::Commit { throw std::runtime_error("failed task"); });
+  submitTasks(pool, 2, 10, rec, 1);
+  pool.stop();
+  checkOrder(rec, 10, 1);
+
+  // The destructor stops a running pool.
+  {
+    OrderedWorkerPool running;
+    running.start(2);
+    submitTasks(running, 2, 10, rec);
+  }
+  checkOrder(rec, 10);
+}
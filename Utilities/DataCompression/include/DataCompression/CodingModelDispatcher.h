@@ -143,8 +143,8 @@ public:
   }
 
   /**
-   * TODO: this is tailored to HuffmanCodec for the moment, some generic interface
-   * has to come
+   * Generate the codes or tables from the weights of the probability model,
+   * all coding models implement generate()
    */
   class generateFctr {
   public:
@@ -156,7 +156,7 @@ public:
     template<typename T>
     return_type operator()(boost::type<T>) {
       T& stage = static_cast<T&>(mContainer);
-      return (*stage).GenerateHuffmanTree();
+      return (*stage).generate();
     }
 
   private:
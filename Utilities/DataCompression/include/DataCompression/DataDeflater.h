@@ -31,6 +31,7 @@
 #include <cerrno>
 #include <stdexcept>
 #include <cassert>
+#include <functional>
 
 namespace o2 {
 namespace data_compression {
@@ -92,14 +93,14 @@ public:
 
   /**
    * Flush and close
-   * Write the pending target word
+   * Write the pending target words
    * @return Number of written words during close
    */
   template<typename WriterT>
   int close(WriterT& writer) {
-    int nWords = 0;
+    int nWords = flush(writer);
     if (mFilledBits > 0) {
-      writer(mCurrent);
+      writer(static_cast<target_type>(mCurrent >> (AccumulatorBitWidth - TargetBitWidth)));
       ++nWords;
     }
     reset();
@@ -110,6 +111,9 @@ public:
    * Write number of bits
    * value contains number of valid LSBs given by bitlength
    *
+   * The bits are collected MSB first in a 64 bit accumulator, complete
+   * target words are written out from its top.
+   *
    * TODO: that function might be renamed to simply 'write' in conjunction
    * with a mixin approach. Every deflater mixin instance has only one
    * 'write' function and does internally the necessary conversions to
@@ -117,32 +121,26 @@ public:
    */
   template <typename ValueType, typename WriterT>
   int writeRaw(ValueType value, uint16_t bitlength, WriterT writer) {
-    auto bitsToWrite = bitlength;
-    if (bitlength > 8*sizeof(ValueType)) {
+    if (bitlength > 8*sizeof(ValueType) || bitlength > AccumulatorBitWidth) {
       // TODO: error policy
       throw std::runtime_error("bit length exceeds width of the data type");
     }
+    uint64_t bits = static_cast<uint64_t>(value);
+    auto bitsToWrite = bitlength;
+    // a value can span at most the remaining space of the accumulator and
+    // the beginning of the next one
     while (bitsToWrite > 0) {
-      if (mFilledBits == TargetBitWidth) {
-        mFilledBits=0;
-        writer(mCurrent);
-        mCurrent = 0;
-      }
-      // write at max what is left to be written
-      auto writeNow = bitsToWrite;
-      // write one element of the target buffer at a time
-      if (writeNow > TargetBitWidth) writeNow = TargetBitWidth;
-      // write the remaining space in the current element
-      auto capacity = TargetBitWidth - mFilledBits;
-      if (writeNow > capacity) writeNow = capacity;
-      auto mask = (((ValueType)1 << writeNow) - 1) << (bitsToWrite - writeNow);
-      auto activebits = (value&mask) >> (bitsToWrite - writeNow);
-      mCurrent |= activebits << (capacity-writeNow);
+      flush(writer);
+      auto capacity = AccumulatorBitWidth - mFilledBits;
+      auto writeNow = bitsToWrite > capacity ? capacity : bitsToWrite;
+      auto activebits = (bits >> (bitsToWrite - writeNow)) & lowBitMask(writeNow);
+      mCurrent |= activebits << (capacity - writeNow);
       mFilledBits += writeNow;
       bitsToWrite -= writeNow;
-      assert(mFilledBits <= TargetBitWidth);
+      assert(mFilledBits <= AccumulatorBitWidth);
     }
-    return bitlength - bitsToWrite;
+    flush(writer);
+    return bitlength;
   }
 
   template <typename T, typename WriterT>
@@ -160,17 +158,38 @@ public:
    * @return number of forward bits
    */
   int align() {
-    if (mFilledBits == 0 || mFilledBits == TargetBitWidth) return 0;
+    auto partial = mFilledBits % TargetBitWidth;
+    if (partial == 0) return 0;
     // set the number of filled bits to the next target border
-    int nBits = TargetBitWidth - mFilledBits;
-    mFilledBits = TargetBitWidth;
+    int nBits = TargetBitWidth - partial;
+    mFilledBits += nBits;
     return nBits;
   }
 
 private:
-  /// current target word
-  target_type mCurrent;
-  /// current bit position
+  static const unsigned AccumulatorBitWidth = 64;
+  static_assert(TargetBitWidth <= AccumulatorBitWidth, "target type exceeds width of the accumulator");
+
+  static uint64_t lowBitMask(unsigned n) {
+    return n >= AccumulatorBitWidth ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+  }
+
+  /// write all complete target words from the top of the accumulator
+  template<typename WriterT>
+  int flush(WriterT& writer) {
+    int nWords = 0;
+    while (mFilledBits >= TargetBitWidth) {
+      writer(static_cast<target_type>(mCurrent >> (AccumulatorBitWidth - TargetBitWidth)));
+      mCurrent = TargetBitWidth < AccumulatorBitWidth ? mCurrent << (TargetBitWidth % AccumulatorBitWidth) : 0;
+      mFilledBits -= TargetBitWidth;
+      ++nWords;
+    }
+    return nWords;
+  }
+
+  /// bit accumulator, filled from the MSB
+  uint64_t mCurrent;
+  /// number of valid bits in the accumulator
   unsigned mFilledBits;
   /// codec instance
   Codec mCodec;
@@ -0,0 +1,130 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef DATAINFLATER_H
+#define DATAINFLATER_H
+
+//  @file   DataInflater.h
+//  @brief  Bit reader for the output of the DataDeflater
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <cassert>
+
+namespace o2 {
+namespace data_compression {
+
+/**
+ * @class DataInflater
+ * Read back bit fields written by the DataDeflater, MSB first from a buffer
+ * of source words.
+ *
+ * Source words are loaded as a whole into a 64 bit accumulator, so that
+ * after a refill at least sMaxPeekLength bits can be inspected without
+ * further access to the buffer. This is used by table driven decoders which
+ * inspect a fixed number of bits and then consume the length of the decoded
+ * code.
+ *
+ * Bits beyond the end of the buffer read as zero.
+ */
+template<typename SourceType>
+class DataInflater {
+public:
+  using source_type = SourceType;
+  static const std::size_t SourceBitWidth = 8 * sizeof(source_type);
+  static_assert(SourceBitWidth <= 32, "source type exceeds width supported by the accumulator");
+  static const std::size_t sMaxPeekLength = 64 - SourceBitWidth + 1;
+
+  DataInflater(const source_type* begin, const source_type* end)
+    : mPosition(begin), mEnd(end), mCurrent(0), mAvailableBits(0) {}
+  ~DataInflater() = default;
+
+  /**
+   * Get the next bitlength bits without consuming them
+   * @return bits in the LSBs of the returned value
+   */
+  uint64_t peek(uint16_t bitlength) {
+    assert(bitlength <= sMaxPeekLength);
+    if (mAvailableBits < bitlength) refill();
+    return bitlength == 0 ? 0 : mCurrent >> (64 - bitlength);
+  }
+
+  /**
+   * Skip bitlength bits, which must have been inspected by peek before
+   */
+  void consume(uint16_t bitlength) {
+    assert(bitlength <= sMaxPeekLength);
+    mCurrent <<= bitlength;
+    mAvailableBits -= bitlength < mAvailableBits ? bitlength : mAvailableBits;
+  }
+
+  /**
+   * Read number of bits
+   * value gets the number of bits given by bitlength in the LSBs
+   * @return number of read bits
+   */
+  template<typename ValueType>
+  int readRaw(ValueType& value, uint16_t bitlength) {
+    if (bitlength > 8 * sizeof(ValueType)) {
+      // TODO: error policy
+      throw std::runtime_error("bit length exceeds width of the data type");
+    }
+    uint64_t bits = 0;
+    auto bitsToRead = bitlength;
+    while (bitsToRead > 0) {
+      uint16_t readNow = bitsToRead > 32 ? 32 : bitsToRead;
+      bits = (bits << readNow) | peek(readNow);
+      consume(readNow);
+      bitsToRead -= readNow;
+    }
+    value = static_cast<ValueType>(bits);
+    return bitlength;
+  }
+
+  /**
+   * Skip to the next border of a source word, the counterpart of
+   * DataDeflater::align
+   * @return number of skipped bits
+   */
+  int align() {
+    int nBits = mAvailableBits % SourceBitWidth;
+    consume(nBits);
+    return nBits;
+  }
+
+  /// true if all bits of the buffer have been consumed
+  bool empty() const {
+    return mAvailableBits == 0 && mPosition == mEnd;
+  }
+
+private:
+  /// load complete source words into the free space of the accumulator
+  void refill() {
+    while (mAvailableBits + SourceBitWidth <= 64 && mPosition != mEnd) {
+      mCurrent |= static_cast<uint64_t>(*mPosition++) << (64 - SourceBitWidth - mAvailableBits);
+      mAvailableBits += SourceBitWidth;
+    }
+  }
+
+  /// next source word to be loaded
+  const source_type* mPosition;
+  /// end of the source buffer
+  const source_type* mEnd;
+  /// bit accumulator, the next bit to be read in the MSB
+  uint64_t mCurrent;
+  /// number of valid bits in the accumulator
+  unsigned mAvailableBits;
+};
+
+}; // namespace data_compression
+}; // namespace o2
+
+#endif
@@ -40,6 +40,10 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream> // stringstream in configuration parsing
+#include <algorithm>
+#include <bitset>
+#include <queue>
+#include <type_traits>
 
 namespace o2 {
 
@@ -289,6 +293,9 @@ public:
     }
   };
 
+  /// generic interface of the coding models, see CodingModelDispatcher
+  bool generate() {return GenerateHuffmanTree();}
+
   /**
    * Combine and sort nodes to build a binary tree
    * TODO: separate data structures for tree and leaf nodes to optimize
@@ -535,6 +542,319 @@ private:
   std::multiset<std::shared_ptr<_NodeType>, isless<std::shared_ptr<_NodeType>>> mTreeNodes;
 };
 
+/**
+ * Conversion of the code types used by the Huffman models to an integer,
+ * either std::bitset or unsigned integral types
+ */
+template<std::size_t N>
+uint64_t codeToInteger(const std::bitset<N>& code) {return code.to_ullong();}
+template<std::size_t N>
+constexpr std::size_t codeWidth(const std::bitset<N>&) {return N;}
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, uint64_t>::type codeToInteger(T code) {return code;}
+template<typename T>
+constexpr typename std::enable_if<std::is_integral<T>::value, std::size_t>::type codeWidth(T) {return 8 * sizeof(T);}
+
+/**
+ * @class CanonicalHuffmanModel
+ * @brief Probability model implementing canonical Huffman codes with table
+ * driven decoding
+ * This is a mixin class which extends the ProbabilityModel base, it provides
+ * the same interface as HuffmanModel and can be used in its place, e.g. in
+ * the CodingModelDispatcher.
+ *
+ * Only the code lengths are derived from the Huffman tree, lengths are
+ * limited to _MaxLength bits. Codes of the same length are consecutive
+ * numbers in the order of the symbol index, which allows to decode without
+ * the tree: the first _TableBits bits of the code are looked up in a table
+ * holding symbol and length of all codes up to this length, longer codes
+ * are resolved by comparing with the first code of every length.
+ *
+ * Codes are always written MSB first.
+ */
+template<typename _BASE, typename _CodeType, uint16_t _MaxLength = 24, uint16_t _TableBits = 10>
+class CanonicalHuffmanModel : public _BASE {
+public:
+  CanonicalHuffmanModel() : mAlphabet(), mCodeLengths(), mCodes(), mSortedIndices(), mFirstCode(), mFirstIndex(), mCount(), mTable() {}
+  ~CanonicalHuffmanModel() {}
+
+  typedef _BASE                                base_type;
+  typedef typename _BASE::value_type value_type;
+  typedef _CodeType code_type;
+  static constexpr bool orderMSB = true;
+  static constexpr uint16_t sMaxLength = _MaxLength;
+  static constexpr uint16_t sTableBits = _TableBits;
+  static_assert(_TableBits > 0 && _TableBits <= _MaxLength, "table bits must be in the range of the code length");
+  static_assert(_MaxLength <= 32, "code length is limited to 32 bits");
+
+  int init(double v = 1.) {return _BASE::initWeight(mAlphabet, v);}
+
+  /**
+   * Encode value
+   *
+   * @arg symbol     [in]  symbol to be encoded
+   * @arg codeLength [OUT] code length, number of LSBs
+   * @return Huffman code, valid if codeLength > 0
+   */
+  code_type Encode(value_type symbol, uint16_t& codeLength) const {
+    auto index = _BASE::alphabet_type::getIndex(symbol);
+    if (index >= mCodeLengths.size() || mCodeLengths[index] == 0) {
+      std::string msg = "symbol "; msg += symbol;
+      msg += " not found in alphapet "; msg += _BASE::getName();
+      throw std::range_error(msg);
+    }
+    codeLength = mCodeLengths[index];
+    return code_type(mCodes[index]);
+  }
+
+  /**
+   * Decode bit pattern
+   *
+   * The code starts at the MSB of the code parameter, the number of decoded
+   * bits is indicated in the codeLength parameter after decoding.
+   * @arg code        [in]  code bits
+   * @arg codeLength  [OUT] number of decoded bits
+   * @return value, valid if codeLength > 0
+   */
+  value_type Decode(code_type code, uint16_t& codeLength) const {
+    auto width = codeWidth(code);
+    auto bits = codeToInteger(code);
+    uint32_t window = width >= sMaxLength ? bits >> (width - sMaxLength) : bits << (sMaxLength - width);
+    return decodeWindow(window, codeLength);
+  }
+
+  /**
+   * Decode the next symbol from a bit reader providing peek and consume,
+   * e.g. DataInflater
+   */
+  template<typename ReaderT>
+  value_type decode(ReaderT& reader) const {
+    uint16_t codeLength = 0;
+    value_type v = decodeWindow(reader.peek(sMaxLength), codeLength);
+    reader.consume(codeLength);
+    return v;
+  }
+
+  /// generic interface of the coding models, see CodingModelDispatcher
+  bool generate() {return GenerateHuffmanTree();}
+
+  /**
+   * Calculate the code lengths and create the codes and the decoding tables
+   * The name is kept for compatibility with HuffmanModel.
+   */
+  bool GenerateHuffmanTree() {
+    std::vector<std::pair<unsigned, double>> weights;
+    _BASE& model = *this;
+    for (auto i : model) {
+      weights.emplace_back(_BASE::alphabet_type::getIndex(i.first), i.second);
+    }
+    if (weights.empty()) return false;
+    if ((weights.size() - 1) >> sMaxLength) {
+      throw std::range_error("alphabet size exceeds maximum code length");
+    }
+    unsigned maxIndex = 0;
+    for (auto& w : weights) {
+      if (w.first > maxIndex) maxIndex = w.first;
+    }
+    mCodeLengths.assign(maxIndex + 1, 0);
+
+    if (weights.size() == 1) {
+      mCodeLengths[weights[0].first] = 1;
+      return buildCodes();
+    }
+
+    // build the Huffman tree to get the code lengths, nodes are just
+    // referenced by their parent
+    using Node = std::pair<double, unsigned>;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+    std::vector<unsigned> parents(2 * weights.size() - 1, 0);
+    for (unsigned i = 0; i < weights.size(); ++i) {
+      queue.emplace(weights[i].second, i);
+    }
+    unsigned next = weights.size();
+    while (queue.size() > 1) {
+      Node a = queue.top(); queue.pop();
+      Node b = queue.top(); queue.pop();
+      parents[a.second] = parents[b.second] = next;
+      queue.emplace(a.first + b.first, next++);
+    }
+    // depth of every node, parents always have a higher index
+    std::vector<uint16_t> depths(parents.size(), 0);
+    unsigned maxDepth = 0;
+    for (int node = parents.size() - 2; node >= 0; --node) {
+      depths[node] = depths[parents[node]] + 1;
+      if (node < (int)weights.size() && depths[node] > maxDepth) maxDepth = depths[node];
+    }
+
+    // limit the code lengths: codes longer than the maximum are moved up to
+    // a shorter length, which is compensated by moving a shorter code down
+    std::vector<unsigned> count(maxDepth + 1, 0);
+    for (unsigned i = 0; i < weights.size(); ++i) count[depths[i]]++;
+    for (unsigned len = maxDepth; len > sMaxLength; --len) {
+      while (count[len] > 0) {
+        unsigned j = len - 2;
+        while (count[j] == 0) --j;
+        count[len] -= 2;
+        count[len - 1]++;
+        count[j + 1] += 2;
+        count[j]--;
+      }
+    }
+    // assign the lengths in the order of decreasing weight
+    std::vector<unsigned> order(weights.size());
+    for (unsigned i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&weights, &depths](unsigned a, unsigned b) {
+        return depths[a] < depths[b] || (depths[a] == depths[b] && weights[a].second > weights[b].second);
+      });
+    unsigned len = 1;
+    for (auto i : order) {
+      while (count[len] == 0) ++len;
+      count[len]--;
+      mCodeLengths[weights[i].first] = len;
+    }
+    return buildCodes();
+  }
+
+  /**
+   * @brief Write the code table
+   * Only the code lengths are needed to restore the canonical codes, one line
+   * per symbol: value weight codelen
+   */
+  int write(std::ostream& out) {
+    const _BASE& model = *this;
+    for (unsigned index = 0; index < mCodeLengths.size(); ++index) {
+      if (mCodeLengths[index] == 0) continue;
+      auto value = _BASE::alphabet_type::getSymbol(index);
+      out << value << " " << model[value] << " " << mCodeLengths[index] << std::endl;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Read the code table written by write
+   * The table has to be terminated by blank line or eof
+   */
+  int read(std::istream& in) {
+    mCodeLengths.clear();
+    std::string line;
+    while (std::getline(in, line) && !line.empty()) {
+      std::stringstream ls(line);
+      typename _BASE::alphabet_type::value_type symbol;
+      typename _BASE::weight_type weight;
+      uint16_t codeLen = 0;
+      if (!(ls >> symbol >> weight >> codeLen) || codeLen == 0 || codeLen > sMaxLength) {
+        std::cerr << "format error: invalid code table entry '" << line << "'" << std::endl;
+        return -1;
+      }
+      unsigned index = _BASE::alphabet_type::getIndex(symbol);
+      if (mCodeLengths.size() < index + 1) mCodeLengths.resize(index + 1, 0);
+      mCodeLengths[index] = codeLen;
+      _BASE::addWeight(symbol, weight);
+    }
+    return buildCodes() ? 0 : -1;
+  }
+
+  void print() const {
+    for (unsigned index = 0; index < mCodeLengths.size(); ++index) {
+      if (mCodeLengths[index] == 0) continue;
+      std::cout << "value: " << std::setw(6) << _BASE::alphabet_type::getSymbol(index)
+                << "   code length: " << std::setw(3) << mCodeLengths[index]
+                << "   code: " << std::bitset<sMaxLength>(mCodes[index]).to_string().substr(sMaxLength - mCodeLengths[index])
+                << std::endl;
+    }
+  }
+
+private:
+  /**
+   * Decode from a window holding the next sMaxLength bits in its LSBs
+   */
+  value_type decodeWindow(uint32_t window, uint16_t& codeLength) const {
+    const auto& entry = mTable[window >> (sMaxLength - sTableBits)];
+    if (entry.length > 0) {
+      codeLength = entry.length;
+      return _BASE::alphabet_type::getSymbol(entry.index);
+    }
+    for (uint16_t len = sTableBits + 1; len <= sMaxLength; ++len) {
+      uint32_t code = window >> (sMaxLength - len);
+      if (code - mFirstCode[len] < mCount[len]) {
+        codeLength = len;
+        return _BASE::alphabet_type::getSymbol(mSortedIndices[mFirstIndex[len] + code - mFirstCode[len]]);
+      }
+    }
+    codeLength = 0;
+    throw std::range_error("invalid code");
+  }
+
+  /**
+   * Assign canonical codes from the code lengths and fill the decoding tables
+   */
+  bool buildCodes() {
+    mCount.assign(sMaxLength + 1, 0);
+    mSortedIndices.clear();
+    for (unsigned index = 0; index < mCodeLengths.size(); ++index) {
+      if (mCodeLengths[index] > 0) mCount[mCodeLengths[index]]++;
+    }
+    mFirstCode.assign(sMaxLength + 1, 0);
+    mFirstIndex.assign(sMaxLength + 1, 0);
+    uint32_t code = 0;
+    unsigned nCodes = 0;
+    for (uint16_t len = 1; len <= sMaxLength; ++len) {
+      code = (code + mCount[len - 1]) << 1;
+      mFirstCode[len] = code;
+      mFirstIndex[len] = nCodes;
+      nCodes += mCount[len];
+    }
+    mSortedIndices.resize(nCodes);
+    mCodes.assign(mCodeLengths.size(), 0);
+    std::vector<uint32_t> nextCode(mFirstCode);
+    std::vector<unsigned> nextIndex(mFirstIndex);
+    for (unsigned index = 0; index < mCodeLengths.size(); ++index) {
+      auto len = mCodeLengths[index];
+      if (len == 0) continue;
+      mCodes[index] = nextCode[len]++;
+      mSortedIndices[nextIndex[len]++] = index;
+      if (mCodes[index] >> len) {
+        // the code lengths violate the Kraft inequality
+        std::cerr << "error: invalid code lengths in model " << _BASE::getName() << std::endl;
+        return false;
+      }
+    }
+
+    mTable.assign(1 << sTableBits, TableEntry());
+    for (unsigned index = 0; index < mCodeLengths.size(); ++index) {
+      auto len = mCodeLengths[index];
+      if (len == 0 || len > sTableBits) continue;
+      uint32_t first = mCodes[index] << (sTableBits - len);
+      uint32_t last = first + (1 << (sTableBits - len));
+      for (uint32_t i = first; i < last; ++i) {
+        mTable[i].index = index;
+        mTable[i].length = len;
+      }
+    }
+    return true;
+  }
+
+  struct TableEntry {
+    unsigned index = 0;
+    uint16_t length = 0;
+  };
+
+  // the alphabet, determined by template parameter
+  typename _BASE::alphabet_type mAlphabet;
+  // code length for every symbol index, 0 for symbols without code
+  std::vector<uint16_t> mCodeLengths;
+  // code for every symbol index
+  std::vector<uint32_t> mCodes;
+  // symbol indices sorted by code
+  std::vector<unsigned> mSortedIndices;
+  // per code length: first code, position of the first code in mSortedIndices, number of codes
+  std::vector<uint32_t> mFirstCode;
+  std::vector<unsigned> mFirstIndex;
+  std::vector<unsigned> mCount;
+  // lookup table for all codes up to sTableBits
+  std::vector<TableEntry> mTable;
+};
+
 }; // namespace o2
 
 #endif
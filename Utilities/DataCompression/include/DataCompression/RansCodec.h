@@ -0,0 +1,354 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//-*- Mode: C++ -*-
+
+#ifndef RANSCODEC_H
+#define RANSCODEC_H
+
+//  @file   RansCodec.h
+//  @brief  Range asymmetric numeral system (rANS) coding model and codec
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace o2 {
+
+/**
+ * @class RansModel
+ * @brief Probability model providing the quantized frequency table for rANS
+ * This is a mixin class which extends the ProbabilityModel base like the
+ * Huffman models, weights are added via the ProbabilityModel interface and
+ * converted by generate() to frequencies summing up to 2^_ScaleBits.
+ *
+ * Unlike Huffman, rANS does not assign a code to a single symbol, a sequence
+ * of symbols is coded as a block by RansCodec. Only symbols with non-zero
+ * weight can be coded.
+ *
+ * The frequency table can be written to and read from a word buffer, so that
+ * it can be stored together with the coded data.
+ */
+template<typename _BASE, unsigned _ScaleBits = 14>
+class RansModel : public _BASE {
+public:
+  RansModel() : mAlphabet(), mFrequencies(), mStarts(), mSlots() {}
+  ~RansModel() {}
+
+  typedef _BASE                                base_type;
+  typedef typename _BASE::value_type value_type;
+  // the word type for the serialized table, same as used by the codec
+  typedef uint16_t word_type;
+  static constexpr unsigned sScaleBits = _ScaleBits;
+  static constexpr uint32_t sTotalFrequency = 1u << _ScaleBits;
+  static_assert(_ScaleBits > 0 && _ScaleBits <= 15, "scale must be in the range 1 to 15 bits");
+
+  int init(double v = 1.) {return _BASE::initWeight(mAlphabet, v);}
+
+  /**
+   * Quantize the weights to frequencies
+   * Every symbol with non-zero weight gets at least frequency 1, the rounding
+   * error is compensated at the most frequent symbols.
+   */
+  bool generate() {
+    _BASE& model = *this;
+    typename _BASE::weight_type totalWeight = 0;
+    unsigned maxIndex = 0;
+    unsigned nSymbols = 0;
+    for (auto i : model) {
+      if (i.second <= 0) continue;
+      totalWeight += i.second;
+      auto index = _BASE::alphabet_type::getIndex(i.first);
+      if (index > maxIndex) maxIndex = index;
+      ++nSymbols;
+    }
+    if (nSymbols == 0) return false;
+    if (nSymbols > sTotalFrequency) {
+      throw std::range_error("number of symbols exceeds the frequency scale");
+    }
+    mFrequencies.assign(maxIndex + 1, 0);
+    int64_t sum = 0;
+    for (auto i : model) {
+      if (i.second <= 0) continue;
+      auto index = _BASE::alphabet_type::getIndex(i.first);
+      uint32_t frequency = static_cast<uint32_t>(i.second / totalWeight * sTotalFrequency + 0.5);
+      if (frequency == 0) frequency = 1;
+      mFrequencies[index] = frequency;
+      sum += frequency;
+    }
+    // move the difference to/from the most frequent symbols
+    std::vector<unsigned> order;
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      if (mFrequencies[index] > 0) order.push_back(index);
+    }
+    std::sort(order.begin(), order.end(), [this](unsigned a, unsigned b) {return mFrequencies[a] > mFrequencies[b];});
+    int64_t difference = sum - sTotalFrequency;
+    for (unsigned k = 0; difference != 0; k = (k + 1) % order.size()) {
+      auto& frequency = mFrequencies[order[k]];
+      if (difference > 0) {
+        if (frequency == 1) continue;
+        int64_t step = std::min<int64_t>(difference, (frequency + 1) / 2);
+        frequency -= step;
+        difference -= step;
+      } else {
+        frequency -= difference;
+        difference = 0;
+      }
+    }
+    return buildTables();
+  }
+
+  /// frequency of the symbol with index, 0 if the symbol can not be coded
+  uint32_t getFrequency(unsigned index) const {
+    return index < mFrequencies.size() ? mFrequencies[index] : 0;
+  }
+  /// cumulative frequency of all symbols before index
+  uint32_t getStart(unsigned index) const {return mStarts[index];}
+  /// symbol index for a slot in the range [0, 2^sScaleBits)
+  unsigned getIndexForSlot(uint32_t slot) const {return mSlots[slot];}
+
+  /**
+   * Serialize the frequency table
+   * Format: number of entries (2 words), then for every symbol with non-zero
+   * frequency the symbol index (2 words) and the frequency (1 word)
+   */
+  int writeTable(std::vector<word_type>& out) const {
+    uint32_t nEntries = 0;
+    for (auto f : mFrequencies) {
+      if (f > 0) ++nEntries;
+    }
+    auto begin = out.size();
+    writeWord32(out, nEntries);
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      if (mFrequencies[index] == 0) continue;
+      writeWord32(out, index);
+      out.push_back(mFrequencies[index]);
+    }
+    return out.size() - begin;
+  }
+
+  /**
+   * Restore the frequency table written by writeTable
+   * @return pointer behind the table, nullptr in case of error
+   */
+  const word_type* readTable(const word_type* position, const word_type* end) {
+    if (end - position < 2) return nullptr;
+    uint32_t nEntries = readWord32(position);
+    if (uint64_t(end - position) < 3 * uint64_t(nEntries)) return nullptr;
+    mFrequencies.clear();
+    for (uint32_t entry = 0; entry < nEntries; ++entry) {
+      uint32_t index = readWord32(position);
+      if (mFrequencies.size() < index + 1) mFrequencies.resize(index + 1, 0);
+      mFrequencies[index] = *position++;
+    }
+    return buildTables() ? position : nullptr;
+  }
+
+  /**
+   * @brief Write the frequency table in text format, one line per symbol:
+   * value frequency
+   */
+  int write(std::ostream& out) {
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      if (mFrequencies[index] == 0) continue;
+      out << _BASE::alphabet_type::getSymbol(index) << " " << mFrequencies[index] << std::endl;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Read the frequency table written by write
+   * The table has to be terminated by blank line or eof. The frequencies are
+   * also added as weights to the probability model.
+   */
+  int read(std::istream& in) {
+    mFrequencies.clear();
+    std::string line;
+    while (std::getline(in, line) && !line.empty()) {
+      std::stringstream ls(line);
+      typename _BASE::alphabet_type::value_type symbol;
+      uint32_t frequency = 0;
+      if (!(ls >> symbol >> frequency) || frequency == 0) {
+        std::cerr << "format error: invalid frequency table entry '" << line << "'" << std::endl;
+        return -1;
+      }
+      unsigned index = _BASE::alphabet_type::getIndex(symbol);
+      if (mFrequencies.size() < index + 1) mFrequencies.resize(index + 1, 0);
+      mFrequencies[index] = frequency;
+      _BASE::addWeight(symbol, frequency);
+    }
+    return buildTables() ? 0 : -1;
+  }
+
+  void print() const {
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      if (mFrequencies[index] == 0) continue;
+      std::cout << "value: " << std::setw(6) << _BASE::alphabet_type::getSymbol(index)
+                << "   frequency: " << std::setw(6) << mFrequencies[index]
+                << std::endl;
+    }
+  }
+
+private:
+  static void writeWord32(std::vector<word_type>& out, uint32_t value) {
+    out.push_back(value >> 16);
+    out.push_back(value & 0xffff);
+  }
+  static uint32_t readWord32(const word_type*& position) {
+    uint32_t value = uint32_t(position[0]) << 16 | position[1];
+    position += 2;
+    return value;
+  }
+
+  /// cumulative frequencies and slot to symbol lookup table
+  bool buildTables() {
+    mStarts.assign(mFrequencies.size(), 0);
+    uint32_t start = 0;
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      mStarts[index] = start;
+      start += mFrequencies[index];
+    }
+    if (start != sTotalFrequency) {
+      std::cerr << "error: frequencies of model " << _BASE::getName() << " sum up to " << start
+                << ", expected " << sTotalFrequency << std::endl;
+      return false;
+    }
+    mSlots.resize(sTotalFrequency);
+    for (unsigned index = 0; index < mFrequencies.size(); ++index) {
+      std::fill(mSlots.begin() + mStarts[index], mSlots.begin() + mStarts[index] + mFrequencies[index], index);
+    }
+    return true;
+  }
+
+  // the alphabet, determined by template parameter
+  typename _BASE::alphabet_type mAlphabet;
+  // quantized frequency for every symbol index
+  std::vector<uint32_t> mFrequencies;
+  // cumulative frequency for every symbol index
+  std::vector<uint32_t> mStarts;
+  // symbol index for every slot of the total frequency range
+  std::vector<unsigned> mSlots;
+};
+
+/**
+ * @class RansCodec
+ * @brief Interleaved rANS coder for a block of symbols
+ *
+ * The symbols are distributed round robin to _NStreams independent coder
+ * states which are interleaved in one output buffer, this breaks the
+ * dependency between consecutive symbols and allows the CPU to work on
+ * several of them in parallel.
+ *
+ * States are 32 bit and renormalized in 16 bit words. The block is written
+ * as: the frequency table of the model, the number of symbols (2 words),
+ * the final coder states (2 words each) and the coded words.
+ */
+template<typename _Model, unsigned _NStreams = 4>
+class RansCodec {
+public:
+  typedef _Model model_type;
+  typedef typename _Model::value_type value_type;
+  typedef typename _Model::word_type word_type;
+  static constexpr unsigned sNStreams = _NStreams;
+  static_assert(_NStreams > 0, "at least one stream required");
+
+  /**
+   * Encode the symbols of the range [begin, end) and append the block to out
+   * @return number of words written
+   */
+  template<typename InputIt>
+  static size_t encode(const model_type& model, InputIt begin, InputIt end, std::vector<word_type>& out) {
+    auto blockBegin = out.size();
+    model.writeTable(out);
+    uint32_t nSymbols = std::distance(begin, end);
+    out.push_back(nSymbols >> 16);
+    out.push_back(nSymbols & 0xffff);
+
+    // rANS works as a stack: symbols are coded in reverse order and the
+    // words are reversed at the end
+    std::vector<word_type> words;
+    words.reserve(nSymbols / 2 + 2 * sNStreams);
+    uint32_t states[sNStreams];
+    std::fill(states, states + sNStreams, sLowerBound);
+    auto it = end;
+    for (uint32_t position = nSymbols; position-- > 0;) {
+      --it;
+      auto index = _Model::alphabet_type::getIndex(*it);
+      uint32_t frequency = model.getFrequency(index);
+      if (frequency == 0) {
+        std::stringstream msg;
+        msg << "symbol " << *it << " can not be coded in model " << model.getName();
+        throw std::range_error(msg.str());
+      }
+      uint32_t& state = states[position % sNStreams];
+      // 64 bit, since the bound is 2^32 for a symbol taking all the frequency range
+      uint64_t maxState = (uint64_t(sLowerBound >> _Model::sScaleBits) << 16) * frequency;
+      if (state >= maxState) {
+        words.push_back(state & 0xffff);
+        state >>= 16;
+      }
+      state = ((state / frequency) << _Model::sScaleBits) + (state % frequency) + model.getStart(index);
+    }
+    for (unsigned stream = sNStreams; stream-- > 0;) {
+      words.push_back(states[stream] & 0xffff);
+      words.push_back(states[stream] >> 16);
+    }
+    out.insert(out.end(), words.rbegin(), words.rend());
+    return out.size() - blockBegin;
+  }
+
+  /**
+   * Decode a block written by encode, the model is initialized from the
+   * frequency table of the block
+   * @return pointer behind the block
+   */
+  template<typename OutputIt>
+  static const word_type* decode(model_type& model, const word_type* position, const word_type* end, OutputIt output) {
+    position = model.readTable(position, end);
+    if (position == nullptr || end - position < 2 + 2 * sNStreams) {
+      throw std::runtime_error("rANS block corrupted");
+    }
+    uint32_t nSymbols = uint32_t(position[0]) << 16 | position[1];
+    position += 2;
+    uint32_t states[sNStreams];
+    for (unsigned stream = 0; stream < sNStreams; ++stream) {
+      states[stream] = uint32_t(position[0]) << 16 | position[1];
+      position += 2;
+    }
+    constexpr uint32_t mask = _Model::sTotalFrequency - 1;
+    for (uint32_t symbol = 0; symbol < nSymbols; ++symbol) {
+      uint32_t& state = states[symbol % sNStreams];
+      uint32_t slot = state & mask;
+      auto index = model.getIndexForSlot(slot);
+      *output++ = _Model::alphabet_type::getSymbol(index);
+      state = model.getFrequency(index) * (state >> _Model::sScaleBits) + slot - model.getStart(index);
+      if (state < sLowerBound) {
+        if (position == end) {
+          throw std::runtime_error("rANS block corrupted");
+        }
+        state = state << 16 | *position++;
+      }
+    }
+    return position;
+  }
+
+private:
+  // lower bound of the normalized state interval [L, L << 16)
+  static constexpr uint32_t sLowerBound = 1u << 16;
+};
+
+}; // namespace o2
+
+#endif
@@ -0,0 +1,98 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//  @file   benchmark_CanonicalHuffman.cxx
+//  @brief  Benchmark of the table decoding of canonical Huffman codes against
+//          the decoding with the Huffman tree
+
+#include <iostream>
+#include <vector>
+#include <bitset>
+#include <chrono>
+#include "../include/DataCompression/dc_primitives.h"
+#include "../include/DataCompression/HuffmanCodec.h"
+#include "../include/DataCompression/DataDeflater.h"
+#include "../include/DataCompression/DataInflater.h"
+#include "DataGenerator.h"
+
+int main()
+{
+  // a wide distribution, typical for the TPC cluster parameters, where
+  // most codes are around 10 bit
+  using TestDistribution_t = o2::test::normal_distribution<double>;
+  using DataGenerator_t = o2::test::DataGenerator<int16_t, TestDistribution_t>;
+  DataGenerator_t dg(-511, 512, 1, 0., 100.);
+  using Alphabet_t = ContiguousAlphabet<DataGenerator_t::value_type, -511, 512>;
+  Alphabet_t alphabet;
+
+  using HuffmanModel_t = o2::HuffmanModel<ProbabilityModel<Alphabet_t>, o2::HuffmanNode<std::bitset<32>>, true>;
+  using CanonicalModel_t = o2::CanonicalHuffmanModel<ProbabilityModel<Alphabet_t>, std::bitset<32>, 20, 10>;
+  HuffmanModel_t huffmanmodel;
+  CanonicalModel_t canonicalmodel;
+  huffmanmodel.init(0.);
+  canonicalmodel.init(0.);
+  for (auto s : alphabet) {
+    huffmanmodel.addWeight(s, dg.getProbability(s));
+    canonicalmodel.addWeight(s, dg.getProbability(s));
+  }
+  huffmanmodel.GenerateHuffmanTree();
+  canonicalmodel.GenerateHuffmanTree();
+
+  const int nRolls = 1000000;
+  std::vector<DataGenerator_t::value_type> values;
+  for (int n = 0; n < nRolls; ++n) {
+    values.emplace_back(dg());
+  }
+
+  // the tree model is decoded from codes aligned to the MSB, this leaves out
+  // the bit stream handling and is in favour of the tree model
+  std::vector<HuffmanModel_t::code_type> treeCodes;
+  for (auto v : values) {
+    uint16_t codeLen = 0;
+    auto code = huffmanmodel.Encode(v, codeLen);
+    code <<= (code.size() - codeLen);
+    treeCodes.emplace_back(code);
+  }
+
+  std::vector<uint32_t> stream;
+  auto writer = [&](const uint32_t& word) -> bool {stream.emplace_back(word); return true;};
+  o2::data_compression::DataDeflater<uint32_t> deflater;
+  auto start = std::chrono::steady_clock::now();
+  for (auto v : values) {
+    uint16_t codeLen = 0;
+    auto code = canonicalmodel.Encode(v, codeLen);
+    deflater.writeRaw(code.to_ulong(), codeLen, writer);
+  }
+  deflater.close(writer);
+  auto encodeTime = std::chrono::steady_clock::now() - start;
+
+  std::vector<DataGenerator_t::value_type> decoded(nRolls);
+  start = std::chrono::steady_clock::now();
+  for (int n = 0; n < nRolls; ++n) {
+    uint16_t codeLen = 0;
+    decoded[n] = huffmanmodel.Decode(treeCodes[n], codeLen);
+  }
+  auto treeTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  o2::data_compression::DataInflater<uint32_t> inflater(stream.data(), stream.data() + stream.size());
+  for (int n = 0; n < nRolls; ++n) {
+    decoded[n] = canonicalmodel.decode(inflater);
+  }
+  auto tableTime = std::chrono::steady_clock::now() - start;
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  std::cout << nRolls << " values, " << 32 * stream.size() / double(nRolls) << " bit per value" << std::endl
+            << "  encoding with bit stream:  " << duration_cast<microseconds>(encodeTime).count() << " us" << std::endl
+            << "  decoding with tree:        " << duration_cast<microseconds>(treeTime).count() << " us" << std::endl
+            << "  decoding with table:       " << duration_cast<microseconds>(tableTime).count() << " us" << std::endl;
+  return 0;
+}
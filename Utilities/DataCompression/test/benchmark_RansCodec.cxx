@@ -0,0 +1,109 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//  @file   benchmark_RansCodec.cxx
+//  @brief  Benchmark of the rANS codec against the canonical Huffman codec
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include "../include/DataCompression/dc_primitives.h"
+#include "../include/DataCompression/HuffmanCodec.h"
+#include "../include/DataCompression/RansCodec.h"
+#include "../include/DataCompression/DataDeflater.h"
+#include "../include/DataCompression/DataInflater.h"
+#include "DataGenerator.h"
+
+int main()
+{
+  // a skewed distribution like the TPC time deltas, where the most probable
+  // symbol has a probability of 0.6 and Huffman needs at least one bit
+  using TestDistribution_t = o2::test::geometric_distribution<int16_t>;
+  using DataGenerator_t = o2::test::DataGenerator<int16_t, TestDistribution_t>;
+  DataGenerator_t dg(0, 63, 1, 0.6);
+  using Alphabet_t = ContiguousAlphabet<DataGenerator_t::value_type, 0, 63>;
+
+  const int nRolls = 4000000;
+  std::vector<DataGenerator_t::value_type> values;
+  for (int n = 0; n < nRolls; ++n) {
+    values.emplace_back(dg());
+  }
+
+  // both models are trained on the data itself
+  using HuffmanModel_t = o2::CanonicalHuffmanModel<ProbabilityModel<Alphabet_t>, uint32_t, 20, 10>;
+  using RansModel_t = o2::RansModel<ProbabilityModel<Alphabet_t>>;
+  using RansCodec_t = o2::RansCodec<RansModel_t>;
+  HuffmanModel_t huffmanmodel;
+  RansModel_t ransmodel;
+  huffmanmodel.init(0.);
+  ransmodel.init(0.);
+  std::vector<int> counts(64, 0);
+  for (auto v : values) {
+    huffmanmodel.addWeight(v);
+    ransmodel.addWeight(v);
+    counts[v]++;
+  }
+  huffmanmodel.generate();
+  ransmodel.generate();
+  double entropy = 0.;
+  for (auto c : counts) {
+    if (c > 0) entropy -= c * std::log2(double(c) / nRolls);
+  }
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  // input size in MB, 16 bit per value
+  const double mbytes = nRolls * sizeof(DataGenerator_t::value_type) / 1e6;
+  auto rate = [mbytes](std::chrono::steady_clock::duration d) {
+    return mbytes / (duration_cast<microseconds>(d).count() / 1e6);
+  };
+
+  std::vector<uint32_t> huffmanStream;
+  auto writer = [&](const uint32_t& word) -> bool {huffmanStream.emplace_back(word); return true;};
+  o2::data_compression::DataDeflater<uint32_t> deflater;
+  auto start = std::chrono::steady_clock::now();
+  for (auto v : values) {
+    uint16_t codeLen = 0;
+    auto code = huffmanmodel.Encode(v, codeLen);
+    deflater.writeRaw(code, codeLen, writer);
+  }
+  deflater.close(writer);
+  auto huffmanEncodeTime = std::chrono::steady_clock::now() - start;
+
+  std::vector<DataGenerator_t::value_type> decoded(nRolls);
+  start = std::chrono::steady_clock::now();
+  o2::data_compression::DataInflater<uint32_t> inflater(huffmanStream.data(), huffmanStream.data() + huffmanStream.size());
+  for (int n = 0; n < nRolls; ++n) {
+    decoded[n] = huffmanmodel.decode(inflater);
+  }
+  auto huffmanDecodeTime = std::chrono::steady_clock::now() - start;
+
+  std::vector<RansCodec_t::word_type> ransStream;
+  start = std::chrono::steady_clock::now();
+  RansCodec_t::encode(ransmodel, values.begin(), values.end(), ransStream);
+  auto ransEncodeTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  RansModel_t decodermodel;
+  RansCodec_t::decode(decodermodel, ransStream.data(), ransStream.data() + ransStream.size(), decoded.begin());
+  auto ransDecodeTime = std::chrono::steady_clock::now() - start;
+
+  double huffmanBits = 32. * huffmanStream.size() / nRolls;
+  double ransBits = 16. * ransStream.size() / nRolls;
+  std::cout << std::fixed << std::setprecision(3)
+            << nRolls << " values, entropy " << entropy / nRolls << " bit per value" << std::endl
+            << "  Huffman: " << huffmanBits << " bit per value, encoding "
+            << rate(huffmanEncodeTime) << " MB/s, decoding " << rate(huffmanDecodeTime) << " MB/s" << std::endl
+            << "  rANS:    " << ransBits << " bit per value, encoding "
+            << rate(ransEncodeTime) << " MB/s, decoding " << rate(ransDecodeTime) << " MB/s" << std::endl;
+  return 0;
+}
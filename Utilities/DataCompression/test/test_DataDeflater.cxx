@@ -37,6 +37,7 @@
 #include <thread>
 #include <stdexcept>  // exeptions, runtime_error
 #include "../include/DataCompression/DataDeflater.h"
+#include "../include/DataCompression/DataInflater.h"
 #include "../include/DataCompression/TruncatedPrecisionConverter.h"
 #include "DataGenerator.h"
 #include "Fifo.h"
@@ -177,3 +178,42 @@ BOOST_AUTO_TEST_CASE(test_TruncatedPrecisionConverter)
   deflater.close(writerfct);
   compare(data, Codec::sMaxLength, targetBuffer);
 }
+
+BOOST_AUTO_TEST_CASE(test_DataInflater)
+{
+  // write fields of varying length with the deflater and read them back
+  using TestDataDeflater = o2dc::DataDeflater<uint16_t>;
+  using target_type = TestDataDeflater::target_type;
+  TestDataDeflater deflater;
+
+  std::vector<target_type> targetBuffer;
+  auto writerfct = [&](const target_type& value) -> bool
+    {
+      targetBuffer.emplace_back(value);
+      return true;
+    };
+
+  std::vector<std::pair<uint64_t, uint16_t>> fields;
+  for (uint16_t i = 0; i < 1000; ++i) {
+    uint16_t bitlength = 1 + (i * 7) % 64;
+    uint64_t value = (0x9e3779b97f4a7c15ull * (i + 1)) >> (64 - bitlength);
+    fields.emplace_back(value, bitlength);
+    deflater.writeRaw(value, bitlength, writerfct);
+    if (i % 100 == 99) {
+      deflater.align();
+    }
+  }
+  deflater.close(writerfct);
+
+  o2dc::DataInflater<target_type> inflater(targetBuffer.data(), targetBuffer.data() + targetBuffer.size());
+  int i = 0;
+  for (const auto& field : fields) {
+    uint64_t value = 0;
+    inflater.readRaw(value, field.second);
+    BOOST_REQUIRE(value == field.first);
+    if (i++ % 100 == 99) {
+      inflater.align();
+    }
+  }
+  BOOST_CHECK(inflater.empty());
+}
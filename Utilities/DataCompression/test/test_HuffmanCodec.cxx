@@ -34,9 +34,13 @@
 #include <vector>
 #include <bitset>
 #include <thread>
+#include <sstream>
+#include <algorithm>
 #include <stdexcept>  // exeptions, runtime_error
 #include "../include/DataCompression/dc_primitives.h"
 #include "../include/DataCompression/HuffmanCodec.h"
+#include "../include/DataCompression/DataDeflater.h"
+#include "../include/DataCompression/DataInflater.h"
 #include "DataGenerator.h"
 #include "Fifo.h"
 
@@ -183,3 +187,110 @@ BOOST_AUTO_TEST_CASE(test_HuffmanCodec)
   decoderThread.join();
   std::cout << "... done" << std::endl;
 }
+
+BOOST_AUTO_TEST_CASE(test_CanonicalHuffmanModel)
+{
+  using TestDistribution_t = o2::test::normal_distribution<double>;
+  using DataGenerator_t = o2::test::DataGenerator<int16_t, TestDistribution_t>;
+  DataGenerator_t dg(-7, 10, 1, 0., 1.);
+  using SimpleRangeAlphabet_t = ContiguousAlphabet<DataGenerator_t::value_type, -7, 10>;
+  SimpleRangeAlphabet_t alphabet;
+
+  // the tree based model for comparison
+  using HuffmanModel_t = o2::HuffmanModel<
+    ProbabilityModel<SimpleRangeAlphabet_t>
+    , o2::HuffmanNode<std::bitset<32> >
+    , true
+    >;
+  // length limited canonical codes, the distribution creates codes longer
+  // than 8 bit which are not covered by the decoding table
+  using CanonicalModel_t = o2::CanonicalHuffmanModel<
+    ProbabilityModel<SimpleRangeAlphabet_t>
+    , std::bitset<32>
+    , 12
+    , 6
+    >;
+  HuffmanModel_t huffmanmodel;
+  CanonicalModel_t canonicalmodel;
+  huffmanmodel.init(0.);
+  canonicalmodel.init(0.);
+  for (auto s : alphabet) {
+    huffmanmodel.addWeight(s, dg.getProbability(s));
+    canonicalmodel.addWeight(s, dg.getProbability(s));
+  }
+  huffmanmodel.GenerateHuffmanTree();
+  BOOST_REQUIRE(canonicalmodel.GenerateHuffmanTree());
+  canonicalmodel.print();
+
+  for (auto s : alphabet) {
+    uint16_t canonicalLen = 0;
+    auto code = canonicalmodel.Encode(s, canonicalLen);
+    BOOST_CHECK(canonicalLen > 0 && canonicalLen <= CanonicalModel_t::sMaxLength);
+    code <<= (code.size() - canonicalLen);
+    uint16_t decodedLen = 0;
+    BOOST_CHECK(canonicalmodel.Decode(code, decodedLen) == s);
+    BOOST_CHECK(decodedLen == canonicalLen);
+  }
+
+  // the code table can be restored from the dump
+  std::stringstream dump;
+  canonicalmodel.write(dump);
+  CanonicalModel_t restoredmodel;
+  BOOST_REQUIRE(restoredmodel.read(dump) == 0);
+  for (auto s : alphabet) {
+    uint16_t len = 0, restoredLen = 0;
+    BOOST_CHECK(canonicalmodel.Encode(s, len) == restoredmodel.Encode(s, restoredLen));
+    BOOST_CHECK(len == restoredLen);
+  }
+
+  // decode a stream of random values
+  const int nRolls = 100000;
+  std::vector<DataGenerator_t::value_type> values;
+  for (int n = 0; n < nRolls; ++n) {
+    values.emplace_back(dg());
+  }
+  std::vector<uint32_t> stream;
+  auto writer = [&](const uint32_t& word) -> bool {stream.emplace_back(word); return true;};
+  o2::data_compression::DataDeflater<uint32_t> deflater;
+  for (auto v : values) {
+    uint16_t codeLen = 0;
+    auto code = canonicalmodel.Encode(v, codeLen);
+    deflater.writeRaw(code.to_ulong(), codeLen, writer);
+  }
+  deflater.close(writer);
+  o2::data_compression::DataInflater<uint32_t> inflater(stream.data(), stream.data() + stream.size());
+  for (auto v : values) {
+    BOOST_REQUIRE(canonicalmodel.decode(inflater) == v);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_CanonicalHuffmanLengthLimit)
+{
+  // weights of a geometric series lead to a degenerated tree with code
+  // lengths up to the number of symbols
+  using Alphabet_t = ContiguousAlphabet<int16_t, 0, 19>;
+  using CanonicalModel_t = o2::CanonicalHuffmanModel<ProbabilityModel<Alphabet_t>, uint32_t, 8, 4>;
+  Alphabet_t alphabet;
+  CanonicalModel_t model;
+  model.init(0.);
+  double weight = 1.;
+  for (auto s : alphabet) {
+    model.addWeight(s, weight);
+    weight /= 2.;
+  }
+  BOOST_REQUIRE(model.GenerateHuffmanTree());
+  double kraft = 0.;
+  uint16_t lastLen = 0;
+  for (auto s : alphabet) {
+    uint16_t len = 0;
+    uint32_t code = model.Encode(s, len);
+    BOOST_CHECK(len <= CanonicalModel_t::sMaxLength);
+    BOOST_CHECK(len >= lastLen);
+    lastLen = len;
+    kraft += 1. / (1 << len);
+    uint16_t decodedLen = 0;
+    BOOST_CHECK(model.Decode(code << (32 - len), decodedLen) == s);
+    BOOST_CHECK(decodedLen == len);
+  }
+  BOOST_CHECK(kraft <= 1.);
+}
@@ -0,0 +1,168 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//  @file   test_RansCodec.cxx
+//  @brief  Test program for the rANS coding model and codec
+
+#define BOOST_TEST_MODULE Utility test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <vector>
+#include <bitset>
+#include <sstream>
+#include "../include/DataCompression/dc_primitives.h"
+#include "../include/DataCompression/HuffmanCodec.h"
+#include "../include/DataCompression/RansCodec.h"
+#include "../include/DataCompression/DataDeflater.h"
+#include "../include/DataCompression/DataInflater.h"
+#include "DataGenerator.h"
+
+BOOST_AUTO_TEST_CASE(test_RansCodec)
+{
+  using TestDistribution_t = o2::test::normal_distribution<double>;
+  using DataGenerator_t = o2::test::DataGenerator<int16_t, TestDistribution_t>;
+  DataGenerator_t dg(-7, 10, 1, 0., 1.);
+  using SimpleRangeAlphabet_t = ContiguousAlphabet<DataGenerator_t::value_type, -7, 10>;
+  SimpleRangeAlphabet_t alphabet;
+
+  using RansModel_t = o2::RansModel<ProbabilityModel<SimpleRangeAlphabet_t>>;
+  using Codec_t = o2::RansCodec<RansModel_t>;
+  RansModel_t model;
+  model.init(0.);
+  for (auto s : alphabet) {
+    model.addWeight(s, dg.getProbability(s));
+  }
+  BOOST_REQUIRE(model.generate());
+  model.print();
+  uint32_t total = 0;
+  for (auto s : alphabet) {
+    auto frequency = model.getFrequency(SimpleRangeAlphabet_t::getIndex(s));
+    BOOST_CHECK(frequency > 0);
+    total += frequency;
+  }
+  BOOST_CHECK(total == RansModel_t::sTotalFrequency);
+
+  // the text dump of the table restores the same frequencies
+  std::stringstream dump;
+  model.write(dump);
+  RansModel_t restoredmodel;
+  BOOST_REQUIRE(restoredmodel.read(dump) == 0);
+  for (auto s : alphabet) {
+    auto index = SimpleRangeAlphabet_t::getIndex(s);
+    BOOST_CHECK(model.getFrequency(index) == restoredmodel.getFrequency(index));
+  }
+
+  // two blocks in one buffer, the number of symbols is not a multiple of the
+  // number of streams
+  std::vector<DataGenerator_t::value_type> values;
+  for (int n = 0; n < 100003; ++n) {
+    values.emplace_back(dg());
+  }
+  std::vector<Codec_t::word_type> buffer;
+  Codec_t::encode(model, values.begin(), values.end(), buffer);
+  Codec_t::encode(model, values.begin(), values.begin() + 7, buffer);
+
+  // the decoder model is initialized from the table in the block
+  RansModel_t decodermodel;
+  std::vector<DataGenerator_t::value_type> decoded;
+  auto position = Codec_t::decode(decodermodel, buffer.data(), buffer.data() + buffer.size(), std::back_inserter(decoded));
+  BOOST_REQUIRE(decoded == values);
+  decoded.clear();
+  position = Codec_t::decode(decodermodel, position, buffer.data() + buffer.size(), std::back_inserter(decoded));
+  BOOST_CHECK(position == buffer.data() + buffer.size());
+  BOOST_REQUIRE(decoded.size() == 7);
+  BOOST_CHECK(std::equal(decoded.begin(), decoded.end(), values.begin()));
+
+  // symbols without frequency can not be coded
+  RansModel_t sparsemodel;
+  sparsemodel.init(0.);
+  sparsemodel.addWeight(1, 1.);
+  sparsemodel.addWeight(2, 1.);
+  BOOST_REQUIRE(sparsemodel.generate());
+  std::vector<DataGenerator_t::value_type> invalid = {1, 2, 3};
+  BOOST_CHECK_THROW(Codec_t::encode(sparsemodel, invalid.begin(), invalid.end(), buffer), std::range_error);
+
+  // a single symbol takes all the frequency range and is coded without any
+  // word, the block is as long as an empty one
+  RansModel_t constantmodel;
+  constantmodel.init(0.);
+  constantmodel.addWeight(3, 1.);
+  BOOST_REQUIRE(constantmodel.generate());
+  BOOST_CHECK(constantmodel.getFrequency(SimpleRangeAlphabet_t::getIndex(3)) == RansModel_t::sTotalFrequency);
+  std::vector<DataGenerator_t::value_type> constant(1000, 3);
+  std::vector<Codec_t::word_type> emptyBlock, constantBlock;
+  Codec_t::encode(constantmodel, constant.begin(), constant.begin(), emptyBlock);
+  Codec_t::encode(constantmodel, constant.begin(), constant.end(), constantBlock);
+  BOOST_CHECK(constantBlock.size() == emptyBlock.size());
+  decoded.clear();
+  position = Codec_t::decode(decodermodel, constantBlock.data(), constantBlock.data() + constantBlock.size(), std::back_inserter(decoded));
+  BOOST_CHECK(position == constantBlock.data() + constantBlock.size());
+  BOOST_CHECK(decoded == constant);
+}
+
+BOOST_AUTO_TEST_CASE(test_RansCodec_skewed)
+{
+  // a skewed distribution like the TPC time deltas, where the most probable
+  // symbol has a probability of 0.6 and Huffman needs at least one bit
+  using TestDistribution_t = o2::test::geometric_distribution<int16_t>;
+  using DataGenerator_t = o2::test::DataGenerator<int16_t, TestDistribution_t>;
+  DataGenerator_t dg(0, 63, 1, 0.6);
+  using Alphabet_t = ContiguousAlphabet<DataGenerator_t::value_type, 0, 63>;
+
+  const int nRolls = 100000;
+  std::vector<DataGenerator_t::value_type> values;
+  for (int n = 0; n < nRolls; ++n) {
+    values.emplace_back(dg());
+  }
+
+  // both models are trained on the data itself
+  using HuffmanModel_t = o2::CanonicalHuffmanModel<ProbabilityModel<Alphabet_t>, uint32_t, 20, 10>;
+  using RansModel_t = o2::RansModel<ProbabilityModel<Alphabet_t>>;
+  using RansCodec_t = o2::RansCodec<RansModel_t>;
+  HuffmanModel_t huffmanmodel;
+  RansModel_t ransmodel;
+  huffmanmodel.init(0.);
+  ransmodel.init(0.);
+  for (auto v : values) {
+    huffmanmodel.addWeight(v);
+    ransmodel.addWeight(v);
+  }
+  huffmanmodel.generate();
+  ransmodel.generate();
+
+  std::vector<uint32_t> huffmanStream;
+  auto writer = [&](const uint32_t& word) -> bool {huffmanStream.emplace_back(word); return true;};
+  o2::data_compression::DataDeflater<uint32_t> deflater;
+  for (auto v : values) {
+    uint16_t codeLen = 0;
+    auto code = huffmanmodel.Encode(v, codeLen);
+    deflater.writeRaw(code, codeLen, writer);
+  }
+  deflater.close(writer);
+
+  std::vector<DataGenerator_t::value_type> decoded(nRolls);
+  o2::data_compression::DataInflater<uint32_t> inflater(huffmanStream.data(), huffmanStream.data() + huffmanStream.size());
+  for (int n = 0; n < nRolls; ++n) {
+    decoded[n] = huffmanmodel.decode(inflater);
+  }
+  BOOST_REQUIRE(decoded == values);
+
+  std::vector<RansCodec_t::word_type> ransStream;
+  RansCodec_t::encode(ransmodel, values.begin(), values.end(), ransStream);
+  RansModel_t decodermodel;
+  std::fill(decoded.begin(), decoded.end(), 0);
+  RansCodec_t::decode(decodermodel, ransStream.data(), ransStream.data() + ransStream.size(), decoded.begin());
+  BOOST_REQUIRE(decoded == values);
+
+  // rANS codes the fractional bits which Huffman rounds up
+  BOOST_CHECK(16. * ransStream.size() < 32. * huffmanStream.size());
+}
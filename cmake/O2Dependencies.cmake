@@ -155,6 +155,11 @@ if(GLFW_FOUND)
     set(GUI_LIBRARIES DebugGUI)
 endif()
 
+# shm_open lives in librt on Linux
+if(NOT APPLE)
+    set(RT_LIBRARIES rt)
+endif()
+
 o2_define_bucket(
     NAME
     O2DeviceApplication_bucket
@@ -176,6 +181,7 @@ o2_define_bucket(
     Net
     ${GUI_LIBRARIES}
     ${OPTIONAL_DDS_LIBRARIES}
+    ${RT_LIBRARIES}
 
     INCLUDE_DIRECTORIES
     ${DDS_INCLUDE_DIR}
@@ -263,6 +269,7 @@ o2_define_bucket(
 
     DEPENDENCIES
     common_boost_bucket
+    common_vc_bucket
     FairRoot::FairMQ Base FairTools Core MathCore Matrix Minuit Hist Geom GenVector RIO
 
     INCLUDE_DIRECTORIES
@@ -276,6 +283,7 @@ o2_define_bucket(
 
     DEPENDENCIES
     fairroot_base_bucket
+    common_vc_bucket
     Base ParBase Core RIO MathUtils Geom
 
     INCLUDE_DIRECTORIES
@@ -284,6 +292,16 @@ o2_define_bucket(
     ${CMAKE_SOURCE_DIR}/Common/MathUtils/include
 )
 
+o2_define_bucket(
+    NAME
+    common_utils_bucket
+
+    DEPENDENCIES
+    pthread
+
+    INCLUDE_DIRECTORIES
+)
+
 o2_define_bucket(
     NAME
     configuration_bucket
@@ -397,6 +415,7 @@ o2_define_bucket(
     DEPENDENCIES
     fairroot_base_bucket
     root_physics_bucket
+    common_vc_bucket
     Field
     VMC # ROOT
     Geom
@@ -472,10 +491,12 @@ o2_define_bucket(
     Gpad
     DetectorsBase
     ITSMFTBase
+    CommonUtils
 
     INCLUDE_DIRECTORIES
     ${CMAKE_SOURCE_DIR}/Detectors/Base/include
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/common/base/include
+    ${CMAKE_SOURCE_DIR}/Common/Utils/include
 )
 
 o2_define_bucket(
@@ -526,6 +547,7 @@ o2_define_bucket(
     ITSBase
     ITSSimulation
     DetectorsBase
+    CommonUtils
 
     INCLUDE_DIRECTORIES
     ${CMAKE_SOURCE_DIR}/Detectors/Base/include
@@ -533,6 +555,7 @@ o2_define_bucket(
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/common/reconstruction/include
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/ITS/base/include
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/ITS/simulation/include
+    ${CMAKE_SOURCE_DIR}/Common/Utils/include
 )
 
 o2_define_bucket(
@@ -675,6 +698,7 @@ o2_define_bucket(
     Gen
     Base
     TreePlayer
+    CommonUtils
     #   Core
     #    root_base_bucket
     #    fairroot_geom
@@ -688,6 +712,7 @@ o2_define_bucket(
     ${CMAKE_SOURCE_DIR}/DataFormats/simulation/include
     ${CMAKE_SOURCE_DIR}/Common/Field/include
     ${CMAKE_SOURCE_DIR}/Common/MathUtils/include
+    ${CMAKE_SOURCE_DIR}/Common/Utils/include
     ${MS_GSL_INCLUDE_DIR}
 )
 
@@ -857,6 +882,7 @@ o2_define_bucket(
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/common/reconstruction/include
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/MFT/base/include
     ${CMAKE_SOURCE_DIR}/Detectors/ITSMFT/MFT/simulation/include
+    ${CMAKE_SOURCE_DIR}/Common/Utils/include
 
 )
 
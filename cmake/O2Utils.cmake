@@ -428,6 +428,42 @@ function(O2_GENERATE_TESTS)
   endforeach ()
 endfunction()
 
+#------------------------------------------------------------------------------
+# O2_GENERATE_BENCHMARKS
+# Generate benchmark executables for all source files listed in BENCHMARK_SRCS
+# The benchmarks are built like the tests but are not added to ctest, they are run by hand.
+# arg BUCKET_NAME
+# arg BENCHMARK_SRCS
+# arg MODULE_LIBRARY_NAME - Name of the library of the module this executable belongs to.
+function(O2_GENERATE_BENCHMARKS)
+  cmake_parse_arguments(
+      PARSED_ARGS
+      "" # bool args
+      "BUCKET_NAME;MODULE_LIBRARY_NAME" # mono-valued arguments
+      "BENCHMARK_SRCS" # multi-valued arguments
+      ${ARGN} # arguments
+  )
+
+# Note: the BUCKET_NAME and MODULE_LIBRARY_NAME are optional arguments
+  CHECK_VARIABLE(PARSED_ARGS_BENCHMARK_SRCS "You must provide the list of sources")
+
+  foreach (benchmark ${PARSED_ARGS_BENCHMARK_SRCS})
+    string(REGEX REPLACE ".*/" "" benchmark_name ${benchmark})
+    string(REGEX REPLACE "\\..*" "" benchmark_name ${benchmark_name})
+    set(benchmark_name benchmark_${MODULE_NAME}_${benchmark_name})
+
+    message(STATUS "Generate benchmark ${benchmark_name}")
+
+    O2_GENERATE_EXECUTABLE(
+        EXE_NAME ${benchmark_name}
+        SOURCES ${benchmark}
+        MODULE_LIBRARY_NAME ${PARSED_ARGS_MODULE_LIBRARY_NAME}
+        BUCKET_NAME ${PARSED_ARGS_BUCKET_NAME}
+        NO_INSTALL FALSE
+    )
+  endforeach ()
+endfunction()
+
 
 #------------------------------------------------------------------------------
 # CHECK_VARIABLE